@@ -165,6 +165,25 @@ public:
 #endif
     }
 
+    TesseractString read8(
+        const unsigned char* data,
+        size_t width, size_t height,
+        size_t bytes_per_line, size_t ppi = 100
+    ){
+#ifdef PA_TESSERACT
+        return TesseractAPI_read_bitmap(
+            m_api,
+            data,
+            width, height,
+            sizeof(uint8_t),
+            bytes_per_line,
+            ppi
+        );
+#else
+        return nullptr;
+#endif
+    }
+
 private:
     TesseractAPI_internal* m_api = nullptr;
 };
@@ -16,6 +16,7 @@
 #ifndef PokemonAutomation_ComputationThreadPool_H
 #define PokemonAutomation_ComputationThreadPool_H
 
+#include <memory>
 #include <functional>
 #include "Common/Cpp/Time.h"
 #include "Common/Cpp/Containers/Pimpl.h"
@@ -47,9 +48,6 @@ public:
 
 
 public:
-    //  As of this writing, tasks dispatched earlier are not allowed to block
-    //  on tasks that are dispatched later as it may cause a deadlock.
-
     //  Dispatch the function. If there are no threads available, it waits until
     //  there are.
     [[nodiscard]] std::unique_ptr<AsyncTask> blocking_dispatch(std::function<void()>&& func);
@@ -59,7 +57,8 @@ public:
     [[nodiscard]] std::unique_ptr<AsyncTask> try_dispatch(std::function<void()>& func);
 
     //  Run function for all the indices [start, end).
-    //  Lower indices are not allowed to block on higher indices.
+    //  "func" may itself call "run_in_parallel()" on this pool. The calling
+    //  thread helps with the work while it waits.
     void run_in_parallel(
         const std::function<void(size_t index)>& func,
         size_t start, size_t end,
@@ -6,7 +6,7 @@
 
 #include <thread>
 #include "Common/Cpp/PanicDump.h"
-#include "ReverseLockGuard.h"
+#include "SpinPause.h"
 #include "ComputationThreadPoolCore.h"
 
 //#include <iostream>
@@ -16,6 +16,135 @@
 namespace PokemonAutomation{
 
 
+namespace{
+
+//  Tickets that a worker can hold for nested "run_in_parallel()" calls.
+const size_t WORKER_DEQUE_SIZE = 256;
+
+//  Tickets for "run_in_parallel()" calls from outside the pool.
+const size_t EXTERNAL_JOB_QUEUE_SIZE = 256;
+
+size_t round_up_power_of_two(size_t x){
+    size_t ret = 1;
+    while (ret < x){
+        ret <<= 1;
+    }
+    return ret;
+}
+
+int64_t now_ns(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(current_time().time_since_epoch()).count();
+}
+
+//  The pool and worker that the current thread belongs to.
+thread_local const void* t_current_pool = nullptr;
+thread_local void* t_current_worker = nullptr;
+
+}
+
+
+
+//
+//  A single "run_in_parallel()" call. This lives on the stack of the caller.
+//
+//  The blocks are handed out with an atomic counter. So nothing is allocated
+//  per block. To get other threads to help, the caller pushes "tickets" (the
+//  pointer to this job) into the queues. Whoever pops a ticket runs blocks
+//  until there are none left.
+//
+//  "refs" counts the unfinished blocks and the tickets that haven't been
+//  popped yet. The caller can't return until it reaches zero since the
+//  tickets point to this object.
+//
+struct ComputationThreadPoolCore::ParallelJob{
+    const std::function<void(size_t index)>& func;
+    const size_t start;
+    const size_t end;
+    const size_t block_size;
+    const size_t blocks;
+
+    std::atomic<size_t> next_block;
+    std::atomic<size_t> refs;
+    std::atomic<bool> safe_to_destruct;
+
+    std::mutex lock;
+    std::condition_variable cv;
+    std::exception_ptr exception;
+
+    ParallelJob(
+        const std::function<void(size_t index)>& p_func,
+        size_t p_start, size_t p_end, size_t p_block_size, size_t p_blocks,
+        size_t tickets
+    )
+        : func(p_func)
+        , start(p_start)
+        , end(p_end)
+        , block_size(p_block_size)
+        , blocks(p_blocks)
+        , next_block(0)
+        , refs(p_blocks + tickets)
+        , safe_to_destruct(false)
+    {}
+
+    void run_blocks() noexcept{
+        while (true){
+            size_t block = next_block.fetch_add(1, std::memory_order_relaxed);
+            if (block >= blocks){
+                return;
+            }
+            size_t s = start + block * block_size;
+            size_t e = std::min(s + block_size, end);
+            try{
+                for (; s < e; s++){
+                    func(s);
+                }
+            }catch (...){
+                std::lock_guard<std::mutex> lg(lock);
+                if (!exception){
+                    exception = std::current_exception();
+                }
+            }
+            release(1);
+        }
+    }
+
+    //  Same protocol as "AsyncTask::report_cancelled()". The caller may
+    //  destroy this the moment it sees "safe_to_destruct".
+    void release(size_t count) noexcept{
+        if (refs.fetch_sub(count, std::memory_order_acq_rel) != count){
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lg(lock);
+        }
+        cv.notify_all();
+        safe_to_destruct.store(true, std::memory_order_release);
+    }
+};
+
+
+struct ComputationThreadPoolCore::Worker{
+    size_t index = 0;
+    WorkStealingDeque<ParallelJob> jobs{WORKER_DEQUE_SIZE};
+
+    ThreadHandle handle;
+
+    //  Time spent awake. "awake_since" is zero while asleep.
+    std::atomic<int64_t> runtime_ns{0};
+    std::atomic<int64_t> awake_since{0};
+
+    void start_runtime(){
+        awake_since.store(now_ns(), std::memory_order_relaxed);
+    }
+    void stop_runtime(){
+        int64_t since = awake_since.exchange(0, std::memory_order_relaxed);
+        if (since != 0){
+            runtime_ns.fetch_add(now_ns() - since, std::memory_order_relaxed);
+        }
+    }
+};
+
+
 
 ComputationThreadPoolCore::ComputationThreadPoolCore(
     std::function<void()>&& new_thread_callback,
@@ -24,38 +153,48 @@ ComputationThreadPoolCore::ComputationThreadPoolCore(
 )
     : m_new_thread_callback(std::move(new_thread_callback))
     , m_max_threads(max_threads == 0 ? std::thread::hardware_concurrency() : max_threads)
+    , m_workers(new Worker[m_max_threads])
+    , m_thread_count(0)
+    , m_tasks(round_up_power_of_two(m_max_threads))
+    , m_jobs(EXTERNAL_JOB_QUEUE_SIZE)
     , m_stopping(false)
+    , m_queued_tasks(0)
     , m_busy_count(0)
+    , m_sleeping(0)
+    , m_dispatch_waiters(0)
 {
-    for (size_t c = 0; c < starting_threads; c++){
-        spawn_thread();
-    }
+    ensure_threads(starting_threads);
 }
 
-void ComputationThreadPoolCore::stop() {
+void ComputationThreadPoolCore::stop(){
     {
-        std::lock_guard<std::mutex> lg(m_lock);
-        if (m_stopping) return;
-        m_stopping = true;
+        std::lock_guard<std::mutex> lg(m_sleep_lock);
+        if (m_stopping.exchange(true)){
+            return;
+        }
         m_thread_cv.notify_all();
-//        m_dispatch_cv.notify_all();
+        m_dispatch_cv.notify_all();
+    }
+
+    std::deque<Thread> threads;
+    {
+        std::lock_guard<std::mutex> lg(m_threads_lock);
+        threads = std::move(m_threads);
     }
-    for (ThreadData& thread : m_threads){
-        if (thread.thread.joinable()) {
-            thread.thread.join();
+    for (Thread& thread : threads){
+        if (thread.joinable()){
+            thread.join();
         }
     }
 
-    // DO NOT JOIN AGAIN IN DESTRUCTOR
-    m_threads.clear();
-
-    for (auto& task : m_queue){
+    //  Cancel every task that no worker got to. Whoever holds it will see it
+    //  as cancelled. Tickets for parallel jobs are left in their queues. The
+    //  callers of "run_in_parallel()" run their own blocks, so nothing else
+    //  needs to.
+    while (AsyncTask* task = m_tasks.pop()){
+        m_queued_tasks.fetch_sub(1, std::memory_order_relaxed);
         task->report_cancelled();
     }
-
-    // DO NOT CLEAR AGAIN IN DESTRUCTOR
-    m_queue.clear();
-
 }
 
 ComputationThreadPoolCore::~ComputationThreadPoolCore(){
@@ -66,82 +205,94 @@ ComputationThreadPoolCore::~ComputationThreadPoolCore(){
 
 
 WallDuration ComputationThreadPoolCore::cpu_time() const{
-    //  TODO: Don't lock the entire queue.
-    WallDuration ret = WallDuration::zero();
-    std::lock_guard<std::mutex> lg(m_lock);
-    for (const ThreadData& thread : m_threads){
-//        ret += thread_cpu_time(thread.handle);
-        ret += thread.runtime.total();
+    int64_t now = now_ns();
+    int64_t total = 0;
+    size_t threads = m_thread_count.load(std::memory_order_acquire);
+    for (size_t c = 0; c < threads; c++){
+        const Worker& worker = m_workers[c];
+        total += worker.runtime_ns.load(std::memory_order_relaxed);
+        int64_t since = worker.awake_since.load(std::memory_order_relaxed);
+        if (since != 0){
+            total += now - since;
+        }
     }
-    return ret;
+    return std::chrono::duration_cast<WallDuration>(std::chrono::nanoseconds(total));
 }
 
 
 void ComputationThreadPoolCore::ensure_threads(size_t threads){
-    std::lock_guard<std::mutex> lg(m_lock);
-    while (m_threads.size() < threads){
+    threads = std::min(threads, m_max_threads);
+    std::lock_guard<std::mutex> lg(m_threads_lock);
+    if (m_stopping.load(std::memory_order_acquire)){
+        return;
+    }
+    while (m_thread_count.load(std::memory_order_relaxed) < threads){
         spawn_thread();
     }
 }
-#if 0
-void ComputationThreadPoolCore::wait_for_everything(){
-    std::unique_lock<std::mutex> lg(m_lock);
-    m_dispatch_cv.wait(lg, [this]{
-        return m_queue.size() + m_busy_count == 0;
-    });
+
+
+
+bool ComputationThreadPoolCore::try_reserve_task(){
+    size_t queued = m_queued_tasks.load(std::memory_order_acquire);
+    while (true){
+        if (queued + m_busy_count.load(std::memory_order_acquire) >= m_max_threads){
+            return false;
+        }
+        if (m_queued_tasks.compare_exchange_weak(queued, queued + 1, std::memory_order_acq_rel)){
+            return true;
+        }
+    }
+}
+void ComputationThreadPoolCore::release_task(){
+    m_queued_tasks.fetch_sub(1, std::memory_order_acq_rel);
+}
+void ComputationThreadPoolCore::submit_task(AsyncTask* task){
+    //  A slot was reserved in "try_reserve_task()". So this can't fail.
+    task->report_started();
+    m_tasks.push(task);
+    spawn_threads_if_needed(1);
+    wake_workers(1);
 }
-#endif
 
 std::unique_ptr<AsyncTask> ComputationThreadPoolCore::blocking_dispatch(std::function<void()>&& func){
     std::unique_ptr<AsyncTask> task(new AsyncTask(std::move(func)));
 
-    {
-        std::unique_lock<std::mutex> lg(m_lock);
-
-        m_dispatch_cv.wait(lg, [this]{
-            return m_queue.size() + m_busy_count < m_max_threads;
+    if (!try_reserve_task()){
+        std::unique_lock<std::mutex> lg(m_sleep_lock);
+        m_dispatch_waiters.fetch_add(1, std::memory_order_seq_cst);
+        bool reserved = false;
+        m_dispatch_cv.wait(lg, [&, this]{
+            if (m_stopping.load(std::memory_order_acquire)){
+                return true;
+            }
+            reserved = try_reserve_task();
+            return reserved;
         });
-
-        //  Enqueue task.
-        m_queue.emplace_back(task.get())->report_started();
-        spawn_threads();
-
-#if 0
-        //  Use this thread to process the queue until our task is
-        while (!m_queue.empty() && !task->is_finished()){
-            AsyncTask* current = m_queue.front();
-            m_queue.pop_front();
-
-            ReverseLockGuard<std::mutex> lg0(m_lock);
-            current->run();
+        m_dispatch_waiters.fetch_sub(1, std::memory_order_relaxed);
+        if (!reserved){
+            task->report_cancelled();
+            return task;
         }
-#endif
     }
 
-//    cout << "notify... " << endl;
-    m_thread_cv.notify_one();
-
+    submit_task(task.get());
     return task;
 }
 std::unique_ptr<AsyncTask> ComputationThreadPoolCore::try_dispatch(std::function<void()>& func){
-    std::unique_ptr<AsyncTask> task;
-    {
-        std::lock_guard<std::mutex> lg(m_lock);
-
-        if (m_queue.size() + m_busy_count >= m_max_threads){
-            return nullptr;
-        }
+    if (m_stopping.load(std::memory_order_acquire) || !try_reserve_task()){
+        return nullptr;
+    }
 
+    std::unique_ptr<AsyncTask> task;
+    try{
         task.reset(new AsyncTask(std::move(func)));
-
-        //  Enqueue task.
-        m_queue.emplace_back(task.get())->report_started();
-
-        spawn_threads();
+    }catch (...){
+        release_task();
+        throw;
     }
 
-    m_thread_cv.notify_one();
-
+    submit_task(task.get());
     return task;
 }
 
@@ -164,98 +315,208 @@ void ComputationThreadPoolCore::run_in_parallel(
     }
 
     size_t blocks = (total + block_size - 1) / block_size;
+    if (blocks == 1){
+        for (size_t c = start; c < end; c++){
+            func(c);
+        }
+        return;
+    }
 
-    //  Prepare all the tasks.
-    std::vector<std::unique_ptr<AsyncTask>> tasks(blocks);
-    for (size_t c = 0; c < blocks; c++){
-        tasks[c].reset(new AsyncTask([=, &func]{
-            size_t s = start + c * block_size;
-            size_t e = std::min(s + block_size, end);
-//            cout << "Running: [" << s << "," << e << ")" << endl;
-            for (; s < e; s++){
-                func(s);
-            }
-        }));
+    Worker* worker = t_current_pool == this ? (Worker*)t_current_worker : nullptr;
+
+    //  Hand out a ticket to every thread that could help.
+    size_t tickets = std::min(blocks - 1, m_max_threads);
+    ParallelJob job(func, start, end, block_size, blocks, tickets);
+    size_t pushed = 0;
+    for (; pushed < tickets; pushed++){
+        bool ok = worker
+            ? worker->jobs.push(&job)
+            : m_jobs.push(&job);
+        if (!ok){
+            break;
+        }
+    }
+    if (pushed < tickets){
+        //  The queue is full. This can't hit zero since no blocks have run.
+        job.refs.fetch_sub(tickets - pushed, std::memory_order_acq_rel);
+    }
+    if (pushed > 0){
+        spawn_threads_if_needed(pushed);
+        wake_workers(pushed);
     }
 
-    {
-        //  Enqueue all the tasks.
-        std::unique_lock<std::mutex> lg(m_lock);
-        for (std::unique_ptr<AsyncTask>& task : tasks){
-            m_queue.emplace_back(task.get())->report_started();
-            m_thread_cv.notify_one();
+    job.run_blocks();
+
+    //  Help with parallel work (ours or anyone else's) until ours is done.
+    //  This is what makes nested calls safe. Tasks from "try_dispatch()" are
+    //  not run here since they may take arbitrarily long.
+    while (job.refs.load(std::memory_order_acquire) != 0){
+        if (try_run_parallel_job(worker)){
+            continue;
         }
-        spawn_threads();
+        std::unique_lock<std::mutex> lg(job.lock);
+        job.cv.wait_for(lg, std::chrono::milliseconds(1), [&]{
+            return job.refs.load(std::memory_order_acquire) == 0;
+        });
+    }
+    while (!job.safe_to_destruct.load(std::memory_order_acquire)){
+        pause();
+    }
+
+    if (job.exception){
+        std::rethrow_exception(job.exception);
+    }
+}
 
-        //  Use this thread to process the queue until our tasks are done.
-        while (!m_queue.empty() && !tasks.back()->is_finished()){
-            AsyncTask* task = m_queue.front();
-            m_queue.pop_front();
 
-            ReverseLockGuard<std::mutex> lg0(m_lock);
-            task->run();
+
+bool ComputationThreadPoolCore::try_run_parallel_job(Worker* worker){
+    ParallelJob* job = find_parallel_job(worker);
+    if (job == nullptr){
+        return false;
+    }
+    job->run_blocks();
+    job->release(1);
+    return true;
+}
+ComputationThreadPoolCore::ParallelJob* ComputationThreadPoolCore::find_parallel_job(Worker* worker){
+    if (worker){
+        if (ParallelJob* job = worker->jobs.pop()){
+            return job;
         }
     }
+    if (ParallelJob* job = m_jobs.pop()){
+        return job;
+    }
 
-    //  Wait for everything to finish.
-    for (std::unique_ptr<AsyncTask>& task : tasks){
-        task->wait_and_rethrow_exceptions();
+    //  Steal from the other threads. Start from our neighbor so that thieves
+    //  spread out.
+    size_t threads = m_thread_count.load(std::memory_order_acquire);
+    size_t first = worker ? worker->index + 1 : 0;
+    for (size_t c = 0; c < threads; c++){
+        Worker& victim = m_workers[(first + c) % threads];
+        if (&victim == worker){
+            continue;
+        }
+        //  "steal()" can fail from contention. Keep trying until it's empty.
+        while (!victim.jobs.empty()){
+            if (ParallelJob* job = victim.jobs.steal()){
+                return job;
+            }
+            pause();
+        }
+    }
+    return nullptr;
+}
+AsyncTask* ComputationThreadPoolCore::find_task(){
+    AsyncTask* task = m_tasks.pop();
+    if (task){
+        //  Count it as busy before it stops counting as queued.
+        m_busy_count.fetch_add(1, std::memory_order_acq_rel);
+        release_task();
     }
+    return task;
 }
 
 
 
-void ComputationThreadPoolCore::spawn_thread(){
-    //  Must call under lock.
-    ThreadData& handle = m_threads.emplace_back();
-    try{
-        handle.thread = Thread([&, this]{
-            run_with_catch(
-                "ParallelTaskRunner::thread_loop()",
-                [&, this]{ thread_loop(handle); }
-            );
-        });
-    }catch (...){
-        m_threads.pop_back();
-        throw;
+void ComputationThreadPoolCore::wake_workers(size_t count){
+    //  Pairs with the fence in "thread_loop()" before it checks for work.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed) == 0){
+        return;
+    }
+    std::lock_guard<std::mutex> lg(m_sleep_lock);
+    if (count >= m_max_threads){
+        m_thread_cv.notify_all();
+        return;
+    }
+    for (size_t c = 0; c < count; c++){
+        m_thread_cv.notify_one();
     }
 }
-void ComputationThreadPoolCore::spawn_threads(){
-    while (m_threads.size() < std::min(m_queue.size() + m_busy_count, m_max_threads)){
+void ComputationThreadPoolCore::spawn_threads_if_needed(size_t wanted){
+    size_t sleeping = m_sleeping.load(std::memory_order_acquire);
+    if (sleeping >= wanted){
+        return;
+    }
+    if (m_thread_count.load(std::memory_order_acquire) >= m_max_threads){
+        return;
+    }
+    wanted -= sleeping;
+
+    std::lock_guard<std::mutex> lg(m_threads_lock);
+    if (m_stopping.load(std::memory_order_acquire)){
+        return;
+    }
+    while (wanted > 0 && m_thread_count.load(std::memory_order_relaxed) < m_max_threads){
         spawn_thread();
+        wanted--;
     }
 }
-void ComputationThreadPoolCore::thread_loop(ThreadData& data){
-    data.handle = current_thread_handle();
+void ComputationThreadPoolCore::spawn_thread(){
+    //  Must call under "m_threads_lock".
+    size_t index = m_thread_count.load(std::memory_order_relaxed);
+    Worker& worker = m_workers[index];
+    worker.index = index;
+    m_threads.emplace_back([&, this]{
+        run_with_catch(
+            "ComputationThreadPoolCore::thread_loop()",
+            [&, this]{ thread_loop(worker); }
+        );
+    });
+    m_thread_count.store(index + 1, std::memory_order_release);
+}
+void ComputationThreadPoolCore::thread_loop(Worker& worker){
+    t_current_pool = this;
+    t_current_worker = &worker;
+    worker.handle = current_thread_handle();
 
     if (m_new_thread_callback){
         m_new_thread_callback();
     }
 
-    data.runtime.start();
+    worker.start_runtime();
 
-    std::unique_lock<std::mutex> lg(m_lock);
-    m_busy_count++;
-    while (!m_stopping){
-//        cout << "m_queue... " << m_queue.size() << endl;
-        if (m_queue.empty()){
-            data.runtime.stop();
-            m_busy_count--;
-            m_dispatch_cv.notify_all();
-//            cout << "waiting... " << m_busy_count << endl;
-            m_thread_cv.wait(lg);
-//            cout << "waking... " << m_busy_count << endl;
-            m_busy_count++;
-            data.runtime.start();
+    while (!m_stopping.load(std::memory_order_acquire)){
+        //  Parallel jobs go first since someone is always waiting on them.
+        if (ParallelJob* job = find_parallel_job(&worker)){
+            m_busy_count.fetch_add(1, std::memory_order_acq_rel);
+            job->run_blocks();
+            job->release(1);
+        }else if (AsyncTask* task = find_task()){
+            task->run();
+        }else{
+            //  Nothing to do. Go to sleep.
+            worker.stop_runtime();
+            {
+                std::unique_lock<std::mutex> lg(m_sleep_lock);
+                m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                bool has_work = !m_tasks.empty() || !m_jobs.empty();
+                size_t threads = m_thread_count.load(std::memory_order_acquire);
+                for (size_t c = 0; c < threads && !has_work; c++){
+                    has_work = !m_workers[c].jobs.empty();
+                }
+                if (!has_work && !m_stopping.load(std::memory_order_acquire)){
+                    m_thread_cv.wait(lg);
+                }
+                m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+            }
+            worker.start_runtime();
             continue;
         }
 
-        AsyncTask* task = m_queue.front();
-        m_queue.pop_front();
-
-        ReverseLockGuard<std::mutex> lg0(m_lock);
-        task->run();
+        //  Done with a piece of work. Let blocked dispatchers check again.
+        m_busy_count.fetch_sub(1, std::memory_order_seq_cst);
+        if (m_dispatch_waiters.load(std::memory_order_seq_cst) != 0){
+            std::lock_guard<std::mutex> lg(m_sleep_lock);
+            m_dispatch_cv.notify_all();
+        }
     }
+
+    worker.stop_runtime();
 }
 
 
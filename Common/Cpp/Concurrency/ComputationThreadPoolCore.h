@@ -11,6 +11,10 @@
  *  Because the # of threads is capped, it is safe to spam this thread pool with
  *  lots of smaller tasks.
  *
+ *  Each worker thread has its own work-stealing deque. Submission is lock-free.
+ *  Threads that wait inside "run_in_parallel()" help with the work instead of
+ *  sleeping. So it is safe to call "run_in_parallel()" from inside the pool.
+ *
  */
 
 #ifndef PokemonAutomation_ComputationThreadPoolCore_H
@@ -18,9 +22,13 @@
 
 #include <functional>
 #include <deque>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "Common/Cpp/Time.h"
 #include "Common/Cpp/CpuUtilization/CpuUtilization.h"
-#include "Common/Cpp/Stopwatch.h"
 #include "Common/Cpp/Concurrency/Thread.h"
+#include "LockFreeQueues.h"
 #include "AsyncTask.h"
 
 namespace PokemonAutomation{
@@ -38,8 +46,7 @@ public:
     ~ComputationThreadPoolCore();
 
     size_t current_threads() const{
-        std::lock_guard<std::mutex> lg(m_lock);
-        return m_threads.size();
+        return m_thread_count.load(std::memory_order_acquire);
     }
     size_t max_threads() const{
         return m_max_threads;
@@ -49,13 +56,9 @@ public:
     void ensure_threads(size_t threads);
 
     void stop();
-//    void wait_for_everything();
 
 
 public:
-    //  As of this writing, tasks dispatched earlier are not allowed to block
-    //  on tasks that are dispatched later as it may cause a deadlock.
-
     //  Dispatch the function. If there are no threads available, it waits until
     //  there are.
     [[nodiscard]] std::unique_ptr<AsyncTask> blocking_dispatch(std::function<void()>&& func);
@@ -65,7 +68,7 @@ public:
     [[nodiscard]] std::unique_ptr<AsyncTask> try_dispatch(std::function<void()>& func);
 
     //  Run function for all the indices [start, end).
-    //  Lower indices are not allowed to block on higher indices.
+    //  "func" may itself call "run_in_parallel()" on this pool.
     void run_in_parallel(
         const std::function<void(size_t index)>& func,
         size_t start, size_t end,
@@ -74,31 +77,51 @@ public:
 
 
 private:
-    struct ThreadData{
-        Thread thread;
-        ThreadHandle handle;
-        Stopwatch runtime;
-    };
+    struct ParallelJob;
+    struct Worker;
+
+    bool try_reserve_task();
+    void release_task();
+    void submit_task(AsyncTask* task);
+
+    //  Run one piece of parallel-for work if there is any.
+    bool try_run_parallel_job(Worker* worker);
+    ParallelJob* find_parallel_job(Worker* worker);
+    AsyncTask* find_task();
 
+    void wake_workers(size_t count);
+    void spawn_threads_if_needed(size_t wanted);
     void spawn_thread();
-    void spawn_threads();
-    void thread_loop(ThreadData& data);
+    void thread_loop(Worker& worker);
 
 
 private:
-    struct Data;
-
     std::function<void()> m_new_thread_callback;
-    size_t m_max_threads;
-    std::deque<AsyncTask*> m_queue;
+    const size_t m_max_threads;
+
+    //  One per potential thread. These never move so other threads can steal
+    //  from them without a lock.
+    std::unique_ptr<Worker[]> m_workers;
+    std::atomic<size_t> m_thread_count;
 
-    std::deque<ThreadData> m_threads;
+    //  Submissions from outside the pool.
+    BoundedMPMCQueue<AsyncTask> m_tasks;
+    BoundedMPMCQueue<ParallelJob> m_jobs;
 
-    bool m_stopping;
-    size_t m_busy_count;
-    mutable std::mutex m_lock;
+    std::atomic<bool> m_stopping;
+    std::atomic<size_t> m_queued_tasks;
+    std::atomic<size_t> m_busy_count;
+
+    //  Sleeping threads and blocked dispatchers wait here.
+    std::mutex m_sleep_lock;
     std::condition_variable m_thread_cv;
     std::condition_variable m_dispatch_cv;
+    std::atomic<size_t> m_sleeping;
+    std::atomic<size_t> m_dispatch_waiters;
+
+    //  Only for spawning and joining threads.
+    mutable std::mutex m_threads_lock;
+    std::deque<Thread> m_threads;
 };
 
 
@@ -0,0 +1,112 @@
+/*  Computation Thread Pool (Single Queue)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      This is the original implementation of the computation thread pool.
+ *  Every dispatch goes through one lock and one queue. It is no longer used by
+ *  "ComputationThreadPool", but is kept as a baseline for benchmarking.
+ *
+ *      This is a thread pool for compute-heavy tasks.
+ *
+ *  This thread pool has a limited number of threads and should only be used for
+ *  compute-heavy tasks that do not block or yield. A blocked thread will still
+ *  count towards the thread limit.
+ *
+ *  Because the # of threads is capped, it is safe to spam this thread pool with
+ *  lots of smaller tasks.
+ *
+ */
+
+#ifndef PokemonAutomation_ComputationThreadPoolCore_SingleQueue_H
+#define PokemonAutomation_ComputationThreadPoolCore_SingleQueue_H
+
+#include <functional>
+#include <deque>
+#include "Common/Cpp/CpuUtilization/CpuUtilization.h"
+#include "Common/Cpp/Stopwatch.h"
+#include "Common/Cpp/Concurrency/Thread.h"
+#include "AsyncTask.h"
+
+namespace PokemonAutomation{
+
+
+
+
+class ComputationThreadPoolCore_SingleQueue final{
+public:
+    ComputationThreadPoolCore_SingleQueue(
+        std::function<void()>&& new_thread_callback,
+        size_t starting_threads,
+        size_t max_threads
+    );
+    ~ComputationThreadPoolCore_SingleQueue();
+
+    size_t current_threads() const{
+        std::lock_guard<std::mutex> lg(m_lock);
+        return m_threads.size();
+    }
+    size_t max_threads() const{
+        return m_max_threads;
+    }
+    WallDuration cpu_time() const;
+
+    void ensure_threads(size_t threads);
+
+    void stop();
+//    void wait_for_everything();
+
+
+public:
+    //  As of this writing, tasks dispatched earlier are not allowed to block
+    //  on tasks that are dispatched later as it may cause a deadlock.
+
+    //  Dispatch the function. If there are no threads available, it waits until
+    //  there are.
+    [[nodiscard]] std::unique_ptr<AsyncTask> blocking_dispatch(std::function<void()>&& func);
+
+    //  Dispatch the function. Returns null if no threads are available.
+    //  "func" will be moved-from only on success.
+    [[nodiscard]] std::unique_ptr<AsyncTask> try_dispatch(std::function<void()>& func);
+
+    //  Run function for all the indices [start, end).
+    //  Lower indices are not allowed to block on higher indices.
+    void run_in_parallel(
+        const std::function<void(size_t index)>& func,
+        size_t start, size_t end,
+        size_t block_size = 0
+    );
+
+
+private:
+    struct ThreadData{
+        Thread thread;
+        ThreadHandle handle;
+        Stopwatch runtime;
+    };
+
+    void spawn_thread();
+    void spawn_threads();
+    void thread_loop(ThreadData& data);
+
+
+private:
+    struct Data;
+
+    std::function<void()> m_new_thread_callback;
+    size_t m_max_threads;
+    std::deque<AsyncTask*> m_queue;
+
+    std::deque<ThreadData> m_threads;
+
+    bool m_stopping;
+    size_t m_busy_count;
+    mutable std::mutex m_lock;
+    std::condition_variable m_thread_cv;
+    std::condition_variable m_dispatch_cv;
+};
+
+
+
+
+}
+#endif
@@ -0,0 +1,195 @@
+/*  Lock-Free Queues
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Fixed-capacity lock-free queues of pointers for the thread pools.
+ *
+ *  Both queues are bounded. A push that fails because the queue is full
+ *  returns false and it is up to the caller to handle it.
+ *
+ */
+
+#ifndef PokemonAutomation_LockFreeQueues_H
+#define PokemonAutomation_LockFreeQueues_H
+
+#include <stdint.h>
+#include <memory>
+#include <atomic>
+
+namespace PokemonAutomation{
+
+
+//
+//  Chase-Lev work-stealing deque.
+//
+//  Only the owning thread may call "push()" and "pop()". Any thread may call
+//  "steal()". The owner works off the bottom (LIFO). Thieves take from the
+//  top (FIFO).
+//
+//  "Dynamic Circular Work-Stealing Deque" (Chase, Lev 2005)
+//  "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013)
+//
+template <typename Type>
+class WorkStealingDeque{
+public:
+    WorkStealingDeque(size_t capacity_power_of_two)
+        : m_top(0)
+        , m_bottom(0)
+        , m_mask((int64_t)capacity_power_of_two - 1)
+        , m_buffer(new std::atomic<Type*>[capacity_power_of_two])
+    {}
+
+    bool empty() const{
+        int64_t b = m_bottom.load(std::memory_order_acquire);
+        int64_t t = m_top.load(std::memory_order_acquire);
+        return b <= t;
+    }
+
+    //  Owner only. Returns false if full.
+    bool push(Type* item){
+        int64_t b = m_bottom.load(std::memory_order_relaxed);
+        int64_t t = m_top.load(std::memory_order_acquire);
+        if (b - t > m_mask){
+            return false;
+        }
+        m_buffer[b & m_mask].store(item, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    //  Owner only. Returns null if empty.
+    Type* pop(){
+        int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+
+        if (t > b){
+            //  Empty.
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Type* item = m_buffer[b & m_mask].load(std::memory_order_acquire);
+        if (t == b){
+            //  Last item. Race against the thieves for it.
+            if (!m_top.compare_exchange_strong(
+                t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed
+            )){
+                item = nullptr;
+            }
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    //  Any thread. Returns null if empty or if it lost a race.
+    Type* steal(){
+        int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b){
+            return nullptr;
+        }
+        Type* item = m_buffer[t & m_mask].load(std::memory_order_acquire);
+        if (!m_top.compare_exchange_strong(
+            t, t + 1,
+            std::memory_order_seq_cst, std::memory_order_relaxed
+        )){
+            return nullptr;
+        }
+        return item;
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> m_top;
+    alignas(64) std::atomic<int64_t> m_bottom;
+    const int64_t m_mask;
+    std::unique_ptr<std::atomic<Type*>[]> m_buffer;
+};
+
+
+
+//
+//  Multi-producer, multi-consumer ring buffer.
+//
+//  "Bounded MPMC queue" (Dmitry Vyukov)
+//
+template <typename Type>
+class BoundedMPMCQueue{
+public:
+    BoundedMPMCQueue(size_t capacity_power_of_two)
+        : m_enqueue(0)
+        , m_dequeue(0)
+        , m_mask(capacity_power_of_two - 1)
+        , m_buffer(new Cell[capacity_power_of_two])
+    {
+        for (size_t c = 0; c < capacity_power_of_two; c++){
+            m_buffer[c].sequence.store(c, std::memory_order_relaxed);
+        }
+    }
+
+    bool empty() const{
+        return m_enqueue.load(std::memory_order_acquire) == m_dequeue.load(std::memory_order_acquire);
+    }
+
+    //  Returns false if full.
+    bool push(Type* item){
+        size_t pos = m_enqueue.load(std::memory_order_relaxed);
+        while (true){
+            Cell& cell = m_buffer[pos & m_mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0){
+                if (m_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                    cell.item = item;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }else if (diff < 0){
+                return false;
+            }else{
+                pos = m_enqueue.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //  Returns null if empty.
+    Type* pop(){
+        size_t pos = m_dequeue.load(std::memory_order_relaxed);
+        while (true){
+            Cell& cell = m_buffer[pos & m_mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0){
+                if (m_dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                    Type* item = cell.item;
+                    cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    return item;
+                }
+            }else if (diff < 0){
+                return nullptr;
+            }else{
+                pos = m_dequeue.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell{
+        std::atomic<size_t> sequence;
+        Type* item;
+    };
+
+    alignas(64) std::atomic<size_t> m_enqueue;
+    alignas(64) std::atomic<size_t> m_dequeue;
+    const size_t m_mask;
+    std::unique_ptr<Cell[]> m_buffer;
+};
+
+
+
+}
+#endif
@@ -4,6 +4,7 @@
  *
  */
 
+#include <algorithm>
 #include "PeriodicScheduler.h"
 
 #include <iostream>
@@ -104,8 +105,9 @@ private:
 
 
 
-PeriodicRunner::PeriodicRunner(AsyncDispatcher& dispatcher)
+PeriodicRunner::PeriodicRunner(AsyncDispatcher& dispatcher, bool batch_due_events)
     : m_dispatcher(dispatcher)
+    , m_batch_due_events(batch_due_events)
     , m_pending_waits(0)
 {}
 bool PeriodicRunner::add_event(void* event, std::chrono::milliseconds period, WallClock start){
@@ -144,6 +146,11 @@ bool PeriodicRunner::cancel(std::exception_ptr exception) noexcept{
     m_cv.notify_all();
     return false;
 }
+void PeriodicRunner::run_batch(void* const* events, size_t count, bool is_back_to_back) noexcept{
+    for (size_t c = 0; c < count; c++){
+        run(events[c], is_back_to_back || c != 0);
+    }
+}
 void PeriodicRunner::thread_loop(){
     bool is_back_to_back = false;
     std::unique_lock<std::mutex> lg(m_lock);
@@ -169,13 +176,34 @@ void PeriodicRunner::thread_loop(){
         idle_since_last_check = WallDuration(0);
 //        cout << m_utilization.utilization() << endl;
 
-        void* event = m_scheduler.request_next_event(now);
-
-        //  Event is available now. Run it.
-        if (event != nullptr){
-            run(event, is_back_to_back);
-            is_back_to_back = true;
-            continue;
+        if (m_batch_due_events){
+            //  Gather everything that is due now. An event with a period
+            //  shorter than the scheduling slop can be handed back again.
+            //  Stop when that happens since it's already in the batch.
+            m_batch.clear();
+            while (true){
+                void* event = m_scheduler.request_next_event(now);
+                if (event == nullptr ||
+                    std::find(m_batch.begin(), m_batch.end(), event) != m_batch.end()
+                ){
+                    break;
+                }
+                m_batch.emplace_back(event);
+            }
+            if (!m_batch.empty()){
+                run_batch(m_batch.data(), m_batch.size(), is_back_to_back);
+                is_back_to_back = true;
+                continue;
+            }
+        }else{
+            void* event = m_scheduler.request_next_event(now);
+
+            //  Event is available now. Run it.
+            if (event != nullptr){
+                run(event, is_back_to_back);
+                is_back_to_back = true;
+                continue;
+            }
         }
         is_back_to_back = false;
 
@@ -11,6 +11,7 @@
 
 #include <chrono>
 #include <map>
+#include <vector>
 #include <mutex>
 #include <condition_variable>
 #include "Common/Cpp/Time.h"
@@ -73,7 +74,10 @@ public:
     double current_utilization() const;
 
 protected:
-    PeriodicRunner(AsyncDispatcher& dispatcher);
+    //  If "batch_due_events" is true, all events that are due at the same time
+    //  are collected and handed to "run_batch()" together instead of being run
+    //  one at a time.
+    PeriodicRunner(AsyncDispatcher& dispatcher, bool batch_due_events = false);
     bool add_event(void* event, std::chrono::milliseconds period, WallClock start = current_time());
     void remove_event(void* event);
 
@@ -84,6 +88,10 @@ protected:
     //  is too slow to keep up.
     virtual void run(void* event, bool is_back_to_back) noexcept = 0;
 
+    //  Run all the events that are due now. Only called in batch mode.
+    //  The default implementation runs them one at a time.
+    virtual void run_batch(void* const* events, size_t count, bool is_back_to_back) noexcept;
+
 private:
     void thread_loop();
 protected:
@@ -91,6 +99,7 @@ protected:
 
 private:
     AsyncDispatcher& m_dispatcher;
+    const bool m_batch_due_events;
 
     std::atomic<size_t> m_pending_waits;
     std::mutex m_lock;
@@ -100,6 +109,7 @@ private:
     UtilizationTracker m_utilization;
 
     PeriodicScheduler m_scheduler;
+    std::vector<void*> m_batch;
 
     std::unique_ptr<AsyncTask> m_runner;
 };
@@ -52,6 +52,7 @@ public:
 
 private:
     friend class JsonValue;
+    friend class JsonParser;
     std::vector<JsonValue> m_data;
 };
 
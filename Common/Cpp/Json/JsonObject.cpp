@@ -4,6 +4,7 @@
  *
  */
 
+#include <algorithm>
 #include "JsonObject.h"
 #include "JsonTools.h"
 
@@ -13,9 +14,35 @@ namespace PokemonAutomation{
 
 //  RAII
 
+JsonObject::JsonObject(std::vector<Entry>&& members)
+    : m_data(std::move(members))
+{
+    //  Files written by "dump()" are already sorted.
+    auto less = [](const Entry& x, const Entry& y){
+        return x.first < y.first;
+    };
+    if (!std::is_sorted(m_data.begin(), m_data.end(), less)){
+        std::stable_sort(m_data.begin(), m_data.end(), less);
+    }
+
+    //  For duplicate keys, the last one wins. (same as nlohmann)
+    auto out = m_data.begin();
+    for (auto iter = m_data.begin(); iter != m_data.end(); ++iter){
+        if (out != m_data.begin() && out[-1].first == iter->first){
+            out[-1].second = std::move(iter->second);
+        }else{
+            if (out != iter){
+                *out = std::move(*iter);
+            }
+            ++out;
+        }
+    }
+    m_data.erase(out, m_data.end());
+}
 JsonObject::JsonObject(const JsonObject& x){
+    m_data.reserve(x.m_data.size());
     for (const auto& item : x.m_data){
-        m_data.emplace(item.first, item.second.clone());
+        m_data.emplace_back(item.first, item.second.clone());
     }
 }
 JsonObject& JsonObject::operator=(const JsonObject& x){
@@ -28,80 +55,117 @@ JsonObject JsonObject::clone() const{
 
 
 
+//  Lookup
+
+JsonObject::iterator JsonObject::lower_bound(const std::string& key){
+    return std::lower_bound(
+        m_data.begin(), m_data.end(), key,
+        [](const Entry& entry, const std::string& x){
+            return entry.first < x;
+        }
+    );
+}
+JsonObject::const_iterator JsonObject::find(const std::string& key) const{
+    return const_cast<JsonObject&>(*this).find(key);
+}
+JsonObject::iterator JsonObject::find(const std::string& key){
+    iterator iter = lower_bound(key);
+    if (iter == m_data.end() || iter->first != key){
+        return m_data.end();
+    }
+    return iter;
+}
+JsonValue& JsonObject::operator[](const std::string& key){
+    iterator iter = lower_bound(key);
+    if (iter == m_data.end() || iter->first != key){
+        iter = m_data.emplace(iter, key, JsonValue());
+    }
+    return iter->second;
+}
+JsonValue& JsonObject::operator[](std::string&& key){
+    iterator iter = lower_bound(key);
+    if (iter == m_data.end() || iter->first != key){
+        iter = m_data.emplace(iter, std::move(key), JsonValue());
+    }
+    return iter->second;
+}
+
+
+
 //  Get with exception.
 
 bool JsonObject::get_boolean_throw(const std::string& key, const std::string& filename) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         throw JsonParseException(filename, key);
     }
     return iter->second.to_boolean_throw(filename);
 }
 int64_t JsonObject::get_integer_throw(const std::string& key, const std::string& filename) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         throw JsonParseException(filename, key);
     }
     return iter->second.to_integer_throw(filename);
 }
 double JsonObject::get_double_throw(const std::string& key, const std::string& filename) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         throw JsonParseException(filename, key);
     }
     return iter->second.to_double_throw(filename);
 }
 const std::string& JsonObject::get_string_throw(const std::string& key, const std::string& filename) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         throw JsonParseException(filename, key);
     }
     return iter->second.to_string_throw(filename);
 }
 std::string& JsonObject::get_string_throw(const std::string& key, const std::string& filename){
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         throw JsonParseException(filename, key);
     }
     return iter->second.to_string_throw(filename);
 }
 const JsonArray& JsonObject::get_array_throw(const std::string& key, const std::string& filename) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         throw JsonParseException(filename, key);
     }
     return iter->second.to_array_throw(filename);
 }
 JsonArray& JsonObject::get_array_throw(const std::string& key, const std::string& filename){
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         throw JsonParseException(filename, key);
     }
     return iter->second.to_array_throw(filename);
 }
 const JsonObject& JsonObject::get_object_throw(const std::string& key, const std::string& filename) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         throw JsonParseException(filename, key);
     }
     return iter->second.to_object_throw(filename);
 }
 JsonObject& JsonObject::get_object_throw(const std::string& key, const std::string& filename){
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         throw JsonParseException(filename, key);
     }
     return iter->second.to_object_throw(filename);
 }
 const JsonValue& JsonObject::get_value_throw(const std::string& key, const std::string& filename) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         throw JsonParseException(filename, key);
     }
     return iter->second;
 }
 JsonValue& JsonObject::get_value_throw(const std::string& key, const std::string& filename){
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         throw JsonParseException(filename, key);
     }
@@ -113,56 +177,56 @@ JsonValue& JsonObject::get_value_throw(const std::string& key, const std::string
 //  Get pointer.
 
 const std::string* JsonObject::get_string(const std::string& key) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return nullptr;
     }
     return iter->second.to_string();
 }
 std::string* JsonObject::get_string(const std::string& key){
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return nullptr;
     }
     return iter->second.to_string();
 }
 const JsonArray* JsonObject::get_array(const std::string& key) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return nullptr;
     }
     return iter->second.to_array();
 }
 JsonArray* JsonObject::get_array(const std::string& key){
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return nullptr;
     }
     return iter->second.to_array();
 }
 const JsonObject* JsonObject::get_object(const std::string& key) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return nullptr;
     }
     return iter->second.to_object();
 }
 JsonObject* JsonObject::get_object(const std::string& key){
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return nullptr;
     }
     return iter->second.to_object();
 }
 const JsonValue* JsonObject::get_value(const std::string& key) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return nullptr;
     }
     return &iter->second;
 }
 JsonValue* JsonObject::get_value(const std::string& key){
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return nullptr;
     }
@@ -198,21 +262,21 @@ std::string JsonObject::to_string(const std::string& key, const char* default_va
 //  Conditional read.
 
 bool JsonObject::read_boolean(bool& value, const std::string& key) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return false;
     }
     return iter->second.read_boolean(value);
 }
 bool JsonObject::read_float(double& value, const std::string& key) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return false;
     }
     return iter->second.read_float(value);
 }
 bool JsonObject::read_string(std::string& value, const std::string& key) const{
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return false;
     }
@@ -7,16 +7,27 @@
 #ifndef PokemonAutomation_Common_Json_JsonObject_H
 #define PokemonAutomation_Common_Json_JsonObject_H
 
-#include <map>
+#include <vector>
 #include "JsonValue.h"
 
 namespace PokemonAutomation{
 
 
+//  The members are stored as a vector sorted by key. Lookups are a binary
+//  search and iterating visits the keys in order, the same as the std::map
+//  this used to be.
 class JsonObject{
+public:
+    using Entry = std::pair<std::string, JsonValue>;
+
 public:
     JsonObject() = default;
     JsonObject(JsonObject&& x) = default;
+
+    //  Take the members in any order. They are sorted once here instead of
+    //  being inserted one at a time. For duplicate keys, the last one wins.
+    explicit JsonObject(std::vector<Entry>&& members);
+
     JsonObject& operator=(JsonObject&& x) = default;
 
     bool operator==(const JsonObject& x){ // TODO: implement == properly. For JsonValue as well.
@@ -39,8 +50,13 @@ public:
     bool    empty   () const{ return m_data.empty(); }
     size_t  size    () const{ return m_data.size(); }
 
-    JsonValue& operator[](const std::string& key){ return m_data[key]; }
-    JsonValue& operator[](     std::string&& key){ return m_data[std::move(key)]; }
+    //  Returns the value at "key", inserting a null if it doesn't exist.
+    //  Inserting a new key is O(n) and moves the members after it. This
+    //  invalidates all references, pointers and iterators into this object.
+    //  Don't hold onto one value while adding another. To build a large
+    //  object, collect the members and use the vector constructor instead.
+    JsonValue& operator[](const std::string& key);
+    JsonValue& operator[](     std::string&& key);
 
     //  Get the value. Throws if the type doesn't match.
     bool                get_boolean_throw   (const std::string& key, const std::string& filename = std::string()) const;
@@ -91,11 +107,11 @@ public:
     ) const;
 
 public:
-    using const_iterator = std::map<std::string, JsonValue>::const_iterator;
-    using       iterator = std::map<std::string, JsonValue>::iterator;
+    using const_iterator = std::vector<Entry>::const_iterator;
+    using       iterator = std::vector<Entry>::iterator;
 
-    const_iterator find(const std::string& key) const{ return m_data.find(key); }
-          iterator find(const std::string& key)      { return m_data.find(key); }
+    const_iterator find(const std::string& key) const;
+          iterator find(const std::string& key);
 
     const_iterator cbegin   () const{ return m_data.cbegin(); }
     const_iterator begin    () const{ return m_data.begin(); }
@@ -105,9 +121,13 @@ public:
     const_iterator end  () const{ return m_data.end(); }
           iterator end  ()      { return m_data.end(); }
 
+private:
+    iterator lower_bound(const std::string& key);
+
 private:
     friend class JsonValue;
-    std::map<std::string, JsonValue> m_data;
+    friend class JsonParser;
+    std::vector<Entry> m_data;
 };
 
 
@@ -115,7 +135,7 @@ private:
 template <typename Type>
 bool JsonObject::read_integer(Type& value, const std::string& key, int64_t min, int64_t max) const{
     static_assert(std::is_integral<Type>::value);
-    auto iter = m_data.find(key);
+    auto iter = find(key);
     if (iter == m_data.end()){
         return false;
     }
@@ -0,0 +1,502 @@
+/*  JSON Parser
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Recursive descent. The elements of arrays and the members of objects are
+ *  collected on two stacks that are shared by the whole document. When a
+ *  container closes, its children are moved off the stack into a vector of
+ *  exactly the right size. So apart from the values themselves, parsing a
+ *  document only allocates to grow the stacks.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <locale.h>
+#include <cmath>
+#include <vector>
+#include <iterator>
+#include "JsonArray.h"
+#include "JsonObject.h"
+#include "JsonParser.h"
+
+namespace PokemonAutomation{
+
+
+
+class JsonParser{
+public:
+    JsonParser(const char* str, size_t size)
+        : m_ptr(str)
+        , m_end(str + size)
+    {}
+
+    bool parse_document(JsonValue& value);
+
+private:
+    //  Fail instead of overflowing the call stack.
+    static constexpr size_t MAX_DEPTH = 1024;
+
+    static bool is_digit(char ch){
+        return '0' <= ch && ch <= '9';
+    }
+
+    void skip_whitespace();
+    bool parse_value(JsonValue& value, size_t depth);
+    bool parse_literal(const char* literal, size_t length);
+    bool parse_number(JsonValue& value);
+    bool parse_string(std::string& str);
+    bool parse_escape(std::string& str);
+    bool parse_hex4(uint32_t& code);
+    bool parse_utf8(std::string& str);
+    bool parse_array(JsonValue& value, size_t depth);
+    bool parse_object(JsonValue& value, size_t depth);
+
+private:
+    const char* m_ptr;
+    const char* m_end;
+    std::vector<JsonValue> m_elements;
+    std::vector<JsonObject::Entry> m_members;
+    std::string m_number;
+};
+
+
+
+bool JsonParser::parse_document(JsonValue& value){
+    //  Skip the UTF-8 BOM that "string_to_file()" writes.
+    if (m_ptr < m_end && (uint8_t)m_ptr[0] == 0xef){
+        if (m_end - m_ptr < 3 || (uint8_t)m_ptr[1] != 0xbb || (uint8_t)m_ptr[2] != 0xbf){
+            return false;
+        }
+        m_ptr += 3;
+    }
+    skip_whitespace();
+    if (!parse_value(value, 0)){
+        return false;
+    }
+    skip_whitespace();
+
+    //  nlohmann treats a null character as the end of the input.
+    return m_ptr == m_end || *m_ptr == '\0';
+}
+void JsonParser::skip_whitespace(){
+    while (m_ptr < m_end){
+        switch (*m_ptr){
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            m_ptr++;
+            continue;
+        }
+        return;
+    }
+}
+bool JsonParser::parse_value(JsonValue& value, size_t depth){
+    if (m_ptr == m_end){
+        return false;
+    }
+    switch (*m_ptr){
+    case '{':
+        return parse_object(value, depth);
+    case '[':
+        return parse_array(value, depth);
+    case '"':{
+        std::string str;
+        if (!parse_string(str)){
+            return false;
+        }
+        value = JsonValue(std::move(str));
+        return true;
+    }
+    case 't':
+        if (!parse_literal("true", 4)){
+            return false;
+        }
+        value = JsonValue(true);
+        return true;
+    case 'f':
+        if (!parse_literal("false", 5)){
+            return false;
+        }
+        value = JsonValue(false);
+        return true;
+    case 'n':
+        if (!parse_literal("null", 4)){
+            return false;
+        }
+        value.clear();
+        return true;
+    default:
+        return parse_number(value);
+    }
+}
+bool JsonParser::parse_literal(const char* literal, size_t length){
+    if ((size_t)(m_end - m_ptr) < length || memcmp(m_ptr, literal, length) != 0){
+        return false;
+    }
+    m_ptr += length;
+    return true;
+}
+
+
+
+bool JsonParser::parse_number(JsonValue& value){
+    const char* start = m_ptr;
+    const char* ptr = m_ptr;
+
+    bool negative = ptr < m_end && *ptr == '-';
+    ptr += negative;
+    if (ptr == m_end){
+        return false;
+    }
+    if (*ptr == '0'){
+        ptr++;
+    }else if (is_digit(*ptr)){
+        do{
+            ptr++;
+        }while (ptr < m_end && is_digit(*ptr));
+    }else{
+        return false;
+    }
+    const char* integer_end = ptr;
+
+    if (ptr < m_end && *ptr == '.'){
+        ptr++;
+        if (ptr == m_end || !is_digit(*ptr)){
+            return false;
+        }
+        do{
+            ptr++;
+        }while (ptr < m_end && is_digit(*ptr));
+    }
+    if (ptr < m_end && (*ptr == 'e' || *ptr == 'E')){
+        ptr++;
+        if (ptr < m_end && (*ptr == '+' || *ptr == '-')){
+            ptr++;
+        }
+        if (ptr == m_end || !is_digit(*ptr)){
+            return false;
+        }
+        do{
+            ptr++;
+        }while (ptr < m_end && is_digit(*ptr));
+    }
+    m_ptr = ptr;
+
+    //  Integers that don't fit into 64 bits become floats. Positive integers
+    //  past INT64_MAX wrap around. Both are the same as with nlohmann.
+    if (integer_end == ptr){
+        uint64_t x = 0;
+        bool overflow = false;
+        for (const char* digit = start + negative; digit < integer_end; digit++){
+            uint64_t d = *digit - '0';
+            if (x > (UINT64_MAX - d) / 10){
+                overflow = true;
+                break;
+            }
+            x = x * 10 + d;
+        }
+        if (!overflow && !negative){
+            value = JsonValue((int64_t)x);
+            return true;
+        }
+        if (!overflow && x <= (uint64_t)INT64_MAX + 1){
+            value = JsonValue((int64_t)(0 - x));
+            return true;
+        }
+    }
+
+    //  strtod() follows the C locale, which Qt sets from the environment.
+    m_number.assign(start, ptr);
+    char decimal_point = localeconv()->decimal_point[0];
+    if (decimal_point != '.'){
+        std::replace(m_number.begin(), m_number.end(), '.', decimal_point);
+    }
+    double x = strtod(m_number.c_str(), nullptr);
+    if (!std::isfinite(x)){
+        return false;
+    }
+    value = JsonValue(x);
+    return true;
+}
+
+
+
+bool JsonParser::parse_string(std::string& str){
+    m_ptr++;    //  Opening quote.
+    while (true){
+        //  Copy runs of plain ASCII in one go.
+        const char* start = m_ptr;
+        while (m_ptr < m_end){
+            uint8_t ch = *m_ptr;
+            if (ch == '"' || ch == '\\' || ch < 0x20 || ch >= 0x80){
+                break;
+            }
+            m_ptr++;
+        }
+        str.append(start, m_ptr);
+
+        if (m_ptr == m_end){
+            return false;
+        }
+        uint8_t ch = *m_ptr;
+        if (ch == '"'){
+            m_ptr++;
+            return true;
+        }
+        if (ch == '\\'){
+            if (!parse_escape(str)){
+                return false;
+            }
+            continue;
+        }
+        if (ch < 0x20){
+            return false;
+        }
+        if (!parse_utf8(str)){
+            return false;
+        }
+    }
+}
+bool JsonParser::parse_escape(std::string& str){
+    m_ptr++;    //  Backslash
+    if (m_ptr == m_end){
+        return false;
+    }
+    switch (*m_ptr++){
+    case '"':   str += '"';     return true;
+    case '\\':  str += '\\';    return true;
+    case '/':   str += '/';     return true;
+    case 'b':   str += '\b';    return true;
+    case 'f':   str += '\f';    return true;
+    case 'n':   str += '\n';    return true;
+    case 'r':   str += '\r';    return true;
+    case 't':   str += '\t';    return true;
+    case 'u':   break;
+    default:    return false;
+    }
+
+    uint32_t code;
+    if (!parse_hex4(code)){
+        return false;
+    }
+    if (0xdc00 <= code && code <= 0xdfff){
+        return false;
+    }
+    if (0xd800 <= code && code <= 0xdbff){
+        //  Must be followed by the low surrogate.
+        if (m_end - m_ptr < 2 || m_ptr[0] != '\\' || m_ptr[1] != 'u'){
+            return false;
+        }
+        m_ptr += 2;
+        uint32_t low;
+        if (!parse_hex4(low) || low < 0xdc00 || low > 0xdfff){
+            return false;
+        }
+        code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+    }
+
+    if (code < 0x80){
+        str += (char)code;
+    }else if (code < 0x800){
+        str += (char)(0xc0 | (code >> 6));
+        str += (char)(0x80 | (code & 0x3f));
+    }else if (code < 0x10000){
+        str += (char)(0xe0 | (code >> 12));
+        str += (char)(0x80 | ((code >> 6) & 0x3f));
+        str += (char)(0x80 | (code & 0x3f));
+    }else{
+        str += (char)(0xf0 | (code >> 18));
+        str += (char)(0x80 | ((code >> 12) & 0x3f));
+        str += (char)(0x80 | ((code >> 6) & 0x3f));
+        str += (char)(0x80 | (code & 0x3f));
+    }
+    return true;
+}
+bool JsonParser::parse_hex4(uint32_t& code){
+    if (m_end - m_ptr < 4){
+        return false;
+    }
+    code = 0;
+    for (size_t c = 0; c < 4; c++){
+        char ch = *m_ptr++;
+        code <<= 4;
+        if ('0' <= ch && ch <= '9'){
+            code |= ch - '0';
+        }else if ('a' <= ch && ch <= 'f'){
+            code |= ch - 'a' + 10;
+        }else if ('A' <= ch && ch <= 'F'){
+            code |= ch - 'A' + 10;
+        }else{
+            return false;
+        }
+    }
+    return true;
+}
+bool JsonParser::parse_utf8(std::string& str){
+    //  Validate one multi-byte character. (RFC 3629)
+    const uint8_t* ptr = (const uint8_t*)m_ptr;
+    uint8_t lead = ptr[0];
+    size_t length;
+    uint8_t lo = 0x80;
+    uint8_t hi = 0xbf;
+    if (0xc2 <= lead && lead <= 0xdf){
+        length = 2;
+    }else if (lead == 0xe0){
+        length = 3;
+        lo = 0xa0;
+    }else if ((0xe1 <= lead && lead <= 0xec) || lead == 0xee || lead == 0xef){
+        length = 3;
+    }else if (lead == 0xed){
+        length = 3;
+        hi = 0x9f;
+    }else if (lead == 0xf0){
+        length = 4;
+        lo = 0x90;
+    }else if (0xf1 <= lead && lead <= 0xf3){
+        length = 4;
+    }else if (lead == 0xf4){
+        length = 4;
+        hi = 0x8f;
+    }else{
+        return false;
+    }
+    if ((size_t)(m_end - m_ptr) < length){
+        return false;
+    }
+    if (ptr[1] < lo || ptr[1] > hi){
+        return false;
+    }
+    for (size_t c = 2; c < length; c++){
+        if ((ptr[c] & 0xc0) != 0x80){
+            return false;
+        }
+    }
+    str.append(m_ptr, length);
+    m_ptr += length;
+    return true;
+}
+
+
+
+bool JsonParser::parse_array(JsonValue& value, size_t depth){
+    if (++depth > MAX_DEPTH){
+        return false;
+    }
+    m_ptr++;    //  Opening bracket.
+
+    size_t start = m_elements.size();
+    skip_whitespace();
+    if (m_ptr < m_end && *m_ptr == ']'){
+        m_ptr++;
+        value = JsonValue(JsonArray());
+        return true;
+    }
+    while (true){
+        skip_whitespace();
+        //  Parse into a local first. The nested call can reallocate the stack.
+        JsonValue element;
+        if (!parse_value(element, depth)){
+            return false;
+        }
+        m_elements.emplace_back(std::move(element));
+
+        skip_whitespace();
+        if (m_ptr == m_end){
+            return false;
+        }
+        char ch = *m_ptr++;
+        if (ch == ']'){
+            break;
+        }
+        if (ch != ','){
+            return false;
+        }
+    }
+
+    auto begin = m_elements.begin() + start;
+    JsonArray array;
+    array.m_data.reserve(m_elements.end() - begin);
+    for (auto iter = begin; iter != m_elements.end(); ++iter){
+        array.m_data.emplace_back(std::move(*iter));
+    }
+    m_elements.erase(begin, m_elements.end());
+
+    value = JsonValue(std::move(array));
+    return true;
+}
+bool JsonParser::parse_object(JsonValue& value, size_t depth){
+    if (++depth > MAX_DEPTH){
+        return false;
+    }
+    m_ptr++;    //  Opening brace.
+
+    size_t start = m_members.size();
+    skip_whitespace();
+    if (m_ptr < m_end && *m_ptr == '}'){
+        m_ptr++;
+        value = JsonValue(JsonObject());
+        return true;
+    }
+    while (true){
+        skip_whitespace();
+        if (m_ptr == m_end || *m_ptr != '"'){
+            return false;
+        }
+        std::string key;
+        if (!parse_string(key)){
+            return false;
+        }
+        skip_whitespace();
+        if (m_ptr == m_end || *m_ptr != ':'){
+            return false;
+        }
+        m_ptr++;
+        skip_whitespace();
+        JsonValue member;
+        if (!parse_value(member, depth)){
+            return false;
+        }
+        m_members.emplace_back(std::move(key), std::move(member));
+
+        skip_whitespace();
+        if (m_ptr == m_end){
+            return false;
+        }
+        char ch = *m_ptr++;
+        if (ch == '}'){
+            break;
+        }
+        if (ch != ','){
+            return false;
+        }
+    }
+
+    //  Append the members as they come and sort them once at the end.
+    auto begin = m_members.begin() + start;
+    std::vector<JsonObject::Entry> members(
+        std::make_move_iterator(begin),
+        std::make_move_iterator(m_members.end())
+    );
+    m_members.erase(begin, m_members.end());
+
+    value = JsonValue(JsonObject(std::move(members)));
+    return true;
+}
+
+
+
+JsonValue parse_json(const char* str, size_t size){
+    JsonValue value;
+    JsonParser parser(str, size);
+    if (!parser.parse_document(value)){
+        return JsonValue();
+    }
+    return value;
+}
+
+
+
+}
@@ -0,0 +1,27 @@
+/*  JSON Parser
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Parse JSON text directly into a JsonValue in a single pass.
+ *
+ *  This accepts the same documents as "nlohmann::json::parse()" and builds
+ *  the same values that "from_nlohmann()" would. (including a leading UTF-8
+ *  BOM, strict UTF-8 validation and no comments)
+ *
+ */
+
+#ifndef PokemonAutomation_Common_Json_JsonParser_H
+#define PokemonAutomation_Common_Json_JsonParser_H
+
+#include <stddef.h>
+#include "JsonValue.h"
+
+namespace PokemonAutomation{
+
+
+//  Returns an empty JsonValue if the text is not valid JSON.
+JsonValue parse_json(const char* str, size_t size);
+
+
+}
+#endif
@@ -86,11 +86,12 @@ JsonValue from_nlohmann(const nlohmann::json& json){
         return array;
     }
     if (json.is_object()){
-        JsonObject object;
+        std::vector<JsonObject::Entry> members;
+        members.reserve(json.size());
         for (auto it = json.begin(); it != json.end(); ++it){
-            object[it.key()] = from_nlohmann(it.value());
+            members.emplace_back(it.key(), from_nlohmann(it.value()));
         }
-        return object;
+        return JsonObject(std::move(members));
     }
     return JsonValue();
 }
@@ -165,11 +166,12 @@ JsonValue from_QJson(const QJsonValue& json){
     }
     if (json.isObject()){
         QJsonObject obj = json.toObject();
-        JsonObject object;
+        std::vector<JsonObject::Entry> members;
+        members.reserve(obj.size());
         for (auto it = obj.begin(); it != obj.end(); ++it){
-            object[it.key().toStdString()] = from_QJson(it.value());
+            members.emplace_back(it.key().toStdString(), from_QJson(it.value()));
         }
-        return object;
+        return JsonObject(std::move(members));
     }
     return JsonValue();
 }
@@ -9,6 +9,7 @@
 #include "JsonArray.h"
 #include "JsonObject.h"
 #include "JsonTools.h"
+#include "JsonParser.h"
 
 //#include <iostream>
 //using std::cout;
@@ -89,13 +90,13 @@ JsonParseException::JsonParseException(
 JsonValue::~JsonValue(){
     clear();
 }
-JsonValue::JsonValue(JsonValue&& x)
+JsonValue::JsonValue(JsonValue&& x) noexcept
     : m_type(x.m_type)
     , u(x.u)
 {
     x.m_type = JsonType::EMPTY;
 }
-void JsonValue::operator=(JsonValue&& x){
+void JsonValue::operator=(JsonValue&& x) noexcept{
     if (this == &x){
         return;
     }
@@ -367,7 +368,7 @@ bool JsonValue::read_string(std::string& value) const{
 
 
 JsonValue parse_json(const std::string& str){
-    return from_nlohmann(nlohmann::json::parse(str, nullptr, false));
+    return parse_json(str.data(), str.size());
 }
 JsonValue load_json_file(const std::string& filename){
     std::string str = file_to_string(filename);
@@ -63,8 +63,8 @@ class JsonObject;
 class JsonValue{
 public:
     ~JsonValue();
-    JsonValue(JsonValue&& x);
-    void operator=(JsonValue&& x);
+    JsonValue(JsonValue&& x) noexcept;
+    void operator=(JsonValue&& x) noexcept;
 private:
     //  Private to avoid accidental copying.
     JsonValue(const JsonValue& x);
@@ -4,6 +4,7 @@
  * 
  */
 
+#include <mutex>
 #include "Common/Cpp/Exceptions.h"
 #include "PrettyPrint.h"
 #include "PanicDump.h"
@@ -12,7 +13,31 @@ namespace PokemonAutomation{
 
 
 
+namespace{
+std::mutex panic_dump_hook_lock;
+std::function<void()> panic_dump_hook;
+}
+
+void set_panic_dump_hook(std::function<void()> hook){
+    std::lock_guard<std::mutex> lg(panic_dump_hook_lock);
+    panic_dump_hook = std::move(hook);
+}
+
+
 void panic_dump(const char* location, const char* message){
+    {
+        std::function<void()> hook;
+        {
+            std::lock_guard<std::mutex> lg(panic_dump_hook_lock);
+            hook = panic_dump_hook;
+        }
+        if (hook){
+            try{
+                hook();
+            }catch (...){}
+        }
+    }
+
     std::string body;
     body += "\xef\xbb\xbf"; //  UTF-8 BOM
 //    body += "Panic Dump:\r\n";
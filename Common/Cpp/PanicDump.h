@@ -12,6 +12,11 @@
 namespace PokemonAutomation{
 
 
+//  Run "hook" at the start of every panic dump. Use this to get anything that
+//  is buffered (like logs) onto disk before the program goes down.
+//  Pass an empty function to remove it.
+void set_panic_dump_hook(std::function<void()> hook);
+
 void panic_dump(const char* location, const char* message);
 
 void run_with_catch(const char* location, std::function<void()>&& lambda);
@@ -14,13 +14,15 @@ namespace PokemonAutomation{
 
 
 
-std::string current_time_to_str(){
+namespace{
+
+std::string time_to_str(WallClock time, bool utc){
     //  Based off of: https://stackoverflow.com/questions/15957805/extract-year-month-day-etc-from-stdchronotime-point-in-c
 
     using namespace std;
     using namespace std::chrono;
     typedef duration<int, ratio_multiply<hours::period, ratio<24> >::type> days;
-    system_clock::time_point now = system_clock::now();
+    system_clock::time_point now = time;
     system_clock::duration tp = now.time_since_epoch();
     days d = duration_cast<days>(tp);
     tp -= d;
@@ -32,8 +34,7 @@ std::string current_time_to_str(){
     tp -= s;
     auto micros = 1000000 * tp.count() * system_clock::duration::period::num / system_clock::duration::period::den;
     time_t tt = system_clock::to_time_t(now);
-//    tm utc_tm = *gmtime(&tt);
-    tm local_tm = *localtime(&tt);
+    tm local_tm = utc ? *gmtime(&tt) : *localtime(&tt);
 
     std::ostringstream ss;
     ss << local_tm.tm_year + 1900 << '-';
@@ -47,6 +48,31 @@ std::string current_time_to_str(){
     return ss.str();
 }
 
+}
+
+
+std::string current_time_to_str(){
+    return time_to_str(current_time());
+}
+std::string time_to_str(WallClock time){
+    return time_to_str(time, false);
+}
+std::string time_to_str_utc(WallClock time){
+    return time_to_str(time, true);
+}
+int32_t local_utc_offset(WallClock time){
+    time_t tt = std::chrono::system_clock::to_time_t(time);
+    tm local_tm = *localtime(&tt);
+    tm utc_tm = *gmtime(&tt);
+
+    //  The two are at most a day apart.
+    int32_t days = local_tm.tm_year != utc_tm.tm_year
+        ? (local_tm.tm_year > utc_tm.tm_year ? 1 : -1)
+        : local_tm.tm_yday - utc_tm.tm_yday;
+    return ((days * 24 + local_tm.tm_hour - utc_tm.tm_hour) * 60 + local_tm.tm_min - utc_tm.tm_min) * 60
+        + local_tm.tm_sec - utc_tm.tm_sec;
+}
+
 
 
 uint16_t current_year(){
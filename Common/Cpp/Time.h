@@ -7,6 +7,8 @@
 #ifndef PokemonAutomation_Time_H
 #define PokemonAutomation_Time_H
 
+#include <stdint.h>
+#include <string>
 #include <chrono>
 
 namespace PokemonAutomation{
@@ -23,6 +25,15 @@ inline WallClock current_time(){
 }
 std::string current_time_to_str();
 
+//  Same format as "current_time_to_str()" in local time.
+std::string time_to_str(WallClock time);
+
+//  Same format as "current_time_to_str()" in UTC.
+std::string time_to_str_utc(WallClock time);
+
+//  # of seconds that local time is ahead of UTC at "time".
+int32_t local_utc_offset(WallClock time);
+
 
 uint16_t current_year();
 
@@ -78,6 +78,22 @@ typedef struct{
 } PABB_PACK pabb_Message_Command_NS1_WirelessController_FullState;
 
 
+//  Up to this many button states back-to-back in one command. Only the first
+//  "count" states are sent. Only supported by devices that opt into it. (see
+//  "COMMAND_BATCH_DEVICES()")
+#define PABB_MSG_COMMAND_NS1_WIRELESS_CONTROLLER_BUTTONS_BATCH  0xa2
+#define PABB_NS1_WIRELESS_CONTROLLER_BUTTONS_BATCH_SIZE         4
+typedef struct{
+    uint16_t milliseconds;
+    pabb_NintendoSwitch_WirelessController_State0x30_Buttons report;
+} PABB_PACK pabb_NS1_WirelessController_TimedButtons;
+typedef struct{
+    seqnum_t seqnum;
+    uint8_t count;
+    pabb_NS1_WirelessController_TimedButtons states[PABB_NS1_WIRELESS_CONTROLLER_BUTTONS_BATCH_SIZE];
+} PABB_PACK pabb_Message_Command_NS1_WirelessController_ButtonsBatch;
+
+
 
 
 #ifdef __cplusplus
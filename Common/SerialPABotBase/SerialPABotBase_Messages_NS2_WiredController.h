@@ -33,6 +33,21 @@ typedef struct{
     pabb_NintendoSwitch2_WiredController_State report;
 } PABB_PACK pabb_Message_Command_NS2_WiredController_State;
 
+//  Up to this many states back-to-back in one command. Only the first "count"
+//  states are sent. Only supported by devices that opt into it. (see
+//  "COMMAND_BATCH_DEVICES()")
+#define PABB_MSG_COMMAND_NS2_WIRED_CONTROLLER_STATE_BATCH   0x91
+#define PABB_NS2_WIRED_CONTROLLER_STATE_BATCH_SIZE          5
+typedef struct{
+    uint16_t milliseconds;
+    pabb_NintendoSwitch2_WiredController_State report;
+} PABB_PACK pabb_NS2_WiredController_TimedState;
+typedef struct{
+    seqnum_t seqnum;
+    uint8_t count;
+    pabb_NS2_WiredController_TimedState states[PABB_NS2_WIRED_CONTROLLER_STATE_BATCH_SIZE];
+} PABB_PACK pabb_Message_Command_NS2_WiredController_StateBatch;
+
 
 
 #ifdef __cplusplus
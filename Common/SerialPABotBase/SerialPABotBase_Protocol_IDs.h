@@ -41,6 +41,9 @@ typedef uint8_t pabb_ProgramID;
 #define PABB_PID_PABOTBASE_Pico2W_USB                       0x22
 #define PABB_PID_PABOTBASE_Pico2W_UART                      0x23
 
+//  In-process emulator. (not a real device)
+#define PABB_PID_PABOTBASE_Emulator                         0x7f
+
 
 //
 //  Controller IDs
@@ -14,6 +14,8 @@
 
 namespace PokemonAutomation{
 
+class SpectrumPreprocessor;
+
 //  The result of one FFT computation, an array of the magnitudes of different
 //  frequencies.
 //  Each spectrum is computed using a sliding window on the incoming audio stream.
@@ -54,6 +56,10 @@ public:
 
     //  Add visual overlay to the spectrums starting at `starting_stamp` and before `end_stamp` with `color`.
     virtual void add_overlay(uint64_t starting_seqnum, size_t end_seqnum, Color color) = 0;
+
+    //  Filtering of the spectrums that is shared by all the spectrogram
+    //  matchers listening to this feed.
+    virtual SpectrumPreprocessor& spectrum_preprocessor() = 0;
 };
 
 
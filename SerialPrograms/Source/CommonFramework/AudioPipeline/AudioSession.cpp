@@ -138,6 +138,7 @@ void AudioSession::clear_audio_input(){
     //  When this happens, we will be left with a non-empty history which will
     //  be displayed as a non-moving freq-bars or spectrum instead of black.
     m_spectrum_holder.clear();
+    m_spectrum_preprocessor.clear();
 }
 void AudioSession::set_audio_input(std::string file){
     std::lock_guard<std::mutex> lg(m_lock);
@@ -275,6 +276,7 @@ void AudioSession::reset(){
         );
     }
     signal_post_input_change();
+    m_spectrum_preprocessor.clear();
 }
 std::vector<AudioSpectrum> AudioSession::spectrums_since(uint64_t starting_seqnum){
     return m_spectrum_holder.spectrums_since(starting_seqnum);
@@ -22,6 +22,7 @@
 #include "AudioPassthroughPair.h"
 #include "Spectrum/FFTStreamer.h"
 #include "Spectrum/AudioSpectrumHolder.h"
+#include "Spectrum/SpectrumPreprocessor.h"
 #include "AudioOption.h"
 
 namespace PokemonAutomation{
@@ -80,6 +81,7 @@ public:
     virtual std::vector<AudioSpectrum> spectrums_since(uint64_t starting_seqnum) override;
     virtual std::vector<AudioSpectrum> spectrums_latest(size_t num_last_spectrums) override;
     virtual void add_overlay(uint64_t starting_seqnum, size_t end_seqnum, Color color) override;
+    virtual SpectrumPreprocessor& spectrum_preprocessor() override{ return m_spectrum_preprocessor; }
 
 
 private:
@@ -97,6 +99,7 @@ private:
     Logger& m_logger;
     AudioOption& m_option;
     AudioSpectrumHolder m_spectrum_holder;
+    SpectrumPreprocessor m_spectrum_preprocessor;
     std::unique_ptr<AudioPassthroughPair> m_devices;
 
     mutable std::mutex m_lock;
@@ -4,7 +4,10 @@
  *
  */
 
+#include <string.h>
 #include <sstream>
+#include <algorithm>
+#include <QFile>
 #include "Common/Cpp/Containers/AlignedVector.tpp"
 #include "CommonFramework/Logging/Logger.h"
 #include "Kernels/Kernels_Alignment.h"
@@ -96,6 +99,132 @@ AudioTemplate loadAudioTemplate(const std::string& filename, size_t sample_rate)
 
 
 
+namespace{
+
+//  Bump this whenever the layout of the file or the way templates are built
+//  changes. Old cache files are then rebuilt.
+const uint32_t AUDIO_TEMPLATE_BINARY_VERSION = 1;
+
+struct AudioTemplateBinaryHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t header_bytes;
+    uint64_t sample_rate;
+    uint64_t fft_length;
+    uint64_t fft_step;
+    uint64_t frequencies;
+    uint64_t windows;
+    uint64_t bytes_per_spectrum;
+    char source_hash[64];
+};
+static_assert(sizeof(AudioTemplateBinaryHeader) == 128, "Header must keep the spectrogram aligned.");
+
+const char AUDIO_TEMPLATE_BINARY_MAGIC[8] = {'P', 'A', 'A', 'u', 'd', 'T', 'p', 'l'};
+
+void fill_hash(char dst[64], const std::string& source_hash){
+    memset(dst, 0, 64);
+    memcpy(dst, source_hash.data(), std::min<size_t>(source_hash.size(), 64));
+}
+
+}
+
+
+bool saveAudioTemplateBinary(
+    const std::string& filename,
+    const AudioTemplate& audio_template,
+    const std::string& source_hash,
+    size_t sample_rate
+){
+    const size_t frequencies = audio_template.numFrequencies();
+    const size_t windows = audio_template.numWindows();
+    const size_t bytes_per_spectrum = Kernels::align_int_up<PA_ALIGNMENT>(frequencies * sizeof(float));
+
+    AudioTemplateBinaryHeader header;
+    memcpy(header.magic, AUDIO_TEMPLATE_BINARY_MAGIC, sizeof(header.magic));
+    header.version = AUDIO_TEMPLATE_BINARY_VERSION;
+    header.header_bytes = sizeof(AudioTemplateBinaryHeader);
+    header.sample_rate = sample_rate;
+    header.fft_length = NUM_FFT_SAMPLES;
+    header.fft_step = FFT_SLIDING_WINDOW_STEP;
+    header.frequencies = frequencies;
+    header.windows = windows;
+    header.bytes_per_spectrum = bytes_per_spectrum;
+    fill_hash(header.source_hash, source_hash);
+
+    //  Write to a temporary file first so that a crash or a concurrent reader
+    //  never sees a partially written cache file.
+    const QString final_path = QString::fromStdString(filename);
+    const QString temp_path = final_path + ".tmp";
+    {
+        QFile file(temp_path);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)){
+            return false;
+        }
+        const qint64 data_bytes = (qint64)(windows * bytes_per_spectrum);
+        if (file.write((const char*)&header, sizeof(header)) != (qint64)sizeof(header) ||
+            (data_bytes != 0 && file.write((const char*)audio_template.getWindow(0), data_bytes) != data_bytes)
+        ){
+            file.close();
+            QFile::remove(temp_path);
+            return false;
+        }
+    }
+    QFile::remove(final_path);
+    if (!QFile::rename(temp_path, final_path)){
+        QFile::remove(temp_path);
+        return false;
+    }
+    return true;
+}
+
+AudioTemplate loadAudioTemplateBinary(
+    const std::string& filename,
+    const std::string& source_hash,
+    size_t sample_rate
+){
+    QFile file(QString::fromStdString(filename));
+    if (!file.open(QIODevice::ReadOnly)){
+        return AudioTemplate();
+    }
+
+    AudioTemplateBinaryHeader header;
+    if (file.read((char*)&header, sizeof(header)) != (qint64)sizeof(header)){
+        return AudioTemplate();
+    }
+
+    char expected_hash[64];
+    fill_hash(expected_hash, source_hash);
+
+    const size_t frequencies = (size_t)header.frequencies;
+    const size_t windows = (size_t)header.windows;
+    const size_t bytes_per_spectrum = Kernels::align_int_up<PA_ALIGNMENT>(frequencies * sizeof(float));
+    if (memcmp(header.magic, AUDIO_TEMPLATE_BINARY_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != AUDIO_TEMPLATE_BINARY_VERSION ||
+        header.header_bytes != sizeof(AudioTemplateBinaryHeader) ||
+        header.sample_rate != sample_rate ||
+        header.fft_length != NUM_FFT_SAMPLES ||
+        header.fft_step != FFT_SLIDING_WINDOW_STEP ||
+        frequencies == 0 || windows == 0 ||
+        header.bytes_per_spectrum != bytes_per_spectrum ||
+        memcmp(header.source_hash, expected_hash, sizeof(expected_hash)) != 0
+    ){
+        return AudioTemplate();
+    }
+
+    const qint64 data_bytes = (qint64)(windows * bytes_per_spectrum);
+    if (file.size() != (qint64)sizeof(header) + data_bytes){
+        return AudioTemplate();
+    }
+
+    AudioTemplate audio_template(frequencies, windows);
+    if (file.read((char*)audio_template.getWindow(0), data_bytes) != data_bytes){
+        return AudioTemplate();
+    }
+    return audio_template;
+}
+
+
+
 
 
 
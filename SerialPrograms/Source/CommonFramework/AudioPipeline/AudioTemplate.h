@@ -56,6 +56,27 @@ private:
 // Loading .mp3 format however is dependent on Qt's platform-dependent backend.
 AudioTemplate loadAudioTemplate(const std::string& filename, size_t sample_rate = 48000);
 
+// Save a built template to a binary file that can be loaded back without any
+// decoding or FFT. "source_hash" identifies the contents of the audio file the
+// template was built from.
+// The spectrogram is stored after a fixed-size header in exactly the in-memory
+// layout of AudioTemplate so it can be read (or mapped) in one shot.
+// Return false if the file cannot be written.
+bool saveAudioTemplateBinary(
+    const std::string& filename,
+    const AudioTemplate& audio_template,
+    const std::string& source_hash,
+    size_t sample_rate
+);
+// Load a template saved by saveAudioTemplateBinary().
+// Return an empty template (numFrequencies() == 0) if the file doesn't exist,
+// is corrupt, or was built from a different source, sample rate or FFT setting.
+AudioTemplate loadAudioTemplateBinary(
+    const std::string& filename,
+    const std::string& source_hash,
+    size_t sample_rate
+);
+
 
 
 
@@ -4,6 +4,7 @@
  *
  */
 
+#include <atomic>
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/Containers/AlignedVector.tpp"
 #include "Kernels/AbsFFT/Kernels_AbsFFT.h"
@@ -52,7 +53,7 @@ AudioFloatToFFT::AudioFloatToFFT(
     , m_fft_sample_size(average_pairs ? 2 : 1)
     , m_buffer(NUM_FFT_SAMPLES)
     , m_buffered(NUM_FFT_SAMPLES)
-    , m_fft_input(NUM_FFT_SAMPLES)
+    , m_fft_work(NUM_FFT_SAMPLES)
 {
     if (samples_per_frame == 0 || samples_per_frame > 2){
         throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Channels must be 1 or 2.");
@@ -100,26 +101,41 @@ void AudioFloatToFFT::convert(float* fft_input, const float* audio_stream, size_
     }
 }
 void AudioFloatToFFT::run_fft(){
-    float* ptr = m_fft_input.data();
-    size_t remaining = NUM_FFT_SAMPLES;
-    size_t index = m_start;
-    while (remaining > 0){
-        size_t block = std::min(remaining, m_buffer.size() - index);
-        memcpy(ptr, &m_buffer[index], block * sizeof(float));
-        ptr += block;
-        remaining -= block;
-        index += block;
-        if (index == m_buffer.size()){
-            index = 0;
-        }
-    }
-    std::shared_ptr<AlignedVector<float>> out = std::make_unique<AlignedVector<float>>(NUM_FFT_SAMPLES / 2);
-    Kernels::AbsFFT::fft_abs(FFT_LENGTH_POWER_OF_TWO, out->data(), m_fft_input.data());
+    //  The buffer is exactly one FFT long and the window always slides by a
+    //  quarter of it. So the FFT can read the window straight out of the
+    //  circular buffer.
+    std::shared_ptr<AlignedVector<float>> out = get_output_buffer();
+    Kernels::AbsFFT::fft_abs_circular(
+        FFT_LENGTH_POWER_OF_TWO, out->data(),
+        m_buffer.data(), m_start,
+        m_fft_work.data()
+    );
     m_listeners.run_method_unique(
         &FFTListener::on_fft,
-        m_sample_rate, out
+        m_sample_rate, std::move(out)
     );
 }
+std::shared_ptr<AlignedVector<float>> AudioFloatToFFT::get_output_buffer(){
+    //  The listeners release the buffers roughly in the order they got them.
+    //  So if the oldest one is still in use, they all are.
+    if (!m_output_pool.empty()){
+        std::shared_ptr<AlignedVector<float>>& oldest = m_output_pool[m_output_pool_next];
+        if (oldest.use_count() == 1){
+            //  Make sure the listeners are done reading it before we write.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            m_output_pool_next = (m_output_pool_next + 1) % m_output_pool.size();
+            return oldest;
+        }
+    }
+
+    std::shared_ptr<AlignedVector<float>> buffer = std::make_shared<AlignedVector<float>>(NUM_FFT_SAMPLES / 2);
+    if (m_output_pool.size() < MAX_POOLED_OUTPUTS){
+        //  Insert as the newest, right before the oldest.
+        m_output_pool.insert(m_output_pool.begin() + m_output_pool_next, buffer);
+        m_output_pool_next = (m_output_pool_next + 1) % m_output_pool.size();
+    }
+    return buffer;
+}
 void AudioFloatToFFT::drop_from_front(size_t frames){
     if (frames >= m_buffered){
         m_buffered = 0;
@@ -8,6 +8,7 @@
 #define PokemonAutomation_AudioPipeline_FFTStreamer_H
 
 #include <memory>
+#include <vector>
 #include "Common/Cpp/ListenerSet.h"
 #include "CommonFramework/AudioPipeline/AudioStream.h"
 
@@ -23,6 +24,10 @@ struct FFTListener{
 
 //  Listen to an audio stream and compute FFTs on it.
 class AudioFloatToFFT : public AudioFloatStreamListener{
+    //  Max # of output buffers to keep around for reuse. This needs to cover
+    //  how long the listeners hold on to them. (the spectrum history)
+    static constexpr size_t MAX_POOLED_OUTPUTS = 512;
+
 public:
     void add_listener(FFTListener& listener);
     void remove_listener(FFTListener& listener);
@@ -38,6 +43,7 @@ public:
 private:
     void convert(float* fft_input, const float* audio_stream, size_t frames);
     void run_fft();
+    std::shared_ptr<AlignedVector<float>> get_output_buffer();
     void drop_from_front(size_t frames);
 
 private:
@@ -51,7 +57,13 @@ private:
     size_t m_start = 0;
     size_t m_end = 0;
 
-    AlignedVector<float> m_fft_input;
+    //  Scratch space for the FFT. The input is read directly from "m_buffer".
+    AlignedVector<float> m_fft_work;
+
+    //  Output buffers in the order they were handed out to the listeners.
+    //  "m_output_pool_next" is the oldest one.
+    std::vector<std::shared_ptr<AlignedVector<float>>> m_output_pool;
+    size_t m_output_pool_next = 0;
 
     ListenerSet<FFTListener> m_listeners;
 };
@@ -0,0 +1,187 @@
+/*  Spectrum Preprocessor
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <string.h>
+#include <algorithm>
+#include "Common/Cpp/Containers/AlignedVector.tpp"
+#include "Kernels/Kernels_Alignment.h"
+#include "Kernels/SpikeConvolution/Kernels_SpikeConvolution.h"
+#include "CommonFramework/AudioPipeline/AudioFeed.h"
+#include "SpectrumPreprocessor.h"
+
+namespace PokemonAutomation{
+
+
+
+std::vector<float> build_spike_kernel(size_t frequencies, size_t half_sample_rate){
+    std::vector<float> kernel;
+    // We find a good kernel when sample rate is 48K and numFrequencies is 2048:
+    // [-4.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f, 3.f, 4.f, 4.f, 3.f, 2.f, 1.f, 0.f, -1.f, -2.f, -3.f, -4.f]
+    // This spans frenquency range of 17 * halfSampleRate / numFrequencies = 199.21875Hz, where 17 is the number of intervals in the above series.
+    // For another sample rate and numFrequencies combination, the number of intervals is
+    // 199.21875 * numFrequencies / halfSampleRate
+    size_t numKernelIntervals = int(199.21875 * frequencies / half_sample_rate + 0.5);
+    size_t slopeLen = numKernelIntervals / 2;
+    for(size_t i = 0; i <= slopeLen; i++){
+        kernel.push_back(-4.0f + 8.f * i / (float)slopeLen);
+    }
+    for(size_t i = ((numKernelIntervals+1) % 2); i <= slopeLen; i++){
+        kernel.push_back(-4.0f + 8.f * (slopeLen-i)/(float)slopeLen);
+    }
+    return kernel;
+}
+
+// std::vector<float> buildSmoothKernel(size_t numFrequencies, size_t halfSampleRate){
+//     std::vector<float> kernel;
+//     // We find a good kernel when sample rate is 48K and numFrequencies is 2048:
+//     // [0.0111, 0.135, 0.606, 1.0, 0.606, 0.135, 0.0111], built as Gaussian distribution with sigma(stddev) as 1.0
+//     // The equation for Gaussian is exp(-x^2/(2 sigma^2))
+//     // We can think sigma value as 1.0 * frequency_gap = 1.0 * halfSampleRate / numFrequencies = 11.71875 Hz
+// }
+
+
+std::pair<size_t, size_t> processed_spectrum_range(
+    SpectrumProcessingMode mode,
+    size_t freq_start, size_t freq_end,
+    size_t kernel_length
+){
+    switch (mode){
+    case SpectrumProcessingMode::SPIKE_CONV:
+        return {0, (freq_end - freq_start) - kernel_length + 1};
+    case SpectrumProcessingMode::AVERAGE_5:
+        return {0, (freq_end - freq_start) / 5};
+    case SpectrumProcessingMode::RAW:
+    default:
+        return {freq_start, freq_end};
+    }
+}
+
+void process_spectrum(
+    SpectrumProcessingMode mode,
+    float* dst, const float* src,
+    size_t freq_start, size_t freq_end,
+    const std::vector<float>& kernel
+){
+    switch (mode){
+    case SpectrumProcessingMode::SPIKE_CONV:{
+        const size_t num = freq_end - freq_start;
+        if (num < kernel.size()){
+            return;
+        }
+        Kernels::SpikeConvolution::compute_spike_kernel(
+            dst, src + freq_start, num, kernel.data(), kernel.size()
+        );
+        return;
+    }
+    case SpectrumProcessingMode::AVERAGE_5:{
+        const size_t numNewFreq = (freq_end - freq_start) / 5;
+        for (size_t j = 0; j < numNewFreq; j++){
+            const float* rawFreqMag = src + freq_start + j*5;
+            dst[j] = (rawFreqMag[0] + rawFreqMag[1] + rawFreqMag[2] + rawFreqMag[3] + rawFreqMag[4]) / 5.0f;
+        }
+        return;
+    }
+    case SpectrumProcessingMode::RAW:
+        return;
+    }
+}
+
+
+
+bool SpectrumPreprocessor::Key::operator<(const Key& x) const{
+    if (stamp != x.stamp) return stamp < x.stamp;
+    if (source != x.source) return source < x.source;
+    if (mode != x.mode) return mode < x.mode;
+    if (freq_start != x.freq_start) return freq_start < x.freq_start;
+    return freq_end < x.freq_end;
+}
+
+const std::vector<float>& SpectrumPreprocessor::kernel(size_t frequencies, size_t sample_rate){
+    //  Must call under lock.
+    //  Kernels are never removed so the reference stays valid after unlocking.
+    auto iter = m_kernels.find({frequencies, sample_rate});
+    if (iter == m_kernels.end()){
+        iter = m_kernels.emplace(
+            std::make_pair(frequencies, sample_rate),
+            build_spike_kernel(frequencies, sample_rate / 2)
+        ).first;
+    }
+    return iter->second;
+}
+
+std::shared_ptr<const ProcessedSpectrum> SpectrumPreprocessor::process(
+    const AudioSpectrum& spectrum,
+    SpectrumProcessingMode mode,
+    size_t freq_start, size_t freq_end
+){
+    const AlignedVector<float>& source = *spectrum.magnitudes;
+    Key key{spectrum.stamp, &source, mode, freq_start, freq_end};
+
+    const std::vector<float>* conv_kernel;
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        auto iter = m_cache.find(key);
+        if (iter != m_cache.end()){
+            return iter->second.result;
+        }
+        conv_kernel = &kernel(source.size(), spectrum.sample_rate);
+    }
+
+    //  Compute outside the lock. If another matcher races us on the same
+    //  spectrum, the first result to be inserted wins.
+    std::pair<size_t, size_t> range = processed_spectrum_range(mode, freq_start, freq_end, conv_kernel->size());
+
+    std::shared_ptr<ProcessedSpectrum> result = std::make_shared<ProcessedSpectrum>();
+    if (mode == SpectrumProcessingMode::RAW){
+        result->magnitudes = spectrum.magnitudes;
+    }else{
+        const size_t length = Kernels::align_int_up<PA_ALIGNMENT>(range.second * sizeof(float)) / sizeof(float);
+        AlignedVector<float> processed(length);
+        if (length != 0){
+            memset(processed.data(), 0, length * sizeof(float));
+        }
+        process_spectrum(mode, processed.data(), source.data(), freq_start, freq_end, *conv_kernel);
+        result->magnitudes = std::make_shared<AlignedVector<float>>(std::move(processed));
+    }
+
+    float norm_sqr = 0.0f;
+    const float* magnitudes = result->magnitudes->data();
+    for (size_t i = range.first; i < range.second; i++){
+        float mag = magnitudes[i];
+        norm_sqr += mag * mag;
+    }
+    result->norm_sqr = norm_sqr;
+
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    //  This matcher has fallen behind. Its result would be evicted right away
+    //  so don't disturb the cache for it. Feed resets go through "clear()".
+    if (spectrum.stamp + HISTORY_STAMPS <= m_newest_stamp){
+        return result;
+    }
+    m_newest_stamp = std::max(m_newest_stamp, spectrum.stamp);
+
+    auto iter = m_cache.emplace(key, Entry{spectrum.magnitudes, std::move(result)}).first;
+    std::shared_ptr<const ProcessedSpectrum> ret = iter->second.result;
+
+    //  Evict old stamps. The keys are ordered by stamp first.
+    if (m_newest_stamp >= HISTORY_STAMPS){
+        Key threshold{m_newest_stamp - HISTORY_STAMPS + 1, nullptr, SpectrumProcessingMode::RAW, 0, 0};
+        m_cache.erase(m_cache.begin(), m_cache.lower_bound(threshold));
+    }
+
+    return ret;
+}
+
+void SpectrumPreprocessor::clear(){
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_cache.clear();
+    m_newest_stamp = 0;
+}
+
+
+
+}
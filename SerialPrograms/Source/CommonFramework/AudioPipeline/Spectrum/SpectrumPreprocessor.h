@@ -0,0 +1,119 @@
+/*  Spectrum Preprocessor
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Per-spectrum filtering for spectrogram matching.
+ *
+ *  Every AudioFeed owns one of these. Matchers that listen to the same feed
+ *  with the same filter and frequency band get the same filtered spectrum
+ *  instead of each computing it again.
+ *
+ */
+
+#ifndef PokemonAutomation_AudioPipeline_SpectrumPreprocessor_H
+#define PokemonAutomation_AudioPipeline_SpectrumPreprocessor_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include <map>
+#include <mutex>
+#include "Common/Cpp/Containers/AlignedVector.h"
+
+namespace PokemonAutomation{
+
+class AudioSpectrum;
+
+
+enum class SpectrumProcessingMode{
+    // Don't do any processing on each window of spectrum, matching raw spectrums.
+    RAW,
+    // Do convolution on each window of spectrum with a peak detection kernel, before matching spectrums.
+    SPIKE_CONV,
+    // Do convolution on each window of spectrum with a Gaussian smooth kernel, before matching spectrums.
+    // GAUSSIAN_CONV,
+    // Average every 5 frequencies to reduce computation.
+    AVERAGE_5,
+};
+
+
+//  Build the spike convolution kernel for a spectrum of "frequencies"
+//  magnitudes covering [0, half_sample_rate).
+std::vector<float> build_spike_kernel(size_t frequencies, size_t half_sample_rate);
+
+//  The range of the filtered spectrum that is matched when filtering the
+//  band [freq_start, freq_end) of the original spectrum.
+std::pair<size_t, size_t> processed_spectrum_range(
+    SpectrumProcessingMode mode,
+    size_t freq_start, size_t freq_end,
+    size_t kernel_length
+);
+
+//  Filter the band [freq_start, freq_end) of "src" into "dst".
+//  "dst" must be valid for the end of "processed_spectrum_range()" rounded
+//  up to the SIMD size. Does nothing for RAW.
+void process_spectrum(
+    SpectrumProcessingMode mode,
+    float* dst, const float* src,
+    size_t freq_start, size_t freq_end,
+    const std::vector<float>& kernel
+);
+
+
+struct ProcessedSpectrum{
+    //  The filtered magnitudes. For RAW, this is the original spectrum.
+    std::shared_ptr<const AlignedVector<float>> magnitudes;
+
+    //  Sum of squares of "magnitudes" over "processed_spectrum_range()".
+    float norm_sqr;
+};
+
+
+class SpectrumPreprocessor{
+    //  Keep results for this many of the most recent stamps. Matchers that
+    //  fall further behind than this will compute their own.
+    static constexpr uint64_t HISTORY_STAMPS = 256;
+
+public:
+    //  Filter the band [freq_start, freq_end) of "spectrum" with "mode".
+    //  The result is cached for every other matcher using the same settings.
+    //  This function is thread-safe.
+    std::shared_ptr<const ProcessedSpectrum> process(
+        const AudioSpectrum& spectrum,
+        SpectrumProcessingMode mode,
+        size_t freq_start, size_t freq_end
+    );
+
+    void clear();
+
+private:
+    const std::vector<float>& kernel(size_t frequencies, size_t sample_rate);
+
+private:
+    struct Key{
+        uint64_t stamp;
+        const void* source;
+        SpectrumProcessingMode mode;
+        size_t freq_start;
+        size_t freq_end;
+
+        bool operator<(const Key& x) const;
+    };
+    struct Entry{
+        //  Holding the source keeps its address from being reused by a
+        //  different spectrum while it is in the cache.
+        std::shared_ptr<const AlignedVector<float>> source;
+        std::shared_ptr<const ProcessedSpectrum> result;
+    };
+
+    mutable std::mutex m_lock;
+    uint64_t m_newest_stamp = 0;
+    std::map<Key, Entry> m_cache;
+    std::map<std::pair<size_t, size_t>, std::vector<float>> m_kernels;
+};
+
+
+
+}
+#endif
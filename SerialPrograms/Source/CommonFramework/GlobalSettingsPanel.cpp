@@ -16,6 +16,9 @@
 #include "Common/Cpp/Json/JsonArray.h"
 #include "Common/Cpp/Json/JsonObject.h"
 #include "CommonFramework/Globals.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "CommonFramework/Logging/FileWindowLogger.h"
+#include "CommonFramework/Logging/BinaryEventLogFile.h"
 #include "CommonFramework/Options/CheckForUpdatesOption.h"
 #include "CommonFramework/Options/ResolutionOption.h"
 #include "CommonFramework/Options/Environment/SleepSuppressOption.h"
@@ -185,6 +188,20 @@ GlobalSettings::GlobalSettings()
         LockMode::UNLOCK_WHILE_RUNNING,
         false
     )
+    , LOG_DROP_WHEN_BEHIND(
+        "<b>Drop Logs When Behind:</b><br>"
+        "If the output log cannot keep up (e.g. a slow disk), drop log lines instead of making the program wait for it. "
+        "The number of dropped lines is written to the log.",
+        LockMode::UNLOCK_WHILE_RUNNING,
+        false
+    )
+    , BINARY_EVENT_LOG(
+        "<b>Binary Event Log:</b><br>"
+        "Also write a compact binary copy of the log (.palog) next to the output log. "
+        "Use the PALogDecoder tool to turn it back into text.",
+        LockMode::UNLOCK_WHILE_RUNNING,
+        false
+    )
     , SAVE_DEBUG_IMAGES(
         "<b>Save Debug Images:</b><br>"
         "If the program fails to read something when it should succeed, save the image for debugging purposes.",
@@ -246,6 +263,8 @@ GlobalSettings::GlobalSettings()
 
     PA_ADD_STATIC(m_advanced_options);
     PA_ADD_OPTION(LOG_EVERYTHING);
+    PA_ADD_OPTION(LOG_DROP_WHEN_BEHIND);
+    PA_ADD_OPTION(BINARY_EVENT_LOG);
     PA_ADD_OPTION(SAVE_DEBUG_IMAGES);
 //    PA_ADD_OPTION(NAUGHTY_MODE);
 //    PA_ADD_OPTION(HIDE_NOTIF_DISCORD_LINK);
@@ -264,6 +283,8 @@ GlobalSettings::GlobalSettings()
     PA_ADD_OPTION(DEVELOPER_TOKEN);
 
     GlobalSettings::on_config_value_changed(this);
+    LOG_DROP_WHEN_BEHIND.add_listener(*this);
+    BINARY_EVENT_LOG.add_listener(*this);
     ENABLE_LIFETIME_SANITIZER0.add_listener(*this);
     OPEN_BASE_FOLDER_BUTTON.add_listener(static_cast<ButtonListener&>(*this));
 }
@@ -382,6 +403,21 @@ JsonValue GlobalSettings::to_json() const{
 }
 
 void GlobalSettings::on_config_value_changed(void* object){
+    if (object == this || object == &LOG_DROP_WHEN_BEHIND){
+        static_cast<FileWindowLogger&>(global_logger_raw()).set_overflow_policy(
+            LOG_DROP_WHEN_BEHIND ? LogOverflowPolicy::DROP : LogOverflowPolicy::BLOCK
+        );
+        if (object == &LOG_DROP_WHEN_BEHIND){
+            return;
+        }
+    }
+    if (object == this || object == &BINARY_EVENT_LOG){
+        BinaryEventLogFile::instance().set_enabled(BINARY_EVENT_LOG);
+        if (object == &BINARY_EVENT_LOG){
+            return;
+        }
+    }
+
     bool enabled = ENABLE_LIFETIME_SANITIZER0;
     if (enabled){
         global_logger_tagged().log("LifeTime Sanitizer: Enabled", COLOR_BLUE);
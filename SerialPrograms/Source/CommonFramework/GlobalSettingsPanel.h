@@ -113,6 +113,8 @@ public:
     SectionDividerOption m_advanced_options;
 
     BooleanCheckBoxOption LOG_EVERYTHING;
+    BooleanCheckBoxOption LOG_DROP_WHEN_BEHIND;
+    BooleanCheckBoxOption BINARY_EVENT_LOG;
     BooleanCheckBoxOption SAVE_DEBUG_IMAGES;
 //    BooleanCheckBoxOption NAUGHTY_MODE_OPTION;
     BooleanCheckBoxOption HIDE_NOTIF_DISCORD_LINK;
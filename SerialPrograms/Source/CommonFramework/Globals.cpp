@@ -212,6 +212,10 @@ const std::string& ML_MODEL_CACHE_PATH(){
     static const std::string path = RUNTIME_BASE_PATH() + "ModelCache/";
     return path;
 }
+const std::string& AUDIO_TEMPLATE_CACHE_PATH(){
+    static const std::string path = RUNTIME_BASE_PATH() + "AudioTemplateCache/";
+    return path;
+}
 
 }
 
@@ -76,6 +76,9 @@ const std::string& ML_ANNOTATION_PATH();
 // for the Apple CoreML model acceleration framework to create model cache for faster model inference
 // sessions.
 const std::string& ML_MODEL_CACHE_PATH();
+// Folder path (end with "/") to hold precompiled audio templates. These are the spectrograms of
+// the audio template files in RESOURCE_PATH() so they don't need to be decoded and FFT'ed every launch.
+const std::string& AUDIO_TEMPLATE_CACHE_PATH();
 
 
 enum class ProgramState{
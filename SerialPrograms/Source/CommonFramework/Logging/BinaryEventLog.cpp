@@ -0,0 +1,349 @@
+/*  Binary Event Log
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Stream layout:
+ *
+ *      Session:    "PALOG" <version>
+ *      Tag:        0x01 <varint length> <bytes>
+ *      Color:      0x02 <4 bytes little-endian ARGB>
+ *      Format:     0x03 <varint length> <bytes>
+ *      UTC Offset: 0x05 <zigzag varint seconds local time is ahead of UTC>
+ *      Event:      0x04 <zigzag varint time delta (us)> <varint tag> <varint color>
+ *                       <varint format + 1, or 0 followed by an inline format>
+ *                       <one argument per placeholder>
+ *
+ *  Tags, colors and formats are numbered in the order they are defined
+ *  within the session. The UTC offset comes before the first event of each
+ *  session and again whenever it changes. It applies to the events after it. In a format, 0x01 is a number placeholder and 0x02
+ *  escapes the next byte. An argument is a varint of (value << 1 | flag).
+ *  If the flag is set, the number had leading zeros and a varint digit
+ *  count follows.
+ *
+ */
+
+#include <algorithm>
+#include "Common/Cpp/Exceptions.h"
+#include "BinaryEventLog.h"
+
+namespace PokemonAutomation{
+
+
+namespace{
+
+const char SESSION_MAGIC[] = "PALOG";
+const uint8_t FORMAT_VERSION = 2;
+
+const uint8_t RECORD_TAG = 0x01;
+const uint8_t RECORD_COLOR = 0x02;
+const uint8_t RECORD_FORMAT = 0x03;
+const uint8_t RECORD_EVENT = 0x04;
+const uint8_t RECORD_UTC_OFFSET = 0x05;
+
+const char PLACEHOLDER = 0x01;
+const char ESCAPE = 0x02;
+
+//  Longest run of digits that always fits in 63 bits. The argument needs
+//  the low bit of the varint for the leading-zero flag.
+const size_t MAX_DIGITS = 18;
+
+
+void write_varint(std::string& out, uint64_t x){
+    while (x >= 0x80){
+        out += (char)(x | 0x80);
+        x >>= 7;
+    }
+    out += (char)x;
+}
+void write_zigzag(std::string& out, int64_t x){
+    write_varint(out, ((uint64_t)x << 1) ^ (uint64_t)(x >> 63));
+}
+void write_string(std::string& out, const std::string& str){
+    write_varint(out, str.size());
+    out += str;
+}
+
+uint8_t read_byte(std::istream& stream){
+    int ch = stream.get();
+    if (ch == std::char_traits<char>::eof()){
+        throw ParseException("Binary log: Unexpected end of stream.");
+    }
+    return (uint8_t)ch;
+}
+uint64_t read_varint(std::istream& stream){
+    uint64_t x = 0;
+    for (int shift = 0; shift < 64; shift += 7){
+        uint8_t byte = read_byte(stream);
+        x |= (uint64_t)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0){
+            return x;
+        }
+    }
+    throw ParseException("Binary log: Invalid varint.");
+}
+int64_t read_zigzag(std::istream& stream){
+    uint64_t x = read_varint(stream);
+    return (int64_t)(x >> 1) ^ -(int64_t)(x & 1);
+}
+std::string read_string(std::istream& stream){
+    uint64_t length = read_varint(stream);
+    std::string str;
+    //  Grow as we go so a corrupt length can't make us allocate the world.
+    while (str.size() < length){
+        char buffer[4096];
+        size_t block = (size_t)std::min<uint64_t>(length - str.size(), sizeof(buffer));
+        stream.read(buffer, block);
+        if ((size_t)stream.gcount() != block){
+            throw ParseException("Binary log: Unexpected end of stream.");
+        }
+        str.append(buffer, block);
+    }
+    return str;
+}
+
+
+int64_t to_us(WallClock time){
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+WallClock from_us(int64_t us){
+    return WallClock(std::chrono::duration_cast<WallClock::duration>(std::chrono::microseconds(us)));
+}
+
+
+//  Split "message" into its format and number arguments.
+void split_message(std::string& format, std::string& args, const std::string& message){
+    const char* ptr = message.data();
+    const char* end = ptr + message.size();
+    while (ptr < end){
+        char ch = *ptr;
+        if (ch < '0' || ch > '9'){
+            if (ch == PLACEHOLDER || ch == ESCAPE){
+                format += ESCAPE;
+            }
+            format += ch;
+            ptr++;
+            continue;
+        }
+
+        const char* start = ptr;
+        uint64_t value = 0;
+        while (ptr < end && *ptr >= '0' && *ptr <= '9'){
+            value = value * 10 + (*ptr - '0');
+            ptr++;
+        }
+        size_t digits = ptr - start;
+        if (digits > MAX_DIGITS){
+            format.append(start, digits);
+            continue;
+        }
+
+        format += PLACEHOLDER;
+        bool leading_zeros = digits > 1 && start[0] == '0';
+        write_varint(args, value << 1 | (leading_zeros ? 1 : 0));
+        if (leading_zeros){
+            write_varint(args, digits);
+        }
+    }
+}
+
+//  Rebuild the message from its format by reading the arguments.
+std::string join_message(const std::string& format, std::istream& stream){
+    std::string message;
+    message.reserve(format.size() + 16);
+    for (size_t c = 0; c < format.size(); c++){
+        char ch = format[c];
+        if (ch == ESCAPE){
+            if (++c >= format.size()){
+                throw ParseException("Binary log: Invalid format string.");
+            }
+            message += format[c];
+            continue;
+        }
+        if (ch != PLACEHOLDER){
+            message += ch;
+            continue;
+        }
+
+        uint64_t arg = read_varint(stream);
+        std::string digits = std::to_string(arg >> 1);
+        if (arg & 1){
+            uint64_t length = read_varint(stream);
+            if (length > MAX_DIGITS || length < digits.size()){
+                throw ParseException("Binary log: Invalid number argument.");
+            }
+            message.append((size_t)length - digits.size(), '0');
+        }
+        message += digits;
+    }
+    return message;
+}
+
+}
+
+
+
+std::string BinaryLogEvent::to_log_line() const{
+    return time_to_str_utc(timestamp + std::chrono::seconds(utc_offset)) + " - [" + tag + "]: " + message;
+}
+
+
+
+void BinaryEventLogEncoder::start_session(std::string& out){
+    m_tags.clear();
+    m_colors.clear();
+    m_formats.clear();
+    m_last_time_us = 0;
+    m_has_utc_offset = false;
+    out += SESSION_MAGIC;
+    out += (char)FORMAT_VERSION;
+}
+
+void BinaryEventLogEncoder::encode(std::string& out, const BinaryLogEvent& event){
+    if (!m_has_utc_offset || event.utc_offset != m_utc_offset){
+        out += (char)RECORD_UTC_OFFSET;
+        write_zigzag(out, event.utc_offset);
+        m_has_utc_offset = true;
+        m_utc_offset = event.utc_offset;
+    }
+
+    auto tag = m_tags.find(event.tag);
+    if (tag == m_tags.end()){
+        out += (char)RECORD_TAG;
+        write_string(out, event.tag);
+        tag = m_tags.emplace(event.tag, m_tags.size()).first;
+    }
+
+    uint32_t argb = (uint32_t)event.color;
+    auto color = m_colors.find(argb);
+    if (color == m_colors.end()){
+        out += (char)RECORD_COLOR;
+        for (size_t c = 0; c < 4; c++){
+            out += (char)(argb >> (8 * c));
+        }
+        color = m_colors.emplace(argb, m_colors.size()).first;
+    }
+
+    std::string format;
+    std::string args;
+    split_message(format, args, event.message);
+
+    uint64_t format_id = 0;
+    auto iter = m_formats.find(format);
+    if (iter != m_formats.end()){
+        format_id = iter->second + 1;
+    }else if (m_formats.size() < MAX_FORMATS){
+        out += (char)RECORD_FORMAT;
+        write_string(out, format);
+        format_id = m_formats.size() + 1;
+        m_formats.emplace(std::move(format), m_formats.size());
+    }
+
+    int64_t time_us = to_us(event.timestamp);
+    int64_t delta = time_us - m_last_time_us;
+    m_last_time_us = time_us;
+
+    out += (char)RECORD_EVENT;
+    write_zigzag(out, delta);
+    write_varint(out, tag->second);
+    write_varint(out, color->second);
+    write_varint(out, format_id);
+    if (format_id == 0){
+        write_string(out, format);
+    }
+    out += args;
+}
+
+
+
+BinaryEventLogDecoder::BinaryEventLogDecoder(std::istream& stream)
+    : m_stream(stream)
+{}
+
+void BinaryEventLogDecoder::start_session(){
+    //  The 'P' has already been read.
+    char magic[sizeof(SESSION_MAGIC) - 2];
+    m_stream.read(magic, sizeof(magic));
+    if ((size_t)m_stream.gcount() != sizeof(magic) ||
+        std::string(magic, sizeof(magic)) != SESSION_MAGIC + 1
+    ){
+        throw ParseException("Binary log: Invalid session header.");
+    }
+    uint8_t version = read_byte(m_stream);
+    if (version != FORMAT_VERSION){
+        throw ParseException("Binary log: Unsupported version: " + std::to_string(version));
+    }
+    m_tags.clear();
+    m_colors.clear();
+    m_formats.clear();
+    m_last_time_us = 0;
+    m_utc_offset = 0;
+    m_in_session = true;
+}
+
+bool BinaryEventLogDecoder::next(BinaryLogEvent& event){
+    while (true){
+        int ch = m_stream.get();
+        if (ch == std::char_traits<char>::eof()){
+            return false;
+        }
+        if (ch == SESSION_MAGIC[0]){
+            start_session();
+            continue;
+        }
+        if (!m_in_session){
+            throw ParseException("Binary log: Missing session header.");
+        }
+        switch ((uint8_t)ch){
+        case RECORD_TAG:
+            m_tags.emplace_back(read_string(m_stream));
+            break;
+        case RECORD_COLOR:{
+            uint32_t argb = 0;
+            for (size_t c = 0; c < 4; c++){
+                argb |= (uint32_t)read_byte(m_stream) << (8 * c);
+            }
+            m_colors.emplace_back(argb);
+            break;
+        }
+        case RECORD_FORMAT:
+            m_formats.emplace_back(read_string(m_stream));
+            break;
+        case RECORD_UTC_OFFSET:{
+            int64_t offset = read_zigzag(m_stream);
+            if (offset < -86400 || offset > 86400){
+                throw ParseException("Binary log: Invalid UTC offset.");
+            }
+            m_utc_offset = (int32_t)offset;
+            break;
+        }
+        case RECORD_EVENT:{
+            m_last_time_us += read_zigzag(m_stream);
+
+            uint64_t tag = read_varint(m_stream);
+            uint64_t color = read_varint(m_stream);
+            uint64_t format_id = read_varint(m_stream);
+            if (tag >= m_tags.size() || color >= m_colors.size() || format_id > m_formats.size()){
+                throw ParseException("Binary log: Reference to undefined entry.");
+            }
+
+            event.timestamp = from_us(m_last_time_us);
+            event.tag = m_tags[(size_t)tag];
+            event.color = m_colors[(size_t)color];
+            event.utc_offset = m_utc_offset;
+            if (format_id == 0){
+                std::string format = read_string(m_stream);
+                event.message = join_message(format, m_stream);
+            }else{
+                event.message = join_message(m_formats[(size_t)format_id - 1], m_stream);
+            }
+            return true;
+        }
+        default:
+            throw ParseException("Binary log: Unknown record type: " + std::to_string(ch));
+        }
+    }
+}
+
+
+
+}
@@ -0,0 +1,95 @@
+/*  Binary Event Log
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Compact binary encoding of tagged log lines.
+ *
+ *  Every run of digits in a message is pulled out as a number argument and
+ *  what is left becomes the message's "format". Formats, tags and colors are
+ *  interned so that repetitive lines like inference results and controller
+ *  commands only cost a few bytes each. Timestamps are stored as deltas.
+ *
+ *  The encoding is lossless. Decoding reproduces the exact text that
+ *  TaggedLogger writes to the text log.
+ *
+ *  This file does not depend on Qt so that the offline decoder can use it.
+ *
+ */
+
+#ifndef PokemonAutomation_Logging_BinaryEventLog_H
+#define PokemonAutomation_Logging_BinaryEventLog_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <istream>
+#include "Common/Cpp/Color.h"
+#include "Common/Cpp/Time.h"
+
+namespace PokemonAutomation{
+
+
+struct BinaryLogEvent{
+    WallClock timestamp;
+    std::string tag;
+    Color color;
+    std::string message;
+
+    //  # of seconds that local time was ahead of UTC where this was logged.
+    int32_t utc_offset = 0;
+
+    //  The line as TaggedLogger writes it to the text log. The time is in the
+    //  local time of where it was logged, not where it is decoded.
+    std::string to_log_line() const;
+};
+
+
+class BinaryEventLogEncoder{
+    //  Stop interning new formats past this. Further unique messages are
+    //  stored inline.
+    static constexpr size_t MAX_FORMATS = 65536;
+
+public:
+    //  Append the header of a new session to "out" and forget all interned
+    //  strings. Each session in a file can be decoded on its own.
+    void start_session(std::string& out);
+
+    //  Append "event" to "out". "start_session()" must have been called first.
+    void encode(std::string& out, const BinaryLogEvent& event);
+
+private:
+    std::map<std::string, uint64_t> m_tags;
+    std::map<uint32_t, uint64_t> m_colors;
+    std::map<std::string, uint64_t> m_formats;
+    int64_t m_last_time_us = 0;
+    bool m_has_utc_offset = false;
+    int32_t m_utc_offset = 0;
+};
+
+
+class BinaryEventLogDecoder{
+public:
+    BinaryEventLogDecoder(std::istream& stream);
+
+    //  Read the next event. Returns false at the end of the stream.
+    //  Throws a ParseException if the stream is corrupt.
+    bool next(BinaryLogEvent& event);
+
+private:
+    void start_session();
+
+private:
+    std::istream& m_stream;
+    bool m_in_session = false;
+    std::vector<std::string> m_tags;
+    std::vector<Color> m_colors;
+    std::vector<std::string> m_formats;
+    int64_t m_last_time_us = 0;
+    int32_t m_utc_offset = 0;
+};
+
+
+
+}
+#endif
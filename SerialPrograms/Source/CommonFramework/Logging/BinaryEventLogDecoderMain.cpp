@@ -0,0 +1,82 @@
+/*  Binary Event Log Decoder
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Command line tool that turns a binary event log (.palog) back into
+ *      the text log format.
+ *
+ *  Usage:
+ *      PALogDecoder <input.palog> [--tag <tag>]... [--from <time>] [--to <time>]
+ *
+ *  Times are in the same format as the log ("2024-01-31 23:59:59.000000")
+ *  and may be truncated. e.g. "2024-01-31 23" is everything from 11pm.
+ *
+ */
+
+#include <set>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include "Common/Cpp/Exceptions.h"
+#include "BinaryEventLog.h"
+
+using namespace PokemonAutomation;
+
+
+int main(int argc, char* argv[]){
+    std::string input;
+    std::set<std::string> tags;
+    std::string from;
+    std::string to;
+
+    for (int c = 1; c < argc; c++){
+        std::string arg = argv[c];
+        if (arg == "--tag" && c + 1 < argc){
+            tags.insert(argv[++c]);
+        }else if (arg == "--from" && c + 1 < argc){
+            from = argv[++c];
+        }else if (arg == "--to" && c + 1 < argc){
+            to = argv[++c];
+        }else if (input.empty() && !arg.empty() && arg[0] != '-'){
+            input = std::move(arg);
+        }else{
+            input.clear();
+            break;
+        }
+    }
+    if (input.empty()){
+        std::cerr << "Usage: PALogDecoder <input.palog> [--tag <tag>]... [--from <time>] [--to <time>]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(input, std::ios::binary);
+    if (!file){
+        std::cerr << "Unable to open: " << input << std::endl;
+        return 1;
+    }
+
+    BinaryEventLogDecoder decoder(file);
+    BinaryLogEvent event;
+    try{
+        while (decoder.next(event)){
+            if (!tags.empty() && tags.find(event.tag) == tags.end()){
+                continue;
+            }
+            std::string line = event.to_log_line();
+            //  The timestamp comes first in a fixed-width format. So a
+            //  string compare of the prefix is a time compare.
+            if (!from.empty() && line.compare(0, from.size(), from) < 0){
+                continue;
+            }
+            if (!to.empty() && line.compare(0, to.size(), to) > 0){
+                continue;
+            }
+            std::cout << line << "\n";
+        }
+    }catch (ParseException& e){
+        std::cout.flush();
+        std::cerr << e.message() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+/*  Binary Event Log File
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <QCoreApplication>
+#include "CommonFramework/Globals.h"
+#include "BinaryEventLogFile.h"
+
+namespace PokemonAutomation{
+
+
+BinaryEventLogFile& BinaryEventLogFile::instance(){
+    static BinaryEventLogFile log(
+        USER_FILE_PATH() + (QCoreApplication::applicationName() + ".palog").toStdString()
+    );
+    return log;
+}
+
+BinaryEventLogFile::~BinaryEventLogFile(){
+    flush();
+}
+BinaryEventLogFile::BinaryEventLogFile(const std::string& path)
+    : m_enabled(false)
+    , m_file(QString::fromStdString(path))
+    , m_opened(false)
+    , m_buffer_start(current_time())
+{}
+
+void BinaryEventLogFile::set_enabled(bool enabled){
+    std::lock_guard<std::mutex> lg(m_file_lock);
+    if (enabled == m_enabled.load(std::memory_order_relaxed)){
+        return;
+    }
+    if (enabled){
+        if (!m_opened){
+            m_opened = m_file.open(QIODevice::WriteOnly | QIODevice::Append);
+        }
+        //  Every enable starts a new session so the file can be appended to
+        //  across runs.
+        WriteSpinLock lg1(m_lock);
+        if (m_buffer.empty()){
+            m_buffer_start = current_time();
+        }
+        m_encoder.start_session(m_buffer);
+        m_enabled.store(true, std::memory_order_relaxed);
+    }else{
+        std::string buffer;
+        {
+            WriteSpinLock lg1(m_lock);
+            m_enabled.store(false, std::memory_order_relaxed);
+            buffer.swap(m_buffer);
+        }
+        if (m_opened && !buffer.empty()){
+            m_file.write(buffer.data(), buffer.size());
+            m_file.flush();
+        }
+    }
+}
+
+void BinaryEventLogFile::log(WallClock timestamp, const std::string& tag, Color color, const std::string& msg){
+    int32_t utc_offset = local_utc_offset(timestamp);
+    WriteSpinLock lg(m_lock);
+    if (!m_enabled.load(std::memory_order_relaxed)){
+        return;
+    }
+    if (m_buffer.empty()){
+        m_buffer_start = timestamp;
+    }
+    m_event.timestamp = timestamp;
+    m_event.tag = tag;
+    m_event.color = color;
+    m_event.message = msg;
+    m_event.utc_offset = utc_offset;
+    m_encoder.encode(m_buffer, m_event);
+}
+
+bool BinaryEventLogFile::write_pending(bool force){
+    std::lock_guard<std::mutex> lg(m_file_lock);
+    std::string buffer;
+    {
+        WriteSpinLock lg1(m_lock);
+        if (m_buffer.empty()){
+            return false;
+        }
+        if (!force &&
+            m_buffer.size() < WRITE_BYTES &&
+            current_time() - m_buffer_start < WRITE_INTERVAL
+        ){
+            return true;
+        }
+        buffer.swap(m_buffer);
+    }
+    if (m_opened){
+        m_file.write(buffer.data(), buffer.size());
+        m_file.flush();
+    }
+    return false;
+}
+
+
+
+}
@@ -0,0 +1,73 @@
+/*  Binary Event Log File
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Optional binary copy of everything that goes through a TaggedLogger.
+ *      Use the "PALogDecoder" tool to turn it back into a text log.
+ *
+ *  Logging threads only encode events into a buffer in memory. The writer
+ *  thread of the global FileWindowLogger writes the buffer to the file.
+ *
+ */
+
+#ifndef PokemonAutomation_Logging_BinaryEventLogFile_H
+#define PokemonAutomation_Logging_BinaryEventLogFile_H
+
+#include <atomic>
+#include <mutex>
+#include <QFile>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "BinaryEventLog.h"
+
+namespace PokemonAutomation{
+
+
+class BinaryEventLogFile{
+    //  Write to the file once this many bytes are buffered...
+    static constexpr size_t WRITE_BYTES = 64 * 1024;
+    //  ...or when the oldest buffered event is this old.
+    static constexpr std::chrono::seconds WRITE_INTERVAL = std::chrono::seconds(1);
+
+public:
+    static BinaryEventLogFile& instance();
+
+    bool enabled() const{ return m_enabled.load(std::memory_order_relaxed); }
+    void set_enabled(bool enabled);
+
+    //  Encode the event into the buffer. This never touches the file.
+    void log(WallClock timestamp, const std::string& tag, Color color, const std::string& msg);
+
+    //  Called by the log writer thread. Write the buffer to the file if it is
+    //  big or old enough, or if "force" is set.
+    //  Returns true if anything is still waiting in the buffer.
+    bool write_pending(bool force);
+
+    //  Write everything buffered so far to the file and flush it.
+    void flush(){ write_pending(true); }
+
+private:
+    ~BinaryEventLogFile();
+    BinaryEventLogFile(const std::string& path);
+
+private:
+    std::atomic<bool> m_enabled;
+
+    //  Protects the file. Held across taking the buffer so that buffers are
+    //  written in order.
+    std::mutex m_file_lock;
+    QFile m_file;
+    bool m_opened;
+
+    //  Protects everything below. Never held while writing to the file.
+    SpinLock m_lock;
+    BinaryEventLogEncoder m_encoder;
+    BinaryLogEvent m_event;
+    std::string m_buffer;
+    WallClock m_buffer_start;
+};
+
+
+
+}
+#endif
@@ -4,15 +4,19 @@
  *
  */
 
+#include <exception>
 #include <QCoreApplication>
 #include <QMenuBar>
 #include <QDir>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/PanicDump.h"
 #include "CommonFramework/Globals.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
 #include "CommonFramework/Windows/DpiScaler.h"
 #include "CommonFramework/Windows/WindowTracker.h"
 #include "CommonFramework/Windows/MainWindow.h"
 #include "CommonFramework/Options/ResolutionOption.h"
+#include "BinaryEventLogFile.h"
 #include "FileWindowLogger.h"
 
 //#include <iostream>
@@ -39,19 +43,74 @@ std::vector<std::string> LastLogTracker::snapshot() const{
 }
 
 
+namespace{
+
+//  The logger to flush if the program terminates.
+std::atomic<FileWindowLogger*> terminate_logger(nullptr);
+std::terminate_handler previous_terminate_handler = nullptr;
+
+void flush_log_on_terminate(){
+    FileWindowLogger* logger = terminate_logger.load(std::memory_order_acquire);
+    if (logger != nullptr){
+        logger->flush(std::chrono::milliseconds(1000));
+        BinaryEventLogFile::instance().flush();
+    }
+    if (previous_terminate_handler != nullptr){
+        previous_terminate_handler();
+    }
+    std::abort();
+}
+
+size_t ring_capacity(size_t min_lines){
+    size_t capacity = 1;
+    while (capacity < min_lines){
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+}
+
+
+
 FileWindowLogger::~FileWindowLogger(){
+    FileWindowLogger* self = this;
+    if (terminate_logger.compare_exchange_strong(self, nullptr)){
+        set_panic_dump_hook(nullptr);
+        std::set_terminate(previous_terminate_handler);
+    }
     {
         std::lock_guard<std::mutex> lg(m_lock);
         m_stopping = true;
-        m_cv.notify_all();
+        m_writer_cv.notify_all();
+        m_space_cv.notify_all();
     }
     m_thread.join();
 }
 FileWindowLogger::FileWindowLogger(const std::string& path)
+    : FileWindowLogger(path, LOG_HISTORY_LINES)
+{}
+FileWindowLogger::FileWindowLogger(const std::string& path, size_t ring_lines)
     : m_file(QString::fromStdString(path))
-    , m_max_queue_size(LOG_HISTORY_LINES)
+    , m_capacity(ring_capacity(ring_lines))
+    , m_ring(new Slot[m_capacity])
+    , m_write_index(0)
+    , m_policy(LogOverflowPolicy::BLOCK)
+    , m_dropped(0)
+    , m_blocked(0)
+    , m_producers_waiting(0)
+    , m_writer_sleeping(false)
+    , m_read_index(0)
+    , m_binary_log(nullptr)
     , m_stopping(false)
+    , m_flush_target(0)
+    , m_lines_written(0)
+    , m_lines_flushed(0)
 {
+    for (size_t c = 0; c < m_capacity; c++){
+        m_ring[c].sequence.store(c, std::memory_order_relaxed);
+    }
+
     bool exists = m_file.exists();
     bool opened = m_file.open(QIODevice::WriteOnly | QIODevice::Append);
     if (!exists && opened){
@@ -59,9 +118,26 @@ FileWindowLogger::FileWindowLogger(const std::string& path)
         m_file.write(bom.c_str(), bom.size());
     }
 
+    //  Get whatever is still buffered onto disk if we go down. Only the first
+    //  logger does this. It is the global one.
+    FileWindowLogger* expected = nullptr;
+    bool global = terminate_logger.compare_exchange_strong(expected, this);
+    if (global){
+        //  Construct the binary log first so that it outlives this logger.
+        m_binary_log = &BinaryEventLogFile::instance();
+    }
+
     m_thread = Thread([this]{
         thread_loop();
     });
+
+    if (global){
+        set_panic_dump_hook([this]{
+            flush(std::chrono::milliseconds(1000));
+            m_binary_log->flush();
+        });
+        previous_terminate_handler = std::set_terminate(flush_log_on_terminate);
+    }
 }
 void FileWindowLogger::operator+=(FileWindowLoggerWindow& widget){
 //    auto scope_check = m_sanitizer.check_scope();
@@ -76,25 +152,108 @@ void FileWindowLogger::operator-=(FileWindowLoggerWindow& widget){
 
 void FileWindowLogger::log(const std::string& msg, Color color){
 //    auto scope_check = m_sanitizer.check_scope();
-    std::unique_lock<std::mutex> lg(m_lock);
-    m_last_log_tracker += msg;
-    m_cv.wait(lg, [this]{ return m_queue.size() < m_max_queue_size; });
-    m_queue.emplace_back(msg, color);
-    m_cv.notify_all();
+    push(std::string(msg), color);
 }
 void FileWindowLogger::log(std::string&& msg, Color color){
 //    auto scope_check = m_sanitizer.check_scope();
-    std::unique_lock<std::mutex> lg(m_lock);
-    m_last_log_tracker += msg;
-    m_cv.wait(lg, [this]{ return m_queue.size() < m_max_queue_size; });
-    m_queue.emplace_back(std::move(msg), color);
-    m_cv.notify_all();
+    push(std::move(msg), color);
 }
 std::vector<std::string> FileWindowLogger::get_last() const{
 //    auto scope_check = m_sanitizer.check_scope();
-    std::unique_lock<std::mutex> lg(m_lock);
+    wait_for_writer(m_write_index.load(std::memory_order_acquire), false, std::chrono::milliseconds(1000));
+    std::lock_guard<std::mutex> lg(m_lock);
     return m_last_log_tracker.snapshot();
 }
+bool FileWindowLogger::flush(std::chrono::milliseconds timeout){
+    return wait_for_writer(m_write_index.load(std::memory_order_acquire), true, timeout);
+}
+void FileWindowLogger::set_overflow_policy(LogOverflowPolicy policy){
+    m_policy.store(policy, std::memory_order_relaxed);
+    if (policy == LogOverflowPolicy::DROP){
+        //  Release anyone who is already blocked.
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_space_cv.notify_all();
+    }
+}
+
+
+bool FileWindowLogger::try_push(std::string& msg, Color color){
+    //  Bounded multi-producer ring. Each slot's sequence number says whether
+    //  it is free for the position that maps to it.
+    uint64_t index = m_write_index.load(std::memory_order_relaxed);
+    while (true){
+        Slot& slot = m_ring[index & (m_capacity - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        int64_t diff = (int64_t)(sequence - index);
+        if (diff == 0){
+            if (m_write_index.compare_exchange_weak(index, index + 1, std::memory_order_relaxed)){
+                slot.msg = std::move(msg);
+                slot.color = color;
+                slot.sequence.store(index + 1, std::memory_order_release);
+                return true;
+            }
+        }else if (diff < 0){
+            //  Full. The writer hasn't freed this slot from the last lap.
+            return false;
+        }else{
+            index = m_write_index.load(std::memory_order_relaxed);
+        }
+    }
+}
+bool FileWindowLogger::has_pending() const{
+    const Slot& slot = m_ring[m_read_index & (m_capacity - 1)];
+    return slot.sequence.load(std::memory_order_acquire) == m_read_index + 1;
+}
+void FileWindowLogger::wake_writer(){
+    //  Pairs with the fence in "thread_loop()" before the writer goes to sleep.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_writer_sleeping.load(std::memory_order_relaxed)){
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_writer_cv.notify_all();
+    }
+}
+void FileWindowLogger::push(std::string&& msg, Color color){
+    if (try_push(msg, color)){
+        wake_writer();
+        return;
+    }
+    if (m_policy.load(std::memory_order_relaxed) == LogOverflowPolicy::DROP){
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    m_blocked.fetch_add(1, std::memory_order_relaxed);
+    bool pushed = false;
+    {
+        std::unique_lock<std::mutex> lg(m_lock);
+        m_producers_waiting.fetch_add(1, std::memory_order_seq_cst);
+        //  Pairs with the fence in "thread_loop()" after freeing slots.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (true){
+            pushed = try_push(msg, color);
+            if (pushed || m_stopping || m_policy.load(std::memory_order_relaxed) == LogOverflowPolicy::DROP){
+                break;
+            }
+            m_space_cv.wait(lg);
+        }
+        m_producers_waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (pushed){
+        wake_writer();
+    }else{
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+bool FileWindowLogger::wait_for_writer(uint64_t lines, bool flushed, std::chrono::milliseconds timeout) const{
+    std::unique_lock<std::mutex> lg(m_lock);
+    if (flushed && m_flush_target < lines){
+        m_flush_target = lines;
+        m_writer_cv.notify_all();
+    }
+    return m_done_cv.wait_for(lg, timeout, [&]{
+        return (flushed ? m_lines_flushed : m_lines_written) >= lines;
+    });
+}
 
 
 std::string FileWindowLogger::normalize_newlines(const std::string& msg){
@@ -164,45 +323,132 @@ QString FileWindowLogger::to_window_str(const std::string& msg, Color color){
 
     return QString::fromStdString(str);
 }
-void FileWindowLogger::internal_log(const std::string& msg, Color color){
-//    auto scope_check = m_sanitizer.check_scope();
-    std::string line = normalize_newlines(msg);
-    {
-        if (!m_windows.empty()){
-            QString str = to_window_str(line, color);
-            for (FileWindowLoggerWindow* window : m_windows){
-                window->log(str);
-            }
-        }
-    }
-    {
-        m_file.write(to_file_str(msg).c_str());
-        m_file.flush();
-    }
-}
 void FileWindowLogger::thread_loop(){
 //    auto scope_check = m_sanitizer.check_scope();
-    std::unique_lock<std::mutex> lg(m_lock);
+    std::vector<std::pair<std::string, Color>> batch;
+    std::string file_buffer;
+    size_t unflushed_bytes = 0;
+    WallClock last_flush = current_time();
+    uint64_t reported_drops = 0;
+
     while (true){
-        m_cv.wait(lg, [&]{
-            return m_stopping || !m_queue.empty();
-        });
+        //  Take a batch off the ring.
+        batch.clear();
+        while (batch.size() < MAX_BATCH && has_pending()){
+            Slot& slot = m_ring[m_read_index & (m_capacity - 1)];
+            batch.emplace_back(std::move(slot.msg), slot.color);
+            slot.msg.clear();
+            slot.sequence.store(m_read_index + m_capacity, std::memory_order_release);
+            m_read_index++;
+        }
+        if (!batch.empty()){
+            //  Pairs with the fence in "push()" when blocking.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_producers_waiting.load(std::memory_order_relaxed) != 0){
+                std::lock_guard<std::mutex> lg(m_lock);
+                m_space_cv.notify_all();
+            }
+        }
+
+        //  Format everything outside the lock.
+        bool has_windows;
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+            has_windows = !m_windows.empty();
+        }
+        std::vector<QString> window_lines;
+        if (has_windows){
+            window_lines.reserve(batch.size());
+            for (const auto& item : batch){
+                window_lines.emplace_back(to_window_str(normalize_newlines(item.first), item.second));
+            }
+        }
+        for (const auto& item : batch){
+            file_buffer += to_file_str(item.first);
+        }
+        uint64_t drops = m_dropped.load(std::memory_order_relaxed);
+        if (drops != reported_drops){
+            file_buffer += to_file_str(
+                "Logger: " + std::to_string(drops - reported_drops) + " line(s) dropped. The log file could not keep up."
+            );
+            reported_drops = drops;
+        }
+        if (!file_buffer.empty()){
+            m_file.write(file_buffer.c_str(), file_buffer.size());
+            unflushed_bytes += file_buffer.size();
+            file_buffer.clear();
+        }
+
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+            //  A window that was added after we checked will pick up from
+            //  the next batch.
+            for (const QString& str : window_lines){
+                for (FileWindowLoggerWindow* window : m_windows){
+                    window->log(str);
+                }
+            }
+            for (auto& item : batch){
+                m_last_log_tracker += std::move(item.first);
+            }
+            m_lines_written += batch.size();
+        }
+
+        //  Flush policy.
+        WallClock now = current_time();
+        bool flush_requested;
+        bool stopping;
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+            flush_requested = m_flush_target > m_lines_flushed;
+            stopping = m_stopping;
+        }
+        if (unflushed_bytes >= FLUSH_BYTES ||
+            (unflushed_bytes > 0 && now - last_flush >= FLUSH_INTERVAL) ||
+            flush_requested || stopping
+        ){
+            if (unflushed_bytes > 0){
+                m_file.flush();
+            }
+            unflushed_bytes = 0;
+            last_flush = now;
+        }
+
+        //  Logging threads only buffer the binary log. It is written here.
+        bool binary_pending = m_binary_log != nullptr &&
+            m_binary_log->write_pending(flush_requested || stopping);
+
+        std::unique_lock<std::mutex> lg(m_lock);
+        if (unflushed_bytes == 0){
+            m_lines_flushed = m_lines_written;
+        }
+        m_done_cv.notify_all();
+
+        if (!batch.empty()){
+            continue;
+        }
         if (m_stopping){
             break;
         }
-        auto& item = m_queue.front();
-        std::string msg = std::move(item.first);
-        Color color = item.second;
-        m_queue.pop_front();
-
-        lg.unlock();
-        internal_log(msg, color);
-        lg.lock();
 
-        if (m_queue.size() <= m_max_queue_size / 2){
-            m_cv.notify_all();
+        //  Nothing to do. Go to sleep until a producer wakes us up or the
+        //  unflushed lines are due.
+        m_writer_sleeping.store(true, std::memory_order_relaxed);
+        //  Pairs with the fence in "wake_writer()".
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!has_pending() && m_flush_target <= m_lines_flushed){
+            if (unflushed_bytes > 0){
+                m_writer_cv.wait_until(lg, last_flush + FLUSH_INTERVAL);
+            }else if (binary_pending){
+                m_writer_cv.wait_for(lg, FLUSH_INTERVAL);
+            }else{
+                m_writer_cv.wait(lg);
+            }
         }
+        m_writer_sleeping.store(false, std::memory_order_relaxed);
     }
+
+    m_file.flush();
 }
 
 
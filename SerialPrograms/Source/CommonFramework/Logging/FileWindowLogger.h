@@ -2,13 +2,22 @@
  *
  *  From: https://github.com/PokemonAutomation/
  *
+ *  Logging threads push lines into a fixed-size lock-free ring. A single
+ *  writer thread drains it in batches, writes them to the file and the
+ *  output windows, and flushes the file on a time/size policy instead of
+ *  after every line. So a slow disk only slows down the writer.
+ *
  */
 
 #ifndef PokemonAutomation_Logging_FileWindowLogger_H
 #define PokemonAutomation_Logging_FileWindowLogger_H
 
+#include <stdint.h>
 #include <deque>
 #include <set>
+#include <memory>
+#include <atomic>
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 #include <QFile>
@@ -22,6 +31,7 @@
 namespace PokemonAutomation{
 
 class FileWindowLoggerWindow;
+class BinaryEventLogFile;
 
 
 class LastLogTracker{
@@ -38,34 +48,100 @@ private:
 };
 
 
+enum class LogOverflowPolicy{
+    //  Wait for the writer to catch up.
+    BLOCK,
+    //  Throw the line away and count it in "dropped_messages()".
+    DROP,
+};
+
+
 class FileWindowLogger : public Logger{
+    //  Flush the file at least this often while there are unflushed lines.
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL = std::chrono::milliseconds(250);
+
+    //  Flush immediately once this many bytes are unflushed.
+    static constexpr size_t FLUSH_BYTES = 64 * 1024;
+
+    //  Max # of lines the writer takes from the ring at once.
+    static constexpr size_t MAX_BATCH = 256;
+
 public:
     ~FileWindowLogger();
     FileWindowLogger(const std::string& path);
 
+    //  "ring_lines" is the # of lines that can wait for the writer before the
+    //  overflow policy kicks in. It is rounded up to a power of two.
+    FileWindowLogger(const std::string& path, size_t ring_lines);
+
     void operator+=(FileWindowLoggerWindow& widget);
     void operator-=(FileWindowLoggerWindow& widget);
 
     virtual void log(const std::string& msg, Color color = Color()) override;
     virtual void log(std::string&& msg, Color color = Color()) override;
+
+    //  Waits for all lines logged before this call to be processed.
     virtual std::vector<std::string> get_last() const override;
 
+    //  Wait until all lines logged before this call have been written and
+    //  flushed to the file. Returns false on timeout.
+    bool flush(std::chrono::milliseconds timeout = std::chrono::milliseconds(2000));
+
+    void set_overflow_policy(LogOverflowPolicy policy);
+    uint64_t dropped_messages() const{ return m_dropped.load(std::memory_order_relaxed); }
+    uint64_t blocked_messages() const{ return m_blocked.load(std::memory_order_relaxed); }
+
 private:
     static std::string normalize_newlines(const std::string& msg);
     static std::string to_file_str(const std::string& msg);
     static QString to_window_str(const std::string& msg, Color color);
 
-    void internal_log(const std::string& msg, Color color);
+    void push(std::string&& msg, Color color);
+    bool try_push(std::string& msg, Color color);
+    bool has_pending() const;
+    void wake_writer();
+    bool wait_for_writer(uint64_t lines, bool flushed, std::chrono::milliseconds timeout) const;
+
     void thread_loop();
 
 private:
+    struct Slot{
+        //  Equal to the ring position when empty. One past it when filled.
+        std::atomic<uint64_t> sequence;
+        std::string msg;
+        Color color;
+    };
+
     QFile m_file;
-    size_t m_max_queue_size;
+    const size_t m_capacity;
+    std::unique_ptr<Slot[]> m_ring;
+
+    //  Producers
+    std::atomic<uint64_t> m_write_index;
+    std::atomic<LogOverflowPolicy> m_policy;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_blocked;
+    std::atomic<size_t> m_producers_waiting;
+    std::atomic<bool> m_writer_sleeping;
+
+    //  Only touched by the writer thread.
+    uint64_t m_read_index;
+
+    //  The global logger's writer thread also writes the binary event log.
+    //  Null for every other logger.
+    BinaryEventLogFile* m_binary_log;
+
+    //  Everything below is protected by "m_lock". Producers only take it to
+    //  wake a sleeping writer or to block on a full ring.
     mutable std::mutex m_lock;
-    std::condition_variable m_cv;
-    LastLogTracker m_last_log_tracker;
+    mutable std::condition_variable m_writer_cv;
+    mutable std::condition_variable m_done_cv;
+    std::condition_variable m_space_cv;
     bool m_stopping;
-    std::deque<std::pair<std::string, Color>> m_queue;
+    mutable uint64_t m_flush_target;
+    uint64_t m_lines_written;
+    uint64_t m_lines_flushed;
+    LastLogTracker m_last_log_tracker;
     std::set<FileWindowLoggerWindow*> m_windows;
     Thread m_thread;
 
@@ -6,6 +6,7 @@
 
 #include <QString>
 #include "Common/Cpp/Time.h"
+#include "BinaryEventLogFile.h"
 #include "Logger.h"
 
 #include <iostream>
@@ -25,8 +26,13 @@ TaggedLogger::TaggedLogger(Logger& logger, std::string tag)
 {}
 
 void TaggedLogger::log(const std::string& msg, Color color){
+    WallClock now = current_time();
+    BinaryEventLogFile& binary_log = BinaryEventLogFile::instance();
+    if (binary_log.enabled()){
+        binary_log.log(now, m_tag, color, msg);
+    }
     std::string str =
-        current_time_to_str() +
+        time_to_str(now) +
         " - [" + m_tag + "]: " +
         msg;
     m_logger.log(std::move(str), color);
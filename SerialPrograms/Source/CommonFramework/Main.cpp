@@ -21,7 +21,7 @@
 #include "Integrations/DppIntegration/DppClient.h"
 #include "Logging/Logger.h"
 #include "Logging/OutputRedirector.h"
-//#include "Tools/StatsDatabase.h"
+#include "ProgramStats/StatsDatabase.h"
 //#include "Windows/DpiScaler.h"
 #include "Startup/SetupSettings.h"
 #include "Startup/NewVersionCheck.h"
@@ -147,6 +147,9 @@ int main(int argc, char *argv[]){
     // Write program settings back to the json file.
     PERSISTENT_SETTINGS().write();
 
+    //  Leave the stats file readable for anyone who opens it.
+    StatsDatabase::instance().compact(GlobalSettings::instance().STATS_FILE);
+
 #ifdef PA_DPP
     Integration::DppClient::Client::instance().disconnect();
 #endif
@@ -8,6 +8,8 @@
 #define PokemonAutomation_PerformanceOptions_H
 
 #include "Common/Cpp/Options/GroupOption.h"
+#include "Common/Cpp/Options/BooleanCheckBoxOption.h"
+#include "Common/Cpp/Options/SimpleIntegerOption.h"
 #include "Common/Cpp/Options/TimeDurationOption.h"
 #include "CommonFramework/Options/ThreadPoolOption.h"
 #include "ProcessPriorityOption.h"
@@ -56,6 +58,31 @@ public:
             DEFAULT_PRIORITY_NORMAL_INFERENCE,
             1.0
         )
+        , PARALLEL_VISUAL_INFERENCE(
+            "<b>Parallel Visual Inference:</b><br>"
+            "Run all the visual inference callbacks that are due on the same "
+            "frame together on the real-time thread pool instead of one at a "
+            "time. This helps when a program runs many detectors at once and "
+            "slow detectors are causing fast ones to miss frames.<br>"
+            "Restart the program for this to take effect.",
+            LockMode::LOCK_WHILE_RUNNING,
+            false
+        )
+        , OCR_MAX_INSTANCES(
+            "<b>Max OCR Instances per Language:</b><br>"
+            "Maximum number of Tesseract instances to keep for each language. "
+            "Each instance holds tens of MB of language data. When all of them "
+            "are busy, further text reads wait for one to free up.",
+            LockMode::UNLOCK_WHILE_RUNNING,
+            8, 1
+        )
+        , OCR_CACHE_SIZE(
+            "<b>OCR Result Cache Size:</b><br>"
+            "Remember the text of this many recently read images. Reading an "
+            "identical image again skips Tesseract entirely. Set to zero to disable.",
+            LockMode::UNLOCK_WHILE_RUNNING,
+            256
+        )
         , PRECISE_WAKE_MARGIN(
             "<b>Precise Wake Time Margin:</b><br>"
             "Some operations require a thread to wake up at a very precise time - "
@@ -76,6 +103,10 @@ public:
 
         PA_ADD_OPTION(REALTIME_THREAD_POOL);
         PA_ADD_OPTION(NORMAL_THREAD_POOL);
+        PA_ADD_OPTION(PARALLEL_VISUAL_INFERENCE);
+
+        PA_ADD_OPTION(OCR_MAX_INSTANCES);
+        PA_ADD_OPTION(OCR_CACHE_SIZE);
 
         PA_ADD_OPTION(PRECISE_WAKE_MARGIN);
     }
@@ -89,6 +120,10 @@ public:
 
     ThreadPoolOption REALTIME_THREAD_POOL;
     ThreadPoolOption NORMAL_THREAD_POOL;
+    BooleanCheckBoxOption PARALLEL_VISUAL_INFERENCE;
+
+    SimpleIntegerOption<size_t> OCR_MAX_INSTANCES;
+    SimpleIntegerOption<size_t> OCR_CACHE_SIZE;
 
     MicrosecondsOption PRECISE_WAKE_MARGIN;
 };
@@ -4,7 +4,12 @@
  *
  */
 
+#include <string.h>
+#include <stdlib.h>
 #include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QLockFile>
 #include <QSaveFile>
 #include "Common/Cpp/Time.h"
 #include "StatsDatabase.h"
@@ -39,6 +44,36 @@ const std::map<std::string, std::string> STATS_DATABASE_ALIASES{
     {"PokemonLZA:BerryBuyer", "PokemonLZA:StallBuyer"},
 };
 
+const char SNAPSHOT_GENERATION_HEADER[] = "Journal Generation: ";
+const char JOURNAL_GENERATION_HEADER[] = "Stats Journal Generation: ";
+
+//  Fold the journal into the snapshot once it gets this large.
+const int64_t JOURNAL_COMPACTION_SIZE = 256 * 1024;
+
+const int STATS_FILE_LOCK_TIMEOUT_MILLIS = 10000;
+
+
+//  Returns 0 if "line" does not start with "header".
+static uint64_t parse_generation(const std::string& line, const char* header){
+    size_t length = strlen(header);
+    if (line.compare(0, length, header) != 0){
+        return 0;
+    }
+    return strtoull(line.c_str() + length, nullptr, 10);
+}
+static std::string journal_header(uint64_t generation){
+    std::string header = JOURNAL_GENERATION_HEADER;
+    header += std::to_string(generation);
+    header += "\r\n";
+    return header;
+}
+static const std::string& resolve_alias(const std::string& identifier){
+    auto iter = STATS_DATABASE_ALIASES.find(identifier);
+    return iter == STATS_DATABASE_ALIASES.end()
+        ? identifier
+        : iter->second;
+}
+
 
 
 StatLine::StatLine(StatsTracker& tracker)
@@ -101,6 +136,11 @@ void StatList::aggregate(StatsTracker& tracker) const{
 //        cout << tracker.to_str() << endl;
     }
 }
+void StatList::aggregate(std::map<std::string, uint64_t>& stats) const{
+    for (const StatLine& line : m_list){
+        parse_stats_line(stats, line.stats());
+    }
+}
 
 
 
@@ -119,6 +159,11 @@ StatList& StatSet::operator[](const std::string& identifier){
 
 std::string StatSet::to_str() const{
     std::string str;
+    if (m_journal_generation != 0){
+        str += SNAPSHOT_GENERATION_HEADER;
+        str += std::to_string(m_journal_generation);
+        str += "\r\n\r\n";
+    }
     for (const auto& item : m_data){
         if (item.second.size() == 0){
             continue;
@@ -155,23 +200,7 @@ bool StatSet::update_file(
     const std::string& identifier,
     StatsTracker& tracker
 ){
-    QFile file(QString::fromStdString(filepath));
-    while (!file.open(QIODevice::ReadWrite)){
-        return false;
-    }
-    std::string data = file.readAll().data();
-
-    StatSet set;
-    set.load_from_string(data.c_str());
-
-    set[identifier] += tracker;
-
-    data = set.to_str();
-    file.seek(0);
-    file.write(data.c_str(), data.size());
-    file.resize(data.size());
-
-    return true;
+    return StatsDatabase::instance().append(filepath, identifier, tracker);
 }
 
 
@@ -196,6 +225,7 @@ bool StatSet::get_line(std::string& line, const char*& ptr){
     }
 }
 void StatSet::load_from_string(const char* ptr){
+    m_journal_generation = 0;
     m_data.clear();
 
     //  Find first section.
@@ -207,6 +237,10 @@ void StatSet::load_from_string(const char* ptr){
         if (line[0] == '='){
             break;
         }
+        uint64_t generation = parse_generation(line, SNAPSHOT_GENERATION_HEADER);
+        if (generation != 0){
+            m_journal_generation = generation;
+        }
     }
 
     while (true){
@@ -218,12 +252,7 @@ void StatSet::load_from_string(const char* ptr){
             continue;
         }
 
-        auto iter = STATS_DATABASE_ALIASES.find(line);
-        if (iter != STATS_DATABASE_ALIASES.end()){
-            line = iter->second;
-        }
-
-        StatList& program = m_data[line];
+        StatList& program = m_data[resolve_alias(line)];
         while (true){
             if (!get_line(line, ptr)){
                 return;
@@ -247,5 +276,251 @@ void StatSet::load_from_string(const char* ptr){
 
 
 
+StatsDatabase& StatsDatabase::instance(){
+    static StatsDatabase database;
+    return database;
+}
+
+bool StatsDatabase::append(
+    const std::string& filepath,
+    const std::string& identifier,
+    StatsTracker& tracker
+){
+    std::lock_guard<std::mutex> lg(m_lock);
+    QLockFile file_lock(QString::fromStdString(filepath + ".lock"));
+    if (!file_lock.tryLock(STATS_FILE_LOCK_TIMEOUT_MILLIS)){
+        return false;
+    }
+
+    refresh(filepath);
+
+    QFile journal(QString::fromStdString(filepath + ".journal"));
+    if (!journal.open(QIODevice::ReadWrite)){
+        return false;
+    }
+    if (journal.size() == 0 || m_journal_generation <= m_snapshot_generation){
+        //  Missing or already folded into the snapshot. Start a new one.
+        m_journal_generation = m_snapshot_generation + 1;
+        std::string header = journal_header(m_journal_generation);
+        if (!journal.resize(0) || journal.write(header.c_str(), header.size()) != (qint64)header.size()){
+            m_loaded = false;
+            return false;
+        }
+        m_journal_offset = header.size();
+    }else if (journal.size() > m_journal_offset){
+        //  Partial record left behind by a writer that didn't finish.
+        journal.resize(m_journal_offset);
+    }
+
+    std::string record = resolve_alias(identifier);
+    record += '\t';
+    record += StatLine(tracker).to_str();
+    journal.seek(m_journal_offset);
+    if (journal.write(record.c_str(), record.size()) != (qint64)record.size() ||
+        journal.write("\r\n", 2) != 2 ||
+        !journal.flush()
+    ){
+        m_loaded = false;
+        return false;
+    }
+    m_journal_offset = journal.pos();
+    add_record(record);
+
+    if (m_journal_offset >= JOURNAL_COMPACTION_SIZE){
+        journal.close();
+        compact_locked(filepath);
+    }
+    return true;
+}
+
+bool StatsDatabase::aggregate(
+    const std::string& filepath,
+    const std::string& identifier,
+    StatsTracker& tracker
+){
+    std::lock_guard<std::mutex> lg(m_lock);
+    bool ok;
+    {
+        QLockFile file_lock(QString::fromStdString(filepath + ".lock"));
+        ok = file_lock.tryLock(STATS_FILE_LOCK_TIMEOUT_MILLIS);
+        if (ok){
+            refresh(filepath);
+        }
+    }
+    if (!m_loaded || m_filepath != filepath){
+        return false;
+    }
+    auto iter = m_totals.find(resolve_alias(identifier));
+    if (iter != m_totals.end()){
+        tracker.add_stats(iter->second);
+    }
+    return ok;
+}
+
+bool StatsDatabase::compact(const std::string& filepath){
+    std::lock_guard<std::mutex> lg(m_lock);
+    QLockFile file_lock(QString::fromStdString(filepath + ".lock"));
+    if (!file_lock.tryLock(STATS_FILE_LOCK_TIMEOUT_MILLIS)){
+        return false;
+    }
+    refresh(filepath);
+
+    //  Don't rewrite the snapshot if there are no new runs to fold in.
+    if (m_journal_generation <= m_snapshot_generation ||
+        m_journal_offset <= (int64_t)journal_header(m_journal_generation).size()
+    ){
+        return true;
+    }
+    return compact_locked(filepath);
+}
+
+
+void StatsDatabase::refresh(const std::string& filepath){
+    QFileInfo snapshot(QString::fromStdString(filepath));
+    int64_t snapshot_size = snapshot.exists() ? snapshot.size() : -1;
+    int64_t snapshot_mtime = snapshot.exists() ? snapshot.lastModified().toMSecsSinceEpoch() : 0;
+
+    QFile journal(QString::fromStdString(filepath + ".journal"));
+    uint64_t journal_generation = 0;
+    int64_t journal_size = 0;
+    if (journal.open(QIODevice::ReadOnly)){
+        journal_generation = parse_generation(journal.readLine().toStdString(), JOURNAL_GENERATION_HEADER);
+        journal_size = journal.size();
+    }
+
+    //  The snapshot is only rewritten together with the journal. So if
+    //  neither has been replaced, only new records need to be read.
+    if (m_loaded &&
+        m_filepath == filepath &&
+        m_snapshot_size == snapshot_size &&
+        m_snapshot_mtime == snapshot_mtime &&
+        m_journal_generation == journal_generation &&
+        m_journal_offset <= journal_size
+    ){
+        read_journal(filepath);
+        return;
+    }
+
+    reload(filepath);
+    m_snapshot_size = snapshot_size;
+    m_snapshot_mtime = snapshot_mtime;
+    m_journal_generation = journal_generation;
+    m_journal_offset = journal.isOpen() ? journal.pos() : 0;
+    read_journal(filepath);
+}
+void StatsDatabase::reload(const std::string& filepath){
+    m_filepath = filepath;
+    m_loaded = true;
+    m_totals.clear();
+
+    StatSet set;
+    set.open_from_file(filepath);
+    m_snapshot_generation = set.journal_generation();
+    for (const auto& item : set.data()){
+        item.second.aggregate(m_totals[item.first]);
+    }
+}
+void StatsDatabase::read_journal(const std::string& filepath){
+    //  Records from a generation that is already in the snapshot are skipped.
+    if (m_journal_generation <= m_snapshot_generation){
+        return;
+    }
+
+    QFile journal(QString::fromStdString(filepath + ".journal"));
+    if (!journal.open(QIODevice::ReadOnly) || !journal.seek(m_journal_offset)){
+        return;
+    }
+    std::string data = journal.readAll().toStdString();
+
+    //  Only consume complete lines. Anything after the last newline is a
+    //  record that is still being written.
+    size_t start = 0;
+    while (true){
+        size_t end = data.find('\n', start);
+        if (end == std::string::npos){
+            break;
+        }
+        size_t length = end - start;
+        if (length > 0 && data[end - 1] == '\r'){
+            length--;
+        }
+        add_record(data.substr(start, length));
+        start = end + 1;
+    }
+    m_journal_offset += start;
+}
+void StatsDatabase::add_record(const std::string& record){
+    size_t pos = record.find('\t');
+    if (pos == std::string::npos){
+        return;
+    }
+    StatLine line(record.substr(pos + 1));
+    parse_stats_line(m_totals[resolve_alias(record.substr(0, pos))], line.stats());
+}
+bool StatsDatabase::compact_locked(const std::string& filepath){
+    //  Called with the file lock held and the cache up to date.
+    StatSet set;
+    set.open_from_file(filepath);
+
+    if (m_journal_generation > m_snapshot_generation){
+        QFile journal(QString::fromStdString(filepath + ".journal"));
+        if (!journal.open(QIODevice::ReadOnly)){
+            return false;
+        }
+        journal.readLine();
+        while (!journal.atEnd() && journal.pos() < m_journal_offset){
+            std::string line = journal.readLine().toStdString();
+            while (!line.empty() && (line.back() == '\n' || line.back() == '\r')){
+                line.pop_back();
+            }
+            size_t pos = line.find('\t');
+            if (pos != std::string::npos){
+                set[resolve_alias(line.substr(0, pos))] += line.substr(pos + 1);
+            }
+        }
+        set.set_journal_generation(m_journal_generation);
+    }
+
+    //  Write the snapshot first. If we stop before the journal is replaced,
+    //  its generation is already in the snapshot and it will be ignored.
+    {
+        QSaveFile file(QString::fromStdString(filepath));
+        if (!file.open(QIODevice::WriteOnly)){
+            return false;
+        }
+        std::string data = set.to_str();
+        file.write(data.c_str(), data.size());
+        if (!file.commit()){
+            return false;
+        }
+    }
+    m_snapshot_generation = set.journal_generation();
+
+    std::string header = journal_header(m_snapshot_generation + 1);
+    {
+        QSaveFile file(QString::fromStdString(filepath + ".journal"));
+        if (!file.open(QIODevice::WriteOnly)){
+            m_loaded = false;
+            return false;
+        }
+        file.write(header.c_str(), header.size());
+        if (!file.commit()){
+            m_loaded = false;
+            return false;
+        }
+    }
+
+    //  The totals don't change. Only where they came from does.
+    QFileInfo snapshot(QString::fromStdString(filepath));
+    m_snapshot_size = snapshot.size();
+    m_snapshot_mtime = snapshot.lastModified().toMSecsSinceEpoch();
+    m_journal_generation = m_snapshot_generation + 1;
+    m_journal_offset = header.size();
+    return true;
+}
+
+
+
+
 }
 
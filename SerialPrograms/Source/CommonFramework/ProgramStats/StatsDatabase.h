@@ -7,6 +7,7 @@
 #ifndef PokemonAutomation_StatsDatabase_H
 #define PokemonAutomation_StatsDatabase_H
 
+#include <mutex>
 #include "StatsTracking.h"
 
 namespace PokemonAutomation{
@@ -38,6 +39,7 @@ public:
     const std::vector<StatLine>& list() const{ return m_list; }
 
     void aggregate(StatsTracker& tracker) const;
+    void aggregate(std::map<std::string, uint64_t>& stats) const;
 
 private:
     std::vector<StatLine> m_list;
@@ -51,11 +53,20 @@ public:
 //    StatList* find(const std::string& label);
     StatList& operator[](const std::string& identifier);
 
+    const std::map<std::string, StatList>& data() const{ return m_data; }
+
+    //  The last journal generation that has been folded into this set.
+    //  See "StatsDatabase" below.
+    uint64_t journal_generation() const{ return m_journal_generation; }
+    void set_journal_generation(uint64_t generation){ m_journal_generation = generation; }
+
     std::string to_str() const;
 
     void save_to_file(const std::string& filepath);
     void open_from_file(const std::string& filepath);
+    void load_from_string(const char* ptr);
 
+    //  Same as "StatsDatabase::instance().append()".
     static bool update_file(
         const std::string& filepath,
         const std::string& identifier,
@@ -64,13 +75,77 @@ public:
 
 private:
     bool get_line(std::string& line, const char*& ptr);
-    void load_from_string(const char* ptr);
 
 private:
+    uint64_t m_journal_generation = 0;
     std::map<std::string, StatList> m_data;
 };
 
 
 
+//  The stats file is stored in two parts:
+//
+//    - "<file>" is the snapshot. It is a StatSet and stays human-readable.
+//    - "<file>.journal" holds the runs added since the snapshot was written.
+//      Saving stats appends a single line to it.
+//
+//  The journal is folded into the snapshot once it gets large and when the
+//  program exits. Both files are only accessed while holding "<file>.lock"
+//  so that multiple instances of the program can share the same stats file.
+//
+//  The totals for each identifier are cached. Each access only reads the
+//  part of the journal that was appended since the previous access.
+class StatsDatabase{
+public:
+    static StatsDatabase& instance();
+
+    //  Append the stats of "tracker" as a new run of "identifier".
+    bool append(
+        const std::string& filepath,
+        const std::string& identifier,
+        StatsTracker& tracker
+    );
+
+    //  Add the totals of all the runs of "identifier" into "tracker".
+    //  Returns false if the file could not be locked. In that case, the
+    //  last known totals are used.
+    bool aggregate(
+        const std::string& filepath,
+        const std::string& identifier,
+        StatsTracker& tracker
+    );
+
+    //  Fold the journal into the snapshot. Does nothing if the journal
+    //  has no runs.
+    bool compact(const std::string& filepath);
+
+
+private:
+    StatsDatabase() = default;
+
+    void refresh(const std::string& filepath);
+    void reload(const std::string& filepath);
+    void read_journal(const std::string& filepath);
+    void add_record(const std::string& record);
+    bool compact_locked(const std::string& filepath);
+
+private:
+    std::mutex m_lock;
+
+    //  What the cached totals were built from.
+    std::string m_filepath;
+    bool m_loaded = false;
+    int64_t m_snapshot_size = -1;
+    int64_t m_snapshot_mtime = 0;
+    uint64_t m_snapshot_generation = 0;
+    uint64_t m_journal_generation = 0;
+    int64_t m_journal_offset = 0;
+
+    //  identifier -> (stat label -> total)
+    std::map<std::string, std::map<std::string, uint64_t>> m_totals;
+};
+
+
+
 }
 #endif
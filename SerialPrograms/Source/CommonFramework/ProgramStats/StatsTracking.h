@@ -36,6 +36,9 @@ public:
 
     void parse_and_append_line(const std::string& line);
 
+    //  Add counts that were already parsed with "parse_stats_line()".
+    void add_stats(const std::map<std::string, uint64_t>& stats);
+
 
 protected:
 //    static constexpr bool HIDDEN_IF_ZERO = true;
@@ -70,6 +73,12 @@ protected:
 };
 
 
+//  Parse a line produced by "StatsTracker::to_str()" and add its counts
+//  into "stats". This is the same parsing as "parse_and_append_line()".
+void parse_stats_line(std::map<std::string, uint64_t>& stats, const std::string& line);
+
+
+
 std::string stats_to_bar(
     Logger& logger,
     const StatsTracker* historical,
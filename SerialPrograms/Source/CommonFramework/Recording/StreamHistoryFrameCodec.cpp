@@ -0,0 +1,232 @@
+/*  Stream History Frame Codec
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <algorithm>
+#include "Common/Compiler.h"
+#include "StreamHistoryFrameCodec.h"
+
+namespace PokemonAutomation{
+
+
+
+namespace{
+
+//  Token layout: If the top bit is set, the lower 15 bits are the length of a
+//  run of zeros. Otherwise, the token is the # of literal words that follow.
+const uint16_t ZERO_RUN_BIT = 0x8000;
+const size_t MAX_RUN = 0x7fff;
+
+
+PA_FORCE_INLINE uint16_t to_rgb565(uint32_t pixel){
+    return (uint16_t)(
+        ((pixel >> 8) & 0xf800) |
+        ((pixel >> 5) & 0x07e0) |
+        ((pixel >> 3) & 0x001f)
+    );
+}
+PA_FORCE_INLINE uint32_t from_rgb565(uint16_t pixel){
+    uint32_t r = (pixel >> 11) & 0x1f;
+    uint32_t g = (pixel >>  5) & 0x3f;
+    uint32_t b = (pixel >>  0) & 0x1f;
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+    return 0xff000000 | (r << 16) | (g << 8) | b;
+}
+
+
+void compress_residuals(std::vector<uint16_t>& out, const uint16_t* residuals, size_t count){
+    out.clear();
+    out.reserve(count / 8);
+
+    size_t c = 0;
+    while (c < count){
+        //  Run of zeros.
+        size_t run = 0;
+        while (c + run < count && run < MAX_RUN && residuals[c + run] == 0){
+            run++;
+        }
+        if (run > 0){
+            out.emplace_back((uint16_t)(ZERO_RUN_BIT | run));
+            c += run;
+            continue;
+        }
+
+        //  Run of literals. A single zero between literals is cheaper to keep
+        //  as a literal than to split the run.
+        run = 0;
+        while (c + run < count && run < MAX_RUN){
+            if (residuals[c + run] == 0 && (c + run + 1 >= count || residuals[c + run + 1] == 0)){
+                break;
+            }
+            run++;
+        }
+        out.emplace_back((uint16_t)run);
+        out.insert(out.end(), residuals + c, residuals + c + run);
+        c += run;
+    }
+
+    out.shrink_to_fit();
+}
+bool decompress_residuals(uint16_t* residuals, size_t count, const std::vector<uint16_t>& in){
+    const uint16_t* ptr = in.data();
+    const uint16_t* end = ptr + in.size();
+    size_t c = 0;
+    while (ptr < end){
+        uint16_t token = *ptr++;
+        size_t run = token & MAX_RUN;
+        if (c + run > count){
+            return false;
+        }
+        if (token & ZERO_RUN_BIT){
+            std::fill(residuals + c, residuals + c + run, (uint16_t)0);
+        }else{
+            if ((size_t)(end - ptr) < run){
+                return false;
+            }
+            std::copy(ptr, ptr + run, residuals + c);
+            ptr += run;
+        }
+        c += run;
+    }
+    return c == count;
+}
+
+
+}
+
+
+
+CompressedFrame StreamHistoryFrameEncoder::encode(WallClock timestamp, const ImageViewRGB32& image, bool keyframe){
+    const size_t width = image.width();
+    const size_t height = image.height();
+    const size_t pixels = width * height;
+
+    if (width != m_width || height != m_height || m_previous.size() != pixels){
+        keyframe = true;
+    }
+    m_width = width;
+    m_height = height;
+
+    m_current.resize(pixels);
+    uint16_t* current = m_current.data();
+    for (size_t r = 0; r < height; r++){
+        const uint32_t* row = (const uint32_t*)((const char*)image.data() + r * image.bytes_per_row());
+        for (size_t c = 0; c < width; c++){
+            current[c] = to_rgb565(row[c]);
+        }
+        current += width;
+    }
+
+    //  Residuals go into "m_previous". It is overwritten with the current
+    //  frame afterwards anyway.
+    m_previous.resize(pixels);
+    uint16_t* residuals = m_previous.data();
+    current = m_current.data();
+    if (keyframe){
+        for (size_t r = 0; r < height; r++){
+            uint16_t left = 0;
+            for (size_t c = 0; c < width; c++){
+                uint16_t pixel = current[c];
+                residuals[c] = pixel ^ left;
+                left = pixel;
+            }
+            current += width;
+            residuals += width;
+        }
+    }else{
+        for (size_t c = 0; c < pixels; c++){
+            residuals[c] ^= current[c];
+        }
+    }
+
+    CompressedFrame frame;
+    frame.timestamp = timestamp;
+    frame.width = width;
+    frame.height = height;
+    frame.keyframe = keyframe;
+    compress_residuals(frame.data, m_previous.data(), pixels);
+
+    std::swap(m_previous, m_current);
+    return frame;
+}
+
+
+
+ImageRGB32 StreamHistoryFrameDecoder::decode(const CompressedFrame& frame){
+    const size_t width = frame.width;
+    const size_t height = frame.height;
+    const size_t pixels = width * height;
+
+    if (!frame.keyframe && (width != m_width || height != m_height || m_previous.size() != pixels)){
+        return ImageRGB32();
+    }
+
+    std::vector<uint16_t> residuals(pixels);
+    if (!decompress_residuals(residuals.data(), pixels, frame.data)){
+        m_previous.clear();
+        return ImageRGB32();
+    }
+
+    m_width = width;
+    m_height = height;
+    m_previous.resize(pixels);
+
+    uint16_t* current = m_previous.data();
+    if (frame.keyframe){
+        const uint16_t* in = residuals.data();
+        for (size_t r = 0; r < height; r++){
+            uint16_t left = 0;
+            for (size_t c = 0; c < width; c++){
+                left ^= in[c];
+                current[c] = left;
+            }
+            current += width;
+            in += width;
+        }
+    }else{
+        for (size_t c = 0; c < pixels; c++){
+            current[c] ^= residuals[c];
+        }
+    }
+
+    ImageRGB32 image(width, height);
+    current = m_previous.data();
+    for (size_t r = 0; r < height; r++){
+        uint32_t* row = (uint32_t*)((char*)image.data() + r * image.bytes_per_row());
+        for (size_t c = 0; c < width; c++){
+            row[c] = from_rgb565(current[c]);
+        }
+        current += width;
+    }
+    return image;
+}
+
+
+
+bool CompressedFrameHistory::push_back(std::shared_ptr<const CompressedFrame> frame){
+    if (!frame->keyframe && m_frames.empty()){
+        return false;
+    }
+    m_bytes += frame->bytes();
+    m_frames.emplace_back(std::move(frame));
+    return true;
+}
+void CompressedFrameHistory::clear_old(WallClock threshold, size_t max_bytes){
+    while (!m_frames.empty()){
+        if (m_frames.front()->timestamp >= threshold && m_bytes <= max_bytes){
+            return;
+        }
+        do{
+            m_bytes -= m_frames.front()->bytes();
+            m_frames.pop_front();
+        }while (!m_frames.empty() && !m_frames.front()->keyframe);
+    }
+}
+
+
+
+}
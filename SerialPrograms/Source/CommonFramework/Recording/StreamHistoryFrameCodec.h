@@ -0,0 +1,108 @@
+/*  Stream History Frame Codec
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      A cheap codec for holding recent video frames in memory.
+ *
+ *  Pixels are reduced to RGB565 which removes most of the capture card noise
+ *  in the low bits. Keyframes store each pixel XOR'ed with its left neighbor.
+ *  Delta frames store each pixel XOR'ed with the same pixel of the previous
+ *  frame. The residuals are then run-length encoded on zeros.
+ *
+ *  Apart from the RGB565 reduction, this is lossless. A delta frame can only
+ *  be decoded after every frame since the preceding keyframe.
+ *
+ */
+
+#ifndef PokemonAutomation_StreamHistoryFrameCodec_H
+#define PokemonAutomation_StreamHistoryFrameCodec_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <deque>
+#include <memory>
+#include "Common/Cpp/Time.h"
+#include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+
+namespace PokemonAutomation{
+
+
+struct CompressedFrame{
+    WallClock timestamp;
+    size_t width = 0;
+    size_t height = 0;
+    bool keyframe = false;
+    std::vector<uint16_t> data;
+
+    size_t bytes() const{
+        return sizeof(CompressedFrame) + data.size() * sizeof(uint16_t);
+    }
+};
+
+
+
+class StreamHistoryFrameEncoder{
+public:
+    //  Force the next frame to be a keyframe.
+    void reset(){
+        m_previous.clear();
+    }
+
+    //  Encode "image" as the next frame. It will be a keyframe if
+    //  "keyframe" is true or if the dimensions have changed.
+    CompressedFrame encode(WallClock timestamp, const ImageViewRGB32& image, bool keyframe);
+
+private:
+    size_t m_width = 0;
+    size_t m_height = 0;
+    std::vector<uint16_t> m_previous;
+    std::vector<uint16_t> m_current;
+};
+
+
+class StreamHistoryFrameDecoder{
+public:
+    //  Decode the next frame. Returns a null image if "frame" is a delta frame
+    //  that does not follow the previous decoded frame.
+    ImageRGB32 decode(const CompressedFrame& frame);
+
+private:
+    size_t m_width = 0;
+    size_t m_height = 0;
+    std::vector<uint16_t> m_previous;
+};
+
+
+
+//  The compressed frames of the stream history, oldest first.
+//
+//  Frames are evicted a keyframe interval at a time since the delta frames
+//  that follow a keyframe cannot be decoded without it. So the history
+//  always starts on a keyframe.
+class CompressedFrameHistory{
+public:
+    using FrameList = std::deque<std::shared_ptr<const CompressedFrame>>;
+
+    bool empty() const{ return m_frames.empty(); }
+    size_t bytes() const{ return m_bytes; }
+    const FrameList& frames() const{ return m_frames; }
+
+    //  Append the next frame. Returns false and drops it if it is a delta
+    //  frame and the history is empty since its keyframe is gone.
+    bool push_back(std::shared_ptr<const CompressedFrame> frame);
+
+    //  Evict the oldest keyframe intervals until the first frame is no older
+    //  than "threshold" and the history takes no more than "max_bytes".
+    void clear_old(WallClock threshold, size_t max_bytes);
+
+private:
+    size_t m_bytes = 0;
+    FrameList m_frames;
+};
+
+
+
+}
+#endif
@@ -37,6 +37,13 @@ StreamHistoryOption::StreamHistoryOption()
         LockMode::UNLOCK_WHILE_RUNNING,
         30
     )
+    , MEMORY_LIMIT_MB(
+        "<b>Memory Limit (MB):</b><br>"
+        "Max memory to use for the history of each video stream. "
+        "If the history does not fit, the oldest part is dropped even if it is within the time limit above.",
+        LockMode::LOCK_WHILE_RUNNING,
+        1024, 64
+    )
     , RESOLUTION(
         "<b>Resolution:</b>",
         {
@@ -83,6 +90,7 @@ StreamHistoryOption::StreamHistoryOption()
 {
     PA_ADD_STATIC(DESCRIPTION);
     PA_ADD_OPTION(HISTORY_SECONDS);
+    PA_ADD_OPTION(MEMORY_LIMIT_MB);
     PA_ADD_OPTION(RESOLUTION);
     PA_ADD_OPTION(ENCODING_MODE);
     PA_ADD_OPTION(VIDEO_QUALITY);
@@ -25,6 +25,7 @@ public:
 
     StaticTextOption DESCRIPTION;
     SimpleIntegerOption<uint16_t> HISTORY_SECONDS;
+    SimpleIntegerOption<uint32_t> MEMORY_LIMIT_MB;
 
     enum class Resolution{
         MATCH_INPUT,
@@ -0,0 +1,332 @@
+/*  Stream History Tracker
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *  Implement by keeping the last X seconds of frames in memory compressed
+ *  with "StreamHistoryFrameCodec". Frames are compressed on a worker thread
+ *  so the video pipeline never waits on it. History is evicted by both time
+ *  and a memory limit.
+ *
+ *  Saving decodes the frames and feeds them into a StreamRecording. This
+ *  runs on the thread that called "save()" without holding any locks that
+ *  the video or audio streams need.
+ *
+ */
+
+#ifndef PokemonAutomation_StreamHistoryTracker_CompressedFrames_H
+#define PokemonAutomation_StreamHistoryTracker_CompressedFrames_H
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <QImage>
+#include <QVideoFrame>
+#include "Common/Cpp/AbstractLogger.h"
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "CommonFramework/GlobalSettingsPanel.h"
+#include "CommonFramework/VideoPipeline/Backends/VideoFrameQt.h"
+#include "CommonFramework/VideoPipeline/Backends/QVideoFrameConversion.h"
+#include "StreamHistoryOption.h"
+#include "StreamHistoryFrameCodec.h"
+#include "StreamRecorder.h"
+
+namespace PokemonAutomation{
+
+
+
+class StreamHistoryTracker{
+    //  Start a new keyframe at least this often.
+    static constexpr std::chrono::milliseconds KEYFRAME_INTERVAL = std::chrono::milliseconds(2000);
+
+    //  Max # of frames waiting to be compressed before new frames are dropped.
+    static constexpr size_t MAX_PENDING_FRAMES = 8;
+
+    //  Max # of decoded frames waiting in the recorder while saving.
+    static constexpr size_t MAX_SAVE_BUFFER = 8;
+
+public:
+    StreamHistoryTracker(
+        Logger& logger,
+        std::chrono::seconds window,
+        size_t audio_samples_per_frame,
+        size_t audio_frames_per_second,
+        bool has_video
+    )
+        : m_logger(logger)
+        , m_window(window)
+        , m_memory_limit((size_t)GlobalSettings::instance().STREAM_HISTORY->MEMORY_LIMIT_MB * 1024 * 1024)
+        , m_audio_samples_per_frame(audio_samples_per_frame)
+        , m_audio_frames_per_second(audio_frames_per_second)
+        , m_microseconds_per_sample(
+            audio_frames_per_second == 0 ? 0 : 1000000. / audio_frames_per_second
+        )
+        , m_has_video(has_video)
+        , m_audio_bytes(0)
+        , m_stopping(false)
+        , m_last_drop(current_time())
+        , m_last_keyframe(WallClock::min())
+    {
+        switch (GlobalSettings::instance().STREAM_HISTORY->RESOLUTION){
+        case StreamHistoryOption::Resolution::MATCH_INPUT:
+            m_max_width = 0;
+            m_max_height = 0;
+            break;
+        case StreamHistoryOption::Resolution::FORCE_720p:
+            m_max_width = 1280;
+            m_max_height = 720;
+            break;
+        case StreamHistoryOption::Resolution::FORCE_1080p:
+            m_max_width = 1920;
+            m_max_height = 1080;
+            break;
+        }
+        if (m_has_video){
+            m_encoder_thread = std::thread(&StreamHistoryTracker::encoder_thread, this);
+        }
+    }
+    ~StreamHistoryTracker(){
+        {
+            std::lock_guard<std::mutex> lg(m_pending_lock);
+            m_stopping = true;
+            m_pending_cv.notify_all();
+        }
+        if (m_encoder_thread.joinable()){
+            m_encoder_thread.join();
+        }
+    }
+
+    void set_window(std::chrono::seconds window){
+        WriteSpinLock lg(m_lock);
+        m_window = window;
+        clear_old();
+    }
+
+    bool save(const std::string& filename){
+        m_logger.log("Saving stream history...", COLOR_BLUE);
+
+        //  Fast copy the current state of the stream.
+        std::deque<std::shared_ptr<const AudioBlock>> audio;
+        CompressedFrameHistory::FrameList frames;
+        {
+            WriteSpinLock lg(m_lock);
+            audio = m_audio;
+            frames = m_frames.frames();
+        }
+        if (audio.empty() && frames.empty()){
+            m_logger.log("Cannot save stream history. History is empty.", COLOR_RED);
+            return false;
+        }
+
+        WallClock start = WallClock::max();
+        WallClock end = WallClock::min();
+        if (!audio.empty()){
+            start = std::min(start, audio.front()->timestamp);
+            end = std::max(end, audio.back()->timestamp);
+        }
+        if (!frames.empty()){
+            start = std::min(start, frames.front()->timestamp);
+            end = std::max(end, frames.back()->timestamp);
+        }
+
+        //  The recorder never drops anything here since everything we push is
+        //  within this window. Video is throttled below instead.
+        StreamRecording recording(
+            m_logger,
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - start) + std::chrono::seconds(1),
+            current_time(),
+            m_audio_samples_per_frame,
+            m_audio_frames_per_second,
+            m_has_video
+        );
+
+        for (const std::shared_ptr<const AudioBlock>& block : audio){
+            recording.push_samples(
+                block->timestamp,
+                block->samples.data(),
+                block->samples.size() / m_audio_samples_per_frame
+            );
+        }
+
+        StreamHistoryFrameDecoder decoder;
+        for (const std::shared_ptr<const CompressedFrame>& frame : frames){
+            ImageRGB32 image = decoder.decode(*frame);
+            if (!image){
+                continue;
+            }
+
+            QVideoFrame video_frame(image.to_QImage_owning());
+            qint64 start_us = std::chrono::duration_cast<std::chrono::microseconds>(frame->timestamp - start).count();
+            video_frame.setStartTime(start_us);
+
+            recording.wait_for_frame_buffer(MAX_SAVE_BUFFER);
+            recording.push_frame(std::make_shared<VideoFrame>(frame->timestamp, std::move(video_frame)));
+        }
+
+        bool ret = recording.stop_and_save(filename);
+        m_logger.log("Done saving stream history...", COLOR_BLUE);
+        return ret;
+    }
+
+
+    void on_samples(const float* samples, size_t frames){
+        if (frames == 0 || m_audio_samples_per_frame == 0){
+            return;
+        }
+        WallClock now = current_time();
+        std::shared_ptr<const AudioBlock> block = std::make_shared<AudioBlock>(
+            now, samples, frames * m_audio_samples_per_frame
+        );
+        WriteSpinLock lg(m_lock);
+        m_audio.emplace_back(std::move(block));
+        m_audio_bytes += m_audio.back()->samples.size() * sizeof(float);
+        clear_old();
+    }
+    void on_frame(std::shared_ptr<const VideoFrame> frame){
+        if (!m_has_video){
+            return;
+        }
+        std::lock_guard<std::mutex> lg(m_pending_lock);
+        if (m_pending.size() >= MAX_PENDING_FRAMES){
+            //  Throttle the prints.
+            WallClock now = current_time();
+            if (now - m_last_drop > std::chrono::seconds(5)){
+                m_last_drop = now;
+                m_logger.log("Unable to keep up with stream history. Dropping frames.", COLOR_RED);
+            }
+            return;
+        }
+        m_pending.emplace_back(std::move(frame));
+        m_pending_cv.notify_all();
+    }
+
+
+private:
+    void encoder_thread(){
+        StreamHistoryFrameEncoder encoder;
+        while (true){
+            std::shared_ptr<const VideoFrame> frame;
+            {
+                std::unique_lock<std::mutex> lg(m_pending_lock);
+                m_pending_cv.wait(lg, [this]{
+                    return m_stopping || !m_pending.empty();
+                });
+                if (m_stopping){
+                    return;
+                }
+                frame = std::move(m_pending.front());
+                m_pending.pop_front();
+            }
+
+            try{
+                encode_frame(encoder, *frame);
+            }catch (...){
+                m_logger.log("Exception thrown while compressing stream history frame.", COLOR_RED);
+                encoder.reset();
+            }
+        }
+    }
+    void encode_frame(StreamHistoryFrameEncoder& encoder, const VideoFrame& frame){
+        ImageRGB32 image = convert_QVideoFrame_native(frame.frame);
+        if (!image){
+            QImage qimage = frame.frame.toImage();
+            if (qimage.isNull()){
+                return;
+            }
+            image = ImageRGB32(qimage.convertToFormat(QImage::Format_ARGB32));
+        }
+        if (m_max_width != 0 && (image.width() > m_max_width || image.height() > m_max_height)){
+            image = image.scale_to(m_max_width, m_max_height);
+        }
+
+        //  "clear_old()" evicts a keyframe together with its delta frames so
+        //  the history always starts on a keyframe. If it has emptied the
+        //  history, there is nothing left for a delta frame to follow.
+        bool keyframe = frame.timestamp >= m_last_keyframe + KEYFRAME_INTERVAL;
+        {
+            WriteSpinLock lg(m_lock);
+            keyframe |= m_frames.empty();
+        }
+
+        std::shared_ptr<CompressedFrame> compressed = std::make_shared<CompressedFrame>(
+            encoder.encode(frame.timestamp, image, keyframe)
+        );
+        if (compressed->keyframe){
+            m_last_keyframe = frame.timestamp;
+        }
+
+        WriteSpinLock lg(m_lock);
+        //  A delta frame is useless if its keyframe has already been evicted.
+        if (!m_frames.push_back(std::move(compressed))){
+            encoder.reset();
+            return;
+        }
+        clear_old();
+    }
+
+    void clear_old(){
+        //  Must call under lock.
+        WallClock now = current_time();
+        WallClock threshold = now - m_window;
+
+        m_frames.clear_old(
+            threshold,
+            m_memory_limit > m_audio_bytes ? m_memory_limit - m_audio_bytes : 0
+        );
+
+        //  Audio is small. It only goes over the memory limit when there are
+        //  no frames left to evict.
+        while (!m_audio.empty()){
+            const AudioBlock& block = *m_audio.front();
+
+            WallClock end_block = block.timestamp;
+            end_block += std::chrono::microseconds(
+                static_cast<std::chrono::microseconds::rep>(
+                    (double)(block.samples.size() / m_audio_samples_per_frame) * m_microseconds_per_sample
+                )
+            );
+
+            if (end_block < threshold || m_frames.bytes() + m_audio_bytes > m_memory_limit){
+                m_audio_bytes -= block.samples.size() * sizeof(float);
+                m_audio.pop_front();
+            }else{
+                break;
+            }
+        }
+    }
+
+
+private:
+    Logger& m_logger;
+    mutable SpinLock m_lock;
+    std::chrono::seconds m_window;
+    const size_t m_memory_limit;
+    const size_t m_audio_samples_per_frame;
+    const size_t m_audio_frames_per_second;
+    const double m_microseconds_per_sample;
+    const bool m_has_video;
+    size_t m_max_width;
+    size_t m_max_height;
+
+    //  Protected by "m_lock".
+    size_t m_audio_bytes;
+    std::deque<std::shared_ptr<const AudioBlock>> m_audio;
+    CompressedFrameHistory m_frames;
+
+    //  Frames waiting to be compressed.
+    std::mutex m_pending_lock;
+    std::condition_variable m_pending_cv;
+    bool m_stopping;
+    std::deque<std::shared_ptr<const VideoFrame>> m_pending;
+    WallClock m_last_drop;
+
+    //  Only touched by the encoder thread.
+    WallClock m_last_keyframe;
+
+    std::thread m_encoder_thread;
+};
+
+
+
+}
+#endif
@@ -207,6 +207,13 @@ void StreamRecording::push_frame(std::shared_ptr<const VideoFrame> frame){
     m_cv.notify_all();
 #endif
 }
+void StreamRecording::wait_for_frame_buffer(size_t max_frames){
+    auto scope_check = m_santizer.check_scope();
+    std::unique_lock<std::mutex> lg(m_lock);
+    m_cv.wait(lg, [&]{
+        return m_stopping || m_buffered_frames.size() < max_frames;
+    });
+}
 
 
 
@@ -353,6 +360,7 @@ void StreamRecording::internal_run(){
             if (!current_frame && !m_buffered_frames.empty()){
                 current_frame = std::move(m_buffered_frames.front());
                 m_buffered_frames.pop_front();
+                m_cv.notify_all();
             }
 
             if (!current_audio.is_valid() && !current_frame){
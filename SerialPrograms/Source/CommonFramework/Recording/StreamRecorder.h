@@ -123,6 +123,10 @@ public:
     void push_samples(WallClock timestamp, const float* data, size_t frames);
     void push_frame(std::shared_ptr<const VideoFrame> frame);
 
+    //  Block until fewer than "max_frames" video frames are waiting to be
+    //  encoded. Use this to throttle pushing frames faster than real time.
+    void wait_for_frame_buffer(size_t max_frames);
+
     bool stop_and_save(const std::string& filename);
 
 private:
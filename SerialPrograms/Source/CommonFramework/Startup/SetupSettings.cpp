@@ -16,6 +16,7 @@
 #include "Common/Cpp/AbstractLogger.h"
 #include "CommonFramework/Globals.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
+#include "CommonFramework/ProgramStats/StatsDatabase.h"
 #include "SetupSettings.h"
 
 #include <iostream>
@@ -88,6 +89,16 @@ bool migrate_stats(Logger& logger){
 
     const std::string new_path = GlobalSettings::instance().STATS_FILE.default_value();
 
+    //  Runs that haven't been folded into the stats file yet are in its
+    //  journal. Fold them in so the stats file has everything.
+    QFile cur_dir_journal(QString::fromStdString(path + ".journal"));
+    if (cur_dir_journal.exists()){
+        logger.log("Folding the old stats journal into the old stats file...");
+        if (!StatsDatabase::instance().compact(path)){
+            logger.log("Unable to fold the old stats journal. It will be moved as is.", COLOR_RED);
+        }
+    }
+
     // old location: current working directory
     QFile cur_dir_file(QString::fromStdString(path));
     // new location: 
@@ -107,6 +118,10 @@ bool migrate_stats(Logger& logger){
     if (cur_dir_file.exists() && !folder_file.exists()){
         logger.log("Migrating old stats file to the folder...");
         cur_dir_file.copy(folder_file.fileName());
+        if (cur_dir_journal.exists()){
+            cur_dir_journal.copy(folder_file.fileName() + ".journal");
+            cur_dir_journal.rename(cur_dir_journal.fileName() + ".bak");
+        }
         logger.log("Renaming old stats file as backup...");
         cur_dir_file.rename(cur_dir_file.fileName() + ".bak");
         GlobalSettings::instance().STATS_FILE.restore_defaults();
@@ -114,6 +114,9 @@ public:
     virtual VideoSnapshot snapshot_recent_nonblocking(WallClock min_time) override{
         return m_snapshot_manager.snapshot_recent_nonblocking(min_time);
     }
+    virtual VideoRegionSnapshot snapshot_regions_nonblocking(WallClock min_time) override{
+        return m_snapshot_manager.snapshot_regions_nonblocking(min_time);
+    }
 
     virtual QWidget* make_display_QtWidget(QWidget* parent) override;
 
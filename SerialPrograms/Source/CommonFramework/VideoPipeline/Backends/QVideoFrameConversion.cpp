@@ -0,0 +1,290 @@
+/*  QVideoFrame Conversion
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <algorithm>
+#include "QVideoFrameConversion.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+
+
+
+namespace{
+
+bool get_yuv_format(QVideoFrameFormat::PixelFormat format, Kernels::YUVFormat& yuv_format){
+    switch (format){
+    case QVideoFrameFormat::Format_NV12:
+        yuv_format = Kernels::YUVFormat::NV12;
+        return true;
+    case QVideoFrameFormat::Format_YUV420P:
+        yuv_format = Kernels::YUVFormat::I420;
+        return true;
+    case QVideoFrameFormat::Format_YUYV:
+        yuv_format = Kernels::YUVFormat::YUY2;
+        return true;
+    case QVideoFrameFormat::Format_UYVY:
+        yuv_format = Kernels::YUVFormat::UYVY;
+        return true;
+    default:
+        return false;
+    }
+}
+
+Kernels::YUVToRGBCoefficients get_coefficients(const QVideoFrameFormat& format){
+#if QT_VERSION >= 0x060400
+    bool full_range = format.colorRange() == QVideoFrameFormat::ColorRange_Full;
+    switch (format.colorSpace()){
+    case QVideoFrameFormat::ColorSpace_BT601:
+        return Kernels::YUVToRGBCoefficients::BT601(full_range);
+    case QVideoFrameFormat::ColorSpace_BT709:
+        return Kernels::YUVToRGBCoefficients::BT709(full_range);
+    default:;
+    }
+#else
+    bool full_range = false;
+    switch (format.yCbCrColorSpace()){
+    case QVideoFrameFormat::YCbCr_BT601:
+        return Kernels::YUVToRGBCoefficients::BT601(false);
+    case QVideoFrameFormat::YCbCr_BT709:
+        return Kernels::YUVToRGBCoefficients::BT709(false);
+    case QVideoFrameFormat::YCbCr_JPEG:
+        return Kernels::YUVToRGBCoefficients::BT601(true);
+    default:;
+    }
+#endif
+
+    //  Unspecified. Go by the resolution like most decoders do.
+    return format.frameHeight() >= 720
+        ? Kernels::YUVToRGBCoefficients::BT709(full_range)
+        : Kernels::YUVToRGBCoefficients::BT601(full_range);
+}
+
+}
+
+
+
+MappedYUVFrame::MappedYUVFrame(QVideoFrame frame)
+    : m_frame(std::move(frame))
+    , m_mapped(false)
+    , m_view{}
+    , m_coefficients{}
+{
+    if (!m_frame.isValid()){
+        return;
+    }
+
+    Kernels::YUVFormat format;
+    if (!get_yuv_format(m_frame.pixelFormat(), format)){
+        return;
+    }
+
+    if (m_frame.width() <= 0 || m_frame.height() <= 0){
+        return;
+    }
+
+#if (QT_VERSION_MAJOR == 6) && (QT_VERSION_MINOR >= 8)
+    if (!m_frame.map(QtVideo::MapMode::ReadOnly)){
+        return;
+    }
+#else
+    if (!m_frame.map(QVideoFrame::ReadOnly)){
+        return;
+    }
+#endif
+
+    int planes = m_frame.planeCount();
+    int expected_planes = 1;
+    switch (format){
+    case Kernels::YUVFormat::NV12:
+        expected_planes = 2;
+        break;
+    case Kernels::YUVFormat::I420:
+        expected_planes = 3;
+        break;
+    default:;
+    }
+    if (planes < expected_planes){
+        m_frame.unmap();
+        return;
+    }
+
+    m_view.format = format;
+    m_view.width = m_frame.width();
+    m_view.height = m_frame.height();
+    for (int c = 0; c < expected_planes; c++){
+        m_view.planes[c] = m_frame.bits(c);
+        m_view.bytes_per_row[c] = m_frame.bytesPerLine(c);
+        if (m_view.planes[c] == nullptr){
+            m_frame.unmap();
+            return;
+        }
+    }
+    m_coefficients = get_coefficients(m_frame.surfaceFormat());
+    m_mapped = true;
+}
+MappedYUVFrame::~MappedYUVFrame(){
+    if (m_mapped){
+        m_frame.unmap();
+    }
+}
+
+Kernels::YUVFrameView MappedYUVFrame::sub_view(size_t& x, size_t& y, size_t width, size_t height) const{
+    x &= ~(size_t)1;
+    y &= ~(size_t)1;
+
+    Kernels::YUVFrameView ret = m_view;
+    ret.width = width;
+    ret.height = height;
+    switch (m_view.format){
+    case Kernels::YUVFormat::NV12:
+        ret.planes[0] += y * m_view.bytes_per_row[0] + x;
+        ret.planes[1] += (y / 2) * m_view.bytes_per_row[1] + x;
+        break;
+    case Kernels::YUVFormat::I420:
+        ret.planes[0] += y * m_view.bytes_per_row[0] + x;
+        ret.planes[1] += (y / 2) * m_view.bytes_per_row[1] + x / 2;
+        ret.planes[2] += (y / 2) * m_view.bytes_per_row[2] + x / 2;
+        break;
+    case Kernels::YUVFormat::YUY2:
+    case Kernels::YUVFormat::UYVY:
+        ret.planes[0] += y * m_view.bytes_per_row[0] + 2 * x;
+        break;
+    }
+    return ret;
+}
+
+ImageRGB32 MappedYUVFrame::to_image() const{
+    if (!m_mapped){
+        return ImageRGB32();
+    }
+    ImageRGB32 image(m_view.width, m_view.height);
+    Kernels::convert_yuv_to_rgb32(m_view, image.data(), image.bytes_per_row(), m_coefficients);
+    return image;
+}
+
+
+
+QVideoFrameRegions::QVideoFrameRegions(QVideoFrame frame)
+    : m_frame(std::move(frame))
+    , m_full_converting(false)
+{}
+
+const QVideoFrameRegions::CachedRegion* QVideoFrameRegions::find_region(const ImagePixelBox& box) const{
+    for (const CachedRegion& cached : m_regions){
+        if (cached.box.encloses(box)){
+            return &cached;
+        }
+    }
+    return nullptr;
+}
+ImageViewRGB32 QVideoFrameRegions::region(const ImagePixelBox& box){
+    size_t frame_width = m_frame.width();
+    size_t frame_height = m_frame.height();
+    size_t min_x = std::min(box.min_x, frame_width);
+    size_t min_y = std::min(box.min_y, frame_height);
+    size_t max_x = std::min(std::max(box.max_x, min_x), frame_width);
+    size_t max_y = std::min(std::max(box.max_y, min_y), frame_height);
+    if (min_x == max_x || min_y == max_y){
+        return ImageViewRGB32();
+    }
+    ImagePixelBox clipped(min_x, min_y, max_x, max_y);
+
+    //  Start on an even corner so that chroma stays aligned. The size must be
+    //  taken from the aligned corner or the last row and column will be short.
+    size_t x = min_x & ~(size_t)1;
+    size_t y = min_y & ~(size_t)1;
+    Kernels::YUVFrameView view = m_frame.sub_view(x, y, max_x - x, max_y - y);
+
+    CachedRegion* claimed;
+    {
+        std::unique_lock<std::mutex> lg(m_lock);
+        while (true){
+            if (m_full){
+                return m_full->sub_image(min_x, min_y, max_x - min_x, max_y - min_y);
+            }
+            const CachedRegion* cached = find_region(clipped);
+            if (cached == nullptr){
+                break;
+            }
+            if (cached->ready){
+                return cached->image.sub_image(
+                    min_x - cached->box.min_x, min_y - cached->box.min_y,
+                    max_x - min_x, max_y - min_y
+                );
+            }
+
+            //  Another callback is converting this region. Wait for it.
+            m_cv.wait(lg);
+        }
+
+        //  Claim it so that nobody else converts it at the same time.
+        claimed = &m_regions.emplace_back(CachedRegion{ImagePixelBox(x, y, max_x, max_y), ImageRGB32(), false});
+    }
+
+    try{
+        ImageRGB32 image(view.width, view.height);
+        Kernels::convert_yuv_to_rgb32(view, image.data(), image.bytes_per_row(), m_frame.coefficients());
+        claimed->image = std::move(image);
+    }catch (...){
+        //  Leave an empty entry behind. It can't enclose anything.
+        std::lock_guard<std::mutex> lg(m_lock);
+        claimed->box = ImagePixelBox(0, 0, 0, 0);
+        claimed->ready = true;
+        m_cv.notify_all();
+        throw;
+    }
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        claimed->ready = true;
+        m_cv.notify_all();
+    }
+    return claimed->image.sub_image(
+        min_x - x, min_y - y,
+        max_x - min_x, max_y - min_y
+    );
+}
+std::shared_ptr<const ImageRGB32> QVideoFrameRegions::full_frame(){
+    {
+        std::unique_lock<std::mutex> lg(m_lock);
+        m_cv.wait(lg, [this]{ return m_full || !m_full_converting; });
+        if (m_full){
+            return m_full;
+        }
+        m_full_converting = true;
+    }
+
+    std::shared_ptr<const ImageRGB32> full;
+    try{
+        full = std::make_shared<const ImageRGB32>(m_frame.to_image());
+    }catch (...){
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_full_converting = false;
+        m_cv.notify_all();
+        throw;
+    }
+
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_full = full;
+    m_full_converting = false;
+    m_cv.notify_all();
+    return m_full;
+}
+
+
+
+ImageRGB32 convert_QVideoFrame_native(const QVideoFrame& frame){
+    MappedYUVFrame mapped(frame);
+    return mapped.to_image();
+}
+
+
+
+
+}
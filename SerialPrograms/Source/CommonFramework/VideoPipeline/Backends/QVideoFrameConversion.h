@@ -0,0 +1,107 @@
+/*  QVideoFrame Conversion
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Convert QVideoFrames straight into ImageRGB32 for the YUV formats that
+ *  capture cards commonly deliver. This skips QVideoFrame::toImage() and the
+ *  QImage format conversion that follows it.
+ *
+ */
+
+#ifndef PokemonAutomation_VideoPipeline_QVideoFrameConversion_H
+#define PokemonAutomation_VideoPipeline_QVideoFrameConversion_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <QVideoFrame>
+#include "Kernels/VideoFrameConversion/Kernels_VideoFrameConversion.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "CommonFramework/VideoPipeline/VideoRegionSnapshot.h"
+
+namespace PokemonAutomation{
+
+
+//  Maps a QVideoFrame for reading and exposes its planes as a YUV frame view.
+//  If the frame isn't in a supported format or can't be mapped, this will be
+//  invalid. (operator bool returns false)
+class MappedYUVFrame{
+public:
+    MappedYUVFrame(const MappedYUVFrame&) = delete;
+    void operator=(const MappedYUVFrame&) = delete;
+
+public:
+    MappedYUVFrame(QVideoFrame frame);
+    ~MappedYUVFrame();
+
+    explicit operator bool() const{ return m_mapped; }
+
+    size_t width() const{ return m_view.width; }
+    size_t height() const{ return m_view.height; }
+
+    const Kernels::YUVFrameView& view() const{ return m_view; }
+    const Kernels::YUVToRGBCoefficients& coefficients() const{ return m_coefficients; }
+
+    //  Returns a view of the rectangle (x, y, width, height) of this frame.
+    //  "x" and "y" are rounded down to even numbers so that chroma stays
+    //  aligned. The actual starting position is written back to (x, y).
+    Kernels::YUVFrameView sub_view(size_t& x, size_t& y, size_t width, size_t height) const;
+
+    //  Convert the whole frame.
+    ImageRGB32 to_image() const;
+
+private:
+    QVideoFrame m_frame;
+    bool m_mapped;
+    Kernels::YUVFrameView m_view;
+    Kernels::YUVToRGBCoefficients m_coefficients;
+};
+
+
+//  Keeps a frame mapped and converts only the regions that are asked for.
+//  Converted regions are cached so repeated or overlapping requests are free.
+//
+//  The lock is only held to claim a region and to publish it. The conversion
+//  itself runs outside of it so that callbacks asking for different regions
+//  don't wait on each other.
+class QVideoFrameRegions : public VideoFrameRegions{
+public:
+    QVideoFrameRegions(QVideoFrame frame);
+
+    //  Returns false if the frame can't be converted natively.
+    explicit operator bool() const{ return (bool)m_frame; }
+
+    virtual size_t width() const override{ return m_frame.width(); }
+    virtual size_t height() const override{ return m_frame.height(); }
+
+    virtual ImageViewRGB32 region(const ImagePixelBox& box) override;
+    virtual std::shared_ptr<const ImageRGB32> full_frame() override;
+
+private:
+    struct CachedRegion{
+        ImagePixelBox box;
+        ImageRGB32 image;   //  Only touched by the converting thread until "ready".
+        bool ready;
+    };
+
+    //  Must call under the lock.
+    const CachedRegion* find_region(const ImagePixelBox& box) const;
+
+private:
+    MappedYUVFrame m_frame;
+
+    std::mutex m_lock;
+    std::condition_variable m_cv;
+    std::deque<CachedRegion> m_regions;
+    std::shared_ptr<const ImageRGB32> m_full;
+    bool m_full_converting;
+};
+
+
+//  Returns a null image if the frame can't be converted natively.
+ImageRGB32 convert_QVideoFrame_native(const QVideoFrame& frame);
+
+
+
+}
+#endif
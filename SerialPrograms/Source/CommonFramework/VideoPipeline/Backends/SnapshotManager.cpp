@@ -7,6 +7,7 @@
 #include "Common/Cpp/Concurrency/ReverseLockGuard.h"
 #include "Common/Cpp/Concurrency/AsyncTask.h"
 #include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "QVideoFrameConversion.h"
 #include "SnapshotManager.h"
 
 //#include <iostream>
@@ -28,6 +29,7 @@ SnapshotManager::SnapshotManager(Logger& logger, QVideoFrameCache& cache)
     , m_active_conversions(0)
     , m_converting_seqnum(0)
     , m_converted_seqnum(0)
+    , m_region_seqnum(0)
     , m_stats_conversion("ConvertFrame", "ms", 1000, std::chrono::seconds(10))
 {}
 
@@ -40,12 +42,19 @@ QImage SnapshotManager::frame_to_image(const QVideoFrame& frame){
     }
     return image;
 }
+ImageRGB32 SnapshotManager::convert_frame(const QVideoFrame& frame){
+    ImageRGB32 image = convert_QVideoFrame_native(frame);
+    if (image){
+        return image;
+    }
+    return ImageRGB32(frame_to_image(frame));
+}
 void SnapshotManager::convert(uint64_t seqnum, QVideoFrame frame, WallClock timestamp) noexcept{
     VideoSnapshot snapshot;
     snapshot.timestamp = timestamp;
     try{
         WallClock time0 = current_time();
-        snapshot.frame = std::make_shared<const ImageRGB32>(frame_to_image(frame));
+        snapshot.frame = std::make_shared<const ImageRGB32>(convert_frame(frame));
         WallClock time1 = current_time();
         uint32_t microseconds = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count();
         m_stats_conversion.report_data(m_logger, microseconds);
@@ -174,7 +183,7 @@ VideoSnapshot SnapshotManager::snapshot_latest_blocking(){
         {
             ReverseLockGuard<std::mutex> lg0(m_lock);
             WallClock time0 = current_time();
-            snapshot = VideoSnapshot(frame_to_image(frame), timestamp);
+            snapshot = VideoSnapshot(convert_frame(frame), timestamp);
             WallClock time1 = current_time();
             microseconds = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count();
         }
@@ -248,6 +257,55 @@ VideoSnapshot SnapshotManager::snapshot_recent_nonblocking(WallClock min_time){
 #endif
 }
 
+VideoRegionSnapshot SnapshotManager::snapshot_regions_nonblocking(WallClock min_time){
+    {
+        std::unique_lock<std::mutex> lg(m_lock);
+
+        //  The full frame is already converted. Use it.
+        uint64_t seqnum = m_cache.seqnum();
+        if (seqnum <= m_converted_seqnum){
+            if (min_time <= m_converted_snapshot.timestamp){
+                return VideoRegionSnapshot(m_converted_snapshot.frame, m_converted_snapshot.timestamp);
+            }
+            return VideoRegionSnapshot();
+        }
+
+        if (seqnum > m_region_seqnum){
+            QVideoFrame frame;
+            WallClock timestamp;
+            seqnum = m_cache.get_latest(frame, timestamp);
+
+            //  Mapping the frame can be slow. Don't hold the lock for it.
+            std::shared_ptr<QVideoFrameRegions> regions;
+            {
+                ReverseLockGuard<std::mutex> lg0(m_lock);
+                regions = std::make_shared<QVideoFrameRegions>(std::move(frame));
+            }
+
+            //  Another thread may have published a newer frame meanwhile.
+            if (seqnum > m_region_seqnum){
+                m_region_seqnum = seqnum;
+                if (*regions){
+                    m_region_snapshot = VideoRegionSnapshot(std::move(regions), timestamp);
+                }else{
+                    m_region_snapshot.clear();
+                }
+            }
+        }
+
+        if (m_region_snapshot){
+            if (min_time <= m_region_snapshot.timestamp){
+                return m_region_snapshot;
+            }
+            return VideoRegionSnapshot();
+        }
+    }
+
+    //  Unsupported format. Fall back to converting the whole frame.
+    VideoSnapshot snapshot = snapshot_recent_nonblocking(min_time);
+    return VideoRegionSnapshot(std::move(snapshot.frame), snapshot.timestamp);
+}
+
 
 
 
@@ -27,8 +27,16 @@ public:
     VideoSnapshot snapshot_latest_blocking();
     VideoSnapshot snapshot_recent_nonblocking(WallClock min_time);
 
+    //  Returns the latest frame without converting it. Regions are converted
+    //  when they are asked for. All callers get the same object for the same
+    //  frame so they share the conversions.
+    VideoRegionSnapshot snapshot_regions_nonblocking(WallClock min_time);
+
 private:
+    //  Slow path that goes through QImage. Handles every format Qt does.
     static QImage frame_to_image(const QVideoFrame& frame);
+    //  Tries the native YUV conversion first. Falls back to "frame_to_image()".
+    static ImageRGB32 convert_frame(const QVideoFrame& frame);
     void convert(uint64_t seqnum, QVideoFrame frame, WallClock timestamp) noexcept;
     bool try_dispatch_conversion(uint64_t seqnum, QVideoFrame frame, WallClock timestamp) noexcept;
     void dispatch_conversion(uint64_t seqnum, QVideoFrame frame, WallClock timestamp) noexcept;
@@ -49,6 +57,11 @@ private:
     uint64_t m_converted_seqnum;
     VideoSnapshot m_converted_snapshot;
 
+    //  The region snapshot for "m_region_seqnum". If this is null, then that
+    //  frame can't be converted piecewise.
+    uint64_t m_region_seqnum;
+    VideoRegionSnapshot m_region_snapshot;
+
     PeriodicStatsReporterI32 m_stats_conversion;
 };
 
@@ -0,0 +1,45 @@
+/*  OCR Pool Stats
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "Common/Cpp/PrettyPrint.h"
+#include "CommonTools/OCR/OCR_RawOCR.h"
+#include "OcrPoolStats.h"
+
+namespace PokemonAutomation{
+
+
+
+OverlayStatSnapshot OcrPoolStat::get_current(){
+    OCR::PoolStats stats = OCR::pool_stats();
+
+    uint64_t lookups = stats.cache_hits + stats.cache_misses;
+    if (stats.instances == 0 && lookups == 0){
+        return OverlayStatSnapshot{"OCR: ---"};
+    }
+
+    OverlayStatSnapshot ret;
+    ret.text = "OCR: " + std::to_string(stats.busy) + "/" + std::to_string(stats.instances) + " busy";
+    if (stats.waiting != 0){
+        ret.text += ", " + std::to_string(stats.waiting) + " waiting";
+        ret.color = COLOR_ORANGE;
+    }
+    if (stats.memory != 0){
+        ret.text += ", ~" + tostr_bytes(stats.memory);
+    }
+    if (stats.waits != 0){
+        double ms = std::chrono::duration_cast<std::chrono::microseconds>(stats.total_wait).count() / 1000.;
+        ret.text += ", wait " + tostr_fixed(ms / stats.waits, 1) + " ms";
+    }
+    if (lookups != 0){
+        ret.text += ", cache " + tostr_fixed(100. * stats.cache_hits / lookups, 1) + "%";
+    }
+    return ret;
+}
+
+
+
+
+}
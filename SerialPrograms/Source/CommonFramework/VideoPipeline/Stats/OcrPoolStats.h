@@ -0,0 +1,25 @@
+/*  OCR Pool Stats
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_OcrPoolStats_H
+#define PokemonAutomation_OcrPoolStats_H
+
+#include "CommonFramework/VideoPipeline/VideoOverlayTypes.h"
+
+namespace PokemonAutomation{
+
+
+//  Tesseract instances, memory and result cache hit rate across all languages.
+class OcrPoolStat : public OverlayStat{
+public:
+    virtual OverlayStatSnapshot get_current() override;
+};
+
+
+
+
+}
+#endif
@@ -0,0 +1,57 @@
+/*  Serial Link Stats
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "Common/Cpp/PrettyPrint.h"
+#include "Controllers/ControllerSession.h"
+#include "Controllers/SerialPABotBase/SerialPABotBase_Connection.h"
+#include "SerialLinkStats.h"
+
+namespace PokemonAutomation{
+
+
+
+SerialLinkStat::SerialLinkStat(const ControllerSession& session)
+    : m_session(session)
+{}
+
+OverlayStatSnapshot SerialLinkStat::get_current(){
+    PABotBaseLinkStats stats;
+    m_session.run_on_connection([&](ControllerConnection& connection){
+        const SerialPABotBase::SerialPABotBase_Connection* serial =
+            dynamic_cast<const SerialPABotBase::SerialPABotBase_Connection*>(&connection);
+        if (serial != nullptr){
+            stats = serial->link_stats();
+        }
+    });
+    if (stats.sent == 0 && stats.rtt_samples == 0){
+        return OverlayStatSnapshot{"Serial: ---"};
+    }
+
+    auto to_ms = [](WallDuration duration){
+        return tostr_fixed(std::chrono::duration_cast<std::chrono::microseconds>(duration).count() / 1000., 1);
+    };
+
+    OverlayStatSnapshot ret;
+    ret.text = "Serial:";
+    if (stats.rtt_samples != 0){
+        ret.text += " RTT " + to_ms(stats.rtt_p50) + "/" + to_ms(stats.rtt_p90) + "/" + to_ms(stats.rtt_p99) + " ms";
+        ret.text += ", RTO " + to_ms(stats.rto) + " ms,";
+    }
+    ret.text += " resent " + std::to_string(stats.retransmits);
+    if (stats.sent != 0){
+        double ratio = (double)stats.retransmits / stats.sent;
+        ret.text += " (" + tostr_fixed(100. * ratio, 1) + "%)";
+        if (ratio > 0.05){
+            ret.color = COLOR_ORANGE;
+        }
+    }
+    return ret;
+}
+
+
+
+
+}
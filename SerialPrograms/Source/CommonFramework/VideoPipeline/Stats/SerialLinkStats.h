@@ -0,0 +1,33 @@
+/*  Serial Link Stats
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_SerialLinkStats_H
+#define PokemonAutomation_SerialLinkStats_H
+
+#include "CommonFramework/VideoPipeline/VideoOverlayTypes.h"
+
+namespace PokemonAutomation{
+
+class ControllerSession;
+
+
+//  PABotBase round-trip time percentiles, retransmit timeout and resend rate
+//  of the connection that "session" currently has open.
+class SerialLinkStat : public OverlayStat{
+public:
+    SerialLinkStat(const ControllerSession& session);
+
+    virtual OverlayStatSnapshot get_current() override;
+
+private:
+    const ControllerSession& m_session;
+};
+
+
+
+
+}
+#endif
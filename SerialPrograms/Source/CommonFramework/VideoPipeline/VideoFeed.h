@@ -10,6 +10,7 @@
 #include <memory>
 #include "Common/Cpp/Time.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "VideoRegionSnapshot.h"
 
 namespace PokemonAutomation{
 
@@ -99,6 +100,18 @@ public:
     //
     virtual VideoSnapshot snapshot_recent_nonblocking(WallClock min_time) = 0;
 
+    //
+    //  Same as "snapshot_recent_nonblocking()", but the frame is converted
+    //  lazily. Only the regions that are asked for will be converted.
+    //
+    //  Implementations that can't do this will return the fully converted
+    //  frame from "snapshot_recent_nonblocking()".
+    //
+    virtual VideoRegionSnapshot snapshot_regions_nonblocking(WallClock min_time){
+        VideoSnapshot snapshot = snapshot_recent_nonblocking(min_time);
+        return VideoRegionSnapshot(std::move(snapshot.frame), snapshot.timestamp);
+    }
+
 
 public:
     //  Returns the currently measured frames/second for the video source.
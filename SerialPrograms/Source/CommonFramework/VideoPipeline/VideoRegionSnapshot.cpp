@@ -0,0 +1,41 @@
+/*  Video Region Snapshot
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "VideoRegionSnapshot.h"
+
+namespace PokemonAutomation{
+
+
+
+ImageViewRGB32 FullFrameRegions::region(const ImagePixelBox& box){
+    return m_frame->sub_image(box.min_x, box.min_y, box.width(), box.height());
+}
+
+
+
+VideoRegionSnapshot::VideoRegionSnapshot(std::shared_ptr<const ImageRGB32> p_frame, WallClock p_timestamp)
+    : timestamp(p_timestamp)
+{
+    if (p_frame && *p_frame){
+        frame = std::make_shared<FullFrameRegions>(std::move(p_frame));
+    }
+}
+
+ImageViewRGB32 VideoRegionSnapshot::region(const ImageFloatBox& box) const{
+    //  Round the same way as "extract_box_reference()" so that callbacks get
+    //  exactly the same pixels either way.
+    size_t width = frame->width();
+    size_t height = frame->height();
+    size_t min_x = (size_t)(width * box.x + 0.5);
+    size_t min_y = (size_t)(height * box.y + 0.5);
+    size_t box_width = (size_t)(width * box.width + 0.5);
+    size_t box_height = (size_t)(height * box.height + 0.5);
+    return frame->region(ImagePixelBox(min_x, min_y, min_x + box_width, min_y + box_height));
+}
+
+
+
+}
@@ -0,0 +1,103 @@
+/*  Video Region Snapshot
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      A snapshot of a video frame that converts to RGB32 lazily. Only the
+ *  rectangles that are requested get converted. This is meant for inference
+ *  callbacks that only look at a few small boxes of the frame.
+ *
+ */
+
+#ifndef PokemonAutomation_VideoPipeline_VideoRegionSnapshot_H
+#define PokemonAutomation_VideoPipeline_VideoRegionSnapshot_H
+
+#include <memory>
+#include "Common/Cpp/Time.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "CommonFramework/ImageTools/ImageBoxes.h"
+
+namespace PokemonAutomation{
+
+
+//  A single video frame that may not have been converted to RGB32 yet.
+//  Implementations must be thread-safe and should cache whatever they convert
+//  so that overlapping requests share the work.
+class VideoFrameRegions{
+public:
+    virtual ~VideoFrameRegions() = default;
+
+    virtual size_t width() const = 0;
+    virtual size_t height() const = 0;
+
+    //  Return the pixels inside "box". "box" will be clipped to the frame.
+    //  The returned view is valid for as long as this object is alive.
+    virtual ImageViewRGB32 region(const ImagePixelBox& box) = 0;
+
+    //  Return the entire frame.
+    virtual std::shared_ptr<const ImageRGB32> full_frame() = 0;
+};
+
+
+//  Regions of a frame that has already been fully converted.
+class FullFrameRegions : public VideoFrameRegions{
+public:
+    FullFrameRegions(std::shared_ptr<const ImageRGB32> frame)
+        : m_frame(std::move(frame))
+    {}
+
+    virtual size_t width() const override{ return m_frame->width(); }
+    virtual size_t height() const override{ return m_frame->height(); }
+
+    virtual ImageViewRGB32 region(const ImagePixelBox& box) override;
+    virtual std::shared_ptr<const ImageRGB32> full_frame() override{ return m_frame; }
+
+private:
+    std::shared_ptr<const ImageRGB32> m_frame;
+};
+
+
+
+struct VideoRegionSnapshot{
+    //  The frame itself. Null means no snapshot was available.
+    std::shared_ptr<VideoFrameRegions> frame;
+
+    //  The timestamp of when the frame was taken.
+    WallClock timestamp = WallClock::min();
+
+    VideoRegionSnapshot() = default;
+    VideoRegionSnapshot(std::shared_ptr<VideoFrameRegions> p_frame, WallClock p_timestamp)
+        : frame(std::move(p_frame))
+        , timestamp(p_timestamp)
+    {}
+
+    //  Wrap a frame that is already converted. A null or empty frame results
+    //  in a null snapshot.
+    VideoRegionSnapshot(std::shared_ptr<const ImageRGB32> p_frame, WallClock p_timestamp);
+
+    //  Returns true if the snapshot is valid.
+    explicit operator bool() const{ return frame != nullptr; }
+
+    size_t width() const{ return frame->width(); }
+    size_t height() const{ return frame->height(); }
+
+    //  Same as "extract_box_reference()" on the fully converted frame.
+    ImageViewRGB32 region(const ImagePixelBox& box) const{
+        return frame->region(box);
+    }
+    ImageViewRGB32 region(const ImageFloatBox& box) const;
+
+    //  Converts the rest of the frame if it hasn't been already.
+    std::shared_ptr<const ImageRGB32> full_frame() const{
+        return frame->full_frame();
+    }
+
+    void clear(){
+        frame.reset();
+        timestamp = WallClock::min();
+    }
+};
+
+
+
+}
+#endif
@@ -309,6 +309,14 @@ VideoSnapshot VideoSession::snapshot_recent_nonblocking(WallClock min_time){
         return VideoSnapshot();
     }
 }
+VideoRegionSnapshot VideoSession::snapshot_regions_nonblocking(WallClock min_time){
+    ReadSpinLock lg(m_state_lock);
+    if (m_video_source){
+        return m_video_source->snapshot_regions_nonblocking(min_time);
+    }else{
+        return VideoRegionSnapshot();
+    }
+}
 
 double VideoSession::fps_source() const{
     ReadSpinLock lg(m_fps_lock);
@@ -111,6 +111,8 @@ public:
     //  This function is thread-safe. It has a lock to prevent concurrent calls
     //  of other VideoSession functions.
     virtual VideoSnapshot snapshot_recent_nonblocking(WallClock min_time) override;
+    //  Implements VideoFeed::snapshot_regions_nonblocking().
+    virtual VideoRegionSnapshot snapshot_regions_nonblocking(WallClock min_time) override;
 
     //  Implements VideoFeed::fps_source().
     //  Returns the currently measured frames/second for the video source.
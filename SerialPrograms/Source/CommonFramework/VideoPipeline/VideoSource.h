@@ -60,6 +60,10 @@ public:
 
     virtual VideoSnapshot snapshot_latest_blocking() = 0;
     virtual VideoSnapshot snapshot_recent_nonblocking(WallClock min_time) = 0;
+    virtual VideoRegionSnapshot snapshot_regions_nonblocking(WallClock min_time){
+        VideoSnapshot snapshot = snapshot_recent_nonblocking(min_time);
+        return VideoRegionSnapshot(std::move(snapshot.frame), snapshot.timestamp);
+    }
 
 
 protected:
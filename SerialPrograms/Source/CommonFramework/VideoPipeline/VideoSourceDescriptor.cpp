@@ -12,6 +12,7 @@
 
 #include "VideoSources/VideoSource_Null.h"
 #include "VideoSources/VideoSource_StillImage.h"
+#include "VideoSources/VideoSource_FileReplay.h"
 #include "VideoSources/VideoSource_Camera.h"
 
 //#include <iostream>
@@ -52,6 +53,9 @@ std::shared_ptr<VideoSourceDescriptor> VideoSourceOption::get_descriptor_from_ca
     case VideoSourceType::StillImage:
         descriptor.reset(new VideoSourceDescriptor_StillImage());
         break;
+    case VideoSourceType::VideoPlayback:
+        descriptor.reset(new VideoSourceDescriptor_FileReplay());
+        break;
     case VideoSourceType::Camera:
         descriptor.reset(new VideoSourceDescriptor_Camera());
         break;
@@ -115,7 +119,9 @@ void VideoSourceOption::load_json(const JsonValue& json){
         }
         params = obj->get_value(VIDEO_TYPE_STRINGS.get_string(VideoSourceType::VideoPlayback));
         if (params != nullptr){
-//            m_descriptor_cache[VideoSourceType::VideoPlayback] =
+            auto x = std::make_unique<VideoSourceDescriptor_FileReplay>();
+            x->load_json(*params);
+            m_descriptor_cache[VideoSourceType::VideoPlayback] = std::move(x);
         }
         params = obj->get_value(VIDEO_TYPE_STRINGS.get_string(VideoSourceType::Camera));
         if (params != nullptr){
@@ -0,0 +1,551 @@
+/*  Video Source (File Replay)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QFileDialog>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QVBoxLayout>
+#include <QCheckBox>
+#include <QThread>
+#include <QTimer>
+#include <QWidget>
+#include <QPainter>
+#include <QMediaPlayer>
+#include <QVideoSink>
+#include "Common/Cpp/Json/JsonValue.h"
+#include "Common/Cpp/Json/JsonObject.h"
+#include "Common/Cpp/PanicDump.h"
+#include "Common/Qt/SpinWaitWithEvents.h"
+#include "CommonFramework/VideoPipeline/Backends/VideoFrameQt.h"
+#include "VideoSource_FileReplay.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+
+
+//  Frame interval to use when the frame files aren't numbered.
+const Milliseconds FALLBACK_FRAME_INTERVAL(33);
+
+//  Speed to play video files at in "as fast as possible" mode.
+const double FAST_PLAYBACK_RATE = 8.0;
+
+//  How long to wait for the first frame of a video file to learn its resolution.
+const Milliseconds FIRST_FRAME_TIMEOUT(5000);
+
+
+
+bool VideoSourceDescriptor_FileReplay::operator==(const VideoSourceDescriptor& x) const{
+    if (typeid(*this) != typeid(x)){
+        return false;
+    }
+
+    const VideoSourceDescriptor_FileReplay& other = static_cast<const VideoSourceDescriptor_FileReplay&>(x);
+    std::string other_path = other.path();
+    bool other_loop = other.loop();
+    bool other_as_fast_as_possible = other.as_fast_as_possible();
+
+    ReadSpinLock lg(m_lock);
+    return m_path == other_path &&
+        m_loop == other_loop &&
+        m_as_fast_as_possible == other_as_fast_as_possible;
+}
+
+std::string VideoSourceDescriptor_FileReplay::path() const{
+    ReadSpinLock lg(m_lock);
+    return m_path;
+}
+void VideoSourceDescriptor_FileReplay::set_path(std::string path){
+    WriteSpinLock lg(m_lock);
+    m_path = std::move(path);
+}
+bool VideoSourceDescriptor_FileReplay::loop() const{
+    ReadSpinLock lg(m_lock);
+    return m_loop;
+}
+void VideoSourceDescriptor_FileReplay::set_loop(bool enabled){
+    WriteSpinLock lg(m_lock);
+    m_loop = enabled;
+}
+bool VideoSourceDescriptor_FileReplay::as_fast_as_possible() const{
+    ReadSpinLock lg(m_lock);
+    return m_as_fast_as_possible;
+}
+void VideoSourceDescriptor_FileReplay::set_as_fast_as_possible(bool enabled){
+    WriteSpinLock lg(m_lock);
+    m_as_fast_as_possible = enabled;
+}
+
+void VideoSourceDescriptor_FileReplay::run_post_select(){
+    QString path = QFileDialog::getOpenFileName(
+        nullptr, "Open recording", ".",
+        "Video files (*.mp4 *.mkv *.mov *.avi *.webm);;Frame directory (*.png *.jpg *.jpeg *.bmp)"
+    );
+
+    //  Picking any frame selects the directory it is in.
+    QFileInfo info(path);
+    if (!path.isEmpty() && !QImageReader::imageFormat(path).isEmpty()){
+        path = info.absolutePath();
+    }
+    set_path(path.toStdString());
+    if (path.isEmpty()){
+        return;
+    }
+
+    QDialog dialog;
+    dialog.setWindowTitle("Replay Options");
+    QVBoxLayout* layout = new QVBoxLayout(&dialog);
+
+    QCheckBox* loop_box = new QCheckBox("Loop", &dialog);
+    loop_box->setToolTip("Restart from the beginning when the end is reached.");
+    loop_box->setChecked(loop());
+    layout->addWidget(loop_box);
+
+    QCheckBox* fast_box = new QCheckBox("As Fast As Possible", &dialog);
+    fast_box->setToolTip(
+        "Ignore the original timing. Frame directories show each frame once it has been read. "
+        "Video files play at " + QString::number(FAST_PLAYBACK_RATE) + "x speed."
+    );
+    fast_box->setChecked(as_fast_as_possible());
+    layout->addWidget(fast_box);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok, &dialog);
+    layout->addWidget(buttons);
+    QObject::connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+
+    dialog.exec();
+    set_loop(loop_box->isChecked());
+    set_as_fast_as_possible(fast_box->isChecked());
+}
+void VideoSourceDescriptor_FileReplay::load_json(const JsonValue& json){
+    const JsonObject* obj = json.to_object();
+    if (obj == nullptr){
+        return;
+    }
+    WriteSpinLock lg(m_lock);
+    const std::string* path = obj->get_string("Path");
+    if (path != nullptr){
+        m_path = *path;
+    }
+    obj->read_boolean(m_loop, "Loop");
+    obj->read_boolean(m_as_fast_as_possible, "AsFastAsPossible");
+}
+JsonValue VideoSourceDescriptor_FileReplay::to_json() const{
+    ReadSpinLock lg(m_lock);
+    JsonObject obj;
+    obj["Path"] = m_path;
+    obj["Loop"] = m_loop;
+    obj["AsFastAsPossible"] = m_as_fast_as_possible;
+    return obj;
+}
+
+std::unique_ptr<VideoSource> VideoSourceDescriptor_FileReplay::make_VideoSource(Logger& logger, Resolution resolution) const{
+    ReadSpinLock lg(m_lock);
+    return std::make_unique<VideoSource_FileReplay>(
+        logger, m_path, resolution, m_loop, m_as_fast_as_possible
+    );
+}
+
+
+
+
+
+//  Owns a QMediaPlayer on its own thread and hands every decoded frame to
+//  "callback" on the thread that decoded it.
+class QMediaPlayerThread : public QThread{
+public:
+    using FrameCallback = std::function<void(const QVideoFrame& frame)>;
+
+    QMediaPlayerThread(
+        Logger& logger,
+        QUrl source,
+        bool loop,
+        double playback_rate,
+        FrameCallback callback
+    )
+        : m_logger(logger)
+        , m_source(std::move(source))
+        , m_loop(loop)
+        , m_playback_rate(playback_rate)
+        , m_callback(std::move(callback))
+    {
+        start();
+
+        m_spin_waiter.process_events_while_waiting();
+    }
+    ~QMediaPlayerThread(){
+        quit();
+        wait();
+    }
+
+private:
+    virtual void run() override{
+        QMediaPlayer player;
+        QVideoSink sink;
+        player.setVideoSink(&sink);
+
+        connect(
+            &sink, &QVideoSink::videoFrameChanged,
+            &sink, [&](const QVideoFrame& frame){
+                if (frame.isValid()){
+                    m_callback(frame);
+                }
+            },
+            Qt::DirectConnection
+        );
+        connect(
+            &player, &QMediaPlayer::errorOccurred,
+            &player, [&](QMediaPlayer::Error error, const QString& message){
+                if (error == QMediaPlayer::NoError){
+                    return;
+                }
+                m_logger.log("QMediaPlayer error: " + message.toStdString(), COLOR_RED);
+            }
+        );
+        connect(
+            &player, &QMediaPlayer::mediaStatusChanged,
+            &player, [&](QMediaPlayer::MediaStatus status){
+                if (status == QMediaPlayer::EndOfMedia){
+                    m_logger.log("Replay finished: " + m_source.toLocalFile().toStdString());
+                }
+            }
+        );
+
+        player.setSource(m_source);
+        player.setLoops(m_loop ? QMediaPlayer::Infinite : QMediaPlayer::Once);
+        player.setPlaybackRate(m_playback_rate);
+        player.play();
+
+        m_spin_waiter.signal();
+
+        exec();
+
+        player.stop();
+    }
+
+private:
+    Logger& m_logger;
+    QUrl m_source;
+    bool m_loop;
+    double m_playback_rate;
+    FrameCallback m_callback;
+    SpinWaitWithEvents m_spin_waiter;
+};
+
+
+
+
+
+namespace{
+
+//  Returns the number that the file name starts with.
+bool parse_frame_offset(const QString& name, Milliseconds& offset){
+    uint64_t value = 0;
+    int digits = 0;
+    for (QChar ch : name){
+        if (!ch.isDigit()){
+            break;
+        }
+        value = value * 10 + ch.digitValue();
+        digits++;
+    }
+    offset = Milliseconds(value);
+    return digits > 0;
+}
+
+QVideoFrame make_video_frame(const QImage& image){
+    QImage argb = image.convertToFormat(QImage::Format_ARGB32);
+    QVideoFrame frame(QVideoFrameFormat(argb.size(), QVideoFrameFormat::Format_BGRA8888));
+#if (QT_VERSION_MAJOR == 6) && (QT_VERSION_MINOR >= 8)
+    if (!frame.map(QtVideo::MapMode::WriteOnly)){
+#else
+    if (!frame.map(QVideoFrame::WriteOnly)){
+#endif
+        return QVideoFrame();
+    }
+    size_t bytes_per_row = (size_t)argb.width() * sizeof(uint32_t);
+    for (int r = 0; r < argb.height(); r++){
+        memcpy(frame.bits(0) + r * frame.bytesPerLine(0), argb.constScanLine(r), bytes_per_row);
+    }
+    frame.unmap();
+    return frame;
+}
+
+}
+
+
+
+std::vector<FileReplayFrame> list_replay_frames(Logger& logger, const std::string& path){
+    QDir dir(QString::fromStdString(path));
+    QFileInfoList files = dir.entryInfoList(
+        {"*.png", "*.jpg", "*.jpeg", "*.bmp"},
+        QDir::Files, QDir::Name
+    );
+
+    std::vector<FileReplayFrame> frames;
+    bool numbered = true;
+    for (const QFileInfo& file : files){
+        Milliseconds offset;
+        numbered &= parse_frame_offset(file.completeBaseName(), offset);
+        frames.emplace_back(FileReplayFrame{file.absoluteFilePath().toStdString(), offset});
+    }
+    if (frames.empty()){
+        logger.log("No frames found in: " + path, COLOR_RED);
+        return frames;
+    }
+
+    if (numbered){
+        std::stable_sort(
+            frames.begin(), frames.end(),
+            [](const FileReplayFrame& x, const FileReplayFrame& y){
+                return x.offset < y.offset;
+            }
+        );
+        Milliseconds start = frames[0].offset;
+        for (FileReplayFrame& frame : frames){
+            frame.offset -= start;
+        }
+    }else{
+        logger.log("Frame files are not numbered. Playing at 30 FPS.", COLOR_ORANGE);
+        for (size_t c = 0; c < frames.size(); c++){
+            frames[c].offset = (int64_t)c * FALLBACK_FRAME_INTERVAL;
+        }
+    }
+    logger.log("Frames: " + std::to_string(frames.size()));
+    return frames;
+}
+
+
+
+VideoSource_FileReplay::~VideoSource_FileReplay(){
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_stopping = true;
+        m_cv.notify_all();
+    }
+    m_thread.join();
+    m_player.reset();
+}
+VideoSource_FileReplay::VideoSource_FileReplay(
+    Logger& logger,
+    const std::string& path,
+    Resolution resolution,
+    bool loop,
+    bool as_fast_as_possible
+)
+    : VideoSource(logger, false)
+    , m_logger(logger)
+    , m_loop(loop)
+    , m_as_fast_as_possible(as_fast_as_possible)
+    , m_resolution(resolution)
+    , m_last_frame(logger)
+    , m_snapshot_manager(logger, m_last_frame)
+{
+    if (path.empty()){
+        m_resolutions = {m_resolution};
+        return;
+    }
+
+    m_logger.log(
+        "Replaying: " + path +
+        (m_loop ? " (loop)" : "") +
+        (m_as_fast_as_possible ? " (as fast as possible)" : "")
+    );
+
+    if (QFileInfo(QString::fromStdString(path)).isDir()){
+        load_frame_directory(path);
+    }else{
+        start_video_file(path);
+    }
+    m_resolutions = {current_resolution()};
+}
+
+
+void VideoSource_FileReplay::load_frame_directory(const std::string& path){
+    m_frames = list_replay_frames(m_logger, path);
+    if (m_frames.empty()){
+        return;
+    }
+
+    QSize size = QImageReader(QString::fromStdString(m_frames[0].path)).size();
+    if (size.isValid()){
+        m_resolution = Resolution(size.width(), size.height());
+    }
+
+    m_thread = Thread([this]{
+        run_with_catch(
+            "VideoSource_FileReplay::replay_thread()",
+            [this]{ replay_thread(); }
+        );
+    });
+}
+void VideoSource_FileReplay::start_video_file(const std::string& path){
+    m_player.reset(new QMediaPlayerThread(
+        m_logger,
+        QUrl::fromLocalFile(QString::fromStdString(path)),
+        m_loop,
+        m_as_fast_as_possible ? FAST_PLAYBACK_RATE : 1.0,
+        [this](const QVideoFrame& frame){
+            push_frame(frame, current_time());
+        }
+    ));
+
+    //  The size of a video is only known once a frame has been decoded. Keep
+    //  processing events while waiting in case the backend needs this thread.
+    WallClock deadline = current_time() + FIRST_FRAME_TIMEOUT;
+    while (m_last_frame.seqnum() == 0 && current_time() < deadline){
+        QApplication::processEvents();
+        pause();
+    }
+
+    QVideoFrame frame;
+    WallClock timestamp;
+    if (m_last_frame.get_latest(frame, timestamp) != 0){
+        m_resolution = Resolution(frame.size().width(), frame.size().height());
+    }else{
+        m_logger.log("No frames decoded from: " + path, COLOR_RED);
+    }
+}
+
+
+void VideoSource_FileReplay::push_frame(QVideoFrame frame, WallClock timestamp){
+    //  Looping restarts the media timestamps. Clear them so the cache doesn't
+    //  drop the frames of the next pass as duplicates.
+    frame.setStartTime(-1);
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_published_timestamp = timestamp;
+        m_consumed = false;
+    }
+
+    if (!m_last_frame.push_frame(frame, timestamp)){
+        return;
+    }
+    report_source_frame(std::make_shared<VideoFrame>(timestamp, std::move(frame)));
+}
+void VideoSource_FileReplay::report_consumed(WallClock timestamp){
+    if (!m_as_fast_as_possible){
+        return;
+    }
+    std::lock_guard<std::mutex> lg(m_lock);
+    if (m_consumed || timestamp < m_published_timestamp){
+        return;
+    }
+    m_consumed = true;
+    m_cv.notify_all();
+}
+
+
+bool VideoSource_FileReplay::wait_until(WallClock time){
+    std::unique_lock<std::mutex> lg(m_lock);
+    m_cv.wait_until(lg, time, [this]{ return m_stopping; });
+    return !m_stopping;
+}
+bool VideoSource_FileReplay::wait_for_consumer(){
+    std::unique_lock<std::mutex> lg(m_lock);
+    m_cv.wait(lg, [this]{ return m_stopping || m_consumed; });
+    return !m_stopping;
+}
+void VideoSource_FileReplay::replay_thread(){
+    const Milliseconds length = m_frames.back().offset;
+
+    //  Time between the last frame of a pass and the first frame of the next.
+    const Milliseconds gap = m_frames.size() > 1
+        ? length / (int64_t)(m_frames.size() - 1)
+        : FALLBACK_FRAME_INTERVAL;
+
+    WallClock start = current_time();
+    do{
+        for (const FileReplayFrame& file : m_frames){
+            //  Decode before waiting so the frame goes out on time.
+            QVideoFrame frame = make_video_frame(QImage(QString::fromStdString(file.path)));
+            if (!frame.isValid()){
+                m_logger.log("Unable to load frame: " + file.path, COLOR_RED);
+                continue;
+            }
+
+            bool running = m_as_fast_as_possible
+                ? wait_for_consumer()
+                : wait_until(start + file.offset);
+            if (!running){
+                return;
+            }
+
+            push_frame(std::move(frame), current_time());
+        }
+        start += length + gap;
+    }while (m_loop);
+
+    m_logger.log("Replay finished.");
+}
+
+
+
+
+
+class VideoWidget_FileReplay : public QWidget{
+public:
+    VideoWidget_FileReplay(QWidget* parent, VideoSource_FileReplay& source)
+        : QWidget(parent)
+        , m_source(source)
+        , m_painted_seqnum(0)
+    {
+        QTimer* timer = new QTimer(this);
+        connect(
+            timer, &QTimer::timeout,
+            this, [this]{
+                if (m_source.m_last_frame.seqnum() != m_painted_seqnum){
+                    update();
+                }
+            }
+        );
+        timer->start(16);
+    }
+
+private:
+    virtual void paintEvent(QPaintEvent* event) override{
+        QWidget::paintEvent(event);
+
+        QVideoFrame frame;
+        WallClock timestamp;
+        m_painted_seqnum = m_source.m_last_frame.get_latest(frame, timestamp);
+        if (!frame.isValid()){
+            return;
+        }
+
+        QRect rect(0, 0, this->width(), this->height());
+        QPainter painter(this);
+        painter.drawImage(rect, frame.toImage());
+        m_source.report_rendered_frame(current_time());
+    }
+
+private:
+    VideoSource_FileReplay& m_source;
+    uint64_t m_painted_seqnum;
+};
+
+
+
+
+
+QWidget* VideoSource_FileReplay::make_display_QtWidget(QWidget* parent){
+    return new VideoWidget_FileReplay(parent, *this);
+}
+
+
+
+
+}
+
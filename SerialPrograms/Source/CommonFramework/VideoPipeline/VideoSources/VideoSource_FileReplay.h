@@ -0,0 +1,182 @@
+/*  Video Source (File Replay)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Replays a recorded session as if it were a live camera. The path is
+ *  either a video file or a directory of frames.
+ *
+ *  For a directory, each image is a frame and the leading number of its file
+ *  name is its timestamp in milliseconds. If the names aren't numbered, the
+ *  frames are played in name order at 30 FPS.
+ *
+ *  Snapshots go through the same cache and snapshot manager as the camera so
+ *  inference sees the same behavior it would on a live feed.
+ *
+ *  The resolution is that of the first frame. It is the only one supported.
+ *
+ *  Options: (asked for when the source is selected)
+ *    - Loop: Restart from the beginning when the end is reached. Otherwise
+ *      the last frame stays up.
+ *    - As Fast As Possible: Ignore the original timing. For frame directories,
+ *      the next frame is shown as soon as the current one has been returned
+ *      by a snapshot so that no frame is skipped. The media player can't wait
+ *      on the consumer, so video files are instead played at a fixed multiple
+ *      of real time and may skip frames.
+ *
+ */
+
+#ifndef PokemonAutomation_VideoPipeline_VideoSource_FileReplay_H
+#define PokemonAutomation_VideoPipeline_VideoSource_FileReplay_H
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "Common/Cpp/Concurrency/Thread.h"
+#include "CommonFramework/VideoPipeline/Backends/QVideoFrameCache.h"
+#include "CommonFramework/VideoPipeline/Backends/SnapshotManager.h"
+#include "CommonFramework/VideoPipeline/VideoSourceDescriptor.h"
+#include "CommonFramework/VideoPipeline/VideoSource.h"
+
+namespace PokemonAutomation{
+
+
+class VideoSourceDescriptor_FileReplay : public VideoSourceDescriptor{
+public:
+    VideoSourceDescriptor_FileReplay()
+        : VideoSourceDescriptor(VideoSourceType::VideoPlayback)
+    {}
+    VideoSourceDescriptor_FileReplay(std::string path, bool loop, bool as_fast_as_possible)
+        : VideoSourceDescriptor(VideoSourceType::VideoPlayback)
+        , m_path(std::move(path))
+        , m_loop(loop)
+        , m_as_fast_as_possible(as_fast_as_possible)
+    {}
+
+public:
+    //  Path to a video file or a directory of frames.
+    std::string path() const;
+    void set_path(std::string path);
+
+    bool loop() const;
+    void set_loop(bool enabled);
+
+    bool as_fast_as_possible() const;
+    void set_as_fast_as_possible(bool enabled);
+
+    virtual bool should_reload() const override{ return true; }
+    virtual bool operator==(const VideoSourceDescriptor& x) const override;
+    virtual std::string display_name() const override{
+        return "Replay Recording";
+    }
+
+    virtual void run_post_select() override;
+    virtual void load_json(const JsonValue& json) override;
+    virtual JsonValue to_json() const override;
+
+    virtual std::unique_ptr<VideoSource> make_VideoSource(Logger& logger, Resolution resolution) const override;
+
+
+private:
+    mutable SpinLock m_lock;
+    std::string m_path;
+    bool m_loop = false;
+    bool m_as_fast_as_possible = false;
+};
+
+
+
+//  One frame of a frame directory.
+struct FileReplayFrame{
+    std::string path;
+    Milliseconds offset;    //  Time since the first frame.
+};
+
+//  List the frames of a directory in the order they are played. Returns
+//  nothing if there are no frames.
+std::vector<FileReplayFrame> list_replay_frames(Logger& logger, const std::string& path);
+
+
+
+class QMediaPlayerThread;
+
+class VideoSource_FileReplay : public VideoSource{
+public:
+    ~VideoSource_FileReplay();
+    VideoSource_FileReplay(
+        Logger& logger,
+        const std::string& path,
+        Resolution resolution,
+        bool loop,
+        bool as_fast_as_possible
+    );
+
+    virtual Resolution current_resolution() const override{
+        return m_resolution;
+    }
+    virtual const std::vector<Resolution>& supported_resolutions() const override{
+        return m_resolutions;
+    }
+
+    virtual VideoSnapshot snapshot_latest_blocking() override{
+        VideoSnapshot snapshot = m_snapshot_manager.snapshot_latest_blocking();
+        report_consumed(snapshot.timestamp);
+        return snapshot;
+    }
+    virtual VideoSnapshot snapshot_recent_nonblocking(WallClock min_time) override{
+        VideoSnapshot snapshot = m_snapshot_manager.snapshot_recent_nonblocking(min_time);
+        report_consumed(snapshot.timestamp);
+        return snapshot;
+    }
+    virtual VideoRegionSnapshot snapshot_regions_nonblocking(WallClock min_time) override{
+        VideoRegionSnapshot snapshot = m_snapshot_manager.snapshot_regions_nonblocking(min_time);
+        report_consumed(snapshot.timestamp);
+        return snapshot;
+    }
+
+    virtual QWidget* make_display_QtWidget(QWidget* parent) override;
+
+
+private:
+    void load_frame_directory(const std::string& path);
+    void start_video_file(const std::string& path);
+
+    void push_frame(QVideoFrame frame, WallClock timestamp);
+    void report_consumed(WallClock timestamp);
+
+    void replay_thread();
+    bool wait_until(WallClock time);
+    bool wait_for_consumer();
+
+
+private:
+    friend class VideoWidget_FileReplay;
+
+    Logger& m_logger;
+    const bool m_loop;
+    const bool m_as_fast_as_possible;
+
+    //  Only set during construction.
+    Resolution m_resolution;
+    std::vector<Resolution> m_resolutions;
+
+    std::vector<FileReplayFrame> m_frames;
+
+    QVideoFrameCache m_last_frame;
+    SnapshotManager m_snapshot_manager;
+
+    std::mutex m_lock;
+    std::condition_variable m_cv;
+    bool m_stopping = false;
+    WallClock m_published_timestamp = WallClock::min();
+    bool m_consumed = true;
+
+    std::unique_ptr<QMediaPlayerThread> m_player;
+    Thread m_thread;
+};
+
+
+
+
+}
+#endif
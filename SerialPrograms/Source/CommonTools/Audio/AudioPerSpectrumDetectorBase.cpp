@@ -125,7 +125,7 @@ bool AudioPerSpectrumDetectorBase::process_spectrums(
     const float threshold = get_score_threshold();
     for (auto it = new_spectrums.rbegin(); it != new_spectrums.rend(); it++){
         std::vector<AudioSpectrum> single_spectrum = {*it};
-        const float matcher_score = m_matcher->match(single_spectrum);
+        const float matcher_score = m_matcher->match(single_spectrum, audio_feed.spectrum_preprocessor());
         // std::cout << "error: " << matcherScore << std::endl;
 
         if (m_lowest_error < 1.0){
@@ -172,10 +172,13 @@ bool AudioPerSpectrumDetectorBase::process_spectrums(
 
             // Tell m_matcher to skip the remaining spectrums so that if `process_spectrums()` gets
             // called again on a newer batch of spectrums, m_matcher is happy.
-            m_matcher->skip(std::vector<AudioSpectrum>(
-                new_spectrums.begin(),
-                new_spectrums.begin() + std::distance(it + 1, new_spectrums.rend())
-            ));
+            m_matcher->skip(
+                std::vector<AudioSpectrum>(
+                    new_spectrums.begin(),
+                    new_spectrums.begin() + std::distance(it + 1, new_spectrums.rend())
+                ),
+                audio_feed.spectrum_preprocessor()
+            );
 
             // Skip the remaining spectrums.
             break;
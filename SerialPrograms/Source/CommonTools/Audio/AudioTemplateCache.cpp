@@ -4,11 +4,17 @@
  *
  */
 
+#include <mutex>
+#include <QFile>
 #include <QFileInfo>
+#include <QDir>
 #include <QString>
+#include <QCryptographicHash>
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/Containers/AlignedVector.tpp"
+#include "Common/Cpp/Concurrency/FireForgetDispatcher.h"
 #include "CommonFramework/Globals.h"
+#include "CommonFramework/Logging/Logger.h"
 #include "CommonFramework/AudioPipeline/AudioTemplate.h"
 #include "AudioTemplateCache.h"
 
@@ -16,6 +22,15 @@
 namespace PokemonAutomation{
 
 
+struct AudioTemplateCache::Entry{
+    //  Held while loading so that only the threads that want this template
+    //  wait for it.
+    std::mutex lock;
+    bool loaded = false;
+    AudioTemplate audio_template;
+};
+
+
 AudioTemplateCache::~AudioTemplateCache(){}
 AudioTemplateCache::AudioTemplateCache(){}
 
@@ -25,29 +40,89 @@ AudioTemplateCache& AudioTemplateCache::instance(){
 }
 
 
-const AudioTemplate* AudioTemplateCache::get_nothrow_internal(const std::string& full_path_no_ext, size_t sample_rate){
-    WriteSpinLock lg(m_lock);
-    auto iter = m_cache.find(full_path_no_ext);
-    if (iter != m_cache.end()){
-        return &iter->second;
+namespace{
+
+std::string hash_file(const std::string& path){
+    QFile file(QString::fromStdString(path));
+    if (!file.open(QIODevice::ReadOnly)){
+        return "";
     }
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&file)){
+        return "";
+    }
+    return hash.result().toHex().toStdString();
+}
 
+AudioTemplate load_template(const std::string& full_path_no_ext, size_t sample_rate){
     std::string full_path = full_path_no_ext + ".wav";
     if (!QFileInfo::exists(QString::fromStdString(full_path))){
         full_path = full_path_no_ext + ".mp3";
     }
 
-    AudioTemplate audio_template = loadAudioTemplate(full_path, (int)sample_rate);
+    //  If the source can't be read, let the loader fail and report it.
+    std::string source_hash = hash_file(full_path);
+    if (source_hash.empty()){
+        return loadAudioTemplate(full_path, sample_rate);
+    }
+
+    const std::string& cache_folder = AUDIO_TEMPLATE_CACHE_PATH();
+    std::string cache_path = cache_folder + source_hash + "-" + std::to_string(sample_rate) + ".bin";
+
+    AudioTemplate audio_template = loadAudioTemplateBinary(cache_path, source_hash, sample_rate);
+    if (audio_template.numFrequencies() != 0){
+        global_logger_tagged().log(
+            "Loaded audio template with sample rate " + std::to_string(sample_rate) +
+            " from cache: " + full_path
+        );
+        return audio_template;
+    }
+
+    audio_template = loadAudioTemplate(full_path, sample_rate);
     if (audio_template.numFrequencies() == 0){
-        return nullptr;
+        return audio_template;
+    }
+
+    //  Failing to write the cache isn't an error. We'll just build it again
+    //  next time.
+    if (!QDir().mkpath(QString::fromStdString(cache_folder)) ||
+        !saveAudioTemplateBinary(cache_path, audio_template, source_hash, sample_rate)
+    ){
+        global_logger_tagged().log("Unable to write audio template cache: " + cache_path, COLOR_ORANGE);
     }
 
-    iter = m_cache.emplace(
-        std::move(full_path_no_ext),
-        std::move(audio_template)
-    ).first;
+    return audio_template;
+}
 
-    return &iter->second;
+}
+
+
+const AudioTemplate* AudioTemplateCache::get_nothrow_internal(const std::string& full_path_no_ext, size_t sample_rate){
+    std::shared_ptr<Entry> entry;
+    {
+        WriteSpinLock lg(m_lock);
+        std::shared_ptr<Entry>& slot = m_cache[full_path_no_ext];
+        if (!slot){
+            slot = std::make_shared<Entry>();
+        }
+        entry = slot;
+    }
+
+    //  Entries are never removed. So the template stays valid after we return.
+    std::lock_guard<std::mutex> lg(entry->lock);
+    if (entry->loaded){
+        return &entry->audio_template;
+    }
+
+    AudioTemplate audio_template = load_template(full_path_no_ext, sample_rate);
+    if (audio_template.numFrequencies() == 0){
+        //  Don't remember the failure. The next caller will try again.
+        return nullptr;
+    }
+
+    entry->audio_template = std::move(audio_template);
+    entry->loaded = true;
+    return &entry->audio_template;
 }
 
 
@@ -69,6 +144,18 @@ const AudioTemplate& AudioTemplateCache::get_throw(const std::string& path, size
     return *audio_template;
 }
 
+void AudioTemplateCache::preload(std::vector<std::string> paths, std::vector<size_t> sample_rates){
+    global_dispatcher.dispatch([this, paths = std::move(paths), sample_rates = std::move(sample_rates)]{
+        for (const std::string& path : paths){
+            for (size_t sample_rate : sample_rates){
+                try{
+                    get_nothrow(path, sample_rate);
+                }catch (...){}
+            }
+        }
+    });
+}
+
 
 
 
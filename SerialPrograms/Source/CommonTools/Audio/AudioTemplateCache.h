@@ -2,13 +2,19 @@
  *
  *  From: https://github.com/PokemonAutomation/
  *
+ *  Built templates are also saved to AUDIO_TEMPLATE_CACHE_PATH(), keyed by
+ *  the hash of the source audio file and the sample rate. Later launches load
+ *  the spectrogram from there instead of decoding and FFT'ing the audio file.
+ *
  */
 
 #ifndef PokemonAutomation_CommonTools_AudioTemplateCache_H
 #define PokemonAutomation_CommonTools_AudioTemplateCache_H
 
 #include <string>
+#include <vector>
 #include <map>
+#include <memory>
 #include "Common/Cpp/Concurrency/SpinLock.h"
 
 namespace PokemonAutomation{
@@ -16,7 +22,6 @@ namespace PokemonAutomation{
 class AudioTemplate;
 
 
-
 class AudioTemplateCache{
 public:
     // path: the path of the basename of the audio template file relative to RESOURCE_PATH().
@@ -32,6 +37,12 @@ public:
     // Throw a FileException if cannot read or parse the template file.
     const AudioTemplate& get_throw(const std::string& path, size_t sample_rate);
 
+    // Start loading these templates in the background for every sample rate in
+    // `sample_rates` so that the detectors that use them later don't have to wait.
+    // Templates that fail to load are skipped. They will be tried again (and
+    // the error reported) when the detector asks for them.
+    void preload(std::vector<std::string> paths, std::vector<size_t> sample_rates);
+
     static AudioTemplateCache& instance();
 
 private:
@@ -42,8 +53,11 @@ private:
 
 
 private:
+    struct Entry;
+
+    //  Protects "m_cache" only. Never held while loading.
     SpinLock m_lock;
-    std::map<std::string, AudioTemplate> m_cache;
+    std::map<std::string, std::shared_ptr<Entry>> m_cache;
 };
 
 
@@ -1,13 +1,13 @@
 
 
 #include <cfloat>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <fstream>
 //#include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/Containers/AlignedVector.tpp"
 #include "Kernels/ScaleInvariantMatrixMatch/Kernels_ScaleInvariantMatrixMatch.h"
-#include "Kernels/SpikeConvolution/Kernels_SpikeConvolution.h"
 #include "CommonFramework/AudioPipeline/AudioFeed.h"
 #include "CommonFramework/AudioPipeline/AudioTemplate.h"
 #include "SpectrogramMatcher.h"
@@ -19,33 +19,6 @@
 namespace PokemonAutomation{
 
 
-std::vector<float> buildSpikeKernel(size_t numFrequencies, size_t halfSampleRate){
-    std::vector<float> kernel;
-    // We find a good kernel when sample rate is 48K and numFrequencies is 2048:
-    // [-4.f, -3.f, -2.f, -1.f, 0.f, 1.f, 2.f, 3.f, 4.f, 4.f, 3.f, 2.f, 1.f, 0.f, -1.f, -2.f, -3.f, -4.f]
-    // This spans frenquency range of 17 * halfSampleRate / numFrequencies = 199.21875Hz, where 17 is the number of intervals in the above series.
-    // For another sample rate and numFrequencies combination, the number of intervals is
-    // 199.21875 * numFrequencies / halfSampleRate
-    size_t numKernelIntervals = int(199.21875 * numFrequencies / halfSampleRate + 0.5);
-    size_t slopeLen = numKernelIntervals / 2;
-    for(size_t i = 0; i <= slopeLen; i++){
-        kernel.push_back(-4.0f + 8.f * i / (float)slopeLen);
-    }
-    for(size_t i = ((numKernelIntervals+1) % 2); i <= slopeLen; i++){
-        kernel.push_back(-4.0f + 8.f * (slopeLen-i)/(float)slopeLen);
-    }
-    return kernel;
-}
-
-// std::vector<float> buildSmoothKernel(size_t numFrequencies, size_t halfSampleRate){
-//     std::vector<float> kernel;
-//     // We find a good kernel when sample rate is 48K and numFrequencies is 2048:
-//     // [0.0111, 0.135, 0.606, 1.0, 0.606, 0.135, 0.0111], built as Gaussian distribution with sigma(stddev) as 1.0
-//     // The equation for Gaussian is exp(-x^2/(2 sigma^2))
-//     // We can think sigma value as 1.0 * frequency_gap = 1.0 * halfSampleRate / numFrequencies = 11.71875 Hz
-// }
-
-
 SpectrogramMatcher::SpectrogramMatcher(
     std::string name,
     AudioTemplate audioTemplate, Mode mode, size_t sample_rate,
@@ -55,6 +28,7 @@ SpectrogramMatcher::SpectrogramMatcher(
     , m_template(std::move(audioTemplate))
     , m_sample_rate(sample_rate)
     , m_mode(mode)
+    , m_local_preprocessor(new SpectrumPreprocessor())
 {
     const size_t numTemplateWindows = m_template.numWindows();
 //    cout << "numTemplateWindows = " << numTemplateWindows << endl;
@@ -80,50 +54,24 @@ SpectrogramMatcher::SpectrogramMatcher(
     m_originalFreqEnd = 20000 * m_numOriginalFrequencies / halfSampleRate + 1;
 
     // Initialize the spike convolution kernel:
-    m_convKernel = buildSpikeKernel(m_numOriginalFrequencies, halfSampleRate);
+    m_convKernel = build_spike_kernel(m_numOriginalFrequencies, halfSampleRate);
 
-    switch(m_mode){
-    case Mode::SPIKE_CONV:
-    {
-        // Do convolution on audio template
-        const size_t numConvedFrequencies = (m_originalFreqEnd - m_originalFreqStart) - m_convKernel.size() + 1;
+    std::tie(m_freqStart, m_freqEnd) = processed_spectrum_range(
+        m_mode, m_originalFreqStart, m_originalFreqEnd, m_convKernel.size()
+    );
 
-        AudioTemplate audio_template(numConvedFrequencies, numTemplateWindows);
+    if (m_mode != Mode::RAW){
+        // Filter the audio template the same way as the incoming spectrums.
+        AudioTemplate audio_template(m_freqEnd, numTemplateWindows);
         for (size_t i = 0; i < numTemplateWindows; i++){
-            conv(
-                m_template.getWindow(i) + m_originalFreqStart, m_originalFreqEnd - m_originalFreqStart,
-                audio_template.getWindow(i)
+            process_spectrum(
+                m_mode,
+                audio_template.getWindow(i), m_template.getWindow(i),
+                m_originalFreqStart, m_originalFreqEnd,
+                m_convKernel
             );
         }
-
         m_template = std::move(audio_template);
-        m_freqStart = 0;
-        m_freqEnd = numConvedFrequencies;
-        break;
-    }
-    case Mode::AVERAGE_5:
-    {
-        // Avereage every 5 frequencies
-        const size_t numNewFreq = (m_originalFreqEnd - m_originalFreqStart) / 5;
-
-        AudioTemplate audio_template(numNewFreq, numTemplateWindows);
-        for (size_t i = 0; i < numTemplateWindows; i++){
-            for (size_t j = 0; j < numNewFreq; j++){
-                const float * rawFreqMag = m_template.getWindow(i) + m_originalFreqStart + j*5;
-                const float newMag = (rawFreqMag[0] + rawFreqMag[1] + rawFreqMag[2] + rawFreqMag[3] + rawFreqMag[4]) / 5.0f;
-                audio_template.getWindow(i)[j] = newMag;
-            }
-        }
-
-        m_template = std::move(audio_template);
-        m_freqStart = 0;
-        m_freqEnd = numNewFreq;
-        break;
-    }
-    case Mode::RAW:
-        m_freqStart = m_originalFreqStart;
-        m_freqEnd = m_originalFreqEnd;
-        break;
     }
 
     if (templateSubdivision <= 1){
@@ -145,36 +93,31 @@ SpectrogramMatcher::SpectrogramMatcher(
 //    cout << "m_numSpectrumsNeeded = " << m_numSpectrumsNeeded << endl;
 
     m_templateNorm = buildTemplateNorm();
-}
 
-uint64_t SpectrogramMatcher::latestTimestamp() const{
-    if (m_spectrums.size() == 0){
-        return SIZE_MAX;
+    // The i-th newest spectrum is always matched against template window
+    // (m_numSpectrumsNeeded - 1 - i). So over its time in the ring buffer, each
+    // spectrum meets each of the first m_numSpectrumsNeeded template windows
+    // exactly once. Their dot products are computed when the spectrum arrives.
+    const size_t freqs = m_freqEnd - m_freqStart;
+    m_matchedTemplateWindows.resize(m_numSpectrumsNeeded);
+    for (size_t i = 0; i < m_numSpectrumsNeeded; i++){
+        const float* window = m_template.getWindow(i) + m_freqStart;
+        m_matchedTemplateWindows[i] = window;
+        for (size_t j = 0; j < freqs; j++){
+            m_matchedTemplateNormSqr += (double)window[j] * window[j];
+        }
     }
-    return m_spectrums.front().stamp;
-}
-
-void SpectrogramMatcher::conv(const float* src, size_t num, float* dst){
-//    cout << (size_t)dst % 64 << endl;
 
-    const size_t numConvedFrequencies = num - m_convKernel.size() + 1;
-    if (num < m_convKernel.size()){
-        memset(dst, 0, numConvedFrequencies * sizeof(float));
-        return;
-    }
+    m_stamps.resize(m_numSpectrumsNeeded);
+    m_spectrumNormSqrs.resize(m_numSpectrumsNeeded);
+    m_crossTerms = AlignedVector<float>(m_numSpectrumsNeeded * m_numSpectrumsNeeded);
+}
 
-#if 0
-    for (size_t i = 0; i < num-m_convKernel.size()+1; i++){
-        dst[i] = 0.0f;
-        for (size_t j = 0; j < m_convKernel.size(); j++){
-            dst[i] += src[i+j] * m_convKernel[j];
-        }
+uint64_t SpectrogramMatcher::latestTimestamp() const{
+    if (m_numSpectrumsStored == 0){
+        return SIZE_MAX;
     }
-#else
-    Kernels::SpikeConvolution::compute_spike_kernel(
-        dst, src, num, m_convKernel.data(), m_convKernel.size()
-    );
-#endif
+    return m_stamps[m_newestSlot];
 }
 
 std::vector<float> SpectrogramMatcher::buildTemplateNorm() const{
@@ -194,135 +137,69 @@ std::vector<float> SpectrogramMatcher::buildTemplateNorm() const{
     return ret;
 }
 
-bool SpectrogramMatcher::update_to_new_spectrum(AudioSpectrum spectrum){
+bool SpectrogramMatcher::update_to_new_spectrum(const AudioSpectrum& spectrum, SpectrumPreprocessor& preprocessor){
     if (m_numOriginalFrequencies != spectrum.magnitudes->size()){
         std::cout << "Error: number of frequencies don't match in SpectrogramMatcher::match() " << 
             m_numOriginalFrequencies << " " << spectrum.magnitudes->size() << std::endl;
         return false;
     }
 
-    switch(m_mode){
-    case Mode::SPIKE_CONV:
-    {
-        // Do the conv on new spectrum too.
-        AlignedVector<float> convedSpectrum(m_template.bufferSize());
-        conv(spectrum.magnitudes->data() + m_originalFreqStart,
-            m_originalFreqEnd - m_originalFreqStart, convedSpectrum.data());
-        
-        spectrum.magnitudes = std::make_unique<AlignedVector<float>>(std::move(convedSpectrum));
-        break;
-    }
-    case Mode::AVERAGE_5:
-    {
-        AlignedVector<float> avgedSpectrum(m_template.bufferSize());
-        for(size_t j = 0; j < m_template.numFrequencies(); j++){
-            const float * rawFreqMag = spectrum.magnitudes->data() + m_originalFreqStart + j*5;
-            const float newMag = (rawFreqMag[0] + rawFreqMag[1] + rawFreqMag[2] + rawFreqMag[3] + rawFreqMag[4]) / 5.0f;
-            avgedSpectrum[j] = newMag;
-        }
-        spectrum.magnitudes = std::make_unique<AlignedVector<float>>(std::move(avgedSpectrum));
-        break;
-    }
-    case Mode::RAW:
-        break;
-    }
-
-    // Compute the norm square (= sum squares) of the spectrum, used for matching:
-    // TODO: if there will be multiple SpectrogramMatcher running on the same audio stream, can
-    // move this per-spectrum computation to a shared struct for those matchers to save computation.
-    float spectrumNormSqr = 0.0f;
-    for (size_t i = m_freqStart; i < m_freqEnd; i++){
-        float mag = (*spectrum.magnitudes)[i];
-        spectrumNormSqr += mag * mag;
-    }
-    m_spectrumNormSqrs.push_front(spectrumNormSqr);
+    // The filtered spectrum and its norm square (= sum squares) are shared
+    // with every other matcher on the same feed with the same settings.
+    std::shared_ptr<const ProcessedSpectrum> processed = preprocessor.process(
+        spectrum, m_mode, m_originalFreqStart, m_originalFreqEnd
+    );
 
-    m_spectrums.emplace_front(std::move(spectrum));
+    // Overwrite the oldest slot.
+    m_newestSlot = (m_newestSlot + 1) % m_numSpectrumsNeeded;
+    m_numSpectrumsStored = std::min(m_numSpectrumsStored + 1, m_numSpectrumsNeeded);
+
+    m_stamps[m_newestSlot] = spectrum.stamp;
+    m_spectrumNormSqrs[m_newestSlot] = processed->norm_sqr;
+    Kernels::ScaleInvariantMatrixMatch::compute_dot_products(
+        m_freqEnd - m_freqStart, m_numSpectrumsNeeded,
+        m_freqStart + processed->magnitudes->data(),
+        m_matchedTemplateWindows.data(),
+        m_crossTerms.data() + m_newestSlot * m_numSpectrumsNeeded
+    );
 
     return true;
 }
 
-bool SpectrogramMatcher::update_to_new_spectrums(const std::vector<AudioSpectrum>& new_spectrums){
+bool SpectrogramMatcher::update_to_new_spectrums(const std::vector<AudioSpectrum>& new_spectrums, SpectrumPreprocessor& preprocessor){
+    if (m_numSpectrumsNeeded == 0){
+        return false;
+    }
     for (auto it = new_spectrums.rbegin(); it != new_spectrums.rend(); it++){
-        if(!update_to_new_spectrum(*it)){
+        if(!update_to_new_spectrum(*it, preprocessor)){
             return false;
         }
     }
-
-    // pop out too old spectrums
-    while (m_spectrums.size() > m_numSpectrumsNeeded){
-        m_spectrums.pop_back();
-        m_spectrumNormSqrs.pop_back();
-    }
-
     return true;
 }
 
 std::pair<float, float> SpectrogramMatcher::match_sub_template(size_t sub_index) const{
-#if 0
-    auto iter = m_spectrums.begin();
-    auto iter2 = m_spectrumNormSqrs.begin();
-    float streamSumSqr = 0.0f;
-    float sumMulti = 0.0f;
-
-    const size_t template_start = m_templateRange[sub_index].first;
-    const size_t template_end = m_templateRange[sub_index].second;
-    for(size_t i = template_start; i < template_end; i++, iter++, iter2++){
-        // match in order from latest window to oldest
-        const float* templateData = m_template.getWindow(template_end-1-i);
-        const float* streamData = iter->magnitudes->data();
-        streamSumSqr += *iter2;
-        for(size_t j = m_freqStart; j < m_freqEnd; j++){
-            sumMulti += templateData[j] * streamData[j];
-        }
-    }
-//    cout << "sumMulti = " << sumMulti << ", streamSumSqr = " << streamSumSqr << endl;
-    const float scale = (streamSumSqr < 1e-6f ? 1.0f : sumMulti / streamSumSqr);
-
-    iter = m_spectrums.begin();
-    float sum = 0.0f;
-    for(size_t i = template_start; i < template_end; i++, iter++){
-        // match in order from latest window to oldest
-        const float* templateData = m_template.getWindow(template_end-1-i);
-        const float* streamData = iter->magnitudes->data();
-        for(size_t j = m_freqStart; j < m_freqEnd; j++){
-            float d = templateData[j] - scale * streamData[j];
-            sum += d * d;
-        }
-    }
-#else
-    //  Build matrix.
-    auto iter = m_spectrums.begin();
-    const size_t template_start = m_templateRange[sub_index].first;
-    const size_t template_end = m_templateRange[sub_index].second;
-    size_t windows = template_end - template_start;
-//    cout << windows << endl;
-//    cout << m_spectrums.size() << " / " << windows << endl;
-    size_t freqs = m_freqEnd - m_freqStart;
-    std::vector<const float*> matrixA(windows);
-    std::vector<const float*> matrixT(windows);
-    for (size_t i = 0; i < windows; i++, iter++){
-//        cout << "Template: " << ((size_t)m_template.getWindow(template_end - 1 - i) % 64) << endl;
-//        cout << "Samples:  " << ((size_t)iter->magnitudes->data() % 64) << endl;
-        matrixT[i] = m_freqStart + m_template.getWindow(windows - 1 - i);
-        matrixA[i] = m_freqStart + iter->magnitudes->data();
-//        cout << matrixT[i] << " : " << matrixA[i] << endl;
+    // Every sub-template has m_numSpectrumsNeeded windows. The i-th newest
+    // spectrum is matched against template window (windows - 1 - i).
+    const size_t windows = m_templateRange[sub_index].second - m_templateRange[sub_index].first;
+
+    // The cross terms A.T and norm squares |A|^2 of the whole window come
+    // from what was computed as each spectrum arrived.
+    double sumAT = 0;
+    double sumA2 = 0;
+    for (size_t i = 0; i < windows; i++){
+        const size_t s = slot(i);
+        sumAT += m_crossTerms[s * m_numSpectrumsNeeded + windows - 1 - i];
+        sumA2 += m_spectrumNormSqrs[s];
     }
 
     //  Compute scale.
-    float scale = Kernels::ScaleInvariantMatrixMatch::compute_scale(
-        freqs, windows,
-        matrixA.data(), matrixT.data()
-    );
+    float scale = (float)(sumAT / sumA2);
     scale = std::min<float>(scale, 1000000);
 
-    //  Compute error.
-    float sum = Kernels::ScaleInvariantMatrixMatch::compute_error(
-        freqs, windows,
-        scale,
-        matrixA.data(), matrixT.data()
-    );
-#endif
+    //  Compute error: |s A - T|^2 = s^2 |A|^2 - 2 s A.T + |T|^2
+    double sum = (double)scale * scale * sumA2 - 2.0 * scale * sumAT + m_matchedTemplateNormSqr;
+    sum = std::max(sum, 0.0);
 
 
     float score = sqrt(sum) / m_templateNorm[0];
@@ -333,28 +210,29 @@ std::pair<float, float> SpectrogramMatcher::match_sub_template(size_t sub_index)
 }
 
 float SpectrogramMatcher::match(const std::vector<AudioSpectrum>& new_spectrums){
-    if (!update_to_new_spectrums(new_spectrums)){
+    return match(new_spectrums, *m_local_preprocessor);
+}
+float SpectrogramMatcher::match(const std::vector<AudioSpectrum>& new_spectrums, SpectrumPreprocessor& preprocessor){
+    if (!update_to_new_spectrums(new_spectrums, preprocessor)){
         return FLT_MAX;
     }
 
-    if (m_spectrums.size() < m_numSpectrumsNeeded){
+    if (m_numSpectrumsStored < m_numSpectrumsNeeded){
         return FLT_MAX;
     }
 
     // Check whether the stored spectrums' timestamps are continuous:
-    size_t curStamp = m_spectrums.front().stamp;
-    size_t lastStamp = curStamp + 1;
-    for (const auto& s : m_spectrums){
-        if (s.stamp != lastStamp - 1){
+    size_t curStamp = m_stamps[m_newestSlot];
+    for (size_t i = 1; i < m_numSpectrumsStored; i++){
+        if (m_stamps[slot(i)] != curStamp - i){
             std::cout << "Error: SpectrogramMatcher (" + m_name + ") spectrum timestamps are not continuous:" << std::endl;
 
-            for(const auto& sp : m_spectrums){
-                std::cout << sp.stamp << ", ";
+            for (size_t c = 0; c < m_numSpectrumsStored; c++){
+                std::cout << m_stamps[slot(c)] << ", ";
             }
             std::cout << std::endl;
             return FLT_MAX;
         }
-        lastStamp--;
     }
 
     if (m_lastStampTested != SIZE_MAX && curStamp <= m_lastStampTested){
@@ -384,17 +262,21 @@ float SpectrogramMatcher::match(const std::vector<AudioSpectrum>& new_spectrums)
 }
 
 bool SpectrogramMatcher::skip(const std::vector<AudioSpectrum>& new_spectrums){
+    return skip(new_spectrums, *m_local_preprocessor);
+}
+bool SpectrogramMatcher::skip(const std::vector<AudioSpectrum>& new_spectrums, SpectrumPreprocessor& preprocessor){
     // Note: ideally we don't want to have any computation while skipping.
-    // But update_to_new_spectrums() may still do some filtering and vector norm computation.
+    // But update_to_new_spectrums() may still do some filtering, vector norm and
+    // dot product computation since later matches need them.
     // Since the computation is relatively small and we won't be skipping lots of frames anyway,
     // this should be fine for now.
     // We can improve this later.
-    return update_to_new_spectrums(new_spectrums);
+    return update_to_new_spectrums(new_spectrums, preprocessor);
 }
 
 void SpectrogramMatcher::clear(){
-    m_spectrums.clear();
-    m_spectrumNormSqrs.clear();
+    m_newestSlot = 0;
+    m_numSpectrumsStored = 0;
     m_lastStampTested = SIZE_MAX;
 }
 
@@ -11,9 +11,10 @@
 #include <array>
 #include <memory>
 #include <vector>
-#include <list>
+#include "Common/Cpp/Containers/AlignedVector.h"
 #include "CommonFramework/AudioPipeline/AudioFeed.h"
 #include "CommonFramework/AudioPipeline/AudioTemplate.h"
+#include "CommonFramework/AudioPipeline/Spectrum/SpectrumPreprocessor.h"
 
 namespace PokemonAutomation{
 
@@ -23,16 +24,7 @@ class AudioSpectrum;
 // spectrogram of the incoming audio stream.
 class SpectrogramMatcher{
 public:
-    enum class Mode{
-        // Don't do any processing on each window of spectrum, matching raw spectrums.
-        RAW,
-        // Do convolution on each window of spectrum with a peak detection kernel, before matching spectrums.
-        SPIKE_CONV,
-        // Do convolution on each window of spectrum with a Gaussian smooth kernel, before matching spectrums.
-        // GAUSSIAN_CONV,
-        // Average every 5 frequencies to reduce computation.
-        AVERAGE_5,
-    };
+    using Mode = SpectrumProcessingMode;
 
     // audioTemplate: the audio template for the audio stream to match against.
     //  Use AudioTemplate::loadAudioTemplate() to load a template from disk, or
@@ -54,6 +46,9 @@ public:
     // timestamp) spectrums at the end.
     // In invalid cases (internal error or not enough windows), return FLT_MAX
     float match(const std::vector<AudioSpectrum>& new_spectrums);
+    // Same as above, but share the per-spectrum filtering with every other
+    // matcher that uses `preprocessor`. Use the one from the AudioFeed.
+    float match(const std::vector<AudioSpectrum>& new_spectrums, SpectrumPreprocessor& preprocessor);
 
     // Pass some spectrums in but don't run match on them.
     // Used for skipping some spectrums to avoid unnecessary matching.
@@ -61,6 +56,7 @@ public:
     // timestamp) spectrums at the end.
     // Return true if there is no error.
     bool skip(const std::vector<AudioSpectrum>& new_spectrums);
+    bool skip(const std::vector<AudioSpectrum>& new_spectrums, SpectrumPreprocessor& preprocessor);
 
     // Clear internal data to be used on another audio stream.
     void clear();
@@ -78,21 +74,24 @@ public:
     float lastMatchedScale() const { return m_lastScale; }
 
 private:
-    void conv(const float* src, size_t num, float* dst);
-    
     // The function to build `m_templateNorm`
     std::vector<float> buildTemplateNorm() const;
 
     // For a given sub-template, return its match score and scaling factor
     std::pair<float, float> match_sub_template(size_t sub_index) const;
 
+    // Slot in the ring buffer of the spectrum that is `age` spectrums older than the newest.
+    size_t slot(size_t age) const{
+        return (m_newestSlot + m_numSpectrumsNeeded - age) % m_numSpectrumsNeeded;
+    }
+
     // Update internal data for the next new spectrum. Called by `update_to_new_spectrums()`.
     // Return true if there is no error.
-    bool update_to_new_spectrum(AudioSpectrum newSpectrum);
+    bool update_to_new_spectrum(const AudioSpectrum& newSpectrum, SpectrumPreprocessor& preprocessor);
 
     // Update internal data for the new specttrums.
     // Return true if there is no error.
-    bool update_to_new_spectrums(const std::vector<AudioSpectrum>& new_spectrums);
+    bool update_to_new_spectrums(const std::vector<AudioSpectrum>& new_spectrums, SpectrumPreprocessor& preprocessor);
 
 
 
@@ -118,13 +117,30 @@ private:
 
     std::vector<float> m_convKernel;
 
-    // Spectrums from audio feed. They will be matched against the template.
-    std::list<AudioSpectrum> m_spectrums;
-    // Norm squares of each spectrum in `m_spectrums`.
-    std::list<float> m_spectrumNormSqrs;
+    // Used when the caller doesn't provide a shared preprocessor.
+    std::unique_ptr<SpectrumPreprocessor> m_local_preprocessor;
+
     // How many spectrums needed to store.
     size_t m_numSpectrumsNeeded = 0;
 
+    // The template windows each stored spectrum is matched against, offset to
+    // `m_freqStart`, and their total sum of squares.
+    std::vector<const float*> m_matchedTemplateWindows;
+    double m_matchedTemplateNormSqr = 0;
+
+    // Ring buffer of the last `m_numSpectrumsNeeded` spectrums from the audio feed.
+    // The spectrums themselves are not kept. Each slot only holds what the match
+    // needs: the timestamp, the norm square (= sum squares) of the filtered spectrum
+    // and its dot products with each of `m_matchedTemplateWindows`.
+    // The dot products of slot i are at `m_crossTerms[i * m_numSpectrumsNeeded]`.
+    std::vector<uint64_t> m_stamps;
+    std::vector<float> m_spectrumNormSqrs;
+    AlignedVector<float> m_crossTerms;
+    // Slot of the newest spectrum.
+    size_t m_newestSlot = 0;
+    // How many slots are filled.
+    size_t m_numSpectrumsStored = 0;
+
     size_t m_lastStampTested = SIZE_MAX;
     float m_lastScale = 0.0f;
 };
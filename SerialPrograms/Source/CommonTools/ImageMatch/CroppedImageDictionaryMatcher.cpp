@@ -5,12 +5,16 @@
  */
 
 #include <cmath>
+#include <vector>
+#include <algorithm>
 #include "Common/Cpp/Exceptions.h"
 #include "CommonFramework/Logging/Logger.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "CommonFramework/ImageTools/ImageStats.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
 #include "CommonFramework/Tools/DebugDumper.h"
 #include "ImageCropper.h"
+#include "DictionaryMatchPruning.h"
 //#include "ImageDiff.h"
 #include "CroppedImageDictionaryMatcher.h"
 
@@ -54,9 +58,75 @@ void CroppedImageDictionaryMatcher::add(const std::string& slug, const ImageView
 
 
 
+void CroppedImageDictionaryMatcher::match_exhaustive(
+    ImageMatchResult& results,
+    const std::vector<ImageViewRGB32>& crops, double alpha_spread
+) const{
+    for (const auto& item : m_database){
+        for (const ImageViewRGB32& crop : crops){
+            double alpha = item.second.diff(crop);
+            results.add(alpha, item.first);
+            results.clear_beyond_spread(alpha_spread);
+        }
+    }
+}
+void CroppedImageDictionaryMatcher::match_pruned(
+    ImageMatchResult& results,
+    const std::vector<ImageViewRGB32>& crops, double alpha_spread
+) const{
+    //  Random access for the thread pool. This is cheap next to scoring a
+    //  single template.
+    std::vector<const std::pair<const std::string, WeightedExactImageMatcher>*> database;
+    for (const auto& item : m_database){
+        database.emplace_back(&item);
+    }
+
+    std::vector<std::pair<double, FloatPixel>> crop_signatures;
+    for (const ImageViewRGB32& crop : crops){
+        crop_signatures.emplace_back(
+            crop ? (double)crop.width() / (double)crop.height() : 1.0,
+            crop ? image_average(crop) : FloatPixel()
+        );
+    }
+    match_dictionary_pruned(
+        results, alpha_spread,
+        database.size(), crops.size(),
+        [&](size_t index){
+            double distance = INFINITY;
+            for (const auto& signature : crop_signatures){
+                distance = std::min(
+                    distance,
+                    database[index]->second.coarse_distance(signature.first, signature.second)
+                );
+            }
+            return distance;
+        },
+        [&](double& alpha, size_t index, size_t candidate, double max_alpha){
+            return database[index]->second.diff_bounded(alpha, crops[candidate], max_alpha);
+        },
+        [&](size_t index) -> const std::string&{
+            return database[index]->first;
+        }
+    );
+}
+
+
 ImageMatchResult CroppedImageDictionaryMatcher::match(
     const ImageViewRGB32& image,
     double alpha_spread
+) const{
+    return match(image, alpha_spread, false);
+}
+ImageMatchResult CroppedImageDictionaryMatcher::match_exhaustive(
+    const ImageViewRGB32& image,
+    double alpha_spread
+) const{
+    return match(image, alpha_spread, true);
+}
+ImageMatchResult CroppedImageDictionaryMatcher::match(
+    const ImageViewRGB32& image,
+    double alpha_spread,
+    bool exhaustive
 ) const{
     ImageMatchResult results;
     if (!image){
@@ -81,12 +151,10 @@ ImageMatchResult CroppedImageDictionaryMatcher::match(
 
 
 
-    for (const auto& item : m_database){
-        for (const ImageViewRGB32& crop : crops){
-            double alpha = item.second.diff(crop);
-            results.add(alpha, item.first);
-            results.clear_beyond_spread(alpha_spread);
-        }
+    if (exhaustive){
+        match_exhaustive(results, crops, alpha_spread);
+    }else{
+        match_pruned(results, crops, alpha_spread);
     }
 
 
@@ -24,14 +24,34 @@ public:
 
     void add(const std::string& slug, const ImageViewRGB32& image);
 
+    // Templates whose score provably cannot land within `alpha_spread` of the best are skipped
+    // partway through. The result is identical to match_exhaustive().
     ImageMatchResult match(const ImageViewRGB32& image, double alpha_spread) const;
 
+    // Reference implementation of match() that fully scores every template against every crop.
+    ImageMatchResult match_exhaustive(const ImageViewRGB32& image, double alpha_spread) const;
+
 
 protected:
     //  Return potential crops for this image.
     virtual std::vector<ImageViewRGB32> get_crop_candidates(const ImageViewRGB32& image) const = 0;
 
 
+private:
+    ImageMatchResult match(const ImageViewRGB32& image, double alpha_spread, bool exhaustive) const;
+
+    //  Score all the templates against all the crops and add them to "results"
+    //  in database order.
+    void match_exhaustive(
+        ImageMatchResult& results,
+        const std::vector<ImageViewRGB32>& crops, double alpha_spread
+    ) const;
+    void match_pruned(
+        ImageMatchResult& results,
+        const std::vector<ImageViewRGB32>& crops, double alpha_spread
+    ) const;
+
+
 private:
     WeightedExactImageMatcher::InverseStddevWeight m_weight;
     std::map<std::string, WeightedExactImageMatcher> m_database;
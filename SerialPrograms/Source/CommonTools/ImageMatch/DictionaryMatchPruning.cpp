@@ -0,0 +1,75 @@
+/*  Dictionary Match Pruning
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "DictionaryMatchPruning.h"
+
+namespace PokemonAutomation{
+namespace ImageMatch{
+
+
+void match_dictionary_pruned(
+    ImageMatchResult& results, double alpha_spread,
+    size_t templates, size_t candidates,
+    const std::function<double(size_t index)>& coarse_distance,
+    const std::function<bool(double& alpha, size_t index, size_t candidate, double max_alpha)>& score_bounded,
+    const std::function<const std::string&(size_t index)>& slug
+){
+    std::vector<std::pair<double, size_t>> order;
+    for (size_t c = 0; c < templates; c++){
+        order.emplace_back(coarse_distance(c), c);
+    }
+    std::sort(order.begin(), order.end());
+
+    //  Any score is an upper bound on the final best. A score that is provably
+    //  above (best so far + alpha_spread) would be cleared anyway.
+    SpinLock lock;
+    double best = INFINITY;
+    std::vector<double> alphas(templates * candidates);
+    std::vector<uint8_t> scored(templates * candidates);
+
+    GlobalThreadPools::normal_inference().run_in_parallel(
+        [&](size_t index){
+            size_t c = order[index].second;
+            for (size_t i = 0; i < candidates; i++){
+                double threshold;
+                {
+                    ReadSpinLock lg(lock);
+                    threshold = best + alpha_spread;
+                }
+                double alpha;
+                if (!score_bounded(alpha, c, i, threshold)){
+                    continue;
+                }
+                alphas[c * candidates + i] = alpha;
+                scored[c * candidates + i] = true;
+                WriteSpinLock lg(lock);
+                best = std::min(best, alpha);
+            }
+        },
+        0, templates
+    );
+
+    //  Add in the same order as the exhaustive search so that ties come out
+    //  the same.
+    for (size_t c = 0; c < templates; c++){
+        for (size_t i = 0; i < candidates; i++){
+            if (!scored[c * candidates + i]){
+                continue;
+            }
+            results.add(alphas[c * candidates + i], slug(c));
+            results.clear_beyond_spread(alpha_spread);
+        }
+    }
+}
+
+
+}
+}
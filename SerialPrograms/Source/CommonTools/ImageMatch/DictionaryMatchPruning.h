@@ -0,0 +1,44 @@
+/*  Dictionary Match Pruning
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Score a dictionary of templates against one or more candidate images
+ *  while skipping templates that cannot make it into the results.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonTools_DictionaryMatchPruning_H
+#define PokemonAutomation_CommonTools_DictionaryMatchPruning_H
+
+#include <string>
+#include <functional>
+#include "ImageMatchResult.h"
+
+namespace PokemonAutomation{
+namespace ImageMatch{
+
+
+//  Score every template against every candidate and add them to "results".
+//  The results are exactly the same as scoring them all in template order and
+//  calling "add()" + "clear_beyond_spread()" after each one.
+//
+//  Templates are tried in increasing "coarse_distance()" so that a good bound
+//  is available early. A score that provably cannot land within "alpha_spread"
+//  of the best is given up on partway through.
+//
+//  coarse_distance(t): The order to try template "t" in. Need not be a bound.
+//  score_bounded(alpha, t, c, max_alpha): Score template "t" against candidate
+//      "c". Return false if it gave up because the score is above "max_alpha".
+//  slug(t): The slug of template "t".
+void match_dictionary_pruned(
+    ImageMatchResult& results, double alpha_spread,
+    size_t templates, size_t candidates,
+    const std::function<double(size_t index)>& coarse_distance,
+    const std::function<bool(double& alpha, size_t index, size_t candidate, double max_alpha)>& score_bounded,
+    const std::function<const std::string&(size_t index)>& slug
+);
+
+
+}
+}
+#endif
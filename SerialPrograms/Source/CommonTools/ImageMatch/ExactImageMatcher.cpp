@@ -6,7 +6,7 @@
 
 #include <cmath>
 #include "Common/Cpp/Exceptions.h"
-#include "CommonFramework/ImageTools/ImageDiff.h"
+#include "Kernels/ImageStats/Kernels_ImageScaledSumSqrDev.h"
 #include "ExactImageMatcher.h"
 
 //#include <iostream>
@@ -27,68 +27,100 @@ ExactImageMatcher::ExactImageMatcher(ImageRGB32 image)
 //    cout << m_stats.stddev.sum() << endl;
 }
 
-ImageRGB32 ExactImageMatcher::scale_template_brightness(const ImageViewRGB32& image) const{
-    FloatPixel image_brightness = pixel_average(image, m_image);
-    FloatPixel scale = image_brightness / m_stats.average;
+double ExactImageMatcher::coarse_distance(double aspect_ratio, const FloatPixel& average) const{
+    double template_aspect_ratio = (double)m_image.width() / (double)m_image.height();
+    double distance = std::abs(std::log(aspect_ratio / template_aspect_ratio));
 
-    if (std::isnan(scale.r)) scale.r = 1.0;
-    if (std::isnan(scale.g)) scale.g = 1.0;
-    if (std::isnan(scale.b)) scale.b = 1.0;
-    scale.bound(0.85, 1.15);
-
-    ImageRGB32 ret = m_image.copy();
-    scale_brightness(ret, scale);
-//    ret.save("test.png");
-    return ret;
+    //  Compare chromaticity since the brightness is normalized when matching.
+    double template_brightness = m_stats.average.sum();
+    double image_brightness = average.sum();
+    if (template_brightness > 0 && image_brightness > 0){
+        distance += euclidean_distance(m_stats.average / template_brightness, average / image_brightness);
+    }
+    return distance;
 }
 
 
-double ExactImageMatcher::rmsd(const ImageViewRGB32& image) const{
+bool ExactImageMatcher::compute_rmsd(
+    double& rmsd, const ImageViewRGB32& image,
+    Kernels::SumSquareMode mode, uint32_t background,
+    double max_rmsd
+) const{
     if (!image){
-        return 1000.;
+        rmsd = 1000.;
+        return true;
     }
 
-//    image.save("test.png");
+    //  Scale the template brightness to match the image. This is the same scale
+    //  that "scale_brightness()" would apply to a copy of the template.
+    Kernels::ScaledPixelSums sums;
+    Kernels::scaled_pixel_sum(
+        sums,
+        m_image.width(), m_image.height(),
+        m_image.data(), m_image.bytes_per_row(),
+        image.width(), image.height(),
+        image.data(), image.bytes_per_row()
+    );
+    FloatPixel image_brightness(
+        (double)sums.sum[2] / (double)sums.count,
+        (double)sums.sum[1] / (double)sums.count,
+        (double)sums.sum[0] / (double)sums.count
+    );
+    FloatPixel scale = image_brightness / m_stats.average;
 
-//    cout << "ExactImageMatcher::rmsd(): image = " << image.width() << " x " << image.height() << endl;
-    ImageRGB32 scaled = image.scale_to(m_image.width(), m_image.height());
-//    cout << "ExactImageMatcher::rmsd(): scaled = " << scaled.width() << " x " << scaled.height() << endl;
-    ImageRGB32 reference = scale_template_brightness(scaled);
+    if (std::isnan(scale.r)) scale.r = 1.0;
+    if (std::isnan(scale.g)) scale.g = 1.0;
+    if (std::isnan(scale.b)) scale.b = 1.0;
+    scale.bound(0.85, 1.15);
 
-#if 0
-    static int c = 0;
-    image.save("test-" + std::to_string(c) + "-image.png");
-    reference.save("test-" + std::to_string(c) + "-sprite.png");
-    c++;
-#endif
+    //  When bounded, visit the rows in interleaved passes so that every partial
+    //  sum covers the whole template. The partial sums are exact and can only
+    //  grow. So a bad match can be rejected after the first pass.
+    const size_t passes = std::isinf(max_rmsd) || m_stats.count == 0 ? 1 : 8;
+    const double max_sumsqrs = max_rmsd * max_rmsd * (double)sums.count;
+
+    uint64_t sumsqrs = 0;
+    for (size_t pass = 0; pass < passes; pass++){
+        Kernels::scaled_sum_sqr_deviation(
+            sumsqrs, mode,
+            m_image.width(), m_image.height(),
+            m_image.data(), m_image.bytes_per_row(),
+            image.width(), image.height(),
+            image.data(), image.bytes_per_row(),
+            (float)scale.r, (float)scale.g, (float)scale.b,
+            background,
+            pass, passes
+        );
+        if (pass + 1 < passes && (double)sumsqrs > max_sumsqrs){
+            return false;
+        }
+    }
 
-    double rmsd = pixel_RMSD(reference, scaled);
-//    cout << "rmsd = " << rmsd << endl;
-    return rmsd;
+    rmsd = std::sqrt((double)sumsqrs / (double)sums.count);
+    return true;
 }
-double ExactImageMatcher::rmsd(const ImageViewRGB32& image, Color background) const{
-    if (!image){
-        return 1000.;
-    }
-    ImageRGB32 scaled = image.scale_to(m_image.width(), m_image.height());
-    ImageRGB32 reference = scale_template_brightness(scaled);
 
-#if 0
-    static int c = 0;
-    scaled.save("test-" + std::to_string(c) + "-image.png");
-    reference.save("test-" + std::to_string(c) + "-sprite.png");
-    c++;
-#endif
 
-    return pixel_RMSD(reference, scaled, background);
+double ExactImageMatcher::rmsd(const ImageViewRGB32& image) const{
+    double ret;
+    compute_rmsd(ret, image, Kernels::SumSquareMode::REFERENCE_ALPHA, 0, INFINITY);
+    return ret;
+}
+double ExactImageMatcher::rmsd(const ImageViewRGB32& image, Color background) const{
+    double ret;
+    compute_rmsd(ret, image, Kernels::SumSquareMode::USE_BACKGROUND, (uint32_t)background, INFINITY);
+    return ret;
 }
 double ExactImageMatcher::rmsd_masked(const ImageViewRGB32& image) const{
-    if (!image){
-        return 1000.;
-    }
-    ImageRGB32 scaled = image.scale_to(m_image.width(), m_image.height());
-    ImageRGB32 reference = scale_template_brightness(scaled);
-    return pixel_RMSD_masked(reference, scaled);
+    double ret;
+    compute_rmsd(ret, image, Kernels::SumSquareMode::ARBITRATE_ALPHAS, 0, INFINITY);
+    return ret;
+}
+bool ExactImageMatcher::rmsd_bounded(double& rmsd, const ImageViewRGB32& image, double max_rmsd) const{
+    return compute_rmsd(rmsd, image, Kernels::SumSquareMode::REFERENCE_ALPHA, 0, max_rmsd);
+}
+bool ExactImageMatcher::rmsd_masked_bounded(double& rmsd, const ImageViewRGB32& image, double max_rmsd) const{
+    return compute_rmsd(rmsd, image, Kernels::SumSquareMode::ARBITRATE_ALPHAS, 0, max_rmsd);
 }
 
 
@@ -118,6 +150,17 @@ double WeightedExactImageMatcher::diff_masked(const ImageViewRGB32& image) const
     }
     return rmsd_masked(image) * m_multiplier;
 }
+bool WeightedExactImageMatcher::diff_bounded(double& alpha, const ImageViewRGB32& image, double max_alpha) const{
+    if (!image){
+        alpha = 1000.;
+        return true;
+    }
+    if (!rmsd_bounded(alpha, image, max_alpha / m_multiplier)){
+        return false;
+    }
+    alpha *= m_multiplier;
+    return true;
+}
 
 
 
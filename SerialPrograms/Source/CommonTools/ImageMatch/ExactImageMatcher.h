@@ -9,6 +9,7 @@
 
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/ImageTools/ImageStats.h"
+#include "Kernels/ImageStats/Kernels_ImagePixelSumSqrDev.h"
 
 namespace PokemonAutomation{
 namespace ImageMatch{
@@ -50,12 +51,27 @@ public:
     // If both two images have alpha==0 on one pixel, that pixel is ignored.
     double rmsd_masked(const ImageViewRGB32& image) const;
 
+    // Same as rmsd(image) and rmsd_masked(image), but may give up as soon as the result is known to
+    // be larger than `max_rmsd`. Return false if it gave up. Otherwise `rmsd` is set to exactly what
+    // the unbounded version returns.
+    bool rmsd_bounded(double& rmsd, const ImageViewRGB32& image, double max_rmsd) const;
+    bool rmsd_masked_bounded(double& rmsd, const ImageViewRGB32& image, double max_rmsd) const;
+
+    // A cheap estimate of how far an image with this aspect ratio and average color is from the
+    // template. Dictionary matchers use it to try the likely templates first. It is not a bound on
+    // the RMSD.
+    double coarse_distance(double aspect_ratio, const FloatPixel& average) const;
+
     const ImageRGB32& image_template() const { return m_image; }
 
 private:
-    // scale stored image template according to the brightness of `image`, assign
-    // the scaled template to `reference`.
-    ImageRGB32 scale_template_brightness(const ImageViewRGB32& image) const;
+    // Shared implementation of the above. The resize, brightness scaling and RMSD
+    // are fused into two kernel passes. See Kernels_ImageScaledSumSqrDev.h.
+    bool compute_rmsd(
+        double& rmsd, const ImageViewRGB32& image,
+        Kernels::SumSquareMode mode, uint32_t background,
+        double max_rmsd
+    ) const;
 
 protected:
     ImageRGB32 m_image;
@@ -89,6 +105,8 @@ public:
     double diff(const ImageViewRGB32& image, Color background) const;
     // Like ExactImageMatcher::rmsd_masked(image) but scale based on template stddev.
     double diff_masked(const ImageViewRGB32& image) const;
+    // Like ExactImageMatcher::rmsd_bounded(rmsd, image, max_rmsd) but scale based on template stddev.
+    bool diff_bounded(double& alpha, const ImageViewRGB32& image, double max_alpha) const;
 
 public:
     double m_multiplier;
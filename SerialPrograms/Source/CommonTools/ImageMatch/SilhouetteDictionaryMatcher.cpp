@@ -4,12 +4,13 @@
  *
  */
 
+#include <vector>
 #include "Common/Cpp/Exceptions.h"
-#include "Common/Cpp/Concurrency/SpinLock.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
 #include "CommonFramework/ImageTools/ImageDiff.h"
-#include "CommonFramework/Tools/GlobalThreadPools.h"
+#include "CommonFramework/ImageTools/ImageStats.h"
 #include "ImageCropper.h"
+#include "DictionaryMatchPruning.h"
 #include "SilhouetteDictionaryMatcher.h"
 
 //#include <iostream>
@@ -29,12 +30,11 @@ void SilhouetteDictionaryMatcher::add(const std::string& slug, const ImageViewRG
         throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Duplicate slug: " + slug);
     }
 
-    iter = m_database.emplace(
+    m_database.emplace(
         std::piecewise_construct,
         std::forward_as_tuple(slug),
         std::forward_as_tuple(trim_image_alpha(image).copy())
-    ).first;
-    m_database_vector.emplace_back(&*iter);
+    );
 }
 
 
@@ -48,32 +48,44 @@ ImageMatchResult SilhouetteDictionaryMatcher::match(
         return results;
     }
 
-    SpinLock lock;
-    GlobalThreadPools::normal_inference().run_in_parallel(
+    //  Random access for the thread pool. This is cheap next to scoring a
+    //  single template.
+    std::vector<const std::pair<const std::string, ExactImageMatcher>*> database;
+    for (const auto& item : m_database){
+        database.emplace_back(&item);
+    }
+
+    double aspect_ratio = (double)image.width() / (double)image.height();
+    FloatPixel average = image_average(image);
+    match_dictionary_pruned(
+        results, alpha_spread,
+        database.size(), 1,
         [&](size_t index){
-            const auto& matcher = *m_database_vector[index];
-            double alpha = matcher.second.rmsd_masked(image);
-            WriteSpinLock lg(lock);
-            results.add(alpha, matcher.first);
-            results.clear_beyond_spread(alpha_spread);
+            return database[index]->second.coarse_distance(aspect_ratio, average);
         },
-        0, m_database_vector.size(),
-        100
+        [&](double& alpha, size_t index, size_t, double max_alpha){
+            return database[index]->second.rmsd_masked_bounded(alpha, image, max_alpha);
+        },
+        [&](size_t index) -> const std::string&{
+            return database[index]->first;
+        }
     );
 
-
-#if 0
+    return results;
+}
+ImageMatchResult SilhouetteDictionaryMatcher::match_exhaustive(
+    const ImageViewRGB32& image,
+    double alpha_spread
+) const{
+    ImageMatchResult results;
+    if (!image){
+        return results;
+    }
     for (const auto& item : m_database){
-//        if (item.first != "solosis"){
-//            continue;
-//        }
         double alpha = item.second.rmsd_masked(image);
-//        WriteSpinLock lg(lock);
         results.add(alpha, item.first);
         results.clear_beyond_spread(alpha_spread);
     }
-#endif
-
     return results;
 }
 
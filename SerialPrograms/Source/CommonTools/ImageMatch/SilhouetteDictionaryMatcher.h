@@ -42,12 +42,16 @@ public:
     // Alpha channels from both the template and the input image are considered when computing RMSD.
     // If only one of the two has alpha==255 on one pixel, that the deviation on that pixel is the max pixel distance.
     // If both two images have alpha==0 on one pixel, that pixel is ignored.
+    // Templates whose score provably cannot land within `alpha_spread` of the best are skipped
+    // partway through. The result is identical to match_exhaustive().
     ImageMatchResult match(const ImageViewRGB32& image, double alpha_spread) const;
 
+    // Reference implementation of match() that fully scores every template.
+    ImageMatchResult match_exhaustive(const ImageViewRGB32& image, double alpha_spread) const;
+
 
 private:
     std::map<std::string, ExactImageMatcher> m_database;
-    std::vector<const std::pair<const std::string, ExactImageMatcher>*> m_database_vector;
 };
 
 
@@ -169,6 +169,34 @@ std::vector<PackedBinaryMatrix> compress_rgb32_to_binary_range(
     return ret;
 }
 
+PackedBinaryMatrix compress_rgb32_to_binary_hsv_range(
+    const ImageViewRGB32& image,
+    uint32_t mins, uint32_t maxs
+){
+    PackedBinaryMatrix ret(image.width(), image.height());
+    Kernels::compress_rgb32_to_binary_hsv_range(
+        image.data(), image.bytes_per_row(),
+        ret, mins, maxs
+    );
+    return ret;
+}
+std::vector<PackedBinaryMatrix> compress_rgb32_to_binary_hsv_range(
+    const ImageViewRGB32& image,
+    const std::vector<std::pair<uint32_t, uint32_t>>& filters
+){
+    std::vector<PackedBinaryMatrix> ret;
+    FixedLimitVector<Kernels::CompressRgb32ToBinaryRangeFilter> vec(filters.size());
+    for (size_t c = 0; c < filters.size(); c++){
+        ret.emplace_back(image.width(), image.height());
+        vec.emplace_back(ret[c], filters[c].first, filters[c].second);
+    }
+    Kernels::compress_rgb32_to_binary_hsv_range(
+        image.data(), image.bytes_per_row(),
+        vec.data(), vec.size()
+    );
+    return ret;
+}
+
 
 
 PackedBinaryMatrix compress_rgb32_to_binary_multirange(
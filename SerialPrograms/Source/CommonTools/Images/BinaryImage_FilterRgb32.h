@@ -88,6 +88,19 @@ std::vector<PackedBinaryMatrix> compress_rgb32_to_binary_range(
 
 
 
+//  Same as above, but the ranges are in HSV. (0xAAHHSSVV, as in ImageHSV32)
+//  The image is converted on the fly without building an ImageHSV32.
+PackedBinaryMatrix compress_rgb32_to_binary_hsv_range(
+    const ImageViewRGB32& image,
+    uint32_t mins, uint32_t maxs
+);
+std::vector<PackedBinaryMatrix> compress_rgb32_to_binary_hsv_range(
+    const ImageViewRGB32& image,
+    const std::vector<std::pair<uint32_t, uint32_t>>& filters
+);
+
+
+
 //  Run multiple filters and OR them all together. (experimental)
 PackedBinaryMatrix compress_rgb32_to_binary_multirange(
     const ImageViewRGB32& image,
@@ -17,6 +17,12 @@ bool VisualInferenceCallback::process_frame(const VideoSnapshot& frame){
 bool VisualInferenceCallback::process_frame(const ImageViewRGB32& frame, WallClock timestamp){
     throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "You must override one of the two process_frame() functions.");
 }
+bool VisualInferenceCallback::process_frame(const VideoRegionSnapshot& frame){
+    VideoSnapshot snapshot;
+    snapshot.frame = frame.full_frame();
+    snapshot.timestamp = frame.timestamp;
+    return process_frame(snapshot);
+}
 
 
 
@@ -16,6 +16,7 @@ namespace PokemonAutomation{
 class ImageViewRGB32;
 class ImageRGB32;
 struct VideoSnapshot;
+struct VideoRegionSnapshot;
 class VideoOverlaySet;
 
 //  Base class for a visual inference object to be called perioridically by
@@ -37,6 +38,17 @@ public:
     //  You must override at least one of the overloaded `process_frame()`.
     virtual bool process_frame(const ImageViewRGB32& frame, WallClock timestamp);
 
+    //  Callbacks that only look at a few small boxes can return true here to
+    //  receive frames that are converted lazily. They must then override the
+    //  `VideoRegionSnapshot` overload of `process_frame()` and only use
+    //  `VideoRegionSnapshot::region()` to access the pixels.
+    virtual bool wants_region_snapshots() const{ return false; }
+
+    //  Return true if the inference session should stop.
+    //  Only called if `wants_region_snapshots()` returns true. The default
+    //  converts the whole frame and forwards to the `VideoSnapshot` overload.
+    virtual bool process_frame(const VideoRegionSnapshot& frame);
+
 };
 
 
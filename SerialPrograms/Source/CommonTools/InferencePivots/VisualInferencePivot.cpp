@@ -4,7 +4,12 @@
  *
  */
 
+#include <algorithm>
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "CommonFramework/GlobalSettingsPanel.h"
+#include "CommonFramework/Options/Environment/PerformanceOptions.h"
+#include "CommonFramework/Tools/GlobalThreadPools.h"
 #include "CommonFramework/VideoPipeline/VideoFeed.h"
 #include "VisualInferencePivot.h"
 
@@ -23,6 +28,7 @@ struct VisualInferencePivot::PeriodicCallback{
     std::chrono::milliseconds period;
     StatAccumulatorI32 stats;
     WallClock last_timestamp;
+    bool regions;
 
     PeriodicCallback(
         Cancellable& p_scope,
@@ -35,14 +41,21 @@ struct VisualInferencePivot::PeriodicCallback{
         , callback(p_callback)
         , period(p_period)
         , last_timestamp(WallClock::min())
+        , regions(p_callback.wants_region_snapshots())
     {}
 };
 
 
 
 VisualInferencePivot::VisualInferencePivot(CancellableScope& scope, VideoFeed& feed, AsyncDispatcher& dispatcher)
-    : PeriodicRunner(dispatcher)
+    : PeriodicRunner(dispatcher, GlobalSettings::instance().PERFORMANCE->PARALLEL_VISUAL_INFERENCE)
     , m_feed(feed)
+    , m_parallel_pool(
+        GlobalSettings::instance().PERFORMANCE->PARALLEL_VISUAL_INFERENCE
+            ? &GlobalThreadPools::realtime_inference()
+            : nullptr
+    )
+    , m_last_critical_path(0)
 {
     attach(scope);
 }
@@ -84,11 +97,45 @@ StatAccumulatorI32 VisualInferencePivot::remove_callback(VisualInferenceCallback
     m_map.erase(iter);
     return stats;
 }
+WallClock VisualInferencePivot::frame_timestamp(const PeriodicCallback& callback) const{
+    return callback.regions ? m_last_regions.timestamp : m_last.timestamp;
+}
+bool VisualInferencePivot::has_frame(const PeriodicCallback& callback) const{
+    return callback.regions ? (bool)m_last_regions : (bool)m_last;
+}
+void VisualInferencePivot::refresh_frame(bool regions, WallClock min_time){
+    if (regions){
+        m_last_regions = m_feed.snapshot_regions_nonblocking(min_time);
+    }else{
+        m_last = m_feed.snapshot_recent_nonblocking(min_time);
+    }
+}
+void VisualInferencePivot::process_frame(PeriodicCallback& callback) noexcept{
+    try{
+        WallClock time0 = current_time();
+        bool stop = callback.regions
+            ? callback.callback.process_frame(m_last_regions)
+            : callback.callback.process_frame(m_last);
+        WallClock time1 = current_time();
+        callback.stats += (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count();
+        callback.last_timestamp = frame_timestamp(callback);
+
+        if (stop){
+            if (callback.set_when_triggered){
+                InferenceCallback* expected = nullptr;
+                callback.set_when_triggered->compare_exchange_strong(expected, &callback.callback);
+            }
+            callback.scope.cancel(nullptr);
+        }
+    }catch (...){
+        callback.scope.cancel(std::current_exception());
+    }
+}
 void VisualInferencePivot::run(void* event, bool is_back_to_back) noexcept{
     PeriodicCallback& callback = *(PeriodicCallback*)event;
     try{
         //  Reuse the cached screenshot.
-        if (!is_back_to_back || callback.last_timestamp == m_last.timestamp){
+        if (!is_back_to_back || callback.last_timestamp == frame_timestamp(callback)){
 //            cout << "back-to-back" << endl;
 //            m_last = m_feed.snapshot();
 
@@ -97,34 +144,99 @@ void VisualInferencePivot::run(void* event, bool is_back_to_back) noexcept{
                 min_time = current_time() - 2 * callback.period;
             }
 
-            m_last = m_feed.snapshot_recent_nonblocking(min_time);
+            refresh_frame(callback.regions, min_time);
         }
+    }catch (...){
+        callback.scope.cancel(std::current_exception());
+        return;
+    }
 
-        if (!m_last){
-            return;
-        }
+    if (!has_frame(callback)){
+        return;
+    }
 
-        WallClock time0 = current_time();
-        bool stop = callback.callback.process_frame(m_last);
-        WallClock time1 = current_time();
-        callback.stats += (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count();
-        callback.last_timestamp = m_last.timestamp;
+    process_frame(callback);
+}
+void VisualInferencePivot::run_batch(void* const* events, size_t count, bool is_back_to_back) noexcept{
+    if (m_parallel_pool == nullptr || count <= 1){
+        PeriodicRunner::run_batch(events, count, is_back_to_back);
+        return;
+    }
 
-        if (stop){
-            if (callback.set_when_triggered){
-                InferenceCallback* expected = nullptr;
-                callback.set_when_triggered->compare_exchange_strong(expected, &callback.callback);
+    //  Grab one frame of each kind for everything that's due. It must be newer
+    //  than what every callback in the batch has already seen.
+    //  Index 0 is the fully converted frame. Index 1 is the region snapshot.
+    bool used[2] = {false, false};
+    bool refresh[2] = {!is_back_to_back, !is_back_to_back};
+    WallClock min_time[2] = {WallClock::max(), WallClock::max()};
+    for (size_t c = 0; c < count; c++){
+        PeriodicCallback& callback = *(PeriodicCallback*)events[c];
+        size_t kind = callback.regions ? 1 : 0;
+        used[kind] = true;
+        refresh[kind] |= callback.last_timestamp == frame_timestamp(callback);
+        WallClock current = callback.last_timestamp;
+        if (current == WallClock::min()){
+            current = current_time() - 2 * callback.period;
+        }
+        min_time[kind] = std::min(min_time[kind], current);
+    }
+
+    try{
+        m_batch.clear();
+        m_batch.reserve(count);
+        for (size_t kind = 0; kind < 2; kind++){
+            if (used[kind] && refresh[kind]){
+                refresh_frame(kind != 0, min_time[kind]);
             }
-            callback.scope.cancel(nullptr);
         }
     }catch (...){
-        callback.scope.cancel(std::current_exception());
+        for (size_t c = 0; c < count; c++){
+            ((PeriodicCallback*)events[c])->scope.cancel(std::current_exception());
+        }
+        return;
+    }
+
+    for (size_t c = 0; c < count; c++){
+        PeriodicCallback* callback = (PeriodicCallback*)events[c];
+        if (has_frame(*callback)){
+            m_batch.emplace_back(callback);
+        }
+    }
+    if (m_batch.empty()){
+        return;
     }
+
+    //  Every callback is independent and "process_frame()" doesn't throw.
+    //  So neither does "run_in_parallel()". The calling thread runs whatever
+    //  the pool doesn't get to. "set_when_triggered" is a compare-exchange so
+    //  the first callback to trigger still wins.
+    WallClock time0 = current_time();
+    m_parallel_pool->run_in_parallel(
+        [this](size_t index){
+            process_frame(*m_batch[index]);
+        },
+        0, m_batch.size(), 1
+    );
+    WallClock time1 = current_time();
+
+    uint32_t latency = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count();
+    WriteSpinLock lg(m_stats_lock);
+    m_last_critical_path = latency;
 }
 
 
 OverlayStatSnapshot VisualInferencePivot::get_current(){
-    return m_printer.get_snapshot("Video Pivot Utilization:", this->current_utilization());
+    OverlayStatSnapshot ret = m_printer.get_snapshot("Video Pivot Utilization:", this->current_utilization());
+    if (m_parallel_pool == nullptr || ret.text.empty()){
+        return ret;
+    }
+    uint32_t latency;
+    {
+        ReadSpinLock lg(m_stats_lock);
+        latency = m_last_critical_path;
+    }
+    ret.text += " (frame: " + tostr_fixed(latency / 1000., 1) + " ms)";
+    return ret;
 }
 
 
@@ -9,6 +9,7 @@
 
 #include "Common/Cpp/Concurrency/SpinLock.h"
 #include "Common/Cpp/Concurrency/PeriodicScheduler.h"
+#include "Common/Cpp/Concurrency/ComputationThreadPool.h"
 #include "CommonFramework/Tools/StatAccumulator.h"
 #include "CommonFramework/VideoPipeline/VideoFeed.h"
 #include "CommonFramework/VideoPipeline/VideoOverlayTypes.h"
@@ -40,16 +41,32 @@ public:
     StatAccumulatorI32 remove_callback(VisualInferenceCallback& callback);
 
 private:
+    struct PeriodicCallback;
+
     virtual void run(void* event, bool is_back_to_back) noexcept override;
+    virtual void run_batch(void* const* events, size_t count, bool is_back_to_back) noexcept override;
     virtual OverlayStatSnapshot get_current() override;
 
-private:
-    struct PeriodicCallback;
+    WallClock frame_timestamp(const PeriodicCallback& callback) const;
+    bool has_frame(const PeriodicCallback& callback) const;
+    void refresh_frame(bool regions, WallClock min_time);
+    void process_frame(PeriodicCallback& callback) noexcept;
 
     VideoFeed& m_feed;
     SpinLock m_lock;
     std::map<VisualInferenceCallback*, PeriodicCallback> m_map;
     VideoSnapshot m_last;
+    VideoRegionSnapshot m_last_regions;     //  For callbacks that want regions.
+
+    //  Non-null if we are running in parallel mode.
+    ComputationThreadPool* m_parallel_pool;
+    std::vector<PeriodicCallback*> m_batch;
+
+    //  In parallel mode, this is the wall-clock time it took to run all the
+    //  callbacks that were due on the last frame. (the slowest callback +
+    //  overhead) Units are microseconds.
+    mutable SpinLock m_stats_lock;
+    uint32_t m_last_critical_path;
 
     OverlayStatUtilizationPrinter m_printer;
 };
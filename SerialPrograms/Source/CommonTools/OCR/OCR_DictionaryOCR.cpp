@@ -10,7 +10,6 @@
 #include "Common/Qt/StringToolsQt.h"
 #include "CommonFramework/Logging/Logger.h"
 #include "OCR_StringNormalization.h"
-#include "OCR_TextMatcher.h"
 #include "OCR_DictionaryOCR.h"
 
 //#include <iostream>
@@ -51,6 +50,7 @@ DictionaryOCR::DictionaryOCR(
             }
         }
     }
+    m_compiled = CompiledTextDictionary(m_candidate_to_token);
     global_logger_tagged().log(
         "DictionaryOCR - Tokens: " + std::to_string(m_database.size()) +
         ", Match Candidates: " + std::to_string(m_candidate_to_token.size())
@@ -92,10 +92,7 @@ StringMatchResult DictionaryOCR::match_substring(
     const std::string& text,
     double log10p_spread
 ) const{
-    return OCR::match_substring(
-        m_candidate_to_token, m_random_match_chance,
-        text, log10p_spread
-    );
+    return m_compiled.match_substring(m_random_match_chance, text, log10p_spread);
 }
 void DictionaryOCR::add_candidate(std::string token, const std::u32string& candidate){
     if (candidate.size() < 2){
@@ -108,7 +105,8 @@ void DictionaryOCR::add_candidate(std::string token, const std::u32string& candi
     if (iter == m_candidate_to_token.end()){
         //  New candidate. Add it to both maps.
         m_database[token].emplace_back(to_utf8(candidate));
-        m_candidate_to_token[candidate].insert(std::move(token));
+        auto& item = *m_candidate_to_token.emplace(candidate, std::set<std::string>{std::move(token)}).first;
+        m_compiled.add(item);
         return;
     }
 
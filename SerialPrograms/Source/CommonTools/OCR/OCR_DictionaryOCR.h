@@ -12,6 +12,7 @@
 #include <map>
 #include "Common/Cpp/Concurrency/SpinLock.h"
 #include "OCR_StringMatchResult.h"
+#include "OCR_TextMatcher.h"
 
 namespace PokemonAutomation{
     class JsonObject;
@@ -51,6 +52,7 @@ private:
     double m_random_match_chance;
     std::map<std::string, std::vector<std::string>> m_database;
     std::map<std::u32string, std::set<std::string>> m_candidate_to_token;
+    CompiledTextDictionary m_compiled;
 };
 
 
@@ -5,13 +5,22 @@
  */
 
 #include <memory>
+#include <string.h>
 #include <deque>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
 #include <QFile>
 #include <QDir>
 #include "3rdParty/TesseractPA/TesseractPA.h"
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/Concurrency/SpinLock.h"
+#include "Common/Cpp/MemoryUtilization/MemoryUtilization.h"
 #include "CommonFramework/Globals.h"
+#include "CommonFramework/GlobalSettingsPanel.h"
+#include "CommonFramework/Options/Environment/PerformanceOptions.h"
 #include "CommonFramework/Logging/Logger.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
 #include "OCR_RawOCR.h"
@@ -37,6 +46,17 @@ bool language_available(Language language){
 
 
 
+//  A bitmap in one of the formats that Tesseract reads directly.
+struct OcrBitmap{
+    const unsigned char* data;
+    size_t width;
+    size_t height;
+    size_t bytes_per_pixel;     //  1 = 8-bit grayscale, 4 = RGB32
+    size_t bytes_per_row;
+};
+
+
+
 class TesseractPool{
 public:
     TesseractPool(Language language)
@@ -46,86 +66,55 @@ public:
         )
     {}
 
-    std::string run(const ImageViewRGB32& image){
-        TesseractAPI* instance;
-        while (true){
-            {
-                WriteSpinLock lg(m_lock, "TesseractPool::run()");
-                if (!m_idle.empty()){
-                    instance = m_idle.back();
-                    m_idle.pop_back();
-                    break;
-                }
-            }
-            add_instance();
-        }
-
-//        auto start = current_time();
-        TesseractString str = instance->read32(
-            (const unsigned char*)image.data(),
-            image.width(),
-            image.height(),
-            image.bytes_per_row()
-        );
-//        auto end = current_time();
-//        cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << endl;
+    std::string run(const OcrBitmap& image){
+        TesseractAPI* instance = acquire();
 
-        {
-            WriteSpinLock lg(m_lock, "TesseractPool::run()");
-            m_idle.emplace_back(instance);
-        }
-
-        return str.c_str() == nullptr
-            ? std::string()
-            : str.c_str();
-    }
-
-    void add_instance(){
-        //  Check for non-ascii characters in path.
-        for (char ch : m_training_data_path){
-            if (ch < 0){
-                throw InternalSystemError(
-                    nullptr, PA_CURRENT_FUNCTION,
-                    "Detected non-ASCII character in Tesseract path. Please move the program to a path with only ASCII characters."
-                );
-            }
-        }
-
-        global_logger_tagged().log(
-            "Initializing TesseractAPI (" + m_language_code + "): " + m_training_data_path
-        );
-        std::unique_ptr<TesseractAPI> api(
-            new TesseractAPI(m_training_data_path.c_str(), m_language_code.c_str())
-        );
-        if (!api->valid()){
-            throw InternalSystemError(nullptr, PA_CURRENT_FUNCTION, "Could not initialize TesseractAPI.");
-        }
-
-        WriteSpinLock lg(m_lock, "TesseractPool::run()");
-
-        m_instances.emplace_back(std::move(api));
+        std::string ret;
         try{
-            m_idle.emplace_back(m_instances.back().get());
+//            auto start = current_time();
+            TesseractString str = image.bytes_per_pixel == 1
+                ? instance->read8(image.data, image.width, image.height, image.bytes_per_row)
+                : instance->read32(image.data, image.width, image.height, image.bytes_per_row);
+//            auto end = current_time();
+//            cout << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << endl;
+            if (str.c_str() != nullptr){
+                ret = str.c_str();
+            }
         }catch (...){
-            m_instances.pop_back();
+            release(instance);
             throw;
         }
+
+        release(instance);
+        return ret;
     }
 
     void ensure_instances(size_t instances){
-        size_t current_instances;
+        instances = std::min(instances, max_instances());
         while (true){
             {
-                ReadSpinLock lg(m_lock, "TesseractPool::run()");
-                current_instances = m_instances.size();
-            }
-            if (current_instances >= instances){
-                break;
+                std::lock_guard<std::mutex> lg(m_lock);
+                if (m_instances.size() + m_pending >= instances){
+                    return;
+                }
+                m_pending++;
             }
-            add_instance();
+            TesseractAPI* instance = add_instance();
+            release(instance);
         }
     }
 
+    void add_stats(PoolStats& stats){
+        std::lock_guard<std::mutex> lg(m_lock);
+        stats.instances += m_instances.size();
+        stats.busy += m_instances.size() - m_idle.size();
+        stats.waiting += m_waiting;
+        stats.memory += m_memory;
+        stats.acquisitions += m_acquisitions;
+        stats.waits += m_waits;
+        stats.total_wait += m_total_wait;
+    }
+
 #ifdef __APPLE__
 #ifdef UNIX_LINK_TESSERACT
     ~TesseractPool(){
@@ -146,18 +135,247 @@ public:
 #endif
 #endif
 
+private:
+    static size_t max_instances(){
+        size_t ret = GlobalSettings::instance().PERFORMANCE->OCR_MAX_INSTANCES;
+        return std::max(ret, (size_t)1);
+    }
+
+    //  Get an idle instance. If there are none, create one if under the limit.
+    //  Otherwise wait for one to be released.
+    TesseractAPI* acquire(){
+        std::unique_lock<std::mutex> lg(m_lock);
+        m_acquisitions++;
+        bool waited = false;
+        while (true){
+            if (!m_idle.empty()){
+                TesseractAPI* instance = m_idle.back();
+                m_idle.pop_back();
+                return instance;
+            }
+            if (m_instances.size() + m_pending < max_instances()){
+                m_pending++;
+                lg.unlock();
+                return add_instance();
+            }
+
+            if (!waited){
+                waited = true;
+                m_waits++;
+            }
+            m_waiting++;
+            WallClock start = current_time();
+            m_cv.wait(lg);
+            m_total_wait += current_time() - start;
+            m_waiting--;
+        }
+    }
+    void release(TesseractAPI* instance){
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+            m_idle.emplace_back(instance);
+        }
+        m_cv.notify_one();
+    }
+
+    //  Create a new instance and return it busy. The caller must have
+    //  incremented "m_pending".
+    TesseractAPI* add_instance(){
+        std::unique_ptr<TesseractAPI> api;
+        size_t memory_before = process_memory_usage().process_physical_memory;
+        try{
+            //  Check for non-ascii characters in path.
+            for (char ch : m_training_data_path){
+                if (ch < 0){
+                    throw InternalSystemError(
+                        nullptr, PA_CURRENT_FUNCTION,
+                        "Detected non-ASCII character in Tesseract path. Please move the program to a path with only ASCII characters."
+                    );
+                }
+            }
+
+            global_logger_tagged().log(
+                "Initializing TesseractAPI (" + m_language_code + "): " + m_training_data_path
+            );
+            api.reset(new TesseractAPI(m_training_data_path.c_str(), m_language_code.c_str()));
+            if (!api->valid()){
+                throw InternalSystemError(nullptr, PA_CURRENT_FUNCTION, "Could not initialize TesseractAPI.");
+            }
+        }catch (...){
+            {
+                std::lock_guard<std::mutex> lg(m_lock);
+                m_pending--;
+            }
+            m_cv.notify_one();
+            throw;
+        }
+
+        //  Only an estimate since other threads may be allocating at the same time.
+        size_t memory_after = process_memory_usage().process_physical_memory;
+
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_pending--;
+        m_instances.emplace_back(std::move(api));
+        if (memory_after > memory_before){
+            m_memory += memory_after - memory_before;
+        }
+        return m_instances.back().get();
+    }
+
 private:
     const std::string& m_language_code;
     const std::string m_training_data_path;
 
-    SpinLock m_lock;
+    std::mutex m_lock;
+    std::condition_variable m_cv;
     std::vector<std::unique_ptr<TesseractAPI>> m_instances;
     std::vector<TesseractAPI*> m_idle;
+    size_t m_pending = 0;   //  Instances being created.
+    size_t m_waiting = 0;   //  Threads waiting for an instance.
+
+    uint64_t m_memory = 0;
+    uint64_t m_acquisitions = 0;
+    uint64_t m_waits = 0;
+    WallDuration m_total_wait = WallDuration::zero();
 };
 
+
+
+//  Identifies an OCR input. Besides the dimensions, it has two independent
+//  hashes of the pixels so that a collision on one of them alone can't
+//  return the text of a different image.
+struct OcrCacheKey{
+    Language language;
+    size_t bytes_per_pixel;
+    size_t width;
+    size_t height;
+    uint64_t hash0;
+    uint64_t hash1;
+
+    bool operator==(const OcrCacheKey& x) const{
+        return language == x.language &&
+            bytes_per_pixel == x.bytes_per_pixel &&
+            width == x.width &&
+            height == x.height &&
+            hash0 == x.hash0 &&
+            hash1 == x.hash1;
+    }
+};
+struct OcrCacheKeyHash{
+    size_t operator()(const OcrCacheKey& key) const{
+        return (size_t)key.hash0;
+    }
+};
+
+
+//  LRU cache of OCR results keyed on the image and the language.
+class OcrResultCache{
+public:
+    bool lookup(const OcrCacheKey& key, std::string& text){
+        WriteSpinLock lg(m_lock, "OcrResultCache::lookup()");
+        auto iter = m_map.find(key);
+        if (iter == m_map.end()){
+            m_misses++;
+            return false;
+        }
+        m_hits++;
+        m_list.splice(m_list.begin(), m_list, iter->second);
+        text = iter->second->second;
+        return true;
+    }
+    void insert(const OcrCacheKey& key, const std::string& text){
+        size_t capacity = GlobalSettings::instance().PERFORMANCE->OCR_CACHE_SIZE;
+        WriteSpinLock lg(m_lock, "OcrResultCache::insert()");
+        auto iter = m_map.find(key);
+        if (iter != m_map.end()){
+            m_list.splice(m_list.begin(), m_list, iter->second);
+            return;
+        }
+        if (capacity == 0){
+            return;
+        }
+        m_list.emplace_front(key, text);
+        try{
+            m_map.emplace(key, m_list.begin());
+        }catch (...){
+            m_list.pop_front();
+            throw;
+        }
+        while (m_list.size() > capacity){
+            m_map.erase(m_list.back().first);
+            m_list.pop_back();
+        }
+    }
+    void clear(){
+        WriteSpinLock lg(m_lock, "OcrResultCache::clear()");
+        m_map.clear();
+        m_list.clear();
+    }
+
+    void add_stats(PoolStats& stats){
+        ReadSpinLock lg(m_lock, "OcrResultCache::add_stats()");
+        stats.cache_entries += m_list.size();
+        stats.cache_hits += m_hits;
+        stats.cache_misses += m_misses;
+    }
+
+private:
+    using Entry = std::pair<OcrCacheKey, std::string>;
+
+    SpinLock m_lock;
+    std::list<Entry> m_list;
+    std::unordered_map<OcrCacheKey, std::list<Entry>::iterator, OcrCacheKeyHash> m_map;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
+
+OcrCacheKey make_ocr_cache_key(Language language, const OcrBitmap& image){
+    auto mix0 = [](uint64_t hash, uint64_t x){
+        hash ^= x;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 32;
+        return hash;
+    };
+    auto mix1 = [](uint64_t hash, uint64_t x){
+        hash += x;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 29;
+        return hash;
+    };
+    uint64_t hash0 = 0x9e3779b97f4a7c15ull;
+    uint64_t hash1 = 0x243f6a8885a308d3ull;
+    size_t row_bytes = image.width * image.bytes_per_pixel;
+    for (size_t r = 0; r < image.height; r++){
+        const unsigned char* row = image.data + r * image.bytes_per_row;
+        size_t c = 0;
+        for (; c + 8 <= row_bytes; c += 8){
+            uint64_t x;
+            memcpy(&x, row + c, 8);
+            hash0 = mix0(hash0, x);
+            hash1 = mix1(hash1, x);
+        }
+        if (c < row_bytes){
+            uint64_t x = 0;
+            memcpy(&x, row + c, row_bytes - c);
+            hash0 = mix0(hash0, x);
+            hash1 = mix1(hash1, x);
+        }
+    }
+    return OcrCacheKey{
+        language,
+        image.bytes_per_pixel,
+        image.width,
+        image.height,
+        hash0,
+        hash1,
+    };
+}
+
+
 struct OcrGlobals{
     SpinLock ocr_pool_lock;
     std::map<Language, TesseractPool> ocr_pool;
+    OcrResultCache result_cache;
 
     static OcrGlobals& instance(){
         static OcrGlobals globals;
@@ -167,10 +385,7 @@ struct OcrGlobals{
 
 
 
-std::string ocr_read(Language language, const ImageViewRGB32& image){
-//    static size_t c = 0;
-//    image.save("ocr-" + std::to_string(c++) + ".png");
-
+std::string ocr_read(Language language, const OcrBitmap& image){
     if (language == Language::None){
         throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Attempted to call OCR without a language.");
     }
@@ -178,6 +393,13 @@ std::string ocr_read(Language language, const ImageViewRGB32& image){
     OcrGlobals& globals = OcrGlobals::instance();
     std::map<Language, TesseractPool>& ocr_pool = globals.ocr_pool;
 
+    //  Menus are often re-read every frame. Skip Tesseract if we've seen this exact image before.
+    OcrCacheKey key = make_ocr_cache_key(language, image);
+    std::string text;
+    if (globals.result_cache.lookup(key, text)){
+        return text;
+    }
+
     std::map<Language, TesseractPool>::iterator iter;
     {
         WriteSpinLock lg(globals.ocr_pool_lock, "ocr_read()");
@@ -186,7 +408,26 @@ std::string ocr_read(Language language, const ImageViewRGB32& image){
             iter = ocr_pool.emplace(language, language).first;
         }
     }
-    return iter->second.run(image);
+    text = iter->second.run(image);
+
+    globals.result_cache.insert(key, text);
+    return text;
+}
+std::string ocr_read(Language language, const ImageViewRGB32& image){
+//    static size_t c = 0;
+//    image.save("ocr-" + std::to_string(c++) + ".png");
+
+    return ocr_read(language, OcrBitmap{
+        (const unsigned char*)image.data(),
+        image.width(), image.height(),
+        sizeof(uint32_t), image.bytes_per_row()
+    });
+}
+std::string ocr_read(
+    Language language,
+    const uint8_t* data, size_t width, size_t height, size_t bytes_per_row
+){
+    return ocr_read(language, OcrBitmap{data, width, height, 1, bytes_per_row});
 }
 void ensure_instances(Language language, size_t instances){
     if (language == Language::None){
@@ -211,6 +452,19 @@ void clear_cache(){
     std::map<Language, TesseractPool>& ocr_pool = globals.ocr_pool;
     WriteSpinLock lg(globals.ocr_pool_lock, "ocr_clear_cache()");
     ocr_pool.clear();
+    globals.result_cache.clear();
+}
+PoolStats pool_stats(){
+    OcrGlobals& globals = OcrGlobals::instance();
+    PoolStats stats;
+    {
+        WriteSpinLock lg(globals.ocr_pool_lock, "ocr_pool_stats()");
+        for (auto& item : globals.ocr_pool){
+            item.second.add_stats(stats);
+        }
+    }
+    globals.result_cache.add_stats(stats);
+    return stats;
 }
 
 
@@ -7,7 +7,9 @@
 #ifndef PokemonAutomation_CommonTools_OCR_RawOCR_H
 #define PokemonAutomation_CommonTools_OCR_RawOCR_H
 
+#include <stdint.h>
 #include <string>
+#include "Common/Cpp/Time.h"
 #include "CommonFramework/Language.h"
 
 namespace PokemonAutomation{
@@ -21,6 +23,12 @@ bool language_available(Language language);
 //  OCR the image in the specified language.
 std::string ocr_read(Language language, const ImageViewRGB32& image);
 
+//  OCR an 8-bit grayscale image.
+std::string ocr_read(
+    Language language,
+    const uint8_t* data, size_t width, size_t height, size_t bytes_per_row
+);
+
 //  Ensure that there are this many parallel instances for this language.
 //  Call this if you expect to need to do many OCR instances in parallel and you
 //  want to preload the OCR instances.
@@ -30,6 +38,24 @@ void ensure_instances(Language language, size_t instances);
 void clear_cache();
 
 
+struct PoolStats{
+    //  Tesseract instances across all languages.
+    size_t instances = 0;
+    size_t busy = 0;
+    size_t waiting = 0;
+    uint64_t memory = 0;        //  Estimated bytes held by the instances.
+
+    uint64_t acquisitions = 0;
+    uint64_t waits = 0;         //  Acquisitions that had to wait for an instance.
+    WallDuration total_wait = WallDuration::zero();
+
+    size_t cache_entries = 0;
+    uint64_t cache_hits = 0;
+    uint64_t cache_misses = 0;
+};
+PoolStats pool_stats();
+
+
 
 }
 }
@@ -4,9 +4,10 @@
  *
  */
 
-#include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "CommonFramework/ImageTypes/ImageViewRGB32.h"
 #include "CommonFramework/Tools/GlobalThreadPools.h"
-#include "CommonTools/Images/ImageFilter.h"
+#include "Kernels/ImageFilters/RGB32_Range/Kernels_ImageFilter_RGB32_Range.h"
 #include "OCR_RawOCR.h"
 #include "OCR_DictionaryMatcher.h"
 #include "OCR_Routines.h"
@@ -25,33 +26,56 @@ StringMatchResult multifiltered_OCR(
         return StringMatchResult();
     }
 
-    std::vector<BlackWhiteRgb32Range> bw_filters;
+    const size_t width = image.width();
+    const size_t height = image.height();
+    double pixels_inv = 1. / (width * height);
+
+    //  Count the text pixels for all the filters in one pass. Filters with a
+    //  text ratio out of range are dropped before anything is allocated or
+    //  sent to Tesseract.
+    std::vector<Kernels::ToBlackWhiteGray8RangeFilter> filters;
     for (const auto& range : text_color_ranges){
-        bw_filters.emplace_back(
-            BlackWhiteRgb32Range{true, range.mins, range.maxs}
+        filters.emplace_back(
+            Kernels::ToBlackWhiteGray8RangeFilter{nullptr, 0, range.mins, range.maxs, true, 0}
         );
     }
-    std::vector<std::pair<ImageRGB32, size_t>> filtered_images = to_blackwhite_rgb32_range(image, bw_filters);
+    Kernels::to_blackwhite_gray8_rgb32_range(
+        image.data(), image.bytes_per_row(), width, height,
+        filters.data(), filters.size()
+    );
+    std::vector<Kernels::ToBlackWhiteGray8RangeFilter> accepted;
+    for (const auto& filter : filters){
+        double ratio = filter.pixels_in_range * pixels_inv;
+//        cout << "ratio = " << ratio << endl;
+        if (ratio < min_text_ratio || ratio > max_text_ratio){
+            continue;
+        }
+        accepted.emplace_back(filter);
+    }
+    if (accepted.empty()){
+        return StringMatchResult();
+    }
 
-    double pixels_inv = 1. / (image.width() * image.height());
+    //  Render the survivors as 8-bit planes in a second single pass.
+    std::vector<uint8_t> planes(accepted.size() * width * height);
+    for (size_t c = 0; c < accepted.size(); c++){
+        accepted[c].data = planes.data() + c * width * height;
+        accepted[c].bytes_per_row = width;
+    }
+    Kernels::to_blackwhite_gray8_rgb32_range(
+        image.data(), image.bytes_per_row(), width, height,
+        accepted.data(), accepted.size()
+    );
 
     //  Run all the filters.
     SpinLock lock;
     StringMatchResult ret;
     GlobalThreadPools::normal_inference().run_in_parallel(
         [&](size_t index){
-            const std::pair<ImageRGB32, size_t>& filtered = filtered_images[index];
+            const Kernels::ToBlackWhiteGray8RangeFilter& filtered = accepted[index];
 
-            std::string text = ocr_read(language, filtered.first);
+            std::string text = ocr_read(language, filtered.data, width, height, filtered.bytes_per_row);
 //            cout << text.toStdString() << endl;
-//            filtered.first.save("test" + QString::number(c++) + ".png");
-
-            //  Compute ratio of image that matches text color. Skip if it's out of range.
-            double ratio = filtered.second * pixels_inv;
-//            cout << "ratio = " << ratio << endl;
-            if (ratio < min_text_ratio || ratio > max_text_ratio){
-                return;
-            }
 
             StringMatchResult current = dictionary.match_substring(language, text, log10p_spread);
 
@@ -60,7 +84,7 @@ StringMatchResult multifiltered_OCR(
             ret.results.insert(current.results.begin(), current.results.end());
 
         },
-        0, filtered_images.size(), 1
+        0, accepted.size(), 1
     );
 //    int c = 0;
 //    for (const auto& filtered : filtered_images){
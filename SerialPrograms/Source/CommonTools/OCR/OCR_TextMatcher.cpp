@@ -5,7 +5,9 @@
  */
 
 #include <cmath>
+#include <limits>
 #include <vector>
+#include <algorithm>
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/Concurrency/SpinLock.h"
 #include "Common/Qt/StringToolsQt.h"
@@ -169,6 +171,207 @@ template size_t levenshtein_distance<std::u32string>(const std::u32string& x, co
 template size_t levenshtein_distance_substring<std::u32string>(const std::u32string& x, const std::u32string& y);
 
 
+
+CompiledCandidate::CompiledCandidate(const std::u32string& candidate)
+    : length(candidate.size())
+    , blocks(std::max<size_t>((candidate.size() + 63) / 64, 1))
+    , chars(candidate.begin(), candidate.end())
+{
+    std::sort(chars.begin(), chars.end());
+    chars.erase(std::unique(chars.begin(), chars.end()), chars.end());
+
+    counts.resize(chars.size());
+    masks.resize(chars.size() * blocks);
+    for (size_t c = 0; c < length; c++){
+        size_t index = std::lower_bound(chars.begin(), chars.end(), candidate[c]) - chars.begin();
+        counts[index]++;
+        masks[index * blocks + c / 64] |= (uint64_t)1 << (c % 64);
+    }
+}
+
+
+namespace{
+
+//  Search state for one text. Characters are remapped to dense indices so
+//  the per-candidate match table only covers the alphabet of the text.
+class SubstringSearch{
+public:
+    SubstringSearch(const std::u32string& text)
+        : m_chars(text.begin(), text.end())
+    {
+        std::sort(m_chars.begin(), m_chars.end());
+        m_chars.erase(std::unique(m_chars.begin(), m_chars.end()), m_chars.end());
+        m_counts.resize(m_chars.size());
+        m_text.reserve(text.size());
+        for (char32_t ch : text){
+            uint32_t index = (uint32_t)(std::lower_bound(m_chars.begin(), m_chars.end(), ch) - m_chars.begin());
+            m_text.emplace_back(index);
+            m_counts[index]++;
+        }
+    }
+
+    //  Every character of the candidate that does not also appear in the text
+    //  needs its own edit. So this is a lower bound of the distance.
+    size_t distance_lower_bound(const CompiledCandidate& candidate){
+        m_found.clear();
+        size_t common = 0;
+        for (size_t c = 0; c < candidate.chars.size(); c++){
+            auto iter = std::lower_bound(m_chars.begin(), m_chars.end(), candidate.chars[c]);
+            if (iter == m_chars.end() || *iter != candidate.chars[c]){
+                continue;
+            }
+            size_t index = iter - m_chars.begin();
+            common += std::min<size_t>(candidate.counts[c], m_counts[index]);
+            m_found.emplace_back(c, index);
+        }
+        return candidate.length - common;
+    }
+
+    //  Must be called right after "distance_lower_bound()" on the same candidate.
+    //  Returns a value larger than "max_distance" as soon as it is known that
+    //  the distance will exceed it.
+    size_t distance(const CompiledCandidate& candidate, size_t max_distance){
+        if (candidate.length == 0){
+            return 0;
+        }
+        const size_t blocks = candidate.blocks;
+        m_peq.resize(std::max(m_peq.size(), m_chars.size() * blocks));
+        for (const auto& item : m_found){
+            const uint64_t* src = &candidate.masks[item.first * blocks];
+            uint64_t* dest = &m_peq[item.second * blocks];
+            for (size_t b = 0; b < blocks; b++){
+                dest[b] = src[b];
+            }
+        }
+
+        size_t distance = blocks == 1
+            ? distance_single(candidate.length, max_distance)
+            : distance_blocked(blocks, candidate.length, max_distance);
+
+        for (const auto& item : m_found){
+            uint64_t* dest = &m_peq[item.second * blocks];
+            for (size_t b = 0; b < blocks; b++){
+                dest[b] = 0;
+            }
+        }
+        return distance;
+    }
+
+private:
+    size_t distance_single(size_t length, size_t max_distance) const{
+        const uint64_t HIGH = (uint64_t)1 << (length - 1);
+        const size_t n = m_text.size();
+
+        uint64_t Pv = ~(uint64_t)0;
+        uint64_t Mv = 0;
+        size_t score = length;
+        size_t best = length;
+        for (size_t j = 0; j < n; j++){
+            uint64_t Eq = m_peq[m_text[j]];
+            uint64_t Xv = Eq | Mv;
+            uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+            uint64_t Ph = Mv | ~(Xh | Pv);
+            uint64_t Mh = Pv & Xh;
+            if (Ph & HIGH){
+                score++;
+            }else if (Mh & HIGH){
+                score--;
+            }
+            //  The candidate may start anywhere in the text. So the top row
+            //  stays at zero and nothing is shifted in.
+            Ph <<= 1;
+            Mh <<= 1;
+            Pv = Mh | ~(Xv | Ph);
+            Mv = Ph & Xv;
+
+            best = std::min(best, score);
+
+            //  The score drops by at most one per remaining character.
+            if (best > max_distance && score > max_distance + (n - j - 1)){
+                return best;
+            }
+        }
+        return best;
+    }
+    size_t distance_blocked(size_t blocks, size_t length, size_t max_distance){
+        const uint64_t LAST_HIGH = (uint64_t)1 << ((length - 1) % 64);
+        const size_t n = m_text.size();
+
+        m_Pv.assign(blocks, ~(uint64_t)0);
+        m_Mv.assign(blocks, 0);
+        size_t score = length;
+        size_t best = length;
+        for (size_t j = 0; j < n; j++){
+            const uint64_t* peq = &m_peq[m_text[j] * blocks];
+
+            //  Horizontal delta carried from the bottom of one block into the
+            //  top of the next.
+            int carry = 0;
+            for (size_t b = 0; b < blocks; b++){
+                uint64_t Pv = m_Pv[b];
+                uint64_t Mv = m_Mv[b];
+                uint64_t Eq = peq[b];
+                uint64_t Xv = Eq | Mv;
+                if (carry < 0){
+                    Eq |= 1;
+                }
+                uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+                uint64_t Ph = Mv | ~(Xh | Pv);
+                uint64_t Mh = Pv & Xh;
+
+                uint64_t high = b + 1 == blocks ? LAST_HIGH : (uint64_t)1 << 63;
+                int carry_out = 0;
+                if (Ph & high){
+                    carry_out = 1;
+                }else if (Mh & high){
+                    carry_out = -1;
+                }
+
+                Ph <<= 1;
+                Mh <<= 1;
+                if (carry < 0){
+                    Mh |= 1;
+                }else if (carry > 0){
+                    Ph |= 1;
+                }
+                m_Pv[b] = Mh | ~(Xv | Ph);
+                m_Mv[b] = Ph & Xv;
+                carry = carry_out;
+            }
+            score += carry;
+
+            best = std::min(best, score);
+            if (best > max_distance && score > max_distance + (n - j - 1)){
+                return best;
+            }
+        }
+        return best;
+    }
+
+private:
+    std::vector<char32_t> m_chars;
+    std::vector<uint32_t> m_counts;
+    std::vector<uint32_t> m_text;
+
+    //  (index into the candidate alphabet, index into the text alphabet)
+    std::vector<std::pair<size_t, size_t>> m_found;
+
+    //  Match bits of the current candidate for each character of the text.
+    std::vector<uint64_t> m_peq;
+    std::vector<uint64_t> m_Pv;
+    std::vector<uint64_t> m_Mv;
+};
+
+}
+
+
+size_t levenshtein_distance_substring(const CompiledCandidate& substring, const std::u32string& fullstring){
+    SubstringSearch search(fullstring);
+    search.distance_lower_bound(substring);
+    return search.distance(substring, substring.length);
+}
+
+
 std::map<size_t, std::vector<uint64_t>> binomial_table;
 SpinLock binomial_lock;
 std::vector<uint64_t> binomial_row_u64(size_t degree){
@@ -301,6 +504,143 @@ StringMatchResult match_substring(
 
 
 
+namespace{
+
+//  Memoized "log10(random_match_probability())" for one call to "match_substring()".
+class Log10pTable{
+public:
+    Log10pTable(double random_match_chance)
+        : m_random_match_chance(random_match_chance)
+    {}
+
+    double operator()(size_t total, size_t matched){
+        if (m_table.size() <= total){
+            m_table.resize(total + 1);
+        }
+        std::vector<double>& row = m_table[total];
+        if (row.empty()){
+            row.resize(total + 1, std::numeric_limits<double>::quiet_NaN());
+        }
+        double& log10p = row[matched];
+        if (std::isnan(log10p)){
+            log10p = std::log10(random_match_probability(total, matched, m_random_match_chance));
+        }
+        return log10p;
+    }
+
+private:
+    double m_random_match_chance;
+    std::vector<std::vector<double>> m_table;
+};
+
+}
+
+
+CompiledTextDictionary::CompiledTextDictionary(const Database& database){
+    m_entries.reserve(database.size());
+    for (const auto& item : database){
+        m_entries.emplace_back(Entry{&item, CompiledCandidate(item.first)});
+    }
+}
+void CompiledTextDictionary::add(const Database::value_type& item){
+    auto iter = std::lower_bound(
+        m_entries.begin(), m_entries.end(), item.first,
+        [](const Entry& entry, const std::u32string& candidate){
+            return entry.item->first < candidate;
+        }
+    );
+    if (iter != m_entries.end() && iter->item == &item){
+        return;
+    }
+    m_entries.insert(iter, Entry{&item, CompiledCandidate(item.first)});
+}
+
+StringMatchResult CompiledTextDictionary::match_substring(
+    double random_match_chance,
+    const std::string& text, double log10p_spread
+) const{
+    StringMatchResult results;
+
+    std::u32string normalized = normalize_utf32(text);
+
+    //  Search for exact match of candidate.
+    auto iter = std::lower_bound(
+        m_entries.begin(), m_entries.end(), normalized,
+        [](const Entry& entry, const std::u32string& candidate){
+            return entry.item->first < candidate;
+        }
+    );
+    if (iter != m_entries.end() && iter->item->first == normalized){
+        results.exact_match = true;
+        double probability = random_match_probability(normalized.size(), normalized.size(), random_match_chance);
+        double log10p = std::log10(probability);
+        for (const auto& target : iter->item->second){
+            results.add(
+                log10p,
+                StringMatchData{text, normalized, normalized, target}
+            );
+        }
+        return results;
+    }
+
+
+    SubstringSearch search(normalized);
+    Log10pTable log10p_table(random_match_chance);
+
+    for (const Entry& entry : m_entries){
+        const CompiledCandidate& candidate = entry.compiled;
+        size_t token_length = candidate.length;
+
+        size_t min_distance = search.distance_lower_bound(candidate);
+        if (min_distance >= token_length){
+            continue;
+        }
+
+        //  Find the largest distance that still lands within the spread of
+        //  the best match so far. Anything worse would be added and then
+        //  immediately cleared.
+        size_t max_distance = token_length - 1;
+        if (!results.results.empty()){
+            double threshold = results.results.begin()->first + log10p_spread;
+            if (log10p_table(token_length, token_length - min_distance) > threshold){
+                //  A perfect substring match still counts as an exact match
+                //  even if it is too short to make the results.
+                if (min_distance == 0 && search.distance(candidate, 0) == 0){
+                    results.exact_match = true;
+                }
+                continue;
+            }
+            max_distance = min_distance;
+            while (max_distance + 1 < token_length &&
+                log10p_table(token_length, token_length - max_distance - 1) <= threshold
+            ){
+                max_distance++;
+            }
+        }
+
+        size_t distance = search.distance(candidate, max_distance);
+        if (distance > max_distance){
+            continue;
+        }
+
+        size_t matched = token_length - distance;
+        double log10p = log10p_table(token_length, matched);
+
+        if (distance == 0){
+            results.exact_match = true;
+        }
+
+        for (const auto& slug : entry.item->second){
+            results.add(log10p, StringMatchData{text, normalized, entry.item->first, slug});
+            results.clear_beyond_spread(log10p_spread);
+        }
+    }
+
+    return results;
+}
+
+
+
 
 
 
@@ -8,6 +8,7 @@
 #define PokemonAutomation_CommonTools_OCR_TextMatcher_H
 
 #include <string>
+#include <vector>
 #include <set>
 #include <map>
 #include <QString>
@@ -25,6 +26,27 @@ size_t levenshtein_distance(const StringType& x, const StringType& y);
 template <typename StringType>
 size_t levenshtein_distance_substring(const StringType& substring, const StringType& fullstring);
 
+
+//  A candidate string preprocessed for bit-parallel (Myers/Hyyro) matching.
+struct CompiledCandidate{
+    explicit CompiledCandidate(const std::u32string& candidate);
+
+    size_t length;
+
+    //  # of 64-bit words needed to hold one bit per character.
+    size_t blocks;
+
+    //  Distinct characters of the candidate in sorted order, the # of times
+    //  each of them occurs and "blocks" words of position bits for each.
+    std::vector<char32_t> chars;
+    std::vector<uint32_t> counts;
+    std::vector<uint64_t> masks;
+};
+
+//  Same result as "levenshtein_distance_substring()" above.
+size_t levenshtein_distance_substring(const CompiledCandidate& substring, const std::u32string& fullstring);
+
+
 //  Mathematically equivalent to:
 //      BinomialCDF[total, 1 - random_match_chance, total - matched]
 double random_match_probability(size_t total, size_t matched, double random_match_chance);
@@ -38,6 +60,39 @@ StringMatchResult match_substring(
 
 
 
+//  A match database preprocessed for "match_substring()". This references the
+//  entries of the source map which must outlive it.
+//
+//  The results are the same as the map version of "match_substring()". But
+//  candidates that cannot come within "log10p_spread" of the best match so
+//  far are rejected early from their length and character histogram.
+class CompiledTextDictionary{
+public:
+    using Database = std::map<std::u32string, std::set<std::string>>;
+
+    CompiledTextDictionary() = default;
+    CompiledTextDictionary(const Database& database);
+
+    //  Add an entry that was just inserted into the source map.
+    void add(const Database::value_type& item);
+
+    StringMatchResult match_substring(
+        double random_match_chance,
+        const std::string& text, double log10p_spread
+    ) const;
+
+private:
+    struct Entry{
+        const Database::value_type* item;
+        CompiledCandidate compiled;
+    };
+
+    //  Sorted in the same order as the source map.
+    std::vector<Entry> m_entries;
+};
+
+
+
 
 }
 }
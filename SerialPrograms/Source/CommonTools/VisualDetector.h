@@ -7,6 +7,7 @@
 #ifndef PokemonAutomation_CommonTools_VisualDetector_H
 #define PokemonAutomation_CommonTools_VisualDetector_H
 
+#include "CommonFramework/VideoPipeline/VideoRegionSnapshot.h"
 #include "CommonTools/InferenceCallbacks/VisualInferenceCallback.h"
 
 namespace PokemonAutomation{
@@ -23,6 +24,15 @@ public:
 
     //  This is not const so that detectors can save/cache state.
     virtual bool detect(const ImageViewRGB32& screen) = 0;
+
+    //  Detectors that only look at a few boxes can return true here and
+    //  override "detect_regions()" to read those boxes with
+    //  "VideoRegionSnapshot::region()". Then only those boxes get converted.
+    virtual bool detects_regions() const{ return false; }
+    virtual bool detect_regions(const VideoRegionSnapshot& screen){
+        return detect(*screen.full_frame());
+    }
+
     //  Called this to lock in the detected state in the detector, if
     //  needed. Leave this function empty if you don't wish the derived
     //  class to "remember" past detection.
@@ -99,10 +109,36 @@ public:
     //    is implemented.
     using VisualInferenceCallback::process_frame;
     virtual bool process_frame(const ImageViewRGB32& frame, WallClock timestamp) override{
+        return update_finder(this->detect(frame), timestamp);
+    }
+
+    virtual bool wants_region_snapshots() const override{
+        return this->detects_regions();
+    }
+    virtual bool process_frame(const VideoRegionSnapshot& frame) override{
+        return update_finder(this->detect_regions(frame), frame.timestamp);
+    }
+
+    //  If m_finder_type is CONSISTENT and process_frame() returns true,
+    //  whether it is consecutively detected , or consecutively not detected.
+    bool consistent_result() const { return m_consistent_result; }
+
+    //  Reset internal state so the finder is ready for next round of detection.
+    //  If there is some kind of "lock-in" mechanism to lock the detection result during
+    //  `process_frame()`, this function should unlock it.
+    virtual void reset_state() override {
+        Detector::reset_state();
+        m_start_of_detection = WallClock::min();
+        m_last_detected = 0;
+        m_consistent_result = false;
+    }
+
+private:
+    bool update_finder(bool detected, WallClock timestamp){
         switch (m_finder_type){
         case FinderType::PRESENT:
         case FinderType::GONE:
-            if (this->detect(frame) == (m_finder_type == FinderType::GONE)){
+            if (detected == (m_finder_type == FinderType::GONE)){
                 m_start_of_detection = WallClock::min();
                 return false;
             }
@@ -117,7 +153,7 @@ public:
                 return false;
             }
         case FinderType::CONSISTENT:{
-            const bool result = this->detect(frame);
+            const bool result = detected;
             const bool result_changed = (result && m_last_detected < 0) || (!result && m_last_detected > 0);
 
             m_last_detected = (result ? 1 : -1);
@@ -144,21 +180,6 @@ public:
         return false;
     }
 
-    //  If m_finder_type is CONSISTENT and process_frame() returns true,
-    //  whether it is consecutively detected , or consecutively not detected.
-    bool consistent_result() const { return m_consistent_result; }
-
-    //  Reset internal state so the finder is ready for next round of detection.
-    //  If there is some kind of "lock-in" mechanism to lock the detection result during
-    //  `process_frame()`, this function should unlock it.
-    virtual void reset_state() override {
-        Detector::reset_state();
-        m_start_of_detection = WallClock::min();
-        m_last_detected = 0;
-        m_consistent_result = false;
-    }
-
-private:
     std::chrono::milliseconds m_duration;  // duration of frames to decide detection outcome
     FinderType m_finder_type;
     WallClock m_start_of_detection = WallClock::min();
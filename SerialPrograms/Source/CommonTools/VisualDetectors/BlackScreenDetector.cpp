@@ -35,6 +35,9 @@ void BlackScreenDetector::make_overlays(VideoOverlaySet& items) const{
 bool BlackScreenDetector::detect(const ImageViewRGB32& screen){
     return is_black(extract_box_reference(screen, m_box), m_max_rgb_sum, m_max_stddev_sum);
 }
+bool BlackScreenDetector::detect_regions(const VideoRegionSnapshot& screen){
+    return is_black(screen.region(m_box), m_max_rgb_sum, m_max_stddev_sum);
+}
 
 
 
@@ -54,6 +57,9 @@ void WhiteScreenDetector::make_overlays(VideoOverlaySet& items) const{
 bool WhiteScreenDetector::detect(const ImageViewRGB32& screen){
     return is_white(extract_box_reference(screen, m_box), m_min_rgb_sum, m_max_stddev_sum);
 }
+bool WhiteScreenDetector::detect_regions(const VideoRegionSnapshot& screen){
+    return is_white(screen.region(m_box), m_min_rgb_sum, m_max_stddev_sum);
+}
 
 
 
@@ -32,6 +32,9 @@ public:
     virtual void make_overlays(VideoOverlaySet& items) const override;
     virtual bool detect(const ImageViewRGB32& screen) override;
 
+    virtual bool detects_regions() const override{ return true; }
+    virtual bool detect_regions(const VideoRegionSnapshot& screen) override;
+
 private:
     Color m_color;
     ImageFloatBox m_box;
@@ -50,6 +53,9 @@ public:
     virtual void make_overlays(VideoOverlaySet& items) const override;
     virtual bool detect(const ImageViewRGB32& screen) override;
 
+    virtual bool detects_regions() const override{ return true; }
+    virtual bool detect_regions(const VideoRegionSnapshot& screen) override;
+
 private:
     Color m_color;
     ImageFloatBox m_box;
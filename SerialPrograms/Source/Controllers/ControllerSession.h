@@ -65,6 +65,18 @@ public:
     ControllerConnection& connection() const;
     AbstractController* controller() const;
 
+    //  Run "function" on the current connection. The connection will not be
+    //  replaced until it returns. Returns false if there is no connection.
+    template <typename Lambda>
+    bool run_on_connection(Lambda&& function) const{
+        ReadSpinLock lg(m_state_lock);
+        if (!m_connection){
+            return false;
+        }
+        function(*m_connection);
+        return true;
+    }
+
 
 public:
     //  Empty String: User input is allowed.
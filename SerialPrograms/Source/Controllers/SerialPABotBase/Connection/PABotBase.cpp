@@ -36,6 +36,59 @@
 namespace PokemonAutomation{
 
 
+//  Upper bound for the adaptive retransmit timeout. This is widened to
+//  include the "retransmit_delay" passed to the constructor.
+//
+//  The lower bound is the "retransmit_delay" itself. The round-trip samples
+//  of a lightly loaded link are much shorter than the time it takes to drain
+//  a full queue of messages over the wire. A timeout based on them alone
+//  fires on messages that are still waiting their turn.
+const WallDuration PABOTBASE_RTO_MAX = std::chrono::milliseconds(1000);
+const WallDuration PABOTBASE_RTO_GRANULARITY = std::chrono::milliseconds(1);
+
+
+
+PABotBase::PendingMessage* PABotBase::PendingTable::find(uint64_t seqnum){
+    if (seqnum < m_base || seqnum - m_base >= m_slots.size()){
+        return nullptr;
+    }
+    PendingMessage& message = m_slots[(size_t)(seqnum - m_base)];
+    return message.live ? &message : nullptr;
+}
+PABotBase::PendingMessage& PABotBase::PendingTable::add(uint64_t seqnum, bool is_command){
+    if (m_slots.empty()){
+        m_base = seqnum;
+    }else if (seqnum != m_base + m_slots.size()){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Non-consecutive sequence number: " + std::to_string(seqnum));
+    }
+    PendingMessage& message = m_slots.emplace_back();
+    message.live = true;
+    message.is_command = is_command;
+    (is_command ? m_commands : m_requests)++;
+    return message;
+}
+void PABotBase::PendingTable::set_is_command(PendingMessage& message, bool is_command){
+    if (message.is_command == is_command){
+        return;
+    }
+    (message.is_command ? m_commands : m_requests)--;
+    (is_command ? m_commands : m_requests)++;
+    message.is_command = is_command;
+}
+void PABotBase::PendingTable::remove(PendingMessage& message){
+    message.live = false;
+    (message.is_command ? m_commands : m_requests)--;
+    message.request = BotBaseMessage();
+    message.ack = BotBaseMessage();
+
+    //  Drop the dead slots at the front of the window.
+    while (!m_slots.empty() && !m_slots.front().live){
+        m_slots.pop_front();
+        m_base++;
+    }
+}
+
+
 
 PABotBase::PABotBase(
     Logger& logger,
@@ -49,6 +102,9 @@ PABotBase::PABotBase(
     , m_send_seq(1)
     , m_retransmit_delay(retransmit_delay)
     , m_last_ack(current_time())
+    , m_srtt(WallDuration::zero())
+    , m_rttvar(WallDuration::zero())
+    , m_rto(retransmit_delay)
     , m_state(State::RUNNING)
     , m_error(false)
 {
@@ -75,12 +131,15 @@ size_t PABotBase::inflight_requests(){
 
     //  Must be called under m_state_lock.
 
-    size_t ret = m_pending_requests.size();
-    for (const auto& item : m_pending_commands){
-        if (item.second.state == AckState::NOT_ACKED){
+    size_t ret = m_pending.requests();
+    if (m_pending.commands() == 0){
+        return ret;
+    }
+    m_pending.for_each([&](uint64_t, const PendingMessage& message){
+        if (message.is_command && message.state == AckState::NOT_ACKED){
             ret++;
         }
-    }
+    });
     return ret;
 }
 
@@ -167,12 +226,12 @@ void PABotBase::wait_for_all_requests(const Cancellable* cancelled){
 #if 0
             m_logger.log(
                 "Waiting for all requests to finish... (Requests: " +
-                std::to_string(m_pending_requests.size()) +
-                ", Commands: " + std::to_string(m_pending_commands.size()) + ")",
+                std::to_string(m_pending.requests()) +
+                ", Commands: " + std::to_string(m_pending.commands()) + ")",
                 COLOR_DARKGREEN
             );
 #endif
-            if (m_pending_requests.empty() && m_pending_commands.empty()){
+            if (m_pending.empty()){
                 break;
             }
         }
@@ -215,58 +274,51 @@ void PABotBase::clear_all_active_commands(uint64_t seqnum){
     //  Remove all commands at or before the specified seqnum.
     std::lock_guard<std::mutex> lg0(m_sleep_lock);
     WriteSpinLock lg1(m_state_lock, "PABotBase::next_command_interrupt()");
-    m_logger.log("Clearing all active commands... (Commands: " + std::to_string(m_pending_commands.size()) + ")", COLOR_DARKGREEN);
+    m_logger.log("Clearing all active commands... (Commands: " + std::to_string(m_pending.commands()) + ")", COLOR_DARKGREEN);
 
     m_cv.notify_all();
 
-    if (m_pending_commands.empty()){
+    if (m_pending.commands() == 0){
         return;
     }
 
     //  Remove all active commands up to the seqnum.
-    while (true){
-        auto iter = m_pending_commands.begin();
-        if (iter == m_pending_commands.end() || iter->first > seqnum){
-            break;
+    uint64_t stop = std::min(seqnum, m_pending.back_seqnum());
+    for (uint64_t current = m_pending.front_seqnum(); current <= stop; current++){
+        PendingMessage* handle = m_pending.find(current);
+        if (handle == nullptr || !handle->is_command){
+            continue;
         }
-        iter->second.sanitizer.check_usage();
+        handle->sanitizer.check_usage();
 
         //  We cannot remove un-acked messages from our buffer. If an un-acked
         //  message is dropped and the receiver is still waiting for it, it will
         //  wait forever since we will never retransmit.
 
-        if (iter->second.state == AckState::NOT_ACKED){
-            //  Convert the command into a no-op request.
-            SerialPABotBase::DeviceRequest_program_id request;
-            BotBaseMessage message = request.message();
-            seqnum_t seqnum_s = (seqnum_t)iter->first;
-            memcpy(&message.body[0], &seqnum_s, sizeof(seqnum_t));
+        if (handle->state != AckState::NOT_ACKED){
+            m_pending.remove(*handle);
+            continue;
+        }
 
-//            cout << "removing = " << seqnum_s << ", " << (int)iter->second.state << endl;
+        //  Convert the command into a no-op request. It keeps its slot and
+        //  its retransmit timer.
+        SerialPABotBase::DeviceRequest_program_id request;
+        BotBaseMessage message = request.message();
+        seqnum_t seqnum_s = (seqnum_t)current;
+        memcpy(&message.body[0], &seqnum_s, sizeof(seqnum_t));
 
-            std::pair<std::map<uint64_t, PendingRequest>::iterator, bool> ret = m_pending_requests.emplace(
-                std::piecewise_construct,
-                std::forward_as_tuple(iter->first),
-                std::forward_as_tuple()
-            );
-            if (!ret.second){
-                throw InternalProgramError(&m_logger, PA_CURRENT_FUNCTION, "Duplicate sequence number: " + std::to_string(seqnum));
-            }
+//        cout << "removing = " << seqnum_s << ", " << (int)handle->state << endl;
 
-            //  This block will never throw.
-            {
-                PendingRequest& handle = ret.first->second;
-                handle.silent_remove = true;
-                handle.request = std::move(message);
-                handle.first_sent = current_time();
-            }
-        }
+        m_pending.set_is_command(*handle, false);
+        handle->silent_remove = true;
+        handle->request = std::move(message);
+        handle->ack = BotBaseMessage();
 
-        m_pending_commands.erase(iter);
+        //  An ack may now be for either the old command or the new request.
+        handle->sample_rtt = false;
     }
 }
-template <typename Map>
-uint64_t PABotBase::infer_full_seqnum(const Map& map, seqnum_t seqnum) const{
+uint64_t PABotBase::infer_full_seqnum(seqnum_t seqnum) const{
     auto scope_check = m_sanitizer.check_scope();
 
     //  The protocol uses a 32-bit seqnum that wraps around. For our purposes of
@@ -279,13 +331,13 @@ uint64_t PABotBase::infer_full_seqnum(const Map& map, seqnum_t seqnum) const{
     //  Here we infer the upper 32 bits of the seqnum to obtain the full 64-bit
     //  seqnum that we need to index our map.
 
-    //  This needs to be called inside the lock. Furthermore, the map must not
-    //  be empty. If it is empty, we know we don't have it and can drop it
+    //  This needs to be called inside the lock. Furthermore, the table must
+    //  not be empty. If it is empty, we know we don't have it and can drop it
     //  before we even call this function.
 
     //  Figure out the upper 32 bits of the seqnum.
-    uint64_t lo = map.begin()->first;
-    uint64_t hi = map.rbegin()->first;
+    uint64_t lo = m_pending.front_seqnum();
+    uint64_t hi = m_pending.back_seqnum();
     uint64_t lo_candidate = (lo & 0xffffffff00000000) | seqnum;
     uint64_t hi_candidate = (hi & 0xffffffff00000000) | seqnum;
     return lo_candidate >= lo
@@ -298,15 +350,33 @@ uint64_t PABotBase::oldest_live_seqnum() const{
 
     //  Must call under state lock.
     uint64_t oldest = m_send_seq;
-    if (!m_pending_requests.empty()){
-        oldest = std::min(oldest, m_pending_requests.begin()->first);
-    }
-    if (!m_pending_commands.empty()){
-        oldest = std::min(oldest, m_pending_commands.begin()->first);
+    if (!m_pending.empty()){
+        oldest = std::min(oldest, m_pending.front_seqnum());
     }
     return oldest;
 }
 
+void PABotBase::update_rtt(WallDuration sample){
+    //  Must call under state lock.
+
+    if (!m_have_rtt){
+        m_srtt = sample;
+        m_rttvar = sample / 2;
+        m_have_rtt = true;
+    }else{
+        WallDuration error = m_srtt > sample ? m_srtt - sample : sample - m_srtt;
+        m_rttvar = (3 * m_rttvar + error) / 4;
+        m_srtt = (7 * m_srtt + sample) / 8;
+    }
+
+    //  A valid sample also ends any backoff. (RFC 6298 5.7)
+    WallDuration max = std::max<WallDuration>(PABOTBASE_RTO_MAX, m_retransmit_delay);
+    WallDuration rto = m_srtt + std::max(PABOTBASE_RTO_GRANULARITY, 4 * m_rttvar);
+    m_rto = std::min<WallDuration>(std::max<WallDuration>(rto, m_retransmit_delay), max);
+
+    m_link_stats.report_rtt(sample, m_rto);
+}
+
 template <typename Params, bool variable_length>
 void PABotBase::process_ack_request(BotBaseMessage message){
     auto scope_check = m_sanitizer.check_scope();
@@ -324,26 +394,29 @@ void PABotBase::process_ack_request(BotBaseMessage message){
     {
         WriteSpinLock lg(m_state_lock, "PABotBase::process_ack_request()");
 
-        if (m_pending_requests.empty()){
+        if (m_pending.requests() == 0){
             m_logger.log("Unexpected request ack message: seqnum = " + std::to_string(seqnum));
             return;
         }
 
-        uint64_t full_seqnum = infer_full_seqnum(m_pending_requests, seqnum);
-        std::map<uint64_t, PendingRequest>::iterator iter = m_pending_requests.find(full_seqnum);
-        if (iter == m_pending_requests.end()){
+        uint64_t full_seqnum = infer_full_seqnum(seqnum);
+        PendingMessage* handle = m_pending.find(full_seqnum);
+        if (handle == nullptr || handle->is_command){
             m_logger.log("Unexpected request ack message: seqnum = " + std::to_string(seqnum));
             return;
         }
-        iter->second.sanitizer.check_usage();
+        handle->sanitizer.check_usage();
 
-        state = iter->second.state;
+        state = handle->state;
         if (state == AckState::NOT_ACKED){
-            if (iter->second.silent_remove){
-                m_pending_requests.erase(iter);
+            if (handle->sample_rtt){
+                update_rtt(current_time() - handle->last_sent);
+            }
+            if (handle->silent_remove){
+                m_pending.remove(*handle);
             }else{
-                iter->second.state = AckState::ACKED;
-                iter->second.ack = std::move(message);
+                handle->state = AckState::ACKED;
+                handle->ack = std::move(message);
             }
         }
     }
@@ -378,26 +451,30 @@ void PABotBase::process_ack_command(BotBaseMessage message){
 
     WriteSpinLock lg(m_state_lock, "PABotBase::process_ack_command()");
 
-    if (m_pending_commands.empty()){
+    if (m_pending.commands() == 0){
         m_logger.log("Unexpected command ack message: seqnum = " + std::to_string(seqnum));
         return;
     }
 
-    uint64_t full_seqnum = infer_full_seqnum(m_pending_commands, seqnum);
-    auto iter = m_pending_commands.find(full_seqnum);
-    if (iter == m_pending_commands.end()){
+    uint64_t full_seqnum = infer_full_seqnum(seqnum);
+    PendingMessage* handle = m_pending.find(full_seqnum);
+    if (handle == nullptr || !handle->is_command){
         m_logger.log("Unexpected command ack message: seqnum = " + std::to_string(seqnum));
         return;
     }
-    iter->second.sanitizer.check_usage();
+    handle->sanitizer.check_usage();
 
-    m_last_ack.store(current_time(), std::memory_order_release);
+    WallClock now = current_time();
+    m_last_ack.store(now, std::memory_order_release);
 
-    switch (iter->second.state){
+    switch (handle->state){
     case AckState::NOT_ACKED:
 //        std::cout << "acked: " << full_seqnum << std::endl;
-        iter->second.state = AckState::ACKED;
-        iter->second.ack = std::move(message);
+        if (handle->sample_rtt){
+            update_rtt(now - handle->last_sent);
+        }
+        handle->state = AckState::ACKED;
+        handle->ack = std::move(message);
         return;
     case AckState::ACKED:
         m_logger.log("Duplicate command ack message: seqnum = " + std::to_string(seqnum));
@@ -437,7 +514,7 @@ void PABotBase::process_command_finished(BotBaseMessage message){
     send_message(BotBaseMessage(PABB_MSG_ACK_REQUEST, std::string((char*)&ack, sizeof(ack))), false);
 #endif
 
-    if (m_pending_commands.empty()){
+    if (m_pending.commands() == 0){
         m_logger.log(
             "Unexpected command finished message: seqnum = " + std::to_string(seqnum) +
             ", command_seqnum = " + std::to_string(command_seqnum)
@@ -445,24 +522,24 @@ void PABotBase::process_command_finished(BotBaseMessage message){
         return;
     }
 
-    uint64_t full_seqnum = infer_full_seqnum(m_pending_commands, command_seqnum);
-    auto iter = m_pending_commands.find(full_seqnum);
-    if (iter == m_pending_commands.end()){
+    uint64_t full_seqnum = infer_full_seqnum(command_seqnum);
+    PendingMessage* handle = m_pending.find(full_seqnum);
+    if (handle == nullptr || !handle->is_command){
         m_logger.log(
             "Unexpected command finished message: seqnum = " + std::to_string(seqnum) +
             ", command_seqnum = " + std::to_string(command_seqnum)
         );
         return;
     }
-    iter->second.sanitizer.check_usage();
+    handle->sanitizer.check_usage();
 
-    switch (iter->second.state){
+    switch (handle->state){
     case AckState::NOT_ACKED:
     case AckState::ACKED:
-        iter->second.state = AckState::FINISHED;
-        iter->second.ack = std::move(message);
-        if (iter->second.silent_remove){
-            m_pending_commands.erase(iter);
+        handle->state = AckState::FINISHED;
+        handle->ack = std::move(message);
+        if (handle->silent_remove){
+            m_pending.remove(*handle);
         }
         m_cv.notify_all();
         return;
@@ -548,79 +625,71 @@ void PABotBase::retransmit_thread(){
     auto scope_check = m_sanitizer.check_scope();
 
 //    cout << "retransmit_thread()" << endl;
-    auto last_sent = current_time();
-    while (m_state.load(std::memory_order_acquire) == State::RUNNING){
-        auto now = current_time();
 
-        if (now - last_sent < m_retransmit_delay){
-            std::unique_lock<std::mutex> lg(m_sleep_lock);
-            if (m_state.load(std::memory_order_acquire) != State::RUNNING){
-                break;
-            }
-            if (m_error.load(std::memory_order_acquire)){
-                break;
-            }
-            m_cv.wait_for(lg, m_retransmit_delay);
-            continue;
-        }
+    //  Everything that expires together goes out in one write.
+    SendBatch batch(*this);
 
+    while (m_state.load(std::memory_order_acquire) == State::RUNNING){
         //  Process retransmits.
-        WriteSpinLock lg(m_state_lock, "PABotBase::retransmit_thread()");
-//        std::cout << "retransmit_thread - m_pending_messages.size(): " << m_pending_messages.size() << std::endl;
-//        cout << "m_pending_messages.size()" << endl;
-
-        //  Retransmit
-        //      Iterate through all pending requests and retransmit them in
-        //  chronological order. ~~Skip the ones that are new.~~
-        //  (Don't skip the new ones since it will lead to gaps.)
-
-        //  Gather together all requests/commands. Sort them by seqnum and
-        //  resend everything.
-
-        WallClock oldest = last_sent;
-
-        std::map<uint64_t, const BotBaseMessage*> messages;
-        for (auto& item : m_pending_requests){
-            item.second.sanitizer.check_usage();
-            if (item.second.state == AckState::NOT_ACKED){
-                oldest = std::max(oldest, item.second.first_sent);
-                messages[item.first] = &item.second.request;
-            }
-        }
-        for (auto& item : m_pending_commands){
-            item.second.sanitizer.check_usage();
-            if (item.second.state == AckState::NOT_ACKED){
-                oldest = std::max(oldest, item.second.first_sent);
-                messages[item.first] = &item.second.request;
-            }
-        }
-
-        if (!messages.empty() && now - oldest >= m_retransmit_delay){
-            for (const auto& item : messages){
-                send_message(*item.second, true);
-            }
+        uint64_t retransmits = 0;
+        WallClock next_wake;
+        {
+            WriteSpinLock lg(m_state_lock, "PABotBase::retransmit_thread()");
+//            cout << "m_pending.requests() = " << m_pending.requests() << endl;
+
+            //  Retransmit
+            //      Every message has its own timer. Nothing is resent until
+            //  one of them expires. When one does, the timeout is doubled
+            //  (RFC 6298 5.5) and the resent messages restart their timers
+            //  with it.
+            //
+            //  The device drops everything that is ahead of the seqnum it is
+            //  expecting. (protocol rule 8) So once a message is resent, all
+            //  the unacked messages after it are resent with it, in order.
+
+            WallClock now = current_time();
+            next_wake = now + m_rto;
+
+            bool resending = false;
+            m_pending.for_each([&](uint64_t, PendingMessage& message){
+                message.sanitizer.check_usage();
+                if (message.state != AckState::NOT_ACKED){
+                    return;
+                }
+                bool expired = message.next_retransmit <= now;
+                if (expired){
+                    if (!resending){
+                        WallDuration max = std::max<WallDuration>(PABOTBASE_RTO_MAX, m_retransmit_delay);
+                        m_rto = std::min<WallDuration>(2 * m_rto, max);
+                    }
+                    message.sample_rtt = false;
+                }
+                resending |= expired;
+                if (resending){
+                    batch.send_message(message.request, true);
+                    message.last_sent = now;
+                    message.next_retransmit = now + m_rto;
+                    retransmits++;
+                }
+                next_wake = std::min(next_wake, message.next_retransmit);
+            });
+
+            //  Flush under the lock so that newer messages cannot overtake
+            //  the retransmits.
+            batch.flush();
+        }
+        if (retransmits != 0){
+            m_link_stats.report_sent(0, retransmits);
         }
 
-#if 0
-        for (auto& item : m_pending_requests){
-            item.second.sanitizer.check_usage();
-            if (item.second.state == AckState::NOT_ACKED &&
-                current_time() - item.second.first_sent >= m_retransmit_delay
-            ){
-                send_message(item.second.request, true);
-            }
+        std::unique_lock<std::mutex> lg(m_sleep_lock);
+        if (m_state.load(std::memory_order_acquire) != State::RUNNING){
+            break;
         }
-        for (auto& item : m_pending_commands){
-            item.second.sanitizer.check_usage();
-            if (item.second.state == AckState::NOT_ACKED &&
-                current_time() - item.second.first_sent >= m_retransmit_delay
-            ){
-                send_message(item.second.request, true);
-            }
+        if (m_error.load(std::memory_order_acquire)){
+            break;
         }
-#endif
-
-        last_sent = current_time();
+        m_cv.wait_until(lg, next_wake);
     }
 //    cout << "retransmit_thread() - exit" << endl;
 }
@@ -679,22 +748,15 @@ uint64_t PABotBase::try_issue_request(
     seqnum_t seqnum_s = (seqnum_t)seqnum;
     memcpy(&message.body[0], &seqnum_s, sizeof(seqnum_t));
 
-    std::pair<std::map<uint64_t, PendingRequest>::iterator, bool> ret = m_pending_requests.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(seqnum),
-        std::forward_as_tuple()
-    );
-    if (!ret.second){
-        throw InternalProgramError(&m_logger, PA_CURRENT_FUNCTION, "Duplicate sequence number: " + std::to_string(seqnum));
-    }
+    PendingMessage& handle = m_pending.add(seqnum, false);
 
     m_send_seq = seqnum + 1;
 
-    PendingRequest& handle = ret.first->second;
-
     handle.silent_remove = silent_remove;
     handle.request = std::move(message);
-    handle.first_sent = current_time();
+    handle.last_sent = current_time();
+    handle.next_retransmit = handle.last_sent + m_rto;
+    m_link_stats.report_sent(1, 0);
 
 #ifdef INTENTIONALLY_DROP_MESSAGES
     if (rand() % 10 != 0){
@@ -739,7 +801,7 @@ uint64_t PABotBase::try_issue_command(
     size_t queue_limit = m_max_pending_requests.load(std::memory_order_relaxed);
 
     //  Command queue is full.
-    if (m_pending_commands.size() >= queue_limit){
+    if (m_pending.commands() >= queue_limit){
 //        cout << "Command queue is full" << endl;
         return 0;
     }
@@ -759,22 +821,15 @@ uint64_t PABotBase::try_issue_command(
     seqnum_t seqnum_s = (seqnum_t)seqnum;
     memcpy(&message.body[0], &seqnum_s, sizeof(seqnum_t));
 
-    std::pair<std::map<uint64_t, PendingCommand>::iterator, bool> ret = m_pending_commands.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(seqnum),
-        std::forward_as_tuple()
-    );
-    if (!ret.second){
-        throw InternalProgramError(&m_logger, PA_CURRENT_FUNCTION, "Duplicate sequence number: " + std::to_string(seqnum));
-    }
+    PendingMessage& handle = m_pending.add(seqnum, true);
 
     m_send_seq = seqnum + 1;
 
-    PendingCommand& handle = ret.first->second;
-
     handle.silent_remove = silent_remove;
     handle.request = std::move(message);
-    handle.first_sent = current_time();
+    handle.last_sent = current_time();
+    handle.next_retransmit = handle.last_sent + m_rto;
+    m_link_stats.report_sent(1, 0);
 
 #ifdef INTENTIONALLY_DROP_MESSAGES
     if (rand() % 10 != 0){
@@ -928,26 +983,26 @@ BotBaseMessage PABotBase::wait_for_request(uint64_t seqnum, const Cancellable* c
 
         {
             WriteSpinLock slg(m_state_lock, "PABotBase::issue_request_and_wait()");
-            auto iter = m_pending_requests.find(seqnum);
-            if (iter == m_pending_requests.end()){
+            PendingMessage* handle = m_pending.find(seqnum);
+            if (handle == nullptr || handle->is_command){
                 throw OperationCancelledException();
             }
-            iter->second.sanitizer.check_usage();
+            handle->sanitizer.check_usage();
 
             State state = m_state.load(std::memory_order_acquire);
             if (state != State::RUNNING){
-                m_pending_requests.erase(iter);
+                m_pending.remove(*handle);
                 m_cv.notify_all();
                 throw InvalidConnectionStateException(m_error_message);
             }
             if (m_error.load(std::memory_order_acquire)){
-                m_pending_requests.erase(iter);
+                m_pending.remove(*handle);
                 m_cv.notify_all();
                 throw ConnectionException(&m_logger, m_error_message);
             }
-            if (iter->second.state == AckState::ACKED){
-                BotBaseMessage ret = std::move(iter->second.ack);
-                m_pending_requests.erase(iter);
+            if (handle->state == AckState::ACKED){
+                BotBaseMessage ret = std::move(handle->ack);
+                m_pending.remove(*handle);
                 m_cv.notify_all();
                 return ret;
             }
@@ -25,7 +25,7 @@
 #define PokemonAutomation_PABotBase_H
 
 #include <string.h>
-#include <map>
+#include <deque>
 #include <atomic>
 #include <condition_variable>
 #include "Common/Cpp/AbstractLogger.h"
@@ -34,6 +34,7 @@
 #include "Common/SerialPABotBase/SerialPABotBase_Protocol.h"
 #include "Controllers/SerialPABotBase/Connection/MessageLogger.h"
 #include "Controllers/SerialPABotBase/Connection/PABotBaseConnection.h"
+#include "Controllers/SerialPABotBase/Connection/PABotBaseLinkStats.h"
 #include "BotBase.h"
 #include "BotBaseMessage.h"
 
@@ -75,6 +76,10 @@ public:
     }
     void set_queue_limit(size_t queue_limit);
 
+    PABotBaseLinkStats link_stats() const{
+        return m_link_stats.get();
+    }
+
 public:
     //  Basic Requests
 
@@ -97,25 +102,82 @@ private:
         ACKED,
         FINISHED,
     };
-    struct PendingRequest{
+    struct PendingMessage{
+        bool live = false;
+        bool is_command;
         AckState state = AckState::NOT_ACKED;
         bool silent_remove;
         BotBaseMessage request;
         BotBaseMessage ack;
-        WallClock first_sent;
+        WallClock last_sent;
+
+        //  Per-message retransmit timer.
+        WallClock next_retransmit;
+
+        //  Messages whose own timer expired are no longer used as round-trip
+        //  samples since the ack may belong to either transmission. (Karn's
+        //  algorithm)
+        //
+        //  Messages that were only resent behind an expired one are still
+        //  sampled, from the resend. If the expired message was lost, the
+        //  device dropped them too and the ack can only be for the resend.
+        //  Otherwise the sample is too short, which the lower bound on the
+        //  timeout absorbs.
+        bool sample_rtt = true;
+
         LifetimeSanitizer sanitizer;
     };
-    struct PendingCommand{
-        AckState state = AckState::NOT_ACKED;
-        bool silent_remove;
-        BotBaseMessage request;
-        BotBaseMessage ack;
-        WallClock first_sent;
-        LifetimeSanitizer sanitizer;
+
+    //  All unfinished requests and commands indexed by their full seqnum.
+    //
+    //  Seqnums are handed out consecutively and every one of them goes in
+    //  here. So this is a window [front_seqnum(), back_seqnum()] where the
+    //  entries are found by offset instead of by searching a tree. Removed
+    //  entries in the middle stay as dead slots until everything in front of
+    //  them is gone. Elements never move so references stay valid.
+    //
+    //  Must be used under "m_state_lock".
+    class PendingTable{
+    public:
+        bool empty() const{ return m_requests == 0 && m_commands == 0; }
+        size_t requests() const{ return m_requests; }
+        size_t commands() const{ return m_commands; }
+
+        //  Only valid if not empty.
+        uint64_t front_seqnum() const{ return m_base; }
+        uint64_t back_seqnum() const{ return m_base + m_slots.size() - 1; }
+
+        //  Returns null if "seqnum" is not pending.
+        PendingMessage* find(uint64_t seqnum);
+
+        //  "seqnum" must be one past the previous one that was added.
+        PendingMessage& add(uint64_t seqnum, bool is_command);
+
+        void set_is_command(PendingMessage& message, bool is_command);
+        void remove(PendingMessage& message);
+
+        //  Visit the pending messages in seqnum order.
+        template <typename Lambda>
+        void for_each(Lambda&& lambda){
+            uint64_t seqnum = m_base;
+            for (PendingMessage& message : m_slots){
+                if (message.live){
+                    lambda(seqnum, message);
+                }
+                seqnum++;
+            }
+        }
+
+    private:
+        uint64_t m_base = 0;
+        std::deque<PendingMessage> m_slots;
+        size_t m_requests = 0;
+        size_t m_commands = 0;
     };
 
-    template <typename Map>
-    uint64_t infer_full_seqnum(const Map& map, seqnum_t seqnum) const;
+    uint64_t infer_full_seqnum(seqnum_t seqnum) const;
+
+    void update_rtt(WallDuration sample);
 
     uint64_t oldest_live_seqnum() const;
 
@@ -184,8 +246,19 @@ private:
     std::chrono::milliseconds m_retransmit_delay;
     std::atomic<std::chrono::time_point<std::chrono::system_clock>> m_last_ack;
 
-    std::map<uint64_t, PendingRequest> m_pending_requests;
-    std::map<uint64_t, PendingCommand> m_pending_commands;
+    PendingTable m_pending;
+
+    //  Round-trip estimator. (RFC 6298)
+    //  "m_rto" starts at the "retransmit_delay" passed to the constructor
+    //  and never goes below it. It is doubled whenever a message times out
+    //  and stays that way until the next valid sample.
+    //  Protected by "m_state_lock".
+    bool m_have_rtt = false;
+    WallDuration m_srtt;
+    WallDuration m_rttvar;
+    WallDuration m_rto;
+
+    PABotBaseLinkStatsCollector m_link_stats;
 
     //  If you need both locks, always acquire m_sleep_lock first!
     SpinLock m_state_lock;
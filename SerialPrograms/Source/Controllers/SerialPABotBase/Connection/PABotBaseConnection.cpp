@@ -51,17 +51,10 @@ void PABotBaseConnection::send_zeros(uint8_t bytes){
         return;
     }
 
-    char ch = 0;
-    for (uint8_t c = 0; c < bytes; c++){
-        m_connection->send(&ch, 1);
-//        Sleep(10);
-    }
+    char zeros[256] = {};
+    m_connection->send(zeros, bytes);
 }
-void PABotBaseConnection::send_message(const BotBaseMessage& message, bool is_retransmit){
-    if (!m_connection){
-        return;
-    }
-
+size_t PABotBaseConnection::frame_message(char* buffer, const BotBaseMessage& message, bool is_retransmit){
 //    log("Sending: " + message_to_string(type, msg));
     m_sniffer->on_send(message, is_retransmit);
 
@@ -70,14 +63,39 @@ void PABotBaseConnection::send_message(const BotBaseMessage& message, bool is_re
         throw InternalProgramError(&m_logger, PA_CURRENT_FUNCTION, "Message is too long.");
     }
 
-    std::string buffer;
-    buffer += ~(uint8_t)total_bytes;
-    buffer += message.type;
-    buffer += message.body;
-    buffer += std::string(sizeof(uint32_t), 0);
-    pabb_crc32_write_to_message(&buffer[0], buffer.size());
+    buffer[0] = ~(uint8_t)total_bytes;
+    buffer[1] = message.type;
+    memcpy(buffer + 2, message.body.data(), message.body.size());
+    pabb_crc32_write_to_message(buffer, total_bytes);
+    return total_bytes;
+}
+void PABotBaseConnection::send_message(const BotBaseMessage& message, bool is_retransmit){
+    if (!m_connection){
+        return;
+    }
+
+    char buffer[PABB_PROTOCOL_MAX_PACKET_SIZE];
+    size_t bytes = frame_message(buffer, message, is_retransmit);
+    m_connection->send(buffer, bytes);
+}
+void PABotBaseConnection::SendBatch::send_message(const BotBaseMessage& message, bool is_retransmit){
+    if (!m_connection.m_connection){
+        return;
+    }
 
-    m_connection->send(&buffer[0], buffer.size());
+    size_t offset = m_buffer.size();
+    m_buffer.resize(offset + PABB_PROTOCOL_MAX_PACKET_SIZE);
+    size_t bytes = m_connection.frame_message(&m_buffer[offset], message, is_retransmit);
+    m_buffer.resize(offset + bytes);
+}
+void PABotBaseConnection::SendBatch::flush(){
+    if (m_buffer.empty()){
+        return;
+    }
+    if (m_connection.m_connection){
+        m_connection.m_connection->send(m_buffer.data(), m_buffer.size());
+    }
+    m_buffer.clear();
 }
 
 
@@ -109,18 +127,28 @@ void PABotBaseConnection::push_error_byte(ErrorBatchType type, char byte){
     m_current_error_type = type;
 }
 void PABotBaseConnection::on_recv(const void* data, size_t bytes){
-    //  Push into receive buffer.
-    for (size_t c = 0; c < bytes; c++){
-        m_recv_buffer.emplace_back(((const char*)data)[c]);
+    //  Fast path: Nothing left over from last time. Parse straight out of the
+    //  caller's buffer and only keep the incomplete tail.
+    if (m_recv_buffer.empty()){
+        size_t consumed = parse_messages((const char*)data, bytes);
+        m_recv_buffer.assign((const char*)data + consumed, bytes - consumed);
+        return;
     }
 
-    while (!m_recv_buffer.empty()){
-        uint8_t length = ~m_recv_buffer[0];
+    m_recv_buffer.append((const char*)data, bytes);
+    size_t consumed = parse_messages(m_recv_buffer.data(), m_recv_buffer.size());
+    m_recv_buffer.erase(0, consumed);
+}
+size_t PABotBaseConnection::parse_messages(const char* data, size_t bytes){
+    size_t index = 0;
+    while (index < bytes){
+        const char* ptr = data + index;
+        uint8_t length = ~ptr[0];
 
-        if (m_recv_buffer[0] == 0){
+        if (ptr[0] == 0){
 //            m_logger.log("Skipping zero byte.");
             push_error_byte(ErrorBatchType::ZERO_BYTES, 0);
-            m_recv_buffer.pop_front();
+            index++;
             continue;
         }
 
@@ -132,7 +160,7 @@ void PABotBaseConnection::on_recv(const void* data, size_t bytes){
                 m_logger.log("Message is too short: bytes = " + std::to_string(length));
                 push_error_byte(ErrorBatchType::OTHER, ~length);
             }
-            m_recv_buffer.pop_front();
+            index++;
             continue;
         }
 
@@ -144,44 +172,44 @@ void PABotBaseConnection::on_recv(const void* data, size_t bytes){
 //                : std::string(", char = ") + ascii;
 //            m_logger.log("Message is too long: bytes = " + std::to_string(length) + text);
             push_error_byte(ErrorBatchType::ASCII_BYTES, ~length);
-            m_recv_buffer.pop_front();
+            index++;
             continue;
         }
 
         //  Message is incomplete.
-        if (length > m_recv_buffer.size()){
-            return;
+        if (length > bytes - index){
+            return index;
         }
 
         m_current_error_type = ErrorBatchType::NO_ERROR_;
         m_current_error_batch.clear();
 
-        std::string message(m_recv_buffer.begin(), m_recv_buffer.begin() + length);
-
         //  Verify checksum
         {
             //  Calculate checksum.
-            uint32_t checksumA = pabb_crc32(0xffffffff, &message[0], length - sizeof(uint32_t));
+            uint32_t checksumA = pabb_crc32(0xffffffff, ptr, length - sizeof(uint32_t));
 
             //  Read the checksum from the message.
-            uint32_t checksumE = ((uint32_t*)(&message[0] + length))[-1];
+            uint32_t checksumE;
+            memcpy(&checksumE, ptr + length - sizeof(uint32_t), sizeof(uint32_t));
 
             //  Compare
 //            std::cout << checksumA << " / " << checksumE << std::endl;
             if (checksumA != checksumE){
                 m_logger.log("Invalid Checksum: bytes = " + std::to_string(length));
 //                std::cout << checksumA << " / " << checksumE << std::endl;
-//                log(message_to_string(message[1], &message[2], length - PABB_PROTOCOL_OVERHEAD));
-                m_recv_buffer.pop_front();
+//                log(message_to_string(ptr[1], ptr + 2, length - PABB_PROTOCOL_OVERHEAD));
+                index++;
                 continue;
             }
         }
-        m_recv_buffer.erase(m_recv_buffer.begin(), m_recv_buffer.begin() + length);
+        index += length;
 
-        BotBaseMessage msg(message[1], std::string(&message[2], length - PABB_PROTOCOL_OVERHEAD));
+        BotBaseMessage msg(ptr[1], std::string(ptr + 2, length - PABB_PROTOCOL_OVERHEAD));
         m_sniffer->on_recv(msg);
         on_recv_message(std::move(msg));
     }
+    return index;
 }
 
 
@@ -15,7 +15,7 @@
 #define PokemonAutomation_PABotBaseConnection_H
 
 #include <memory>
-#include <deque>
+#include <string>
 #include "Common/Cpp/SerialConnection/StreamInterface.h"
 #include "Common/SerialPABotBase/SerialPABotBase_Protocol.h"
 #include "BotBase.h"
@@ -37,6 +37,28 @@ public:
     void send_zeros(uint8_t bytes = PABB_PROTOCOL_MAX_PACKET_SIZE);
     void send_message(const BotBaseMessage& message, bool is_retransmit);
 
+    //  Collects messages and writes them all with a single "send()" on
+    //  "flush()" or when it goes out of scope. Each batch has its own buffer
+    //  so it is safe to use alongside plain "send_message()" calls.
+    class SendBatch{
+    public:
+        SendBatch(PABotBaseConnection& connection)
+            : m_connection(connection)
+        {}
+        ~SendBatch(){
+            flush();
+        }
+        SendBatch(const SendBatch&) = delete;
+        void operator=(const SendBatch&) = delete;
+
+        void send_message(const BotBaseMessage& message, bool is_retransmit);
+        void flush();
+
+    private:
+        PABotBaseConnection& m_connection;
+        std::string m_buffer;
+    };
+
 protected:
     //  Not thread-safe with sends.
     void safely_stop();
@@ -45,6 +67,13 @@ private:
     virtual void on_recv(const void* data, size_t bytes) override;
     virtual void on_recv_message(BotBaseMessage message) = 0;
 
+    //  Parse as many messages as possible out of the buffer. Returns the
+    //  number of bytes consumed. Whatever is left is an incomplete message.
+    size_t parse_messages(const char* data, size_t bytes);
+
+    //  Write the framed message to "buffer" and return its length.
+    size_t frame_message(char* buffer, const BotBaseMessage& message, bool is_retransmit);
+
     enum class ErrorBatchType{
         NO_ERROR_,
         ZERO_BYTES,
@@ -56,9 +85,12 @@ private:
 
 private:
     std::unique_ptr<StreamConnection> m_connection;
-    std::deque<char> m_recv_buffer;
 
-    ErrorBatchType m_current_error_type;
+    //  Unconsumed tail of the received stream. This is never more than one
+    //  incomplete message unless it is being parsed.
+    std::string m_recv_buffer;
+
+    ErrorBatchType m_current_error_type = ErrorBatchType::NO_ERROR_;
     std::string m_current_error_batch;
 
 protected:
@@ -0,0 +1,592 @@
+/*  PABotBase Emulator
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <string.h>
+#include <algorithm>
+#include "Common/CRC32.h"
+#include "Common/SerialPABotBase/SerialPABotBase_Messages_HID_Keyboard.h"
+#include "Common/SerialPABotBase/SerialPABotBase_Messages_NS1_WirelessControllers.h"
+#include "Common/SerialPABotBase/SerialPABotBase_Messages_NS2_WiredController.h"
+#include "PABotBaseEmulator.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+
+
+//  How many request responses to remember for retransmits.
+const size_t PABOTBASE_EMULATOR_RESPONSE_CACHE = 64;
+
+
+const std::map<pabb_ProgramID, uint32_t>& PABOTBASE_EMULATOR_DEVICES(){
+    static const std::map<pabb_ProgramID, uint32_t> database{
+        {PABB_PID_PABOTBASE_Emulator,           2025090401},
+    };
+    return database;
+}
+
+
+
+PABotBaseEmulator::PABotBaseEmulator(PABotBaseEmulatorConfig config)
+    : m_config(std::move(config))
+    , m_start(current_time())
+    , m_rng(m_config.seed)
+    , m_controller(m_config.controller)
+{
+    m_thread = Thread([this]{ thread_loop(); });
+}
+PABotBaseEmulator::~PABotBaseEmulator(){
+    stop();
+}
+void PABotBaseEmulator::stop(){
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_stopping = true;
+        m_cv.notify_all();
+    }
+    if (m_thread.joinable()){
+        m_thread.join();
+    }
+}
+
+
+std::vector<PABotBaseEmulatorReport> PABotBaseEmulator::timeline() const{
+    std::lock_guard<std::mutex> lg(m_lock);
+    return m_timeline;
+}
+void PABotBaseEmulator::clear_timeline(){
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_timeline.clear();
+}
+PABotBaseEmulatorStats PABotBaseEmulator::stats() const{
+    std::lock_guard<std::mutex> lg(m_lock);
+    return m_stats;
+}
+
+
+
+void PABotBaseEmulator::send(const void* data, size_t bytes){
+    std::lock_guard<std::mutex> lg(m_lock);
+    transmit(m_to_device, current_time(), std::string((const char*)data, bytes));
+}
+void PABotBaseEmulator::transmit(Link& link, WallClock when, std::string bytes){
+    if (bytes.empty()){
+        return;
+    }
+
+    //  The write occupies the line whether or not it makes it across.
+    WallClock start = std::max(when, link.line_free);
+    WallDuration wire_time = WallDuration::zero();
+    if (m_config.baud_rate != 0){
+        //  8 data bits + start + stop bit.
+        wire_time = std::chrono::duration_cast<WallDuration>(
+            std::chrono::microseconds((uint64_t)bytes.size() * 10 * 1000000 / m_config.baud_rate)
+        );
+    }
+    link.line_free = start + wire_time;
+
+    std::uniform_real_distribution<double> uniform(0, 1);
+    if (m_config.loss_rate > 0 && uniform(m_rng) < m_config.loss_rate){
+        m_stats.writes_dropped++;
+        return;
+    }
+    if (m_config.corruption_rate > 0 && uniform(m_rng) < m_config.corruption_rate){
+        size_t index = std::uniform_int_distribution<size_t>(0, bytes.size() - 1)(m_rng);
+        bytes[index] ^= (char)(1 << std::uniform_int_distribution<int>(0, 7)(m_rng));
+        m_stats.writes_corrupted++;
+    }
+
+    WallClock arrival = link.line_free + m_config.latency;
+    if (m_config.jitter > WallDuration::zero()){
+        arrival += WallDuration(std::uniform_int_distribution<WallDuration::rep>(0, m_config.jitter.count())(m_rng));
+    }
+
+    //  A serial line does not reorder bytes.
+    if (!link.queue.empty()){
+        arrival = std::max(arrival, link.queue.back().arrival);
+    }
+
+    link.queue.emplace_back(Transfer{arrival, std::move(bytes)});
+    m_cv.notify_all();
+}
+std::string PABotBaseEmulator::frame(uint8_t type, const void* body, size_t bytes) const{
+    size_t total_bytes = PABB_PROTOCOL_OVERHEAD + bytes;
+    std::string ret(total_bytes, 0);
+    ret[0] = ~(uint8_t)total_bytes;
+    ret[1] = type;
+    memcpy(&ret[2], body, bytes);
+    pabb_crc32_write_to_message(&ret[0], total_bytes);
+    return ret;
+}
+void PABotBaseEmulator::send_to_host(WallClock when, uint8_t type, const void* body, size_t bytes){
+    transmit(m_to_host, when, frame(type, body, bytes));
+}
+
+
+
+void PABotBaseEmulator::on_device_recv(WallClock when, const std::string& bytes){
+    m_recv_buffer += bytes;
+
+    size_t index = 0;
+    while (index < m_recv_buffer.size()){
+        const char* ptr = m_recv_buffer.data() + index;
+        uint8_t length = ~ptr[0];
+
+        if (ptr[0] == 0){
+            index++;
+            continue;
+        }
+        if (length < PABB_PROTOCOL_OVERHEAD || length > PABB_PROTOCOL_MAX_PACKET_SIZE){
+            m_stats.invalid_messages++;
+            index++;
+            continue;
+        }
+        if (length > m_recv_buffer.size() - index){
+            break;
+        }
+
+        uint32_t checksumA = pabb_crc32(0xffffffff, ptr, length - sizeof(uint32_t));
+        uint32_t checksumE;
+        memcpy(&checksumE, ptr + length - sizeof(uint32_t), sizeof(uint32_t));
+        if (checksumA != checksumE){
+            m_stats.invalid_messages++;
+            index++;
+            continue;
+        }
+
+        on_device_message(when, ptr[1], ptr + 2, length - PABB_PROTOCOL_OVERHEAD);
+        index += length;
+    }
+    m_recv_buffer.erase(0, index);
+}
+void PABotBaseEmulator::on_device_message(WallClock when, uint8_t type, const char* body, size_t bytes){
+    //  Ack for a "command finished" that we sent.
+    if (PABB_MSG_IS_ACK(type)){
+        pabb_MsgAckRequest ack;
+        if (type == PABB_MSG_ACK_REQUEST && bytes == sizeof(ack)){
+            memcpy(&ack, body, sizeof(ack));
+            m_finishes.erase(ack.seqnum);
+        }
+        return;
+    }
+
+    if (!PABB_MSG_IS_REQUEST_OR_COMMAND(type)){
+        return;
+    }
+    if (bytes < sizeof(seqnum_t)){
+        m_stats.invalid_messages++;
+        return;
+    }
+
+    seqnum_t seqnum;
+    memcpy(&seqnum, body, sizeof(seqnum_t));
+
+    if (type == PABB_MSG_SEQNUM_RESET){
+        clear_commands(when);
+        m_finishes.clear();
+        m_responses.clear();
+        m_interrupt_next = false;
+        m_expected_seqnum = seqnum + 1;
+        pabb_MsgAckRequest ack{seqnum};
+        send_to_host(when, PABB_MSG_ACK_REQUEST, ack);
+        return;
+    }
+
+    //  Ahead of what we're expecting. Something before it was lost. (rule 8)
+    int32_t ahead = (int32_t)(seqnum - m_expected_seqnum);
+    if (ahead > 0){
+        m_stats.skipped_messages++;
+        return;
+    }
+
+    //  Retransmit of something we already processed. (rule 9)
+    if (ahead < 0){
+        m_stats.duplicate_messages++;
+        if (PABB_MSG_IS_COMMAND(type)){
+            pabb_MsgAckCommand ack{seqnum};
+            send_to_host(when, PABB_MSG_ACK_COMMAND, ack);
+            return;
+        }
+        auto iter = m_responses.find(seqnum);
+        if (iter != m_responses.end()){
+            transmit(m_to_host, when, iter->second);
+        }
+        return;
+    }
+
+    if (PABB_MSG_IS_COMMAND(type)){
+        if (process_command(when, seqnum, type, body, bytes)){
+            m_expected_seqnum++;
+        }
+        return;
+    }
+
+    m_expected_seqnum++;
+
+    uint8_t response_type = 0;
+    std::string response;
+    process_request(when, seqnum, type, body, bytes, response_type, response);
+    if (response_type == 0){
+        return;
+    }
+
+    std::string message = frame(response_type, response.data(), response.size());
+    m_responses[seqnum] = message;
+    if (m_responses.size() > PABOTBASE_EMULATOR_RESPONSE_CACHE){
+        m_responses.erase(m_responses.begin());
+    }
+    transmit(m_to_host, when, std::move(message));
+}
+void PABotBaseEmulator::process_request(
+    WallClock when, seqnum_t seqnum, uint8_t type, const char* body, size_t bytes,
+    uint8_t& response_type, std::string& response
+){
+    auto respond_i8 = [&](uint8_t data){
+        pabb_MsgAckRequestI8 ack{seqnum, data};
+        response_type = PABB_MSG_ACK_REQUEST_I8;
+        response.assign((const char*)&ack, sizeof(ack));
+    };
+    auto respond_i32 = [&](uint32_t data){
+        pabb_MsgAckRequestI32 ack{seqnum, data};
+        response_type = PABB_MSG_ACK_REQUEST_I32;
+        response.assign((const char*)&ack, sizeof(ack));
+    };
+    auto respond_data = [&](const void* data, size_t data_bytes){
+        response_type = PABB_MSG_ACK_REQUEST_DATA;
+        response.assign((const char*)&seqnum, sizeof(seqnum));
+        response.append((const char*)data, data_bytes);
+    };
+    auto respond_ack = [&]{
+        response_type = PABB_MSG_ACK_REQUEST;
+        response.assign((const char*)&seqnum, sizeof(seqnum));
+    };
+
+    switch (type){
+    case PABB_MSG_REQUEST_PROTOCOL_VERSION:
+        respond_i32(m_config.protocol_version);
+        return;
+    case PABB_MSG_REQUEST_PROGRAM_VERSION:
+        respond_i32(m_config.program_version);
+        return;
+    case PABB_MSG_REQUEST_PROGRAM_ID:
+        respond_i8(m_config.program_id);
+        return;
+    case PABB_MSG_REQUEST_PROGRAM_NAME:
+        respond_data(m_config.program_name.data(), m_config.program_name.size());
+        return;
+    case PABB_MSG_REQUEST_CONTROLLER_LIST:
+        respond_data(m_config.controllers.data(), m_config.controllers.size() * sizeof(pabb_ControllerID));
+        return;
+    case PABB_MSG_REQUEST_QUEUE_SIZE:
+        respond_i8(m_config.queue_size);
+        return;
+
+    case PABB_MSG_REQUEST_READ_CONTROLLER_MODE:
+        respond_i32(m_controller);
+        return;
+    case PABB_MSG_REQUEST_CHANGE_CONTROLLER_MODE:
+    case PABB_MSG_REQUEST_RESET_TO_CONTROLLER:{
+        pabb_MsgRequestChangeControllerMode params;
+        if (bytes != sizeof(params)){
+            break;
+        }
+        memcpy(&params, body, sizeof(params));
+        if (params.controller_id == PABB_CID_NONE ||
+            std::find(m_config.controllers.begin(), m_config.controllers.end(), params.controller_id) != m_config.controllers.end()
+        ){
+            clear_commands(when);
+            m_controller = params.controller_id;
+            if (type == PABB_MSG_REQUEST_RESET_TO_CONTROLLER){
+                m_spi.clear();
+            }
+        }
+        respond_i32(m_controller);
+        return;
+    }
+
+    case PABB_MSG_REQUEST_STOP:
+        clear_commands(when);
+        m_interrupt_next = false;
+        respond_ack();
+        return;
+    case PABB_MSG_REQUEST_NEXT_CMD_INTERRUPT:
+        m_interrupt_next = true;
+        respond_ack();
+        return;
+
+    case PABB_MSG_REQUEST_CLOCK:
+        respond_i32((uint32_t)std::chrono::duration_cast<Milliseconds>(when - m_start).count());
+        return;
+    case PABB_MSG_REQUEST_STATUS:
+        //  Bit 0: Connected, Bit 1: Ready
+        respond_i32(m_controller == PABB_CID_NONE ? 0 : 3);
+        return;
+    case PABB_MSG_REQUEST_READ_MAC_ADDRESS:{
+        uint8_t mac[6] = {0x50, 0x41, 0x42, 0x42, 0x00, 0x00};
+        mac[4] = (uint8_t)(m_controller >> 8);
+        mac[5] = (uint8_t)m_controller;
+        respond_data(mac, sizeof(mac));
+        return;
+    }
+
+    case PABB_MSG_REQUEST_NS1_WIRELESS_CONTROLLER_READ_SPI:{
+        pabb_Message_NS1_WirelessController_ReadSpi params;
+        if (bytes != sizeof(params)){
+            break;
+        }
+        memcpy(&params, body, sizeof(params));
+        std::string data(params.bytes, (char)0xff);
+        for (uint8_t c = 0; c < params.bytes; c++){
+            auto iter = m_spi.find(params.address + c);
+            if (iter != m_spi.end()){
+                data[c] = iter->second;
+            }
+        }
+        respond_data(data.data(), data.size());
+        return;
+    }
+    case PABB_MSG_REQUEST_NS1_WIRELESS_CONTROLLER_WRITE_SPI:{
+        pabb_Message_NS1_WirelessController_WriteSpi params;
+        if (bytes < sizeof(params)){
+            break;
+        }
+        memcpy(&params, body, sizeof(params));
+        if (bytes - sizeof(params) != params.bytes){
+            break;
+        }
+        for (uint8_t c = 0; c < params.bytes; c++){
+            m_spi[params.address + c] = body[sizeof(params) + c];
+        }
+        respond_ack();
+        return;
+    }
+
+    default:{
+        pabb_MsgInfoInvalidType error{type};
+        send_to_host(when, PABB_MSG_ERROR_INVALID_TYPE, error);
+        return;
+    }
+    }
+
+    //  Recognized request with the wrong size.
+    pabb_MsgInfoInvalidRequest error{seqnum};
+    send_to_host(when, PABB_MSG_ERROR_INVALID_REQUEST, error);
+}
+bool PABotBaseEmulator::process_command(WallClock when, seqnum_t seqnum, uint8_t type, const char* body, size_t bytes){
+    //  Single state commands are the seqnum, the duration, then the report.
+    //  Batches are the seqnum, a count, then that many (duration, report).
+    size_t report_bytes;
+    size_t max_states = 1;
+    switch (type){
+    case PABB_MSG_COMMAND_HID_KEYBOARD_STATE:
+        report_bytes = sizeof(pabb_Message_Command_HID_Keyboard_State::report);
+        break;
+    case PABB_MSG_COMMAND_NS2_WIRED_CONTROLLER_STATE:
+        report_bytes = sizeof(SerialPABotBase::pabb_Message_Command_NS2_WiredController_State::report);
+        break;
+    case PABB_MSG_COMMAND_NS1_WIRELESS_CONTROLLER_BUTTONS:
+        report_bytes = sizeof(pabb_Message_Command_NS1_WirelessController_Buttons::buttons);
+        break;
+    case PABB_MSG_COMMAND_NS1_WIRELESS_CONTROLLER_FULL_STATE:
+        report_bytes = sizeof(pabb_Message_Command_NS1_WirelessController_FullState::state);
+        break;
+    case PABB_MSG_COMMAND_NS2_WIRED_CONTROLLER_STATE_BATCH:
+        report_bytes = sizeof(SerialPABotBase::pabb_NS2_WiredController_TimedState::report);
+        max_states = PABB_NS2_WIRED_CONTROLLER_STATE_BATCH_SIZE;
+        break;
+    case PABB_MSG_COMMAND_NS1_WIRELESS_CONTROLLER_BUTTONS_BATCH:
+        report_bytes = sizeof(pabb_NS1_WirelessController_TimedButtons::report);
+        max_states = PABB_NS1_WIRELESS_CONTROLLER_BUTTONS_BATCH_SIZE;
+        break;
+    default:
+        max_states = 0;
+    }
+    if (max_states == 0 || (max_states > 1 && !m_config.command_batches)){
+        pabb_MsgInfoInvalidType error{type};
+        send_to_host(when, PABB_MSG_ERROR_INVALID_TYPE, error);
+        return true;
+    }
+
+    size_t header_bytes = sizeof(seqnum_t);
+    size_t count = 1;
+    if (max_states > 1){
+        count = bytes > header_bytes ? (uint8_t)body[header_bytes] : 0;
+        header_bytes += sizeof(uint8_t);
+    }
+    const size_t state_bytes = sizeof(uint16_t) + report_bytes;
+    if (count == 0 || count > max_states || bytes != header_bytes + count * state_bytes){
+        pabb_MsgInfoInvalidRequest error{seqnum};
+        send_to_host(when, PABB_MSG_ERROR_INVALID_REQUEST, error);
+        return true;
+    }
+
+    if (m_interrupt_next){
+        clear_commands(when);
+        m_interrupt_next = false;
+    }
+
+    //  Queue is full. Don't consume the seqnum so the retransmit gets in.
+    //  A batch takes one slot no matter how many states are in it.
+    if (m_commands.size() >= m_config.queue_size){
+        m_stats.commands_dropped++;
+        pabb_MsgInfoCommandDropped error{seqnum};
+        send_to_host(when, PABB_MSG_ERROR_COMMAND_DROPPED, error);
+        return false;
+    }
+
+    Command& command = m_commands.emplace_back();
+    command.seqnum = seqnum;
+    command.type = type;
+    for (size_t c = 0; c < count; c++){
+        const char* ptr = body + header_bytes + c * state_bytes;
+        uint16_t milliseconds;
+        memcpy(&milliseconds, ptr, sizeof(uint16_t));
+        command.states.emplace_back(State{
+            Milliseconds(milliseconds),
+            std::string(ptr + sizeof(uint16_t), report_bytes)
+        });
+    }
+
+    pabb_MsgAckCommand ack{seqnum};
+    send_to_host(when, PABB_MSG_ACK_COMMAND, ack);
+
+    if (!m_running){
+        start_next_command(when);
+    }
+    return true;
+}
+
+
+
+void PABotBaseEmulator::start_next_command(WallClock when){
+    if (m_commands.empty()){
+        m_running = false;
+        return;
+    }
+    m_running = true;
+    m_commands.front().current = 0;
+    start_state(when);
+    m_stats.commands_executed++;
+}
+void PABotBaseEmulator::start_state(WallClock when){
+    const Command& command = m_commands.front();
+    const State& state = command.states[command.current];
+    m_command_end = when + state.duration;
+    m_timeline.emplace_back(PABotBaseEmulatorReport{
+        when - m_start, state.duration, command.type, state.report
+    });
+}
+void PABotBaseEmulator::end_state(WallClock when){
+    //  The next state starts exactly where this one ended.
+    Command& command = m_commands.front();
+    if (++command.current < command.states.size()){
+        start_state(when);
+    }else{
+        finish_command(when);
+    }
+}
+void PABotBaseEmulator::finish_command(WallClock when){
+    pabb_MsgRequestCommandFinished params;
+    params.seqnum = m_send_seqnum++;
+    params.seq_of_original_command = m_commands.front().seqnum;
+    params.finish_time = (uint32_t)std::chrono::duration_cast<Milliseconds>(when - m_start).count();
+    m_commands.pop_front();
+
+    PendingFinish& finish = m_finishes[params.seqnum];
+    finish.frame = frame(PABB_MSG_REQUEST_COMMAND_FINISHED, &params, sizeof(params));
+    finish.next_retransmit = when + m_config.finish_retransmit;
+    transmit(m_to_host, when, finish.frame);
+
+    //  The next command starts exactly where this one ended.
+    start_next_command(when);
+}
+void PABotBaseEmulator::clear_commands(WallClock when){
+    //  Cut the running command short.
+    if (m_running && !m_timeline.empty()){
+        PABotBaseEmulatorReport& last = m_timeline.back();
+        last.duration = std::min(last.duration, (when - m_start) - last.start);
+    }
+    m_commands.clear();
+    m_running = false;
+}
+
+
+
+void PABotBaseEmulator::thread_loop(){
+    std::vector<std::string> deliveries;
+
+    std::unique_lock<std::mutex> lg(m_lock);
+    while (!m_stopping){
+        WallClock now = current_time();
+
+        //  Run the device up to now, one event at a time in time order.
+        while (true){
+            WallClock arrival = m_to_device.queue.empty()
+                ? WallClock::max()
+                : m_to_device.queue.front().arrival;
+            WallClock command_end = m_running ? m_command_end : WallClock::max();
+            if (std::min(arrival, command_end) > now){
+                break;
+            }
+            if (command_end <= arrival){
+                end_state(command_end);
+            }else{
+                Transfer transfer = std::move(m_to_device.queue.front());
+                m_to_device.queue.pop_front();
+                on_device_recv(transfer.arrival, transfer.bytes);
+            }
+        }
+
+        //  Resend "command finished" messages that were never acked.
+        WallClock next_wake = WallClock::max();
+        for (auto& item : m_finishes){
+            if (item.second.next_retransmit <= now){
+                transmit(m_to_host, now, item.second.frame);
+                item.second.next_retransmit = now + m_config.finish_retransmit;
+                m_stats.finish_retransmits++;
+            }
+            next_wake = std::min(next_wake, item.second.next_retransmit);
+        }
+
+        //  Deliver to the host outside the lock since it may send from inside
+        //  its receive handler.
+        while (!m_to_host.queue.empty() && m_to_host.queue.front().arrival <= now){
+            deliveries.emplace_back(std::move(m_to_host.queue.front().bytes));
+            m_to_host.queue.pop_front();
+        }
+        if (!deliveries.empty()){
+            lg.unlock();
+            for (const std::string& bytes : deliveries){
+                on_recv(bytes.data(), bytes.size());
+            }
+            deliveries.clear();
+            lg.lock();
+            continue;
+        }
+
+        if (!m_to_device.queue.empty()){
+            next_wake = std::min(next_wake, m_to_device.queue.front().arrival);
+        }
+        if (!m_to_host.queue.empty()){
+            next_wake = std::min(next_wake, m_to_host.queue.front().arrival);
+        }
+        if (m_running){
+            next_wake = std::min(next_wake, m_command_end);
+        }
+
+        if (next_wake == WallClock::max()){
+            m_cv.wait(lg);
+        }else{
+            m_cv.wait_until(lg, next_wake);
+        }
+    }
+}
+
+
+
+}
@@ -0,0 +1,211 @@
+/*  PABotBase Emulator
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      An in-process PABotBase device. It implements the StreamConnection
+ *  interface so it can be handed to PABotBase in place of a serial port.
+ *
+ *  The device side speaks the protocol in SerialPABotBase_Protocol.h along
+ *  with the NS1 wireless, NS2 wired and HID keyboard command sets. Commands
+ *  (single or batched) are queued up to the configured depth and executed
+ *  back-to-back on the device clock. Every report the device would output is
+ *  recorded along with exactly when and for how long it was held.
+ *
+ *  The link in each direction is modeled as a serial line with a baud rate,
+ *  latency, jitter, and random loss and corruption of writes. All randomness
+ *  comes from the seed so runs with the same traffic are repeatable.
+ *
+ */
+
+#ifndef PokemonAutomation_PABotBaseEmulator_H
+#define PokemonAutomation_PABotBaseEmulator_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <random>
+#include <mutex>
+#include <condition_variable>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Concurrency/Thread.h"
+#include "Common/Cpp/SerialConnection/StreamInterface.h"
+#include "Common/SerialPABotBase/SerialPABotBase_Protocol.h"
+#include "Common/SerialPABotBase/SerialPABotBase_Protocol_IDs.h"
+
+namespace PokemonAutomation{
+
+
+//  The program ID and protocol version of the emulator in the format of
+//  "SUPPORTED_DEVICES()". It is not in that table so that no serial port can
+//  claim to be the emulator. Pass this to the "SerialPABotBase_Connection"
+//  that talks to an emulator.
+const std::map<pabb_ProgramID, uint32_t>& PABOTBASE_EMULATOR_DEVICES();
+
+
+struct PABotBaseEmulatorConfig{
+    //  Device identity.
+    uint32_t protocol_version = 2025090401;
+    uint32_t program_version = 2025101600;
+    pabb_ProgramID program_id = PABB_PID_PABOTBASE_Emulator;
+    std::string program_name = "PABotBase Emulator";
+    std::vector<pabb_ControllerID> controllers{
+        PABB_CID_StandardHid_Keyboard,
+        PABB_CID_NintendoSwitch_WiredController,
+        PABB_CID_NintendoSwitch_WiredProController,
+        PABB_CID_NintendoSwitch_WirelessProController,
+        PABB_CID_NintendoSwitch_LeftJoycon,
+        PABB_CID_NintendoSwitch_RightJoycon,
+        PABB_CID_NintendoSwitch2_WiredController,
+    };
+    pabb_ControllerID controller = PABB_CID_NONE;
+
+    //  Commands that can be held at once, including the one running.
+    //  Anything beyond this is answered with "PABB_MSG_ERROR_COMMAND_DROPPED".
+    uint8_t queue_size = 16;
+
+    //  Accept the batched controller state commands. Older firmware does not
+    //  and answers them with "PABB_MSG_ERROR_INVALID_TYPE".
+    bool command_batches = true;
+
+    //  How long to wait for the host to ack a "command finished".
+    WallDuration finish_retransmit = std::chrono::milliseconds(100);
+
+    //  Link model. Applies to each direction independently.
+    uint32_t baud_rate = PABB_BAUD_RATE;    //  0 = Infinitely fast.
+    WallDuration latency = WallDuration::zero();
+    WallDuration jitter = WallDuration::zero();
+    double loss_rate = 0;           //  Probability a write is dropped.
+    double corruption_rate = 0;     //  Probability a write has a bit flipped.
+    uint64_t seed = 0;
+};
+
+
+//  One report as the device output it. Times are relative to the construction
+//  of the emulator. Between reports the controller is in its neutral state.
+struct PABotBaseEmulatorReport{
+    WallDuration start;
+    WallDuration duration;
+    uint8_t command_type;
+    std::string report;
+};
+
+struct PABotBaseEmulatorStats{
+    uint64_t writes_dropped = 0;
+    uint64_t writes_corrupted = 0;
+    uint64_t invalid_messages = 0;
+    uint64_t duplicate_messages = 0;    //  Retransmits of something already processed.
+    uint64_t skipped_messages = 0;      //  Ahead of the expected seqnum.
+    uint64_t commands_executed = 0;
+    uint64_t commands_dropped = 0;      //  The queue was full.
+    uint64_t finish_retransmits = 0;
+};
+
+
+class PABotBaseEmulator : public StreamConnection{
+public:
+    PABotBaseEmulator(PABotBaseEmulatorConfig config = PABotBaseEmulatorConfig());
+    virtual ~PABotBaseEmulator();
+
+    virtual void stop() override;
+    virtual void send(const void* data, size_t bytes) override;
+
+    std::vector<PABotBaseEmulatorReport> timeline() const;
+    void clear_timeline();
+
+    PABotBaseEmulatorStats stats() const;
+
+
+private:
+    struct Transfer{
+        WallClock arrival;
+        std::string bytes;
+    };
+    struct Link{
+        std::deque<Transfer> queue;
+        WallClock line_free = WallClock::min();
+    };
+    struct State{
+        WallDuration duration;
+        std::string report;
+    };
+    struct Command{
+        seqnum_t seqnum;
+        uint8_t type;
+        std::vector<State> states;
+        size_t current = 0;
+    };
+    struct PendingFinish{
+        std::string frame;
+        WallClock next_retransmit;
+    };
+
+    //  All of these must be called under "m_lock".
+    void transmit(Link& link, WallClock when, std::string bytes);
+    void send_to_host(WallClock when, uint8_t type, const void* body, size_t bytes);
+    template <typename Params>
+    void send_to_host(WallClock when, uint8_t type, const Params& params){
+        send_to_host(when, type, &params, sizeof(Params));
+    }
+
+    std::string frame(uint8_t type, const void* body, size_t bytes) const;
+
+    void on_device_recv(WallClock when, const std::string& bytes);
+    void on_device_message(WallClock when, uint8_t type, const char* body, size_t bytes);
+    void process_request(
+        WallClock when, seqnum_t seqnum, uint8_t type, const char* body, size_t bytes,
+        uint8_t& response_type, std::string& response
+    );
+    bool process_command(WallClock when, seqnum_t seqnum, uint8_t type, const char* body, size_t bytes);
+
+    void start_next_command(WallClock when);
+    void start_state(WallClock when);
+    void end_state(WallClock when);
+    void finish_command(WallClock when);
+    void clear_commands(WallClock when);
+
+    void thread_loop();
+
+
+private:
+    const PABotBaseEmulatorConfig m_config;
+    const WallClock m_start;
+
+    mutable std::mutex m_lock;
+    std::condition_variable m_cv;
+    bool m_stopping = false;
+
+    std::mt19937_64 m_rng;
+    Link m_to_device;
+    Link m_to_host;
+
+    //  Device state.
+    std::string m_recv_buffer;
+    seqnum_t m_expected_seqnum = 0;
+    seqnum_t m_send_seqnum = 1;
+    pabb_ControllerID m_controller;
+    std::map<uint32_t, uint8_t> m_spi;
+    bool m_interrupt_next = false;
+
+    //  Recent request responses by seqnum. Retransmitted requests get the
+    //  same response again instead of being processed twice.
+    std::map<seqnum_t, std::string> m_responses;
+
+    //  The front command is the one running if "m_running" is true.
+    //  "m_command_end" is when its current state ends.
+    std::deque<Command> m_commands;
+    bool m_running = false;
+    WallClock m_command_end;
+    std::map<seqnum_t, PendingFinish> m_finishes;
+
+    std::vector<PABotBaseEmulatorReport> m_timeline;
+    PABotBaseEmulatorStats m_stats;
+
+    Thread m_thread;
+};
+
+
+
+}
+#endif
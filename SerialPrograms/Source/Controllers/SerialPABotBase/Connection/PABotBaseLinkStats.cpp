@@ -0,0 +1,54 @@
+/*  PABotBase Link Stats
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <vector>
+#include <algorithm>
+#include "PABotBaseLinkStats.h"
+
+namespace PokemonAutomation{
+
+
+
+void PABotBaseLinkStatsCollector::report_sent(uint64_t sent, uint64_t retransmits){
+    m_sent.fetch_add(sent, std::memory_order_relaxed);
+    m_retransmits.fetch_add(retransmits, std::memory_order_relaxed);
+}
+void PABotBaseLinkStatsCollector::report_rtt(WallDuration rtt, WallDuration rto){
+    WriteSpinLock lg(m_lock);
+    m_rtt[m_rtt_next++ % RTT_HISTORY] = rtt;
+    m_rto = rto;
+}
+
+PABotBaseLinkStats PABotBaseLinkStatsCollector::get() const{
+    PABotBaseLinkStats ret;
+    ret.sent = m_sent.load(std::memory_order_relaxed);
+    ret.retransmits = m_retransmits.load(std::memory_order_relaxed);
+
+    std::vector<WallDuration> samples;
+    {
+        ReadSpinLock lg(m_lock);
+        size_t count = (size_t)std::min<uint64_t>(m_rtt_next, RTT_HISTORY);
+        samples.assign(m_rtt.begin(), m_rtt.begin() + count);
+        ret.rto = m_rto;
+    }
+    if (samples.empty()){
+        return ret;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&](double p){
+        return samples[(size_t)(p * (samples.size() - 1))];
+    };
+    ret.rtt_samples = samples.size();
+    ret.rtt_p50 = percentile(0.50);
+    ret.rtt_p90 = percentile(0.90);
+    ret.rtt_p99 = percentile(0.99);
+    return ret;
+}
+
+
+
+}
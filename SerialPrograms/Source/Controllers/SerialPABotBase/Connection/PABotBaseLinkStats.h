@@ -0,0 +1,62 @@
+/*  PABotBase Link Stats
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Round-trip times and retransmits of a single PABotBase connection.
+ *
+ */
+
+#ifndef PokemonAutomation_PABotBaseLinkStats_H
+#define PokemonAutomation_PABotBaseLinkStats_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <atomic>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Concurrency/SpinLock.h"
+
+namespace PokemonAutomation{
+
+
+struct PABotBaseLinkStats{
+    uint64_t sent = 0;          //  Requests and commands. (not counting retransmits)
+    uint64_t retransmits = 0;
+
+    //  Percentiles over the most recent round-trip samples.
+    size_t rtt_samples = 0;
+    WallDuration rtt_p50 = WallDuration::zero();
+    WallDuration rtt_p90 = WallDuration::zero();
+    WallDuration rtt_p99 = WallDuration::zero();
+
+    //  Retransmit timeout as of the last sample.
+    WallDuration rto = WallDuration::zero();
+};
+
+
+//  Owned by a PABotBase. The reports come from its threads. Reading is safe
+//  from any thread.
+class PABotBaseLinkStatsCollector{
+    //  How many of the most recent round-trip samples to keep.
+    static constexpr size_t RTT_HISTORY = 256;
+
+public:
+    void report_sent(uint64_t sent, uint64_t retransmits);
+    void report_rtt(WallDuration rtt, WallDuration rto);
+
+    PABotBaseLinkStats get() const;
+
+private:
+    std::atomic<uint64_t> m_sent{0};
+    std::atomic<uint64_t> m_retransmits{0};
+
+    mutable SpinLock m_lock;
+    std::array<WallDuration, RTT_HISTORY> m_rtt;
+    uint64_t m_rtt_next = 0;
+    WallDuration m_rto = WallDuration::zero();
+};
+
+
+
+}
+#endif
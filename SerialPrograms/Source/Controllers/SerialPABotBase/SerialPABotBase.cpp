@@ -31,18 +31,38 @@ const std::map<pabb_ProgramID, uint32_t>& SUPPORTED_DEVICES(){
     return database;
 }
 
-std::map<uint32_t, std::map<pabb_ProgramID, uint8_t>> make_SUPPORTED_VERSIONS(){
+std::map<uint32_t, std::map<pabb_ProgramID, uint8_t>> make_SUPPORTED_VERSIONS(
+    const std::map<pabb_ProgramID, uint32_t>& devices
+){
     std::map<uint32_t, std::map<pabb_ProgramID, uint8_t>> ret;
-    for (const auto& item : SUPPORTED_DEVICES()){
+    for (const auto& item : devices){
         ret[item.second / 100][item.first] = (uint8_t)(item.second % 100);
     }
     return ret;
 }
 const std::map<uint32_t, std::map<pabb_ProgramID, uint8_t>>& SUPPORTED_VERSIONS(){
-    static const std::map<uint32_t, std::map<pabb_ProgramID, uint8_t>> database = make_SUPPORTED_VERSIONS();
+    static const std::map<uint32_t, std::map<pabb_ProgramID, uint8_t>> database = make_SUPPORTED_VERSIONS(SUPPORTED_DEVICES());
     return database;
 }
 
+const std::map<pabb_ProgramID, uint32_t>& COMMAND_BATCH_DEVICES(){
+    //  No firmware implements the batched commands yet.
+    static const std::map<pabb_ProgramID, uint32_t> database{
+    };
+    return database;
+}
+bool supports_command_batches(
+    const std::map<pabb_ProgramID, uint32_t>& devices,
+    pabb_ProgramID program_id, uint32_t protocol
+){
+    auto iter = devices.find(program_id);
+    if (iter == devices.end()){
+        return false;
+    }
+    //  Same major version and at least the minor version.
+    return protocol / 100 == iter->second / 100 && protocol >= iter->second;
+}
+
 
 
 ControllerType id_to_controller_type(uint32_t id){
@@ -21,6 +21,9 @@ namespace SerialPABotBase{
 
 
 const std::map<pabb_ProgramID, uint32_t>& SUPPORTED_DEVICES();
+std::map<uint32_t, std::map<pabb_ProgramID, uint8_t>> make_SUPPORTED_VERSIONS(
+    const std::map<pabb_ProgramID, uint32_t>& devices
+);
 const std::map<
     uint32_t,   //  Major protocol version. (version # / 100)
     std::map<
@@ -29,6 +32,14 @@ const std::map<
     >
 >& SUPPORTED_VERSIONS();
 
+//  The first protocol version of each program that accepts the batched
+//  controller state commands. Everything else gets one state per command.
+const std::map<pabb_ProgramID, uint32_t>& COMMAND_BATCH_DEVICES();
+bool supports_command_batches(
+    const std::map<pabb_ProgramID, uint32_t>& devices,
+    pabb_ProgramID program_id, uint32_t protocol
+);
+
 
 
 
@@ -79,6 +79,24 @@ SerialPABotBase_Connection::SerialPABotBase_Connection(
         return;
     }
 
+    start_status_thread(set_to_null_controller);
+}
+SerialPABotBase_Connection::SerialPABotBase_Connection(
+    Logger& logger,
+    std::string name,
+    std::unique_ptr<StreamConnection> connection,
+    bool set_to_null_controller,
+    std::map<pabb_ProgramID, uint32_t> extra_devices
+)
+    : m_logger(logger, GlobalSettings::instance().LOG_EVERYTHING)
+    , m_device_name(std::move(name))
+    , m_extra_devices(std::move(extra_devices))
+{
+    set_status_line0("Connecting...", COLOR_DARKGREEN);
+    m_botbase.reset(new PABotBase(m_logger, std::move(connection), nullptr));
+    start_status_thread(set_to_null_controller);
+}
+void SerialPABotBase_Connection::start_status_thread(bool set_to_null_controller){
     m_status_thread = Thread([=, this]{
         run_with_catch(
             "SerialPABotBase_Connection::thread_body()",
@@ -110,6 +128,12 @@ BotBaseController* SerialPABotBase_Connection::botbase(){
     }
     return ret;
 }
+PABotBaseLinkStats SerialPABotBase_Connection::link_stats() const{
+    if (m_botbase == nullptr){
+        return PABotBaseLinkStats();
+    }
+    return m_botbase->link_stats();
+}
 ControllerType SerialPABotBase_Connection::refresh_controller_type(){
     m_logger.log("Reading Controller Mode...");
     uint32_t type_id = read_controller_mode(*botbase());
@@ -146,15 +170,29 @@ void SerialPABotBase_Connection::throw_incompatible_protocol(){
 ControllerType SerialPABotBase_Connection::process_device(bool set_to_null_controller){
     //  Protocol Version
     const std::map<pabb_ProgramID, uint8_t>* PROGRAMS;
+    std::map<pabb_ProgramID, uint8_t> programs;
     {
         m_logger.Logger::log("Checking Protocol Version...");
         m_protocol = protocol_version(*m_botbase);
         m_logger.Logger::log("Checking Protocol Version... (" + std::to_string(m_protocol) + ")");
         auto iter = SUPPORTED_VERSIONS().find(m_protocol / 100);
-        if (iter == SUPPORTED_VERSIONS().end()){
-            throw_incompatible_protocol();
+        if (m_extra_devices.empty()){
+            if (iter == SUPPORTED_VERSIONS().end()){
+                throw_incompatible_protocol();
+            }
+            PROGRAMS = &iter->second;
+        }else{
+            if (iter != SUPPORTED_VERSIONS().end()){
+                programs = iter->second;
+            }
+            for (const auto& item : make_SUPPORTED_VERSIONS(m_extra_devices)[m_protocol / 100]){
+                programs[item.first] = item.second;
+            }
+            if (programs.empty()){
+                throw_incompatible_protocol();
+            }
+            PROGRAMS = &programs;
         }
-        PROGRAMS = &iter->second;
     }
 
     //  Program ID
@@ -179,6 +217,16 @@ ControllerType SerialPABotBase_Connection::process_device(bool set_to_null_contr
         }
     }
 
+    //  Batched Controller State
+    {
+        m_command_batches =
+            supports_command_batches(COMMAND_BATCH_DEVICES(), m_program_id, m_protocol) ||
+            supports_command_batches(m_extra_devices, m_program_id, m_protocol);
+        m_logger.Logger::log(
+            std::string("Batched Controller State: ") + (m_command_batches ? "Supported" : "Not Supported")
+        );
+    }
+
     //  Firmware Version
     {
         m_logger.Logger::log("Checking Firmware Version...");
@@ -9,14 +9,18 @@
 
 #include <memory>
 //#include <set>
+#include <map>
 #include <mutex>
 #include <condition_variable>
 #include "Common/Cpp/Concurrency/Thread.h"
+#include "Common/SerialPABotBase/SerialPABotBase_Protocol_IDs.h"
 #include "Controllers/SerialPABotBase/Connection/BotBase.h"
 #include "Controllers/SerialPABotBase/Connection/MessageLogger.h"
+#include "Controllers/SerialPABotBase/Connection/PABotBaseLinkStats.h"
 #include "Controllers/ControllerConnection.h"
 
 namespace PokemonAutomation{
+    class StreamConnection;
     class PABotBase;
 namespace SerialPABotBase{
 
@@ -28,6 +32,21 @@ public:
         const std::string& name,
         bool set_to_null_controller
     );
+
+    //  Connect over an already open stream instead of a serial port.
+    //  (such as "PABotBaseEmulator")
+    //
+    //  "extra_devices" are accepted on this connection only, on top of
+    //  "SUPPORTED_DEVICES()". They are in the same format and are also
+    //  assumed to accept the batched controller state commands. This is how
+    //  in-process devices get in without being accepted from serial ports.
+    SerialPABotBase_Connection(
+        Logger& logger,
+        std::string name,
+        std::unique_ptr<StreamConnection> connection,
+        bool set_to_null_controller,
+        std::map<pabb_ProgramID, uint32_t> extra_devices = {}
+    );
     ~SerialPABotBase_Connection();
 
 
@@ -37,6 +56,15 @@ public:
     }
     BotBaseController* botbase();
 
+    //  Round-trip times and retransmits of this connection.
+    PABotBaseLinkStats link_stats() const;
+
+    //  Whether the device accepts the batched controller state commands.
+    //  It it not safe to call this until "is_ready()" is true.
+    bool supports_command_batches() const{
+        return m_command_batches;
+    }
+
     ControllerType refresh_controller_type();
 
 
@@ -45,17 +73,20 @@ private:
     void throw_incompatible_protocol();
     ControllerType process_device(bool set_to_null_controller);
 
+    void start_status_thread(bool set_to_null_controller);
     void thread_body(bool set_to_null_controller);
 
 
 private:
     SerialLogger m_logger;
     std::string m_device_name;
+    std::map<pabb_ProgramID, uint32_t> m_extra_devices;
 
     uint32_t m_protocol = 0;
     uint32_t m_version = 0;
     uint8_t m_program_id = 0;
     std::string m_program_name;
+    bool m_command_batches = false;
 
     Thread m_status_thread;
     std::unique_ptr<PABotBase> m_botbase;
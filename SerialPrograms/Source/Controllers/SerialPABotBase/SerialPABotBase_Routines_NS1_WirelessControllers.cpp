@@ -89,6 +89,41 @@ void register_message_converters_NS1_WirelessControllers(){
             return ss.str();
         }
     );
+    register_message_converter(
+        PABB_MSG_COMMAND_NS1_WIRELESS_CONTROLLER_BUTTONS_BATCH,
+        [](const std::string& body){
+            //  Disable this by default since it's very spammy.
+            if (!GlobalSettings::instance().LOG_EVERYTHING){
+                return std::string();
+            }
+            std::ostringstream ss;
+            ss << "PABB_MSG_COMMAND_NS1_WIRELESS_CONTROLLER_BUTTONS_BATCH - ";
+            using Message = pabb_Message_Command_NS1_WirelessController_ButtonsBatch;
+            const size_t header = sizeof(Message) - sizeof(Message::states);
+            if (body.size() < header){
+                ss << "(invalid size)" << std::endl;
+                return ss.str();
+            }
+            const auto* params = (const Message*)body.c_str();
+            if (params->count > PABB_NS1_WIRELESS_CONTROLLER_BUTTONS_BATCH_SIZE ||
+                body.size() != header + params->count * sizeof(Message::states[0])
+            ){
+                ss << "(invalid size)" << std::endl;
+                return ss.str();
+            }
+            ss << "seqnum = " << (uint64_t)params->seqnum;
+            ss << ", milliseconds = {";
+            for (uint8_t c = 0; c < params->count; c++){
+                ss << (c == 0 ? "" : ", ") << params->states[c].milliseconds;
+            }
+            ss << "}";
+
+            //  Do not log the contents of the command due to privacy concerns.
+            //  (people entering passwords)
+
+            return ss.str();
+        }
+    );
     register_message_converter(
         PABB_MSG_INFO_NS1_WIRELESS_CONTROLLER_RUMBLE,
         [](const std::string& body){
@@ -99,6 +99,26 @@ public:
         return BotBaseMessage(PABB_MSG_COMMAND_NS1_WIRELESS_CONTROLLER_BUTTONS, params);
     }
 };
+class MessageControllerStateButtonsBatch : public BotBaseRequest{
+public:
+    pabb_Message_Command_NS1_WirelessController_ButtonsBatch params;
+    MessageControllerStateButtonsBatch(
+        const pabb_NS1_WirelessController_TimedButtons* states, size_t count
+    )
+        : BotBaseRequest(true)
+    {
+        params.seqnum = 0;
+        params.count = (uint8_t)count;
+        memcpy(params.states, states, count * sizeof(params.states[0]));
+    }
+    virtual BotBaseMessage message() const override{
+        size_t bytes = sizeof(params) - sizeof(params.states) + params.count * sizeof(params.states[0]);
+        return BotBaseMessage(
+            PABB_MSG_COMMAND_NS1_WIRELESS_CONTROLLER_BUTTONS_BATCH,
+            std::string((const char*)&params, bytes)
+        );
+    }
+};
 class MessageControllerStateFull : public BotBaseRequest{
 public:
     pabb_Message_Command_NS1_WirelessController_FullState params;
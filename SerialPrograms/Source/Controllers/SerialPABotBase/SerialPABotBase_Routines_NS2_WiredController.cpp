@@ -46,6 +46,37 @@ void register_message_converters_NS2_WiredController(){
             return ss.str();
         }
     );
+    register_message_converter(
+        PABB_MSG_COMMAND_NS2_WIRED_CONTROLLER_STATE_BATCH,
+        [](const std::string& body){
+            //  Disable this by default since it's very spammy.
+            if (!GlobalSettings::instance().LOG_EVERYTHING){
+                return std::string();
+            }
+            std::ostringstream ss;
+            ss << "PABB_MSG_COMMAND_NS2_WIRED_CONTROLLER_STATE_BATCH - ";
+            using Message = pabb_Message_Command_NS2_WiredController_StateBatch;
+            const size_t header = sizeof(Message) - sizeof(Message::states);
+            if (body.size() < header){
+                ss << "(invalid size)" << std::endl;
+                return ss.str();
+            }
+            const auto* params = (const Message*)body.c_str();
+            if (params->count > PABB_NS2_WIRED_CONTROLLER_STATE_BATCH_SIZE ||
+                body.size() != header + params->count * sizeof(Message::states[0])
+            ){
+                ss << "(invalid size)" << std::endl;
+                return ss.str();
+            }
+            ss << "seqnum = " << (uint64_t)params->seqnum;
+            ss << ", milliseconds = {";
+            for (uint8_t c = 0; c < params->count; c++){
+                ss << (c == 0 ? "" : ", ") << params->states[c].milliseconds;
+            }
+            ss << "}";
+            return ss.str();
+        }
+    );
 }
 
 
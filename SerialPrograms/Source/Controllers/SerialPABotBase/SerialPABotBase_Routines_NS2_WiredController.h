@@ -45,10 +45,40 @@ public:
         params.report.right_joystick_x = right_joystick_x;
         params.report.right_joystick_y = right_joystick_y;
     }
+    DeviceRequest_NS2_WiredController_ControllerStateMs(
+        uint16_t milliseconds,
+        const pabb_NintendoSwitch2_WiredController_State& report
+    )
+        : BotBaseRequest(true)
+    {
+        params.seqnum = 0;
+        params.milliseconds = milliseconds;
+        params.report = report;
+    }
     virtual BotBaseMessage message() const override{
         return BotBaseMessage(PABB_MSG_COMMAND_NS2_WIRED_CONTROLLER_STATE, params);
     }
 };
+class DeviceRequest_NS2_WiredController_ControllerStateBatch : public BotBaseRequest{
+public:
+    pabb_Message_Command_NS2_WiredController_StateBatch params;
+    DeviceRequest_NS2_WiredController_ControllerStateBatch(
+        const pabb_NS2_WiredController_TimedState* states, size_t count
+    )
+        : BotBaseRequest(true)
+    {
+        params.seqnum = 0;
+        params.count = (uint8_t)count;
+        memcpy(params.states, states, count * sizeof(params.states[0]));
+    }
+    virtual BotBaseMessage message() const override{
+        size_t bytes = sizeof(params) - sizeof(params.states) + params.count * sizeof(params.states[0]);
+        return BotBaseMessage(
+            PABB_MSG_COMMAND_NS2_WIRED_CONTROLLER_STATE_BATCH,
+            std::string((const char*)&params, bytes)
+        );
+    }
+};
 
 
 
@@ -0,0 +1,186 @@
+/*  SerialPABotBase State Batch
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Collects the controller reports of a schedule so they can be sent with
+ *  as few commands as possible.
+ *
+ *  Adjacent identical reports are merged into one. If the device accepts the
+ *  batched state commands, up to "MAX_CAPACITY" reports go out in each
+ *  command. Otherwise it is one per command as before.
+ *
+ *  "ControllerStateSender" ties a batch to the device so that the controllers
+ *  only need to say which requests to use.
+ *
+ */
+
+#ifndef PokemonAutomation_SerialPABotBase_StateBatch_H
+#define PokemonAutomation_SerialPABotBase_StateBatch_H
+
+#include <string.h>
+#include <algorithm>
+#include "Common/Cpp/Time.h"
+#include "Controllers/Schedulers/SuperscalarScheduler.h"
+#include "Connection/BotBase.h"
+
+namespace PokemonAutomation{
+namespace SerialPABotBase{
+
+
+
+//  "TimedState" is a packed protocol struct with "milliseconds" and "report".
+template <typename TimedState, size_t MAX_CAPACITY>
+class ControllerStateBatch{
+public:
+    using Report = decltype(TimedState::report);
+
+    //  1 for devices that only take one state per command.
+    void set_capacity(size_t capacity){
+        m_capacity = std::clamp<size_t>(capacity, 1, MAX_CAPACITY);
+    }
+
+    bool empty() const{
+        return m_count == 0;
+    }
+    void clear(){
+        m_count = 0;
+    }
+
+    //  Append a report. If this fills up the batch, "send" is called on
+    //  everything before it.
+    //
+    //  "send" is called as: send(const TimedState* states, size_t count)
+    template <typename SendFunction>
+    void push(Milliseconds duration, const Report& report, SendFunction&& send){
+        uint64_t time_left = duration.count();
+        while (time_left > 0){
+            //  Extend the last report if it's the same.
+            if (m_count > 0){
+                TimedState& last = m_states[m_count - 1];
+                if (last.milliseconds < 65535 && memcmp(&last.report, &report, sizeof(Report)) == 0){
+                    uint16_t current = (uint16_t)std::min<uint64_t>(time_left, 65535 - last.milliseconds);
+                    last.milliseconds += current;
+                    time_left -= current;
+                    continue;
+                }
+            }
+
+            //  Only send once something new comes in since the last report may
+            //  still be extended.
+            if (m_count == m_capacity){
+                flush(send);
+            }
+
+            uint16_t current = (uint16_t)std::min<uint64_t>(time_left, 65535);
+            TimedState& state = m_states[m_count++];
+            state.milliseconds = current;
+            state.report = report;
+            time_left -= current;
+        }
+    }
+
+    template <typename SendFunction>
+    void flush(SendFunction&& send){
+        if (m_count == 0){
+            return;
+        }
+        size_t count = m_count;
+        m_count = 0;
+        send(m_states, count);
+    }
+
+
+private:
+    size_t m_capacity = 1;
+    size_t m_count = 0;
+    TimedState m_states[MAX_CAPACITY];
+};
+
+
+
+//  A "ControllerStateBatch" that sends to "serial".
+//
+//  A single state goes out as "SingleRequest(milliseconds, report)". More than
+//  one goes out as "BatchRequest(states, count)".
+//
+//  This is not thread-safe. The controllers only use it from
+//  "execute_state()" and "execute_schedule()", which run under
+//  "m_issue_lock".
+template <
+    typename TimedState, size_t MAX_CAPACITY,
+    typename SingleRequest, typename BatchRequest
+>
+class ControllerStateSender{
+public:
+    using Report = decltype(TimedState::report);
+
+    ControllerStateSender(BotBaseController* serial)
+        : m_serial(serial)
+    {}
+
+    void set_capacity(size_t capacity){
+        m_batch.set_capacity(capacity);
+    }
+
+    void push(const Cancellable* cancellable, Milliseconds duration, const Report& report){
+        m_batch.push(duration, report, [&](const TimedState* states, size_t count){
+            send(cancellable, states, count);
+        });
+    }
+    void flush(const Cancellable* cancellable){
+        m_batch.flush([&](const TimedState* states, size_t count){
+            send(cancellable, states, count);
+        });
+    }
+
+    //  Run every entry of "schedule" through "execute_state" and send
+    //  everything before returning. Nothing is held back since the caller
+    //  may not issue anything else for a while. If anything throws, the
+    //  states that were not sent yet are dropped.
+    //
+    //  "execute_state" is called as:
+    //      execute_state(const Cancellable* cancellable, const ScheduleEntry& entry)
+    template <typename ExecuteState>
+    void execute_schedule(
+        const Cancellable* cancellable,
+        const SuperscalarScheduler::Schedule& schedule,
+        ExecuteState&& execute_state
+    ){
+        try{
+            for (const SuperscalarScheduler::ScheduleEntry& entry : schedule){
+                execute_state(cancellable, entry);
+            }
+            flush(cancellable);
+        }catch (...){
+            m_batch.clear();
+            throw;
+        }
+    }
+
+
+private:
+    void send(const Cancellable* cancellable, const TimedState* states, size_t count){
+        if (count == 1){
+            m_serial->issue_request(
+                SingleRequest(states[0].milliseconds, states[0].report),
+                cancellable
+            );
+        }else{
+            m_serial->issue_request(
+                BatchRequest(states, count),
+                cancellable
+            );
+        }
+    }
+
+
+private:
+    BotBaseController* m_serial;
+    ControllerStateBatch<TimedState, MAX_CAPACITY> m_batch;
+};
+
+
+
+}
+}
+#endif
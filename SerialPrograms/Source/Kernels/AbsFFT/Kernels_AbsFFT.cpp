@@ -5,6 +5,7 @@
  */
 
 #include <stddef.h>
+#include <string.h>
 #include "Common/Cpp/CpuId/CpuId.h"
 #include "Kernels_AbsFFT.h"
 
@@ -17,6 +18,12 @@ namespace AbsFFT{
 void fft_abs_Default(int k, float* abs, float* real);
 void fft_abs_x86_SSE41(int k, float* abs, float* real);
 void fft_abs_x86_AVX2(int k, float* abs, float* real);
+void fft_abs_x86_AVX512(int k, float* abs, float* real);
+
+void fft_abs_Default(int k, float* abs, const float* const input[4], float* work);
+void fft_abs_x86_SSE41(int k, float* abs, const float* const input[4], float* work);
+void fft_abs_x86_AVX2(int k, float* abs, const float* const input[4], float* work);
+void fft_abs_x86_AVX512(int k, float* abs, const float* const input[4], float* work);
 
 
 void fft_abs(int k, float* abs, float* real){
@@ -30,6 +37,12 @@ void fft_abs(int k, float* abs, float* real){
         throw "real must be aligned to 64 bytes.";
     }
 
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        fft_abs_x86_AVX512(k, abs, real);
+        return;
+    }
+#endif
 #ifdef PA_AutoDispatch_x64_13_Haswell
     if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
         fft_abs_x86_AVX2(k, abs, real);
@@ -46,6 +59,60 @@ void fft_abs(int k, float* abs, float* real){
 }
 
 
+void fft_abs_circular(int k, float* abs, const float* circular, size_t start, float* work){
+    if (k <= 1){
+        throw "FFT length must be at least 2^2.";
+    }
+    if ((size_t)abs & 63){
+        throw "abs must be aligned to 64 bytes.";
+    }
+    if ((size_t)circular & 63){
+        throw "circular must be aligned to 64 bytes.";
+    }
+    if ((size_t)work & 63){
+        throw "work must be aligned to 64 bytes.";
+    }
+
+    const size_t length = (size_t)1 << k;
+    const size_t block = length / 4;
+    start &= length - 1;
+
+    //  The window doesn't start on a quarter. Unwrap it and do a normal FFT.
+    if (start % block != 0){
+        size_t head = length - start;
+        memcpy(work, circular + start, head * sizeof(float));
+        memcpy(work + head, circular, start * sizeof(float));
+        fft_abs(k, abs, work);
+        return;
+    }
+
+    const float* input[4];
+    for (size_t c = 0; c < 4; c++){
+        input[c] = circular + ((start + c*block) & (length - 1));
+    }
+
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        fft_abs_x86_AVX512(k, abs, input, work);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        fft_abs_x86_AVX2(k, abs, input, work);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        fft_abs_x86_SSE41(k, abs, input, work);
+        return;
+    }
+#endif
+    fft_abs_Default(k, abs, input, work);
+}
+
+
 
 }
 }
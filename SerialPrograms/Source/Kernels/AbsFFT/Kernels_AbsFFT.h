@@ -7,6 +7,7 @@
 #ifndef PokemonAutomation_Kernels_AbsFFT_H
 #define PokemonAutomation_Kernels_AbsFFT_H
 
+#include <stddef.h>
 
 namespace PokemonAutomation{
 namespace Kernels{
@@ -25,6 +26,19 @@ namespace AbsFFT{
 //
 void fft_abs(int k, float* abs, float* real);
 
+//
+//  Same as above, but the time domain is read from a circular buffer.
+//
+//    - "circular" is a circular buffer of length 2^k. The input is the 2^k
+//      samples starting from index "start" and wrapping around.
+//    - "work" is scratch space of length 2^k.
+//    - "abs", "circular" and "work" must be aligned to 64 bytes.
+//
+//  "circular" is not modified. When "start" is a multiple of 2^(k-2), the
+//  input is read in place without first copying it into "work".
+//
+void fft_abs_circular(int k, float* abs, const float* circular, size_t start, float* work);
+
 
 
 }
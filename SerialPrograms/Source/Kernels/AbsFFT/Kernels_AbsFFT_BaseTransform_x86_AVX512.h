@@ -0,0 +1,139 @@
+/*  ABS FFT Base Transform (x86 AVX512)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_AbsFFT_BaseTransform_x86_AVX512_H
+#define PokemonAutomation_Kernels_AbsFFT_BaseTransform_x86_AVX512_H
+
+#include "Kernels/Kernels_x64_AVX512.h"
+#include "Kernels_AbsFFT_Arch_x86_AVX512.h"
+#include "Kernels_AbsFFT_Butterflies.h"
+#include "Kernels_AbsFFT_ComplexVector.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+namespace AbsFFT{
+
+
+const float TW16_1 = 0.92387953251128675613f;   //  cos(pi/8)
+const float TW16_3 = 0.38268343236508977173f;   //  sin(pi/8)
+
+
+PA_FORCE_INLINE void vtranspose(__m512 r[16]){
+    __m512 a[16];
+    __m512 b[16];
+
+    for (size_t c = 0; c < 16; c += 2){
+        a[c + 0] = _mm512_unpacklo_ps(r[c], r[c + 1]);
+        a[c + 1] = _mm512_unpackhi_ps(r[c], r[c + 1]);
+    }
+    for (size_t c = 0; c < 16; c += 4){
+        b[c + 0] = _mm512_shuffle_ps(a[c + 0], a[c + 2], 68);
+        b[c + 1] = _mm512_shuffle_ps(a[c + 0], a[c + 2], 238);
+        b[c + 2] = _mm512_shuffle_ps(a[c + 1], a[c + 3], 68);
+        b[c + 3] = _mm512_shuffle_ps(a[c + 1], a[c + 3], 238);
+    }
+    for (size_t c = 0; c < 4; c++){
+        __m512 c0 = _mm512_shuffle_f32x4(b[c +  0], b[c +  4], 136);
+        __m512 c1 = _mm512_shuffle_f32x4(b[c +  0], b[c +  4], 221);
+        __m512 c2 = _mm512_shuffle_f32x4(b[c +  8], b[c + 12], 136);
+        __m512 c3 = _mm512_shuffle_f32x4(b[c +  8], b[c + 12], 221);
+        r[c +  0] = _mm512_shuffle_f32x4(c0, c2, 136);
+        r[c +  8] = _mm512_shuffle_f32x4(c0, c2, 221);
+        r[c +  4] = _mm512_shuffle_f32x4(c1, c3, 136);
+        r[c + 12] = _mm512_shuffle_f32x4(c1, c3, 221);
+    }
+}
+
+template <>
+void base_transform<Context_x86_AVX512>(const TwiddleTable<Context_x86_AVX512>& table, Context_x86_AVX512::vtype* T){
+    using Butterflies = Butterflies<Context_x86_AVX512>;
+
+    __m512 r[16];
+    __m512 i[16];
+
+    for (size_t c = 0; c < 16; c++){
+        r[c] = T[2*c + 0];
+        i[c] = T[2*c + 1];
+    }
+
+    {
+        const vcomplex<Context_x86_AVX512>* w1 = table[7].w1.data();
+        const vcomplex<Context_x86_AVX512>* w2 = table[8].w1.data();
+        const vcomplex<Context_x86_AVX512>* w3 = table[8].w3.data();
+        for (size_t c = 0; c < 4; c++){
+            Butterflies::butterfly4(
+                r[c +  0], i[c +  0],
+                r[c +  4], i[c +  4], w1[c].r, w1[c].i,
+                r[c +  8], i[c +  8], w2[c].r, w2[c].i,
+                r[c + 12], i[c + 12], w3[c].r, w3[c].i
+            );
+        }
+    }
+    {
+        const vcomplex<Context_x86_AVX512>* w1 = table[5].w1.data();
+        const vcomplex<Context_x86_AVX512>* w2 = table[6].w1.data();
+        const vcomplex<Context_x86_AVX512>* w3 = table[6].w3.data();
+        for (size_t c = 0; c < 16; c += 4){
+            Butterflies::butterfly4(
+                r[c + 0], i[c + 0],
+                r[c + 1], i[c + 1], w1[0].r, w1[0].i,
+                r[c + 2], i[c + 2], w2[0].r, w2[0].i,
+                r[c + 3], i[c + 3], w3[0].r, w3[0].i
+            );
+        }
+    }
+
+    //  Each vector is now an independent 16-point transform.
+    vtranspose(r);
+    vtranspose(i);
+
+    Butterflies::butterfly4(
+        r[0], i[0],
+        r[4], i[4],
+        r[8], i[8],
+        r[12], i[12]
+    );
+    Butterflies::butterfly4(
+        r[1], i[1],
+        r[5], i[5], Context_x86_AVX512::vset1(TW8_1), Context_x86_AVX512::vset1(TW8_1),
+        r[9], i[9], Context_x86_AVX512::vset1(TW16_1), Context_x86_AVX512::vset1(TW16_3),
+        r[13], i[13], Context_x86_AVX512::vset1(TW16_3), Context_x86_AVX512::vset1(TW16_1)
+    );
+    Butterflies::butterfly4(
+        r[2], i[2],
+        r[6], i[6], Context_x86_AVX512::vset1(0), Context_x86_AVX512::vset1(1),
+        r[10], i[10], Context_x86_AVX512::vset1(TW8_1), Context_x86_AVX512::vset1(TW8_1),
+        r[14], i[14], Context_x86_AVX512::vset1(-TW8_1), Context_x86_AVX512::vset1(TW8_1)
+    );
+    Butterflies::butterfly4(
+        r[3], i[3],
+        r[7], i[7], Context_x86_AVX512::vset1(-TW8_1), Context_x86_AVX512::vset1(TW8_1),
+        r[11], i[11], Context_x86_AVX512::vset1(TW16_3), Context_x86_AVX512::vset1(TW16_1),
+        r[15], i[15], Context_x86_AVX512::vset1(-TW16_1), Context_x86_AVX512::vset1(-TW16_3)
+    );
+    for (size_t c = 0; c < 16; c += 4){
+        Butterflies::butterfly4(
+            r[c + 0], i[c + 0],
+            r[c + 1], i[c + 1],
+            r[c + 2], i[c + 2],
+            r[c + 3], i[c + 3]
+        );
+    }
+
+    vtranspose(r);
+    vtranspose(i);
+    for (size_t c = 0; c < 16; c++){
+        T[2*c + 0] = r[c];
+        T[2*c + 1] = i[c];
+    }
+}
+
+
+
+}
+}
+}
+#endif
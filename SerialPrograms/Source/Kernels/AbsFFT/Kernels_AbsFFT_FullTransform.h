@@ -20,6 +20,9 @@ void fft_abs_scalar(const TwiddleTable<Context>& table, int k, float* abs, float
 template <typename Context>
 void fft_abs(const TwiddleTable<Context>& table, int k, float* abs, float* real);
 
+template <typename Context>
+void fft_abs(const TwiddleTable<Context>& table, int k, float* abs, const float* const input[4], float* work);
+
 
 
 }
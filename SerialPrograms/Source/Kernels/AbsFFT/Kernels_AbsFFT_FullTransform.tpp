@@ -4,6 +4,7 @@
  *
  */
 
+#include <string.h>
 #include <cmath>
 #include "Kernels_AbsFFT_BitReverse.h"
 #include "Kernels_AbsFFT_ComplexToAbs.h"
@@ -97,6 +98,9 @@ void fft_abs_scalar(const TwiddleTable<Context>& table, int k, float* abs, float
 }
 
 
+template <typename Context>
+void fft_abs_reduced(const TwiddleTable<Context>& table, int k, float* abs, float* real);
+
 template <typename Context>
 void fft_abs(const TwiddleTable<Context>& table, int k, float* abs, float* real){
     using vtype = typename Context::vtype;
@@ -106,11 +110,40 @@ void fft_abs(const TwiddleTable<Context>& table, int k, float* abs, float* real)
         return;
     }
 
-    size_t block = (size_t)1 << (k - 2);
-
     //  Initial split-radix reduction.
     Reductions<Context>::fft_real_split_reduce(table, k, (vtype*)real, (vtype*)abs);
 
+    fft_abs_reduced(table, k, abs, real);
+}
+
+template <typename Context>
+void fft_abs(const TwiddleTable<Context>& table, int k, float* abs, const float* const input[4], float* work){
+    using vtype = typename Context::vtype;
+
+    size_t block = (size_t)1 << (k - 2);
+
+    if (k - 2 < Context::BASE_COMPLEX_TRANSFORM_K){
+        for (size_t c = 0; c < 4; c++){
+            memcpy(work + c*block, input[c], block * sizeof(float));
+        }
+        fft_abs_scalar<Context>(table, k, abs, work);
+        return;
+    }
+
+    //  Initial split-radix reduction. This is the only pass that reads the
+    //  input. Everything after it runs in "work" and "abs".
+    Reductions<Context>::fft_real_split_reduce(table, k, (const vtype* const*)input, (vtype*)work, (vtype*)abs);
+
+    fft_abs_reduced(table, k, abs, work);
+}
+
+//  Everything after the initial reduction.
+template <typename Context>
+void fft_abs_reduced(const TwiddleTable<Context>& table, int k, float* abs, float* real){
+    using vtype = typename Context::vtype;
+
+    size_t block = (size_t)1 << (k - 2);
+
     //  Transform complex upper-half.
     fft_complex_tk(table, k - 2, (vtype*)abs);
 
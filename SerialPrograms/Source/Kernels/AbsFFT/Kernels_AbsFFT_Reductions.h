@@ -77,6 +77,45 @@ static PA_FORCE_INLINE void fft_real_split_reduce(const TwiddleTable<Context>& t
     }while (--lc);
 }
 
+//  Same as above, but read the 4 quarters of the input from "in" and write the
+//  reduced lower half into "real". The input is not modified.
+static PA_FORCE_INLINE void fft_real_split_reduce(const TwiddleTable<Context>& table, int k, const vtype* const in[4], vtype* real, vtype* upper_complex){
+    size_t vstride = (size_t)1 << (k - 2 - Context::VECTOR_K);
+    const vtype* R0 = in[0];
+    const vtype* R1 = in[1];
+    const vtype* R2 = in[2];
+    const vtype* R3 = in[3];
+    vtype* L0 = real;
+    vtype* L1 = L0 + vstride;
+    const vcomplex<Context>* w = table[k].w1.data();
+    size_t lc = vstride;
+    do{
+        vtype r0 = R0[0];
+        vtype r1 = R1[0];
+        vtype r2 = R2[0];
+        vtype r3 = R3[0];
+
+        L0[0] = Context::vadd(r0, r2);
+        L1[0] = Context::vadd(r1, r3);
+
+        r0 = Context::vsub(r0, r2);
+        r1 = Context::vsub(r1, r3);
+        Context::cmul_pp(r0, r1, w[0].r, w[0].i);
+
+        upper_complex[0] = r0;
+        upper_complex[1] = r1;
+
+        R0++;
+        R1++;
+        R2++;
+        R3++;
+        L0++;
+        L1++;
+        upper_complex += 2;
+        w++;
+    }while (--lc);
+}
+
 
 
 };
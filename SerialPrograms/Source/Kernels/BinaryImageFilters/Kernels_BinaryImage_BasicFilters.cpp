@@ -205,6 +205,85 @@ void compress_rgb32_to_binary_range(
 }
 
 
+void compress_rgb32_to_binary_hsv_range_64x64_x64_AVX512(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filters, size_t filter_count
+);
+void compress_rgb32_to_binary_hsv_range_64x32_x64_AVX512(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filters, size_t filter_count
+);
+void compress_rgb32_to_binary_hsv_range_64x16_x64_AVX2(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filters, size_t filter_count
+);
+void compress_rgb32_to_binary_hsv_range_64x8_x64_SSE42(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filters, size_t filter_count
+);
+void compress_rgb32_to_binary_hsv_range_64x8_arm64_NEON(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filters, size_t filter_count
+);
+void compress_rgb32_to_binary_hsv_range_64x4_Default(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filters, size_t filter_count
+);
+void compress_rgb32_to_binary_hsv_range(
+    const uint32_t* image, size_t bytes_per_row,
+    PackedBinaryMatrix_IB& matrix,
+    uint32_t mins, uint32_t maxs
+){
+    CompressRgb32ToBinaryRangeFilter filter(matrix, mins, maxs);
+    compress_rgb32_to_binary_hsv_range(image, bytes_per_row, &filter, 1);
+}
+void compress_rgb32_to_binary_hsv_range(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filters, size_t filter_count
+){
+    if (filter_count == 0){
+        return;
+    }
+    BinaryMatrixType type = filters[0].matrix.type();
+    for (size_t c = 1; c < filter_count; c++){
+        if (type != filters[c].matrix.type()){
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Mismatching matrix formats.");
+        }
+    }
+    switch (type){
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    case BinaryMatrixType::i64x64_x64_AVX512:
+        compress_rgb32_to_binary_hsv_range_64x64_x64_AVX512(image, bytes_per_row, filters, filter_count);
+        return;
+    case BinaryMatrixType::i64x32_x64_AVX512:
+        compress_rgb32_to_binary_hsv_range_64x32_x64_AVX512(image, bytes_per_row, filters, filter_count);
+        return;
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    case BinaryMatrixType::i64x16_x64_AVX2:
+        compress_rgb32_to_binary_hsv_range_64x16_x64_AVX2(image, bytes_per_row, filters, filter_count);
+        return;
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    case BinaryMatrixType::i64x8_x64_SSE42:
+        compress_rgb32_to_binary_hsv_range_64x8_x64_SSE42(image, bytes_per_row, filters, filter_count);
+        return;
+#endif
+#ifdef PA_AutoDispatch_arm64_20_M1
+    case BinaryMatrixType::arm64x8_x64_NEON:
+        compress_rgb32_to_binary_hsv_range_64x8_arm64_NEON(image, bytes_per_row, filters, filter_count);
+        return;
+#endif
+    case BinaryMatrixType::i64x4_Default:
+        compress_rgb32_to_binary_hsv_range_64x4_Default(image, bytes_per_row, filters, filter_count);
+        return;
+    default:
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Unsupported matrix format.");
+    }
+}
+
+
+
 void compress_rgb32_to_binary_euclidean_64x64_x64_AVX512(
     const uint32_t* image, size_t bytes_per_row,
     PackedBinaryMatrix_IB& matrix,
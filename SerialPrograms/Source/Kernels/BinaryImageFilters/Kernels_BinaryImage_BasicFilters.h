@@ -80,6 +80,22 @@ void compress_rgb32_to_binary_range(
 
 
 
+//  Same as `compress_rgb32_to_binary_range()`, but the pixels are converted to HSV32 first.
+//  The conversion is exactly the one done by `ImageHSV32`. So `mins` and `maxs` are in the
+//  HSV32 layout: 0xAAHHSSVV.
+void compress_rgb32_to_binary_hsv_range(
+    const uint32_t* image, size_t bytes_per_row,
+    PackedBinaryMatrix_IB& matrix,
+    uint32_t mins, uint32_t maxs
+);
+void compress_rgb32_to_binary_hsv_range(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filters, size_t filter_count
+);
+
+
+
+
 //  Compress (image, bytes_per_row) into a binary_image.
 //  For each pixel, set to 1 if the Euclidean distance of the pixel color to the expected color <= max distance.
 void compress_rgb32_to_binary_euclidean(
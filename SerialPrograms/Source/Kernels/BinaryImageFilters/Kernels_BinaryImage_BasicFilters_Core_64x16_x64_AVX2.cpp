@@ -9,6 +9,7 @@
 #include "Kernels/BinaryMatrix/Kernels_BinaryMatrix_Arch_64x16_x64_AVX2.h"
 #include "Kernels_BinaryImage_BasicFilters_Routines.h"
 #include "Kernels_BinaryImage_BasicFilters_x64_AVX2.h"
+#include "Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_Routines_x64_AVX2.h"
 
 namespace PokemonAutomation{
 namespace Kernels{
@@ -47,6 +48,17 @@ void compress_rgb32_to_binary_range_64x16_x64_AVX2(
 
 
 
+void compress_rgb32_to_binary_hsv_range_64x16_x64_AVX2(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filters, size_t filter_count
+){
+    compress_rgb32_to_binary_converted<PackedBinaryMatrix_64x16_x64_AVX2, Rgb32ToHsv32_x64_AVX2, Compressor_RgbRange_x64_AVX2>(
+        image, bytes_per_row, filters, filter_count
+    );
+}
+
+
+
 void compress_rgb32_to_binary_euclidean_64x16_x64_AVX2(
     const uint32_t* image, size_t bytes_per_row,
     PackedBinaryMatrix_IB& matrix,
@@ -7,6 +7,7 @@
 #include "Kernels/BinaryMatrix/Kernels_BinaryMatrix_Arch_64xH_Default.h"
 #include "Kernels_BinaryImage_BasicFilters_Routines.h"
 #include "Kernels_BinaryImage_BasicFilters_Default.h"
+#include "Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_Routines_Default.h"
 
 namespace PokemonAutomation{
 namespace Kernels{
@@ -45,6 +46,17 @@ void compress_rgb32_to_binary_range_64x4_Default(
 
 
 
+void compress_rgb32_to_binary_hsv_range_64x4_Default(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filters, size_t filter_count
+){
+    compress_rgb32_to_binary_converted<PackedBinaryMatrix_64x4_Default, Rgb32ToHsv32_Default, Compressor_RgbRange_Default>(
+        image, bytes_per_row, filters, filter_count
+    );
+}
+
+
+
 void compress_rgb32_to_binary_euclidean_64x4_Default(
     const uint32_t* image, size_t bytes_per_row,
     PackedBinaryMatrix_IB& matrix,
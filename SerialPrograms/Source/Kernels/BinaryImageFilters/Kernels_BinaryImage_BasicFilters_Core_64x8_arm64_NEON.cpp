@@ -9,6 +9,7 @@
 #include "Kernels/BinaryMatrix/Kernels_BinaryMatrix_Arch_64x8_arm64_NEON.h"
 #include "Kernels_BinaryImage_BasicFilters_Routines.h"
 #include "Kernels_BinaryImage_BasicFilters_arm64_NEON.h"
+#include "Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_Routines_ARM64_NEON.h"
 
 
 namespace PokemonAutomation{
@@ -47,6 +48,17 @@ void compress_rgb32_to_binary_range_64x8_arm64_NEON(
 }
 
 
+void compress_rgb32_to_binary_hsv_range_64x8_arm64_NEON(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filters, size_t filter_count
+){
+    compress_rgb32_to_binary_converted<PackedBinaryMatrix_64x8_arm64_NEON, Rgb32ToHsv32_ARM64_NEON, Compressor_RgbRange_arm64_NEON>(
+        image, bytes_per_row, filters, filter_count
+    );
+}
+
+
+
 void compress_rgb32_to_binary_euclidean_64x8_arm64_NEON(
     const uint32_t* image, size_t bytes_per_row,
     PackedBinaryMatrix_IB& matrix,
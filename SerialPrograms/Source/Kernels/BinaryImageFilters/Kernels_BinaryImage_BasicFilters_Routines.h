@@ -118,6 +118,49 @@ void compress_rgb32_to_binary(
 }
 
 
+
+//  Same as above, but each block of 64 pixels is first converted by
+//  "Converter" and the filters are applied to the converted pixels. The
+//  conversion is done once per block for all the filters.
+template <typename BinaryMatrixType, typename Converter, typename Compressor>
+void compress_rgb32_to_binary_converted(
+    const uint32_t* image, size_t bytes_per_row,
+    CompressRgb32ToBinaryRangeFilter* filter, size_t filter_count
+){
+    using Entry = CompressRgb32ToBinaryRangeEntry<BinaryMatrixType, Compressor>;
+    FixedLimitVector<Entry> entries(filter_count);
+    for (size_t c = 0; c < filter_count; c++){
+        entries.emplace_back(static_cast<BinaryMatrixType&>(filter[c].matrix), filter[c].mins, filter[c].maxs);
+    }
+
+    alignas(64) uint32_t buffer[64];
+
+    size_t bit_width = entries[0].matrix.get().width();
+    size_t word_height = entries[0].matrix.get().word64_height();
+    for (size_t r = 0; r < word_height; r++){
+        const uint32_t* img = image;
+        size_t c = 0;
+        size_t left = bit_width;
+        while (left >= 64){
+            Converter::convert_row(buffer, img, 64);
+            for (Entry& entry : entries){
+                entry.matrix.get().word64(c, r) = entry.compressor.convert64(buffer);
+            }
+            c++;
+            img += 64;
+            left -= 64;
+        }
+        if (left > 0){
+            Converter::convert_row(buffer, img, left);
+            for (Entry& entry : entries){
+                entry.matrix.get().word64(c, r) = entry.compressor.convert64(buffer, left);
+            }
+        }
+        image = (const uint32_t*)((const char*)image + bytes_per_row);
+    }
+}
+
+
 // Change pixel (as uint32_t) color of image based on bits in a binary matrix
 // If `filter` is constructed with `replace_if_zero` being true, image pixels corresponding to 0-bits in `matrix`
 //    are replaced with color `replace_with` which is provided by the filter.
@@ -8,7 +8,8 @@
 #define PokemonAutomation_Kernels_SparseBinaryMatrixCore_H
 
 #include <string>
-#include <map>
+#include <vector>
+#include <algorithm>
 #include "Kernels_PackedBinaryMatrixCore.h"
 
 namespace PokemonAutomation{
@@ -34,7 +35,18 @@ public:
     SparseBinaryMatrixCore(size_t width, size_t height);
 
     void clear();
-    void set_data(std::map<TileIndex, TileType> data);
+
+    //  Clear all the tiles and set new dimensions. The tile storage is kept
+    //  so refilling a matrix of similar size does not allocate.
+    void reset(size_t width, size_t height);
+
+    //  Bulk fill: append tiles in any order, then call "finish_append()"
+    //  before using the matrix. Each index may only be appended once.
+    void append_tile(TileIndex index, const TileType& tile);
+    void finish_append();
+
+    //  # of tiles that fit in the current storage without reallocating.
+    size_t tile_capacity() const{ return m_data.capacity(); }
 
     void operator^=(const SparseBinaryMatrixCore& x);
     void operator|=(const SparseBinaryMatrixCore& x);
@@ -79,7 +91,13 @@ private:
     size_t m_logical_height;
     size_t m_tile_width;
     size_t m_tile_height;
-    std::map<TileIndex, TileType> m_data;
+
+    //  Non-zero tiles sorted by index.
+    using Entry = std::pair<TileIndex, TileType>;
+    std::vector<Entry> m_data;
+
+    typename std::vector<Entry>::const_iterator lower_bound(TileIndex index) const;
+    typename std::vector<Entry>::iterator lower_bound(TileIndex index);
 
 
     static const TileType& ZERO_TILE();
@@ -96,17 +114,38 @@ private:
 
 //  Tile Access
 
+template <typename Tile> PA_FORCE_INLINE
+typename std::vector<typename SparseBinaryMatrixCore<Tile>::Entry>::const_iterator
+SparseBinaryMatrixCore<Tile>::lower_bound(TileIndex index) const{
+    return std::lower_bound(
+        m_data.begin(), m_data.end(), index,
+        [](const Entry& entry, TileIndex key){ return entry.first < key; }
+    );
+}
+template <typename Tile> PA_FORCE_INLINE
+typename std::vector<typename SparseBinaryMatrixCore<Tile>::Entry>::iterator
+SparseBinaryMatrixCore<Tile>::lower_bound(TileIndex index){
+    return std::lower_bound(
+        m_data.begin(), m_data.end(), index,
+        [](const Entry& entry, TileIndex key){ return entry.first < key; }
+    );
+}
+
 template <typename Tile> PA_FORCE_INLINE
 const Tile& SparseBinaryMatrixCore<Tile>::tile(TileIndex index) const{
-    auto iter = m_data.find(index);
-    if (iter == m_data.end()){
+    auto iter = lower_bound(index);
+    if (iter == m_data.end() || index < iter->first){
         return ZERO_TILE();
     }
     return iter->second;
 }
 template <typename Tile> PA_FORCE_INLINE
 Tile& SparseBinaryMatrixCore<Tile>::tile(TileIndex index){
-    return m_data[index];
+    auto iter = lower_bound(index);
+    if (iter == m_data.end() || index < iter->first){
+        iter = m_data.emplace(iter, index, Tile());
+    }
+    return iter->second;
 }
 template <typename Tile> PA_FORCE_INLINE
 const Tile& SparseBinaryMatrixCore<Tile>::tile(size_t x, size_t y) const{
@@ -90,8 +90,23 @@ void SparseBinaryMatrixCore<Tile>::clear(){
     m_data.clear();
 }
 template <typename Tile>
-void SparseBinaryMatrixCore<Tile>::set_data(std::map<TileIndex, Tile> data){
-    m_data = std::move(data);
+void SparseBinaryMatrixCore<Tile>::reset(size_t width, size_t height){
+    m_logical_width = width;
+    m_logical_height = height;
+    m_tile_width = (width + TILE_WIDTH - 1) / TILE_WIDTH;
+    m_tile_height = (height + TILE_HEIGHT - 1) / TILE_HEIGHT;
+    m_data.clear();
+}
+template <typename Tile>
+void SparseBinaryMatrixCore<Tile>::append_tile(TileIndex index, const Tile& tile){
+    m_data.emplace_back(index, tile);
+}
+template <typename Tile>
+void SparseBinaryMatrixCore<Tile>::finish_append(){
+    std::sort(
+        m_data.begin(), m_data.end(),
+        [](const Entry& a, const Entry& b){ return a.first < b.first; }
+    );
 }
 
 template <typename Tile>
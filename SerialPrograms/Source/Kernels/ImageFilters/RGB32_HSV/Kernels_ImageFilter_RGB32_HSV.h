@@ -0,0 +1,40 @@
+/*  Image Filters RGB32 HSV
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Convert RGB32 pixels into HSV32 pixels. (0xAAHHSSVV)
+ *
+ *  H is the standard hue scaled from [0, 360) to [0, 256). S and V are in
+ *  [0, 255]. Alpha is passed through unchanged.
+ *
+ *  All the implementations are bit-identical with "rgb32_to_hsv32_Default()".
+ *  The vector versions get there by computing the hue and saturation as an
+ *  exact integer fraction followed by a single float division. Both the
+ *  numerator and the denominator fit in a float exactly and the quotient is
+ *  never close enough to an integer for the rounding of the division to
+ *  change the truncated result.
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_H
+#define PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_H
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+//  Convert (in, width, height) into "out" which must be at least as large.
+//  "in" and "out" may be the same buffer.
+void convert_rgb32_to_hsv32(
+    const uint32_t* in, size_t in_bytes_per_row, size_t width, size_t height,
+    uint32_t* out, size_t out_bytes_per_row
+);
+
+
+
+}
+}
+#endif
@@ -0,0 +1,27 @@
+/*  Image Filters RGB32 HSV (Default)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "Kernels_ImageFilter_RGB32_HSV_Routines.h"
+#include "Kernels_ImageFilter_RGB32_HSV_Routines_Default.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+void convert_rgb32_to_hsv32_Default(
+    const uint32_t* in, size_t in_bytes_per_row, size_t width, size_t height,
+    uint32_t* out, size_t out_bytes_per_row
+){
+    convert_rgb32_to_hsv32<Rgb32ToHsv32_Default>(
+        in, in_bytes_per_row, width, height,
+        out, out_bytes_per_row
+    );
+}
+
+
+
+}
+}
@@ -0,0 +1,39 @@
+/*  Image Filters RGB32 HSV
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_H
+#define PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_H
+
+#include <stdint.h>
+#include <cstddef>
+#include "Kernels_ImageFilter_RGB32_HSV.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+//  "Converter" provides:
+//      static void convert_row(uint32_t* out, const uint32_t* in, size_t count);
+template <typename Converter>
+void convert_rgb32_to_hsv32(
+    const uint32_t* in, size_t in_bytes_per_row, size_t width, size_t height,
+    uint32_t* out, size_t out_bytes_per_row
+){
+    if (width == 0){
+        return;
+    }
+    for (size_t r = 0; r < height; r++){
+        Converter::convert_row(out, in, width);
+        in = (const uint32_t*)((const char*)in + in_bytes_per_row);
+        out = (uint32_t*)((char*)out + out_bytes_per_row);
+    }
+}
+
+
+
+}
+}
+#endif
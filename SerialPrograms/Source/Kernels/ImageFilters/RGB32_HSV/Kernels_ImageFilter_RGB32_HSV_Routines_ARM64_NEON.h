@@ -0,0 +1,83 @@
+/*  Image Filters RGB32 HSV (arm64 NEON)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_ARM64_NEON_H
+#define PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_ARM64_NEON_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <string.h>
+#include <arm_neon.h>
+#include "Common/Compiler.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct Rgb32ToHsv32_ARM64_NEON{
+    static PA_FORCE_INLINE void convert_row(uint32_t* out, const uint32_t* in, size_t count){
+        size_t lc = count / 4;
+        while (lc--){
+            uint32x4_t pixel = vld1q_u32(in);
+            vst1q_u32(out, convert(pixel));
+            in += 4;
+            out += 4;
+        }
+        count %= 4;
+        if (count){
+            uint32_t buffer[4] = {};
+            memcpy(buffer, in, sizeof(uint32_t) * count);
+            vst1q_u32(buffer, convert(vld1q_u32(buffer)));
+            memcpy(out, buffer, sizeof(uint32_t) * count);
+        }
+    }
+
+    //  See the SSE4.2 version for how this works. The only difference is
+    //  that NEON converts NaN to 0 instead of INT_MIN.
+    static PA_FORCE_INLINE uint32x4_t convert(uint32x4_t pixel){
+        const int32x4_t zero = vdupq_n_s32(0);
+
+        int32x4_t r = vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(pixel, 16), vdupq_n_u32(0xff)));
+        int32x4_t g = vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(pixel, 8), vdupq_n_u32(0xff)));
+        int32x4_t b = vreinterpretq_s32_u32(vandq_u32(pixel, vdupq_n_u32(0xff)));
+
+        int32x4_t M = vmaxq_s32(vmaxq_s32(r, g), b);
+        int32x4_t m = vminq_s32(vminq_s32(r, g), b);
+        int32x4_t delta = vsubq_s32(M, m);
+
+        int32x4_t S = vsubq_s32(vshlq_n_s32(m, 8), m);
+        S = vaddq_s32(S, vshrq_n_s32(M, 1));
+        S = vcvtq_s32_f32(vdivq_f32(vcvtq_f32_s32(S), vcvtq_f32_s32(M)));
+        S = vsubq_s32(vdupq_n_s32(255), S);
+        S = vbslq_s32(vceqq_s32(M, zero), zero, S);
+
+        uint32x4_t is_r = vceqq_s32(M, r);
+        uint32x4_t is_g = vceqq_s32(M, g);
+        int32x4_t num = vsubq_s32(r, g);
+        int32x4_t off = vdupq_n_s32(4*256 + 3);
+        num = vbslq_s32(is_g, vsubq_s32(b, r), num);
+        off = vbslq_s32(is_g, vdupq_n_s32(2*256 + 3), off);
+        num = vbslq_s32(is_r, vsubq_s32(g, b), num);
+        off = vbslq_s32(is_r, vdupq_n_s32(3), off);
+
+        int32x4_t H = vaddq_s32(vshlq_n_s32(num, 8), vmulq_s32(off, delta));
+        float32x4_t D = vmulq_n_f32(vcvtq_f32_s32(delta), 6);
+        H = vcvtq_s32_f32(vdivq_f32(vcvtq_f32_s32(H), D));
+        H = vmaxq_s32(H, zero);
+
+        pixel = vandq_u32(pixel, vdupq_n_u32(0xff000000));
+        pixel = vorrq_u32(pixel, vshlq_n_u32(vreinterpretq_u32_s32(H), 16));
+        pixel = vorrq_u32(pixel, vshlq_n_u32(vreinterpretq_u32_s32(S), 8));
+        return vorrq_u32(pixel, vreinterpretq_u32_s32(M));
+    }
+};
+
+
+
+}
+}
+#endif
@@ -0,0 +1,73 @@
+/*  Image Filters RGB32 HSV (Default)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_Default_H
+#define PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_Default_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include "Common/Compiler.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+//  This is the reference implementation. The others must match it exactly.
+PA_FORCE_INLINE uint32_t rgb32_to_hsv32_Default(uint32_t p){
+    int r = (uint32_t(0xff) & (p >> 16));
+    int g = (uint32_t(0xff) & (p >> 8));
+    int b = (uint32_t(0xff) & p);
+
+    int M = std::max(std::max(r, g), b);
+    int m = std::min(std::min(r, g), b);
+
+    int delta = M - m;
+
+    int S = 0;
+    if (M > 0){
+        S = std::min(std::max(255 - (m*255 + M/2)/M, 0), 255);
+    }
+
+    int V = M;
+
+    double Hf = 0;
+    if (delta > 0){
+        if (M == r){
+            Hf = std::fmod((g - b)/(double)delta, 6.0);
+        }else if (M == g){
+            Hf = (b - r)/(double)delta + 2.0;
+        }else{
+            Hf = (r - g)/(double)delta + 4.0;
+        }
+    }
+    // This Hf * 60.0 is the standard H value, which ranges in [0, 360).
+    // To hold it in a uint8, need to convert its range to [0, 255]
+    int H = std::max(int(Hf * 256.0 / 6.0 + 0.5) % 256, 0);
+
+    return (p & 0xff000000) |
+           ((uint32_t)(uint8_t)H << 16) |
+           ((uint32_t)(uint8_t)S << 8) |
+           (uint8_t)V;
+}
+
+
+
+struct Rgb32ToHsv32_Default{
+    static PA_FORCE_INLINE void convert_row(uint32_t* out, const uint32_t* in, size_t count){
+        for (size_t c = 0; c < count; c++){
+            out[c] = rgb32_to_hsv32_Default(in[c]);
+        }
+    }
+};
+
+
+
+}
+}
+#endif
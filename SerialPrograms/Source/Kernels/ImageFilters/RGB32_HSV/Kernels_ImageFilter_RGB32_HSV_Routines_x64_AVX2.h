@@ -0,0 +1,81 @@
+/*  Image Filters RGB32 HSV (x64 AVX2)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_x64_AVX2_H
+#define PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_x64_AVX2_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <immintrin.h>
+#include "Common/Compiler.h"
+#include "Kernels/PartialWordAccess/Kernels_PartialWordAccess_x64_AVX2.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct Rgb32ToHsv32_x64_AVX2{
+    static PA_FORCE_INLINE void convert_row(uint32_t* out, const uint32_t* in, size_t count){
+        size_t lc = count / 8;
+        while (lc--){
+            __m256i pixel = _mm256_loadu_si256((const __m256i*)in);
+            _mm256_storeu_si256((__m256i*)out, convert(pixel));
+            in += 8;
+            out += 8;
+        }
+        count %= 8;
+        if (count){
+            PartialWordAccess32_x64_AVX2 loader(count);
+            __m256i pixel = loader.load_i32(in);
+            loader.store(out, convert(pixel));
+        }
+    }
+
+    //  See the SSE4.2 version for how this works.
+    static PA_FORCE_INLINE __m256i convert(__m256i pixel){
+        const __m256i zero = _mm256_setzero_si256();
+
+        __m256i r = _mm256_and_si256(_mm256_srli_epi32(pixel, 16), _mm256_set1_epi32(0xff));
+        __m256i g = _mm256_and_si256(_mm256_srli_epi32(pixel, 8), _mm256_set1_epi32(0xff));
+        __m256i b = _mm256_and_si256(pixel, _mm256_set1_epi32(0xff));
+
+        __m256i M = _mm256_max_epi32(_mm256_max_epi32(r, g), b);
+        __m256i m = _mm256_min_epi32(_mm256_min_epi32(r, g), b);
+        __m256i delta = _mm256_sub_epi32(M, m);
+
+        __m256i S = _mm256_sub_epi32(_mm256_slli_epi32(m, 8), m);
+        S = _mm256_add_epi32(S, _mm256_srli_epi32(M, 1));
+        S = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(S), _mm256_cvtepi32_ps(M)));
+        S = _mm256_sub_epi32(_mm256_set1_epi32(255), S);
+        S = _mm256_andnot_si256(_mm256_cmpeq_epi32(M, zero), S);
+
+        __m256i is_r = _mm256_cmpeq_epi32(M, r);
+        __m256i is_g = _mm256_cmpeq_epi32(M, g);
+        __m256i num = _mm256_sub_epi32(r, g);
+        __m256i off = _mm256_set1_epi32(4*256 + 3);
+        num = _mm256_blendv_epi8(num, _mm256_sub_epi32(b, r), is_g);
+        off = _mm256_blendv_epi8(off, _mm256_set1_epi32(2*256 + 3), is_g);
+        num = _mm256_blendv_epi8(num, _mm256_sub_epi32(g, b), is_r);
+        off = _mm256_blendv_epi8(off, _mm256_set1_epi32(3), is_r);
+
+        __m256i H = _mm256_add_epi32(_mm256_slli_epi32(num, 8), _mm256_mullo_epi32(off, delta));
+        __m256 D = _mm256_mul_ps(_mm256_cvtepi32_ps(delta), _mm256_set1_ps(6));
+        H = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(H), D));
+        H = _mm256_max_epi32(H, zero);
+
+        pixel = _mm256_and_si256(pixel, _mm256_set1_epi32(0xff000000));
+        pixel = _mm256_or_si256(pixel, _mm256_slli_epi32(H, 16));
+        pixel = _mm256_or_si256(pixel, _mm256_slli_epi32(S, 8));
+        return _mm256_or_si256(pixel, M);
+    }
+};
+
+
+
+}
+}
+#endif
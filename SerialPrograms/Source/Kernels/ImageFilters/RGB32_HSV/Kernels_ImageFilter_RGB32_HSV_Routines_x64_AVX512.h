@@ -0,0 +1,80 @@
+/*  Image Filters RGB32 HSV (x64 AVX512)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_x64_AVX512_H
+#define PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_x64_AVX512_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <immintrin.h>
+#include "Common/Compiler.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct Rgb32ToHsv32_x64_AVX512{
+    static PA_FORCE_INLINE void convert_row(uint32_t* out, const uint32_t* in, size_t count){
+        size_t lc = count / 16;
+        while (lc--){
+            __m512i pixel = _mm512_loadu_si512((const __m512i*)in);
+            _mm512_storeu_si512((__m512i*)out, convert(pixel));
+            in += 16;
+            out += 16;
+        }
+        count %= 16;
+        if (count){
+            __mmask16 mask = ((__mmask16)1 << count) - 1;
+            __m512i pixel = _mm512_maskz_loadu_epi32(mask, in);
+            _mm512_mask_storeu_epi32(out, mask, convert(pixel));
+        }
+    }
+
+    //  See the SSE4.2 version for how this works.
+    static PA_FORCE_INLINE __m512i convert(__m512i pixel){
+        const __m512i zero = _mm512_setzero_si512();
+
+        __m512i r = _mm512_and_si512(_mm512_srli_epi32(pixel, 16), _mm512_set1_epi32(0xff));
+        __m512i g = _mm512_and_si512(_mm512_srli_epi32(pixel, 8), _mm512_set1_epi32(0xff));
+        __m512i b = _mm512_and_si512(pixel, _mm512_set1_epi32(0xff));
+
+        __m512i M = _mm512_max_epi32(_mm512_max_epi32(r, g), b);
+        __m512i m = _mm512_min_epi32(_mm512_min_epi32(r, g), b);
+        __m512i delta = _mm512_sub_epi32(M, m);
+
+        __mmask16 nonzero = _mm512_test_epi32_mask(M, M);
+        __m512i S = _mm512_sub_epi32(_mm512_slli_epi32(m, 8), m);
+        S = _mm512_add_epi32(S, _mm512_srli_epi32(M, 1));
+        S = _mm512_cvttps_epi32(_mm512_div_ps(_mm512_cvtepi32_ps(S), _mm512_cvtepi32_ps(M)));
+        S = _mm512_maskz_sub_epi32(nonzero, _mm512_set1_epi32(255), S);
+
+        __mmask16 is_r = _mm512_cmpeq_epi32_mask(M, r);
+        __mmask16 is_g = _mm512_cmpeq_epi32_mask(M, g);
+        __m512i num = _mm512_sub_epi32(r, g);
+        __m512i off = _mm512_set1_epi32(4*256 + 3);
+        num = _mm512_mask_sub_epi32(num, is_g, b, r);
+        off = _mm512_mask_mov_epi32(off, is_g, _mm512_set1_epi32(2*256 + 3));
+        num = _mm512_mask_sub_epi32(num, is_r, g, b);
+        off = _mm512_mask_mov_epi32(off, is_r, _mm512_set1_epi32(3));
+
+        __m512i H = _mm512_add_epi32(_mm512_slli_epi32(num, 8), _mm512_mullo_epi32(off, delta));
+        __m512 D = _mm512_mul_ps(_mm512_cvtepi32_ps(delta), _mm512_set1_ps(6));
+        H = _mm512_cvttps_epi32(_mm512_div_ps(_mm512_cvtepi32_ps(H), D));
+        H = _mm512_max_epi32(H, zero);
+
+        pixel = _mm512_and_si512(pixel, _mm512_set1_epi32(0xff000000));
+        pixel = _mm512_or_si512(pixel, _mm512_slli_epi32(H, 16));
+        pixel = _mm512_or_si512(pixel, _mm512_slli_epi32(S, 8));
+        return _mm512_or_si512(pixel, M);
+    }
+};
+
+
+
+}
+}
+#endif
@@ -0,0 +1,89 @@
+/*  Image Filters RGB32 HSV (x64 SSE4.2)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_x64_SSE42_H
+#define PokemonAutomation_Kernels_ImageFilter_RGB32_HSV_Routines_x64_SSE42_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <immintrin.h>
+#include "Common/Compiler.h"
+#include "Kernels/PartialWordAccess/Kernels_PartialWordAccess_x64_SSE41.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+
+struct Rgb32ToHsv32_x64_SSE42{
+    static PA_FORCE_INLINE void convert_row(uint32_t* out, const uint32_t* in, size_t count){
+        size_t lc = count / 4;
+        while (lc--){
+            __m128i pixel = _mm_loadu_si128((const __m128i*)in);
+            _mm_storeu_si128((__m128i*)out, convert(pixel));
+            in += 4;
+            out += 4;
+        }
+        count %= 4;
+        if (count){
+            PartialWordAccess_x64_SSE41 loader(count * sizeof(uint32_t));
+            __m128i pixel = convert(loader.load(in));
+            do{
+                out[0] = _mm_cvtsi128_si32(pixel);
+                pixel = _mm_srli_si128(pixel, 4);
+                out++;
+            }while (--count);
+        }
+    }
+
+    static PA_FORCE_INLINE __m128i convert(__m128i pixel){
+        const __m128i zero = _mm_setzero_si128();
+
+        __m128i r = _mm_and_si128(_mm_srli_epi32(pixel, 16), _mm_set1_epi32(0xff));
+        __m128i g = _mm_and_si128(_mm_srli_epi32(pixel, 8), _mm_set1_epi32(0xff));
+        __m128i b = _mm_and_si128(pixel, _mm_set1_epi32(0xff));
+
+        __m128i M = _mm_max_epi32(_mm_max_epi32(r, g), b);
+        __m128i m = _mm_min_epi32(_mm_min_epi32(r, g), b);
+        __m128i delta = _mm_sub_epi32(M, m);
+
+        //  S = 255 - (m*255 + M/2) / M
+        //  M == 0 divides by zero. That lane is masked off below.
+        __m128i S = _mm_sub_epi32(_mm_slli_epi32(m, 8), m);
+        S = _mm_add_epi32(S, _mm_srli_epi32(M, 1));
+        S = _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(S), _mm_cvtepi32_ps(M)));
+        S = _mm_sub_epi32(_mm_set1_epi32(255), S);
+        S = _mm_andnot_si128(_mm_cmpeq_epi32(M, zero), S);
+
+        //  H = (256*num + (256*sector + 3)*delta) / (6*delta)
+        //  delta == 0 divides zero by zero. The NaN converts to INT_MIN and
+        //  the clamp below turns it into 0.
+        __m128i is_r = _mm_cmpeq_epi32(M, r);
+        __m128i is_g = _mm_cmpeq_epi32(M, g);
+        __m128i num = _mm_sub_epi32(r, g);
+        __m128i off = _mm_set1_epi32(4*256 + 3);
+        num = _mm_blendv_epi8(num, _mm_sub_epi32(b, r), is_g);
+        off = _mm_blendv_epi8(off, _mm_set1_epi32(2*256 + 3), is_g);
+        num = _mm_blendv_epi8(num, _mm_sub_epi32(g, b), is_r);
+        off = _mm_blendv_epi8(off, _mm_set1_epi32(3), is_r);
+
+        __m128i H = _mm_add_epi32(_mm_slli_epi32(num, 8), _mm_mullo_epi32(off, delta));
+        __m128 D = _mm_mul_ps(_mm_cvtepi32_ps(delta), _mm_set1_ps(6));
+        H = _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(H), D));
+        H = _mm_max_epi32(H, zero);
+
+        pixel = _mm_and_si128(pixel, _mm_set1_epi32(0xff000000));
+        pixel = _mm_or_si128(pixel, _mm_slli_epi32(H, 16));
+        pixel = _mm_or_si128(pixel, _mm_slli_epi32(S, 8));
+        return _mm_or_si128(pixel, M);
+    }
+};
+
+
+
+}
+}
+#endif
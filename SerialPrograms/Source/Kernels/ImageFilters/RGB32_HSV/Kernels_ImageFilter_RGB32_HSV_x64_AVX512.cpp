@@ -0,0 +1,30 @@
+/*  Image Filters RGB32 HSV (x64 AVX512)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_17_Skylake
+
+#include "Kernels_ImageFilter_RGB32_HSV_Routines.h"
+#include "Kernels_ImageFilter_RGB32_HSV_Routines_x64_AVX512.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+void convert_rgb32_to_hsv32_x64_AVX512(
+    const uint32_t* in, size_t in_bytes_per_row, size_t width, size_t height,
+    uint32_t* out, size_t out_bytes_per_row
+){
+    convert_rgb32_to_hsv32<Rgb32ToHsv32_x64_AVX512>(
+        in, in_bytes_per_row, width, height,
+        out, out_bytes_per_row
+    );
+}
+
+
+
+}
+}
+#endif
@@ -339,6 +339,63 @@ void to_blackwhite_rgb32_range(
 
 
 
+void to_blackwhite_gray8_rgb32_range_Default(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+);
+void to_blackwhite_gray8_rgb32_range_x64_SSE42(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+);
+void to_blackwhite_gray8_rgb32_range_x64_AVX2(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+);
+void to_blackwhite_gray8_rgb32_range_x64_AVX512(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+);
+void to_blackwhite_gray8_rgb32_range_arm64_NEON(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+);
+void to_blackwhite_gray8_rgb32_range(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+){
+    if (width * height > 0xffffffff){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Image is too large. more than 2^32 pixels.");
+    }
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        to_blackwhite_gray8_rgb32_range_x64_AVX512(image, bytes_per_row, width, height, filters, filter_count);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        to_blackwhite_gray8_rgb32_range_x64_AVX2(image, bytes_per_row, width, height, filters, filter_count);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        to_blackwhite_gray8_rgb32_range_x64_SSE42(image, bytes_per_row, width, height, filters, filter_count);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_arm64_20_M1
+    if (CPU_CAPABILITY_CURRENT.OK_M1){
+        to_blackwhite_gray8_rgb32_range_arm64_NEON(image, bytes_per_row, width, height, filters, filter_count);
+        return;
+    }
+#endif
+    to_blackwhite_gray8_rgb32_range_Default(image, bytes_per_row, width, height, filters, filter_count);
+}
+
+
+
+
 
 
 
@@ -104,6 +104,29 @@ void to_blackwhite_rgb32_range(
 
 
 
+//  Black and white filtering into 8-bit grayscale planes. In-range pixels are
+//  255 (or 0 if "in_range_black"), the rest are the opposite.
+//
+//  All filters are run in a single pass over the image. Filters with a null
+//  "data" pointer only count the in-range pixels. So this can be used to
+//  check the text ratio of every filter before allocating any output.
+struct ToBlackWhiteGray8RangeFilter{
+    uint8_t* data;
+    size_t bytes_per_row;
+    uint32_t mins;
+    uint32_t maxs;
+    bool in_range_black;
+
+    size_t pixels_in_range;
+};
+void to_blackwhite_gray8_rgb32_range(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+);
+
+
+
+
 
 }
 }
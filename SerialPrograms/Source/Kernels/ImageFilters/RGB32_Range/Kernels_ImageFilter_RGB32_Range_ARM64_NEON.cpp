@@ -58,6 +58,13 @@ public:
         return vceqq_u32(vreinterpretq_u32_u8(cmp_u8), vreinterpretq_u32_u8(m_zeros_u8));
     }
 
+    PA_FORCE_INLINE uint32_t test_bits(const uint32_t* in) const{
+        static const uint32_t LANE_BITS[4] = {1, 2, 4, 8};
+        uint32x4_t pixel = vld1q_u32(in);
+        uint32x4_t mask = test_word(pixel);
+        return vaddvq_u32(vandq_u32(mask, vld1q_u32(LANE_BITS)));
+    }
+
 private:
     uint8x16_t m_mins_u8;
     uint8x16_t m_maxs_u8;
@@ -95,6 +102,12 @@ size_t to_blackwhite_rgb32_range_arm64_NEON(
     filter_per_pixel(in, in_bytes_per_row, width, height, filter, out, out_bytes_per_row);
     return filter.count();
 }
+void to_blackwhite_gray8_rgb32_range_arm64_NEON(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+){
+    to_blackwhite_gray8_per_pixel<PixelTest_Rgb32Range_ARM64_NEON>(image, bytes_per_row, width, height, filters, filter_count);
+}
 
 
 
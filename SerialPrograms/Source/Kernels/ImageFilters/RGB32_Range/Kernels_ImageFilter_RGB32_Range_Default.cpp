@@ -6,7 +6,7 @@
 
 #include "Kernels/ImageFilters/Kernels_ImageFilter_Basic_Routines.h"
 #include "Kernels/ImageFilters/Kernels_ImageFilter_Basic_Routines_Default.h"
-#include "Kernels_ImageFilter_RGB32_Range.h"
+#include "Kernels_ImageFilter_RGB32_Range_Routines.h"
 
 //#include <iostream>
 //using std::cout;
@@ -58,6 +58,10 @@ public:
         return ret;
     }
 
+    PA_FORCE_INLINE uint32_t test_bits(const uint32_t* in) const{
+        return test_word(in[0]);
+    }
+
 private:
     const uint32_t m_shiftB;
     const uint32_t m_shiftG;
@@ -101,6 +105,12 @@ size_t to_blackwhite_rgb32_range_Default(
     filter_per_pixel(image, in_bytes_per_row, width, height, filter, out, out_bytes_per_row);
     return filter.count();
 }
+void to_blackwhite_gray8_rgb32_range_Default(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+){
+    to_blackwhite_gray8_per_pixel<PixelTest_Rgb32Range_Default>(image, bytes_per_row, width, height, filters, filter_count);
+}
 
 
 
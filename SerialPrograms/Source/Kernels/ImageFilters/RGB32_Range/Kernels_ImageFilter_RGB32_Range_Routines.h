@@ -7,6 +7,8 @@
 #ifndef PokemonAutomation_Kernels_ImageFilter_RGB32_Range_Routines_H
 #define PokemonAutomation_Kernels_ImageFilter_RGB32_Range_Routines_H
 
+#include <bitset>
+#include <string.h>
 #include "Common/Compiler.h"
 #include "Common/Cpp/Containers/FixedLimitVector.tpp"
 #include "Kernels_ImageFilter_RGB32_Range.h"
@@ -110,6 +112,88 @@ PA_FORCE_INLINE void filter_per_pixel(
 
 
 
+PA_FORCE_INLINE bool rgb32_in_range(uint32_t pixel, uint32_t mins, uint32_t maxs){
+    for (size_t c = 0; c < 32; c += 8){
+        uint32_t x = (pixel >> c) & 0xff;
+        if (x < ((mins >> c) & 0xff) || x > ((maxs >> c) & 0xff)){
+            return false;
+        }
+    }
+    return true;
+}
+
+//  Write one byte per bit of "bits": 0xff if set, 0 if not.
+PA_FORCE_INLINE void store_bits_as_bytes(uint8_t* out, uint32_t bits, size_t count){
+    for (size_t c = 0; c < count; c += 8){
+        uint64_t x = (bits >> c) & 0xff;
+        x = (x | (x << 28)) & 0x0000000f0000000full;
+        x = (x | (x << 14)) & 0x0003000300030003ull;
+        x = (x | (x <<  7)) & 0x0101010101010101ull;
+        x *= 0xff;
+        memcpy(out + c, &x, count - c < 8 ? count - c : 8);
+    }
+}
+
+
+// PixelTester interface:
+// - static size_t PixelTester::VECTOR_SIZE, how many pixels are tested at once. At most 32.
+// - PixelTester(uint32_t mins, uint32_t maxs)
+// - uint32_t PixelTester::test_bits(const uint32_t* in), return a bitmask of which
+//   of the VECTOR_SIZE pixels starting at "in" are in range.
+//
+// Each row of the image is loaded once and then run through all the filters
+// while it is still in cache.
+template <typename PixelTester>
+PA_FORCE_INLINE void to_blackwhite_gray8_per_pixel(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+){
+    FixedLimitVector<PixelTester> testers(filter_count);
+    for (size_t c = 0; c < filter_count; c++){
+        testers.emplace_back(filters[c].mins, filters[c].maxs);
+        filters[c].pixels_in_range = 0;
+    }
+
+    const size_t VECTOR_SIZE = PixelTester::VECTOR_SIZE;
+    const size_t vector_end = width - width % VECTOR_SIZE;
+    const uint32_t VECTOR_BITS = (uint32_t)(((uint64_t)1 << VECTOR_SIZE) - 1);
+
+    for (size_t r = 0; r < height; r++){
+        const uint32_t* in = (const uint32_t*)((const char*)image + r * bytes_per_row);
+        for (size_t c = 0; c < filter_count; c++){
+            ToBlackWhiteGray8RangeFilter& filter = filters[c];
+            const PixelTester& tester = testers[c];
+            size_t count = 0;
+            size_t x = 0;
+            if (filter.data == nullptr){
+                for (; x < vector_end; x += VECTOR_SIZE){
+                    count += std::bitset<32>(tester.test_bits(in + x)).count();
+                }
+                for (; x < width; x++){
+                    count += rgb32_in_range(in[x], filter.mins, filter.maxs);
+                }
+            }else{
+                uint8_t* out = filter.data + r * filter.bytes_per_row;
+                uint32_t invert = filter.in_range_black ? VECTOR_BITS : 0;
+                for (; x < vector_end; x += VECTOR_SIZE){
+                    uint32_t bits = tester.test_bits(in + x);
+                    count += std::bitset<32>(bits).count();
+                    store_bits_as_bytes(out + x, bits ^ invert, VECTOR_SIZE);
+                }
+                for (; x < width; x++){
+                    bool in_range = rgb32_in_range(in[x], filter.mins, filter.maxs);
+                    count += in_range;
+                    out[x] = in_range != filter.in_range_black ? 0xff : 0x00;
+                }
+            }
+            filter.pixels_in_range += count;
+        }
+    }
+}
+
+
+
+
 }
 }
 #endif
@@ -11,7 +11,7 @@
 #include "Kernels/PartialWordAccess/Kernels_PartialWordAccess_x64_AVX2.h"
 #include "Kernels/ImageFilters/Kernels_ImageFilter_Basic_Routines.h"
 #include "Kernels/ImageFilters/Kernels_ImageFilter_Basic_Routines_x64_AVX2.h"
-#include "Kernels_ImageFilter_RGB32_Range.h"
+#include "Kernels_ImageFilter_RGB32_Range_Routines.h"
 
 //#include <iostream>
 //using std::cout;
@@ -52,6 +52,11 @@ public:
         return _mm256_cmpeq_epi32(cmp0, _mm256_setzero_si256());
     }
 
+    PA_FORCE_INLINE uint32_t test_bits(const uint32_t* in) const{
+        __m256i mask = test_word(_mm256_loadu_si256((const __m256i*)in));
+        return (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(mask));
+    }
+
 private:
     const __m256i m_mins;
     const __m256i m_maxs;
@@ -90,6 +95,12 @@ size_t to_blackwhite_rgb32_range_x64_AVX2(
     filter_per_pixel(in, in_bytes_per_row, width, height, filter, out, out_bytes_per_row);
     return filter.count();
 }
+void to_blackwhite_gray8_rgb32_range_x64_AVX2(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+){
+    to_blackwhite_gray8_per_pixel<PixelTest_Rgb32Range_x64_AVX2>(image, bytes_per_row, width, height, filters, filter_count);
+}
 
 
 
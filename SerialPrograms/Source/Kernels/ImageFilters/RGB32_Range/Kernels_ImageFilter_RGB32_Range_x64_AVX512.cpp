@@ -9,7 +9,7 @@
 #include <immintrin.h>
 #include "Kernels/ImageFilters/Kernels_ImageFilter_Basic_Routines.h"
 #include "Kernels/ImageFilters/Kernels_ImageFilter_Basic_Routines_x64_AVX512.h"
-#include "Kernels_ImageFilter_RGB32_Range.h"
+#include "Kernels_ImageFilter_RGB32_Range_Routines.h"
 
 //#include <iostream>
 //using std::cout;
@@ -49,6 +49,10 @@ public:
         return _mm512_cmpeq_epi32_mask(mask, _mm512_set1_epi32(-1));
     }
 
+    PA_FORCE_INLINE uint32_t test_bits(const uint32_t* in) const{
+        return test_word(_mm512_loadu_si512(in));
+    }
+
 private:
     const __m512i m_shift;
     const __m512i m_threshold;
@@ -85,6 +89,12 @@ size_t to_blackwhite_rgb32_range_x64_AVX512(
     filter_per_pixel(in, in_bytes_per_row, width, height, filter, out, out_bytes_per_row);
     return filter.count();
 }
+void to_blackwhite_gray8_rgb32_range_x64_AVX512(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+){
+    to_blackwhite_gray8_per_pixel<PixelTest_Rgb32Range_x64_AVX512>(image, bytes_per_row, width, height, filters, filter_count);
+}
 
 
 
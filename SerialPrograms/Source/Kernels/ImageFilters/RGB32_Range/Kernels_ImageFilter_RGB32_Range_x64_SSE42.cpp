@@ -11,7 +11,7 @@
 #include "Kernels/PartialWordAccess/Kernels_PartialWordAccess_x64_SSE41.h"
 #include "Kernels/ImageFilters/Kernels_ImageFilter_Basic_Routines.h"
 #include "Kernels/ImageFilters/Kernels_ImageFilter_Basic_Routines_x64_SSE42.h"
-#include "Kernels_ImageFilter_RGB32_Range.h"
+#include "Kernels_ImageFilter_RGB32_Range_Routines.h"
 
 //#include <iostream>
 //using std::cout;
@@ -52,6 +52,11 @@ public:
         return _mm_cmpeq_epi32(cmp0, _mm_setzero_si128());
     }
 
+    PA_FORCE_INLINE uint32_t test_bits(const uint32_t* in) const{
+        __m128i mask = test_word(_mm_loadu_si128((const __m128i*)in));
+        return (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(mask));
+    }
+
 private:
     const __m128i m_mins;
     const __m128i m_maxs;
@@ -90,6 +95,12 @@ size_t to_blackwhite_rgb32_range_x64_SSE42(
     filter_per_pixel(in, in_bytes_per_row, width, height, filter, out, out_bytes_per_row);
     return filter.count();
 }
+void to_blackwhite_gray8_rgb32_range_x64_SSE42(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteGray8RangeFilter* filters, size_t filter_count
+){
+    to_blackwhite_gray8_per_pixel<PixelTest_Rgb32Range_x64_SSE42>(image, bytes_per_row, width, height, filters, filter_count);
+}
 
 
 
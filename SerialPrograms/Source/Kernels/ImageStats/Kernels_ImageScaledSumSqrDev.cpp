@@ -0,0 +1,290 @@
+/*  Scaled Sum of Squares of Deviation
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include <algorithm>
+#include "Common/Cpp/CpuId/CpuId.h"
+#include "Kernels_ImageScaledSumSqrDev.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+void scaled_pixel_sum_Default(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+void scaled_pixel_sum_x64_SSE41(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+void scaled_pixel_sum_x64_AVX2(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+void scaled_pixel_sum_x64_AVX512(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation_Default(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation_x64_SSE41(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation_x64_AVX2(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation_x64_AVX512(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+
+
+
+void scaled_pixel_sum(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+){
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        scaled_pixel_sum_x64_AVX512(
+            sums,
+            width, height,
+            ref, ref_bytes_per_line,
+            img_width, img_height,
+            img, img_bytes_per_line
+        );
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        scaled_pixel_sum_x64_AVX2(
+            sums,
+            width, height,
+            ref, ref_bytes_per_line,
+            img_width, img_height,
+            img, img_bytes_per_line
+        );
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        scaled_pixel_sum_x64_SSE41(
+            sums,
+            width, height,
+            ref, ref_bytes_per_line,
+            img_width, img_height,
+            img, img_bytes_per_line
+        );
+        return;
+    }
+#endif
+    scaled_pixel_sum_Default(
+        sums,
+        width, height,
+        ref, ref_bytes_per_line,
+        img_width, img_height,
+        img, img_bytes_per_line
+    );
+}
+
+
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+){
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        scaled_sum_sqr_deviation_x64_AVX512<mode>(
+            sumsqrs,
+            width, height,
+            ref, ref_bytes_per_line,
+            img_width, img_height,
+            img, img_bytes_per_line,
+            scaleR, scaleG, scaleB,
+            background,
+            row_start, row_step
+        );
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        scaled_sum_sqr_deviation_x64_AVX2<mode>(
+            sumsqrs,
+            width, height,
+            ref, ref_bytes_per_line,
+            img_width, img_height,
+            img, img_bytes_per_line,
+            scaleR, scaleG, scaleB,
+            background,
+            row_start, row_step
+        );
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        scaled_sum_sqr_deviation_x64_SSE41<mode>(
+            sumsqrs,
+            width, height,
+            ref, ref_bytes_per_line,
+            img_width, img_height,
+            img, img_bytes_per_line,
+            scaleR, scaleG, scaleB,
+            background,
+            row_start, row_step
+        );
+        return;
+    }
+#endif
+    scaled_sum_sqr_deviation_Default<mode>(
+        sumsqrs,
+        width, height,
+        ref, ref_bytes_per_line,
+        img_width, img_height,
+        img, img_bytes_per_line,
+        scaleR, scaleG, scaleB,
+        background,
+        row_start, row_step
+    );
+}
+
+
+void scaled_sum_sqr_deviation(
+    uint64_t& sumsqrs, SumSquareMode mode,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+){
+    //  Same as "scale_brightness()".
+    scaleR = std::max(scaleR, 0.0f);
+    scaleG = std::max(scaleG, 0.0f);
+    scaleB = std::max(scaleB, 0.0f);
+    switch (mode){
+    case SumSquareMode::REFERENCE_ALPHA:
+        scaled_sum_sqr_deviation<SumSquareMode::REFERENCE_ALPHA>(
+            sumsqrs,
+            width, height,
+            ref, ref_bytes_per_line,
+            img_width, img_height,
+            img, img_bytes_per_line,
+            scaleR, scaleG, scaleB,
+            background,
+            row_start, row_step
+        );
+        return;
+    case SumSquareMode::USE_BACKGROUND:
+        scaled_sum_sqr_deviation<SumSquareMode::USE_BACKGROUND>(
+            sumsqrs,
+            width, height,
+            ref, ref_bytes_per_line,
+            img_width, img_height,
+            img, img_bytes_per_line,
+            scaleR, scaleG, scaleB,
+            background,
+            row_start, row_step
+        );
+        return;
+    case SumSquareMode::ARBITRATE_ALPHAS:
+        scaled_sum_sqr_deviation<SumSquareMode::ARBITRATE_ALPHAS>(
+            sumsqrs,
+            width, height,
+            ref, ref_bytes_per_line,
+            img_width, img_height,
+            img, img_bytes_per_line,
+            scaleR, scaleG, scaleB,
+            background,
+            row_start, row_step
+        );
+        return;
+    }
+}
+void scaled_sum_sqr_deviation(
+    uint64_t& sumsqrs, SumSquareMode mode,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background
+){
+    scaled_sum_sqr_deviation(
+        sumsqrs, mode,
+        width, height,
+        ref, ref_bytes_per_line,
+        img_width, img_height,
+        img, img_bytes_per_line,
+        scaleR, scaleG, scaleB,
+        background,
+        0, 1
+    );
+}
+
+
+
+}
+}
@@ -0,0 +1,91 @@
+/*  Scaled Sum of Squares of Deviation
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Compare an image against a brightness-scaled template of a different
+ *  size without materializing the resized image or the scaled template.
+ *
+ *  The result is exactly the same as resizing the image with "QImage::scaled()",
+ *  scaling the template with "scale_brightness()" and then running
+ *  "sum_sqr_deviation()" on the two. It takes two passes:
+ *
+ *    1. "scaled_pixel_sum()" sums the resized image over the opaque pixels of
+ *       the template. The caller picks the brightness scale from this.
+ *    2. "scaled_sum_sqr_deviation()" sums the squared deviation from the scaled
+ *       template. This pass can be split into interleaved sets of rows so that
+ *       the caller can give up early.
+ *
+ *  Pixels of the image that are not fully opaque are read as they are. Qt would
+ *  round-trip them through premultiplied alpha when resizing.
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageScaledSumSqrDeviation_H
+#define PokemonAutomation_Kernels_ImageScaledSumSqrDeviation_H
+
+#include <stdint.h>
+#include <cstddef>
+#include "Kernels_ImagePixelSumSqrDev.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+struct ScaledPixelSums{
+    //  # of pixels in "ref" with alpha >= 128.
+    uint64_t count = 0;
+
+    //  Sum of "img" over those pixels. 0 = blue, 1 = green, 2 = red.
+    uint64_t sum[3] = {};
+};
+
+
+//
+//  Sum "img" (img_width x img_height) resampled to the dimensions of "ref"
+//  (width x height) over the opaque pixels of "ref".
+//
+void scaled_pixel_sum(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+
+
+//
+//  Add the sum of squares of deviation between "ref" with its brightness scaled
+//  by (scaleR, scaleG, scaleB) and "img" resampled to the dimensions of "ref".
+//  "background" is only used for USE_BACKGROUND.
+//
+void scaled_sum_sqr_deviation(
+    uint64_t& sumsqrs, SumSquareMode mode,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background = 0
+);
+
+
+//
+//  Same as above, but only add rows "row_start", "row_start + row_step",
+//  "row_start + 2*row_step", etc... Running this for every "row_start" in
+//  [0, row_step) gives exactly the same sum as a single full pass.
+//
+void scaled_sum_sqr_deviation(
+    uint64_t& sumsqrs, SumSquareMode mode,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+
+
+}
+}
+#endif
@@ -0,0 +1,141 @@
+/*  Scaled Sum of Squares of Deviation (Default)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "Kernels_ImageScaledSumSqrDev_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+struct ScaledPixelSum_Default{
+    static const size_t VECTOR_SIZE = 1;
+
+    ScaledPixelSum_Default(ScaledPixelSums& sums)
+        : m_sums(sums)
+    {}
+
+    PA_FORCE_INLINE void process_full(const uint32_t* ref, const uint32_t* img_row, const uint32_t* index){
+        process_pixel(ref[0], img_row[index[0]]);
+    }
+    PA_FORCE_INLINE void process_pixel(uint32_t r, uint32_t i){
+        scaled_pixel_sum_pixel(m_sums, r, i);
+    }
+    PA_FORCE_INLINE void flush(){}
+
+private:
+    ScaledPixelSums& m_sums;
+};
+
+template <SumSquareMode mode>
+struct ScaledSumSqrDev_Default{
+    static const size_t VECTOR_SIZE = 1;
+
+    ScaledSumSqrDev_Default(
+        uint64_t& sumsqrs,
+        float scaleR, float scaleG, float scaleB,
+        uint32_t background
+    )
+        : m_sumsqrs(sumsqrs)
+        , m_scale{scaleB, scaleG, scaleR}
+        , m_background(background)
+    {}
+
+    PA_FORCE_INLINE void process_full(const uint32_t* ref, const uint32_t* img_row, const uint32_t* index){
+        process_pixel(ref[0], img_row[index[0]]);
+    }
+    PA_FORCE_INLINE void process_pixel(uint32_t r, uint32_t i){
+        m_sumsqrs += scaled_sum_sqr_deviation_pixel<mode, false>(r, i, m_scale, m_background);
+    }
+    PA_FORCE_INLINE void flush(){}
+
+private:
+    uint64_t& m_sumsqrs;
+    const float m_scale[3];
+    const uint32_t m_background;
+};
+
+
+
+void scaled_pixel_sum_Default(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+){
+    ScaledPixelSum_Default runner(sums);
+    scaled_image_runner(
+        runner,
+        width, height,
+        ref, ref_bytes_per_line,
+        img_width, img_height,
+        img, img_bytes_per_line,
+        0, 1
+    );
+}
+
+
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation_Default(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+){
+    ScaledSumSqrDev_Default<mode> runner(sumsqrs, scaleR, scaleG, scaleB, background);
+    scaled_image_runner(
+        runner,
+        width, height,
+        ref, ref_bytes_per_line,
+        img_width, img_height,
+        img, img_bytes_per_line,
+        row_start, row_step
+    );
+}
+
+
+template
+void scaled_sum_sqr_deviation_Default<SumSquareMode::REFERENCE_ALPHA>(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+template
+void scaled_sum_sqr_deviation_Default<SumSquareMode::USE_BACKGROUND>(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+template
+void scaled_sum_sqr_deviation_Default<SumSquareMode::ARBITRATE_ALPHAS>(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+
+
+
+}
+}
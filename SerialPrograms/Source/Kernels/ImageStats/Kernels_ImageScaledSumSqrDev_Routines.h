@@ -0,0 +1,223 @@
+/*  Scaled Sum of Squares of Deviation Routines
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageScaledSumSqrDeviation_Routines_H
+#define PokemonAutomation_Kernels_ImageScaledSumSqrDeviation_Routines_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cmath>
+#include <algorithm>
+#include "Common/Compiler.h"
+#include "Kernels_ImageScaledSumSqrDev.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+//
+//  Nearest-neighbor sampling that picks the same source pixels as "QImage::scaled()".
+//
+//  Qt's raster engine nudges the transform by 1/65536 of a destination pixel,
+//  maps each destination pixel center back through the inverse and rounds down.
+//  If neither axis is scaled by more than 256x or less than 1/100x, it steps
+//  along a row in 16.16 fixed point. Otherwise it steps in double. Either way,
+//  it starts over from the exact position every 2048 pixels.
+//
+class QtNearestSampler{
+public:
+    QtNearestSampler(size_t width, size_t height, size_t img_width, size_t img_height)
+        : m_img_width(img_width)
+        , m_img_height(img_height)
+    {
+        double sx = (double)width / (double)img_width;
+        double sy = (double)height / (double)img_height;
+        m_m11 = 1 / sx;
+        m_m22 = 1 / sy;
+        m_dx = -(sx / 65536) / sx;
+        m_dy = -(sy / 65536) / sy;
+
+        double f1 = m_m11 * m_m11;
+        double f2 = m_m22 * m_m22;
+        m_fixed_point = f1 < 1e4 && f2 < 1e4 && f1 > 1. / 65536 && f2 > 1. / 65536;
+        m_fdx = (int64_t)(m_m11 * 65536);
+    }
+
+    //  The image row for template row "y".
+    size_t row(size_t y) const{
+        double fy = m_m22 * ((double)y + 0.5) + m_dy;
+        int64_t py = m_fixed_point
+            ? (int64_t)(fy * 65536) >> 16
+            : (int64_t)std::floor(fy);
+        return clamp(py, m_img_height);
+    }
+
+    //  The image columns for the next "count" template columns.
+    void next_columns(uint32_t* index, size_t count){
+        for (size_t c = 0; c < count; c++, m_x++){
+            if (m_x % 2048 == 0){
+                m_fx = m_m11 * ((double)m_x + 0.5) + m_dx;
+                m_fx_fixed = (int64_t)(m_fx * 65536);
+            }
+            int64_t px;
+            if (m_fixed_point){
+                px = m_fx_fixed >> 16;
+                m_fx_fixed += m_fdx;
+            }else{
+                px = (int64_t)std::floor(m_fx);
+                m_fx += m_m11;
+            }
+            index[c] = (uint32_t)clamp(px, m_img_width);
+        }
+    }
+
+private:
+    static size_t clamp(int64_t x, size_t size){
+        return x < 0 ? 0 : std::min((size_t)x, size - 1);
+    }
+
+private:
+    size_t m_img_width;
+    size_t m_img_height;
+    double m_m11;
+    double m_m22;
+    double m_dx;
+    double m_dy;
+    bool m_fixed_point;
+    int64_t m_fdx;
+
+    size_t m_x = 0;
+    double m_fx = 0;
+    int64_t m_fx_fixed = 0;
+};
+
+
+
+PA_FORCE_INLINE void scaled_pixel_sum_pixel(ScaledPixelSums& sums, uint32_t r, uint32_t i){
+    if ((int32_t)r >= 0){
+        return;
+    }
+    sums.count++;
+    for (size_t ch = 0; ch < 3; ch++){
+        sums.sum[ch] += (i >> (8 * ch)) & 0xff;
+    }
+}
+
+
+//  Scale one channel of the template the same way "scale_brightness()" does on
+//  the same instruction set. The x64 SIMD kernels clamp and then round to
+//  nearest. The others truncate and then clamp.
+template <bool round>
+PA_FORCE_INLINE uint32_t scale_brightness_channel(uint32_t t, float scale){
+    float f = (float)t * scale;
+    if (round){
+        return (uint32_t)std::lrint(std::max(std::min(f, 255.f), 0.f));
+    }else{
+        return std::min((uint32_t)f, (uint32_t)255);
+    }
+}
+
+template <SumSquareMode mode, bool round>
+PA_FORCE_INLINE uint64_t scaled_sum_sqr_deviation_pixel(
+    uint32_t r, uint32_t i,
+    const float scale[3], uint32_t background
+){
+    bool opaqueR = (int32_t)r < 0;
+    if (mode == SumSquareMode::REFERENCE_ALPHA && !opaqueR){
+        return 0;
+    }
+    if (mode == SumSquareMode::ARBITRATE_ALPHAS){
+        bool opaqueI = (int32_t)i < 0;
+        if (opaqueR != opaqueI){
+            return 3 * 255 * 255;
+        }
+        if (!opaqueR){
+            return 0;
+        }
+    }
+    uint64_t sumsqr = 0;
+    for (size_t ch = 0; ch < 3; ch++){
+        uint32_t t = opaqueR
+            ? scale_brightness_channel<round>((r >> (8 * ch)) & 0xff, scale[ch])
+            : (background >> (8 * ch)) & 0xff;
+        int32_t d = (int32_t)t - (int32_t)((i >> (8 * ch)) & 0xff);
+        sumsqr += d * d;
+    }
+    return sumsqr;
+}
+
+
+
+// Runner interface:
+// - static size_t Runner::VECTOR_SIZE, how many pixels are processed at once.
+// - Runner::process_full(const uint32_t* ref, const uint32_t* img_row, const uint32_t* index),
+//   process VECTOR_SIZE pixels. The n'th image pixel is "img_row[index[n]]".
+// - Runner::process_pixel(uint32_t ref, uint32_t img), process a single pixel.
+// - Runner::flush(), add the lane accumulators into the output and reset them.
+//
+// The runner may accumulate into 32-bit lanes. It is flushed often enough that
+// no lane can overflow.
+template <typename Runner>
+PA_FORCE_INLINE void scaled_image_runner(
+    Runner& runner,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    size_t row_start, size_t row_step
+){
+    if (width == 0 || height == 0 || img_width == 0 || img_height == 0 || row_start >= height){
+        return;
+    }
+
+    //  Process the template in vertical strips so that the column map fits on
+    //  the stack. Between flushes, the sum of all lanes is bounded by
+    //  (STRIP * ROWS_PER_FLUSH * 3 * 255^2) < 2^31. So neither the lanes nor a
+    //  32-bit horizontal reduction can overflow.
+    const size_t VECTOR_SIZE = Runner::VECTOR_SIZE;
+    const size_t STRIP = 64;
+    const size_t ROWS_PER_FLUSH = 64;
+    static_assert(STRIP % Runner::VECTOR_SIZE == 0, "Strip must be a multiple of the vector size.");
+
+    QtNearestSampler sampler(width, height, img_width, img_height);
+    uint32_t index[STRIP];
+
+    for (size_t c0 = 0; c0 < width; c0 += STRIP){
+        size_t strip = std::min(STRIP, width - c0);
+        sampler.next_columns(index, strip);
+
+        size_t vector_end = strip - strip % VECTOR_SIZE;
+
+        const uint32_t* ref_row = (const uint32_t*)((const char*)ref + row_start * ref_bytes_per_line) + c0;
+        size_t rows = 0;
+        for (size_t r = row_start; r < height; r += row_step){
+            const uint32_t* img_row = (const uint32_t*)(
+                (const char*)img + sampler.row(r) * img_bytes_per_line
+            );
+
+            size_t c = 0;
+            for (; c < vector_end; c += VECTOR_SIZE){
+                runner.process_full(ref_row + c, img_row, index + c);
+            }
+            for (; c < strip; c++){
+                runner.process_pixel(ref_row[c], img_row[index[c]]);
+            }
+
+            if (++rows == ROWS_PER_FLUSH){
+                runner.flush();
+                rows = 0;
+            }
+            ref_row = (const uint32_t*)((const char*)ref_row + row_step * ref_bytes_per_line);
+        }
+        runner.flush();
+    }
+}
+
+
+
+}
+}
+#endif
@@ -0,0 +1,242 @@
+/*  Scaled Sum of Squares of Deviation (x64 AVX2)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_13_Haswell
+
+#include <immintrin.h>
+#include "Kernels/Kernels_x64_AVX2.h"
+#include "Kernels_ImageScaledSumSqrDev_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+struct ScaledPixelSum_x64_AVX2{
+    static const size_t VECTOR_SIZE = 8;
+
+    ScaledPixelSum_x64_AVX2(ScaledPixelSums& sums)
+        : m_sums(sums)
+    {
+        reset();
+    }
+
+    PA_FORCE_INLINE void process_full(const uint32_t* ref, const uint32_t* img_row, const uint32_t* index){
+        __m256i r = _mm256_loadu_si256((const __m256i*)ref);
+        __m256i i = _mm256_i32gather_epi32(
+            (const int*)img_row,
+            _mm256_loadu_si256((const __m256i*)index),
+            4
+        );
+
+        __m256i alphaR = _mm256_srai_epi32(r, 31);
+        m_count = _mm256_sub_epi32(m_count, alphaR);
+
+        const __m256i LOW8 = _mm256_set1_epi32(0x000000ff);
+        i = _mm256_and_si256(i, alphaR);
+        m_sum[0] = _mm256_add_epi32(m_sum[0], _mm256_and_si256(i, LOW8));
+        m_sum[1] = _mm256_add_epi32(m_sum[1], _mm256_and_si256(_mm256_srli_epi32(i, 8), LOW8));
+        m_sum[2] = _mm256_add_epi32(m_sum[2], _mm256_and_si256(_mm256_srli_epi32(i, 16), LOW8));
+    }
+    PA_FORCE_INLINE void process_pixel(uint32_t r, uint32_t i){
+        scaled_pixel_sum_pixel(m_sums, r, i);
+    }
+    PA_FORCE_INLINE void flush(){
+        m_sums.count += reduce_add32_x64_AVX2(m_count);
+        for (size_t ch = 0; ch < 3; ch++){
+            m_sums.sum[ch] += reduce_add32_x64_AVX2(m_sum[ch]);
+        }
+        reset();
+    }
+
+private:
+    PA_FORCE_INLINE void reset(){
+        m_count = _mm256_setzero_si256();
+        for (size_t ch = 0; ch < 3; ch++){
+            m_sum[ch] = _mm256_setzero_si256();
+        }
+    }
+
+private:
+    ScaledPixelSums& m_sums;
+    __m256i m_count;
+    __m256i m_sum[3];
+};
+
+
+
+template <SumSquareMode mode>
+struct ScaledSumSqrDev_x64_AVX2{
+    static const size_t VECTOR_SIZE = 8;
+
+    ScaledSumSqrDev_x64_AVX2(
+        uint64_t& sumsqrs,
+        float scaleR, float scaleG, float scaleB,
+        uint32_t background
+    )
+        : m_sumsqrs(sumsqrs)
+        , m_scale{scaleB, scaleG, scaleR}
+        , m_background(background)
+    {
+        for (size_t ch = 0; ch < 3; ch++){
+            m_scale_v[ch] = _mm256_set1_ps(m_scale[ch]);
+            m_background_v[ch] = _mm256_set1_epi32((background >> (8 * ch)) & 0xff);
+        }
+        reset();
+    }
+
+    PA_FORCE_INLINE void process_full(const uint32_t* ref, const uint32_t* img_row, const uint32_t* index){
+        __m256i r = _mm256_loadu_si256((const __m256i*)ref);
+        __m256i i = _mm256_i32gather_epi32(
+            (const int*)img_row,
+            _mm256_loadu_si256((const __m256i*)index),
+            4
+        );
+
+        __m256i alphaR = _mm256_srai_epi32(r, 31);
+        __m256i compared = alphaR;
+        if (mode == SumSquareMode::ARBITRATE_ALPHAS){
+            __m256i alphaI = _mm256_srai_epi32(i, 31);
+            compared = _mm256_and_si256(alphaR, alphaI);
+            m_mismatches = _mm256_sub_epi32(m_mismatches, _mm256_xor_si256(alphaR, alphaI));
+        }
+
+        m_sum = _mm256_add_epi32(m_sum, process_channel<0>(r, i, alphaR, compared));
+        m_sum = _mm256_add_epi32(m_sum, process_channel<1>(r, i, alphaR, compared));
+        m_sum = _mm256_add_epi32(m_sum, process_channel<2>(r, i, alphaR, compared));
+    }
+    PA_FORCE_INLINE void process_pixel(uint32_t r, uint32_t i){
+        m_sumsqrs += scaled_sum_sqr_deviation_pixel<mode, true>(r, i, m_scale, m_background);
+    }
+    PA_FORCE_INLINE void flush(){
+        m_sumsqrs += reduce_add32_x64_AVX2(m_sum);
+        if (mode == SumSquareMode::ARBITRATE_ALPHAS){
+            m_sumsqrs += reduce_add32_x64_AVX2(m_mismatches) * (3 * 255 * 255);
+        }
+        reset();
+    }
+
+private:
+    template <size_t ch>
+    PA_FORCE_INLINE __m256i process_channel(__m256i r, __m256i i, __m256i alphaR, __m256i compared){
+        const __m256i LOW8 = _mm256_set1_epi32(0x000000ff);
+        __m256i t = _mm256_and_si256(_mm256_srli_epi32(r, 8 * ch), LOW8);
+        __m256i x = _mm256_and_si256(_mm256_srli_epi32(i, 8 * ch), LOW8);
+
+        //  Same as "scale_brightness_x64_AVX2()".
+        __m256 f = _mm256_mul_ps(_mm256_cvtepi32_ps(t), m_scale_v[ch]);
+        f = _mm256_min_ps(f, _mm256_set1_ps(255.));
+        f = _mm256_max_ps(f, _mm256_set1_ps(0.));
+        t = _mm256_cvtps_epi32(f);
+
+        __m256i d;
+        if (mode == SumSquareMode::USE_BACKGROUND){
+            t = _mm256_blendv_epi8(m_background_v[ch], t, alphaR);
+            d = _mm256_abs_epi32(_mm256_sub_epi32(t, x));
+        }else{
+            d = _mm256_and_si256(_mm256_abs_epi32(_mm256_sub_epi32(t, x)), compared);
+        }
+
+        //  The upper 16 bits of each lane are zero so "madd" is a 32-bit multiply.
+        return _mm256_madd_epi16(d, d);
+    }
+    PA_FORCE_INLINE void reset(){
+        m_sum = _mm256_setzero_si256();
+        m_mismatches = _mm256_setzero_si256();
+    }
+
+private:
+    uint64_t& m_sumsqrs;
+    const float m_scale[3];
+    const uint32_t m_background;
+    __m256 m_scale_v[3];
+    __m256i m_background_v[3];
+    __m256i m_sum;
+    __m256i m_mismatches;
+};
+
+
+
+void scaled_pixel_sum_x64_AVX2(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+){
+    ScaledPixelSum_x64_AVX2 runner(sums);
+    scaled_image_runner(
+        runner,
+        width, height,
+        ref, ref_bytes_per_line,
+        img_width, img_height,
+        img, img_bytes_per_line,
+        0, 1
+    );
+}
+
+
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation_x64_AVX2(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+){
+    ScaledSumSqrDev_x64_AVX2<mode> runner(sumsqrs, scaleR, scaleG, scaleB, background);
+    scaled_image_runner(
+        runner,
+        width, height,
+        ref, ref_bytes_per_line,
+        img_width, img_height,
+        img, img_bytes_per_line,
+        row_start, row_step
+    );
+}
+
+
+template
+void scaled_sum_sqr_deviation_x64_AVX2<SumSquareMode::REFERENCE_ALPHA>(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+template
+void scaled_sum_sqr_deviation_x64_AVX2<SumSquareMode::USE_BACKGROUND>(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+template
+void scaled_sum_sqr_deviation_x64_AVX2<SumSquareMode::ARBITRATE_ALPHAS>(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+
+
+
+}
+}
+#endif
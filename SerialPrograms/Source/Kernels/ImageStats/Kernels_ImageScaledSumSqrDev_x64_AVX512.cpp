@@ -0,0 +1,242 @@
+/*  Scaled Sum of Squares of Deviation (x64 AVX512)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_17_Skylake
+
+#include <immintrin.h>
+#include "Kernels/Kernels_x64_AVX512.h"
+#include "Kernels_ImageScaledSumSqrDev_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+struct ScaledPixelSum_x64_AVX512{
+    static const size_t VECTOR_SIZE = 16;
+
+    ScaledPixelSum_x64_AVX512(ScaledPixelSums& sums)
+        : m_sums(sums)
+    {
+        reset();
+    }
+
+    PA_FORCE_INLINE void process_full(const uint32_t* ref, const uint32_t* img_row, const uint32_t* index){
+        __m512i r = _mm512_loadu_si512(ref);
+        __m512i i = _mm512_i32gather_epi32(
+            _mm512_loadu_si512(index),
+            (const int*)img_row,
+            4
+        );
+
+        __m512i alphaR = _mm512_srai_epi32(r, 31);
+        m_count = _mm512_sub_epi32(m_count, alphaR);
+
+        const __m512i LOW8 = _mm512_set1_epi32(0x000000ff);
+        i = _mm512_and_si512(i, alphaR);
+        m_sum[0] = _mm512_add_epi32(m_sum[0], _mm512_and_si512(i, LOW8));
+        m_sum[1] = _mm512_add_epi32(m_sum[1], _mm512_and_si512(_mm512_srli_epi32(i, 8), LOW8));
+        m_sum[2] = _mm512_add_epi32(m_sum[2], _mm512_and_si512(_mm512_srli_epi32(i, 16), LOW8));
+    }
+    PA_FORCE_INLINE void process_pixel(uint32_t r, uint32_t i){
+        scaled_pixel_sum_pixel(m_sums, r, i);
+    }
+    PA_FORCE_INLINE void flush(){
+        m_sums.count += (uint32_t)_mm512_reduce_add_epi32(m_count);
+        for (size_t ch = 0; ch < 3; ch++){
+            m_sums.sum[ch] += (uint32_t)_mm512_reduce_add_epi32(m_sum[ch]);
+        }
+        reset();
+    }
+
+private:
+    PA_FORCE_INLINE void reset(){
+        m_count = _mm512_setzero_si512();
+        for (size_t ch = 0; ch < 3; ch++){
+            m_sum[ch] = _mm512_setzero_si512();
+        }
+    }
+
+private:
+    ScaledPixelSums& m_sums;
+    __m512i m_count;
+    __m512i m_sum[3];
+};
+
+
+
+template <SumSquareMode mode>
+struct ScaledSumSqrDev_x64_AVX512{
+    static const size_t VECTOR_SIZE = 16;
+
+    ScaledSumSqrDev_x64_AVX512(
+        uint64_t& sumsqrs,
+        float scaleR, float scaleG, float scaleB,
+        uint32_t background
+    )
+        : m_sumsqrs(sumsqrs)
+        , m_scale{scaleB, scaleG, scaleR}
+        , m_background(background)
+    {
+        for (size_t ch = 0; ch < 3; ch++){
+            m_scale_v[ch] = _mm512_set1_ps(m_scale[ch]);
+            m_background_v[ch] = _mm512_set1_epi32((background >> (8 * ch)) & 0xff);
+        }
+        reset();
+    }
+
+    PA_FORCE_INLINE void process_full(const uint32_t* ref, const uint32_t* img_row, const uint32_t* index){
+        __m512i r = _mm512_loadu_si512(ref);
+        __m512i i = _mm512_i32gather_epi32(
+            _mm512_loadu_si512(index),
+            (const int*)img_row,
+            4
+        );
+
+        __m512i alphaR = _mm512_srai_epi32(r, 31);
+        __m512i compared = alphaR;
+        if (mode == SumSquareMode::ARBITRATE_ALPHAS){
+            __m512i alphaI = _mm512_srai_epi32(i, 31);
+            compared = _mm512_and_si512(alphaR, alphaI);
+            m_mismatches = _mm512_sub_epi32(m_mismatches, _mm512_xor_si512(alphaR, alphaI));
+        }
+
+        m_sum = _mm512_add_epi32(m_sum, process_channel<0>(r, i, alphaR, compared));
+        m_sum = _mm512_add_epi32(m_sum, process_channel<1>(r, i, alphaR, compared));
+        m_sum = _mm512_add_epi32(m_sum, process_channel<2>(r, i, alphaR, compared));
+    }
+    PA_FORCE_INLINE void process_pixel(uint32_t r, uint32_t i){
+        m_sumsqrs += scaled_sum_sqr_deviation_pixel<mode, true>(r, i, m_scale, m_background);
+    }
+    PA_FORCE_INLINE void flush(){
+        m_sumsqrs += (uint32_t)_mm512_reduce_add_epi32(m_sum);
+        if (mode == SumSquareMode::ARBITRATE_ALPHAS){
+            m_sumsqrs += (uint64_t)(uint32_t)_mm512_reduce_add_epi32(m_mismatches) * (3 * 255 * 255);
+        }
+        reset();
+    }
+
+private:
+    template <size_t ch>
+    PA_FORCE_INLINE __m512i process_channel(__m512i r, __m512i i, __m512i alphaR, __m512i compared){
+        const __m512i LOW8 = _mm512_set1_epi32(0x000000ff);
+        __m512i t = _mm512_and_si512(_mm512_srli_epi32(r, 8 * ch), LOW8);
+        __m512i x = _mm512_and_si512(_mm512_srli_epi32(i, 8 * ch), LOW8);
+
+        //  Same as "scale_brightness_x64_AVX512()".
+        __m512 f = _mm512_mul_ps(_mm512_cvtepi32_ps(t), m_scale_v[ch]);
+        f = _mm512_min_ps(f, _mm512_set1_ps(255.));
+        f = _mm512_max_ps(f, _mm512_set1_ps(0.));
+        t = _mm512_cvtps_epi32(f);
+
+        __m512i d;
+        if (mode == SumSquareMode::USE_BACKGROUND){
+            t = _mm512_mask_blend_epi32(_mm512_test_epi32_mask(alphaR, alphaR), m_background_v[ch], t);
+            d = _mm512_abs_epi32(_mm512_sub_epi32(t, x));
+        }else{
+            d = _mm512_and_si512(_mm512_abs_epi32(_mm512_sub_epi32(t, x)), compared);
+        }
+
+        //  The upper 16 bits of each lane are zero so "madd" is a 32-bit multiply.
+        return _mm512_madd_epi16(d, d);
+    }
+    PA_FORCE_INLINE void reset(){
+        m_sum = _mm512_setzero_si512();
+        m_mismatches = _mm512_setzero_si512();
+    }
+
+private:
+    uint64_t& m_sumsqrs;
+    const float m_scale[3];
+    const uint32_t m_background;
+    __m512 m_scale_v[3];
+    __m512i m_background_v[3];
+    __m512i m_sum;
+    __m512i m_mismatches;
+};
+
+
+
+void scaled_pixel_sum_x64_AVX512(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+){
+    ScaledPixelSum_x64_AVX512 runner(sums);
+    scaled_image_runner(
+        runner,
+        width, height,
+        ref, ref_bytes_per_line,
+        img_width, img_height,
+        img, img_bytes_per_line,
+        0, 1
+    );
+}
+
+
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation_x64_AVX512(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+){
+    ScaledSumSqrDev_x64_AVX512<mode> runner(sumsqrs, scaleR, scaleG, scaleB, background);
+    scaled_image_runner(
+        runner,
+        width, height,
+        ref, ref_bytes_per_line,
+        img_width, img_height,
+        img, img_bytes_per_line,
+        row_start, row_step
+    );
+}
+
+
+template
+void scaled_sum_sqr_deviation_x64_AVX512<SumSquareMode::REFERENCE_ALPHA>(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+template
+void scaled_sum_sqr_deviation_x64_AVX512<SumSquareMode::USE_BACKGROUND>(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+template
+void scaled_sum_sqr_deviation_x64_AVX512<SumSquareMode::ARBITRATE_ALPHAS>(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+
+
+
+}
+}
+#endif
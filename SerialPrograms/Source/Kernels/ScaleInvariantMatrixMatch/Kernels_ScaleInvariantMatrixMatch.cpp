@@ -131,7 +131,37 @@ float compute_error(
 
 
 
-
+void compute_dot_products_Default         (size_t width, size_t rows, const float* A, float const* const* T, float* dots);
+void compute_dot_products_min4_x86_SSE    (size_t width, size_t rows, const float* A, float const* const* T, float* dots);
+void compute_dot_products_min8_x86_AVX2   (size_t width, size_t rows, const float* A, float const* const* T, float* dots);
+void compute_dot_products_min16_x86_AVX512(size_t width, size_t rows, const float* A, float const* const* T, float* dots);
+
+void compute_dot_products(
+    size_t width, size_t rows,
+    const float* A,
+    float const* const* T,
+    float* dots
+){
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (width >= 16 && CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        compute_dot_products_min16_x86_AVX512(width, rows, A, T, dots);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (width >= 8 && CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        compute_dot_products_min8_x86_AVX2(width, rows, A, T, dots);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (width >= 4 && CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        compute_dot_products_min4_x86_SSE(width, rows, A, T, dots);
+        return;
+    }
+#endif
+    compute_dot_products_Default(width, rows, A, T, dots);
+}
 
 
 
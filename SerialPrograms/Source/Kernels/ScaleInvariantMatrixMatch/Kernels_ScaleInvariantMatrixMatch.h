@@ -7,6 +7,8 @@
 #ifndef PokemonAutomation_Kernels_ScaleInvariantMatrixMatch_H
 #define PokemonAutomation_Kernels_ScaleInvariantMatrixMatch_H
 
+#include <stddef.h>
+
 namespace PokemonAutomation{
 namespace Kernels{
 namespace ScaleInvariantMatrixMatch{
@@ -54,6 +56,19 @@ float compute_error(
 
 
 
+//  Compute: dots[r] = A . T[r] for each of the "rows" rows of T.
+//  This is the batched form of the cross term of "compute_scale()" for when
+//  the same row of A is matched against many rows of T.
+//      All pointers must have the same alignment.
+void compute_dot_products(
+    size_t width, size_t rows,
+    const float* A,
+    float const* const* T,
+    float* dots
+);
+
+
+
 
 
 }
@@ -108,6 +108,14 @@ float compute_error_Default(
 ){
     return compute_error<SumError<Context_x86_SSE41>>(width, height, scale, A, TW, W);
 }
+void compute_dot_products_Default(
+    size_t width, size_t rows,
+    const float* A,
+    float const* const* T,
+    float* dots
+){
+    compute_dot_products<SumAT<Context_x86_SSE41>>(width, rows, A, T, dots);
+}
 
 
 
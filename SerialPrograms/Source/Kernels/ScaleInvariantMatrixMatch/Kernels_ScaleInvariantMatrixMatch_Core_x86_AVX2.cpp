@@ -123,6 +123,14 @@ float compute_error_min8_x86_AVX2(
 ){
     return compute_error<SumError<Context_x86_AVX2>>(width, height, scale, A, TW, W);
 }
+void compute_dot_products_min8_x86_AVX2(
+    size_t width, size_t rows,
+    const float* A,
+    float const* const* T,
+    float* dots
+){
+    compute_dot_products<SumAT<Context_x86_AVX2>>(width, rows, A, T, dots);
+}
 
 
 
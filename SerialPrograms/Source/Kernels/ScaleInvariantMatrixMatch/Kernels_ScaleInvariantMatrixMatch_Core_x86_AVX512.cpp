@@ -115,6 +115,14 @@ float compute_error_min16_x86_AVX512(
 ){
     return compute_error<SumError<Context_x86_AVX512>>(width, height, scale, A, TW, W);
 }
+void compute_dot_products_min16_x86_AVX512(
+    size_t width, size_t rows,
+    const float* A,
+    float const* const* T,
+    float* dots
+){
+    compute_dot_products<SumAT<Context_x86_AVX512>>(width, rows, A, T, dots);
+}
 
 
 
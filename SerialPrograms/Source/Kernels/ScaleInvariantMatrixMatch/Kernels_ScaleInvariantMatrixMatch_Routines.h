@@ -197,6 +197,77 @@ struct SumATA2{
 
 
 
+template <typename Context>
+struct SumAT{
+    using vtype = typename Context::vtype;
+    static constexpr size_t VECTOR_LENGTH = sizeof(vtype) / sizeof(float);
+
+    vtype sum_AT = Context::vzero();
+
+    PA_FORCE_INLINE float dot() const{
+        return Context::vreduce(sum_AT);
+    }
+
+    PA_FORCE_INLINE void accumulate(size_t length, const float* A, const float* T){
+        vtype sum_at0 = Context::vzero();
+        vtype sum_at1 = Context::vzero();
+        vtype sum_at2 = Context::vzero();
+        vtype sum_at3 = Context::vzero();
+
+        if (VECTOR_LENGTH > 1){
+            size_t align = (size_t)T % (VECTOR_LENGTH * sizeof(float));
+            if (align){
+                align /= sizeof(float);
+                A -= align;
+                T -= align;
+
+                vtype a0, t0;
+                Context::load2_partial_back(align, a0, A, t0, T);
+                sum_at0 = Context::vpma(a0, t0, sum_at0);
+
+                A += VECTOR_LENGTH;
+                T += VECTOR_LENGTH;
+                length -= VECTOR_LENGTH - align;
+            }
+        }
+
+        const vtype* ptrA = (const vtype*)A;
+        const vtype* ptrT = (const vtype*)T;
+
+        size_t lc = length / (4 * VECTOR_LENGTH);
+        if (lc){
+            do{
+                sum_at0 = Context::vpma(ptrA[0], ptrT[0], sum_at0);
+                sum_at1 = Context::vpma(ptrA[1], ptrT[1], sum_at1);
+                sum_at2 = Context::vpma(ptrA[2], ptrT[2], sum_at2);
+                sum_at3 = Context::vpma(ptrA[3], ptrT[3], sum_at3);
+                ptrA += 4;
+                ptrT += 4;
+            }while (--lc);
+            sum_at0 = Context::vadd(sum_at0, sum_at1);
+            sum_at2 = Context::vadd(sum_at2, sum_at3);
+            sum_at0 = Context::vadd(sum_at0, sum_at2);
+        }
+
+        length %= 4 * VECTOR_LENGTH;
+        while (length >= VECTOR_LENGTH){
+            sum_at0 = Context::vpma(ptrA[0], ptrT[0], sum_at0);
+            ptrA += 1;
+            ptrT += 1;
+            length -= VECTOR_LENGTH;
+        }
+        if (VECTOR_LENGTH > 1 && length){
+            vtype a0, t0;
+            Context::load2_partial_front(length, a0, ptrA, t0, ptrT);
+            sum_at0 = Context::vpma(a0, t0, sum_at0);
+        }
+
+        sum_AT = Context::vadd(sum_AT, sum_at0);
+    }
+};
+
+
+
 template <typename Context>
 struct SumError{
     using vtype = typename Context::vtype;
@@ -437,6 +508,26 @@ PA_FORCE_INLINE float compute_error(
 }
 
 
+template <typename SumAT>
+PA_FORCE_INLINE void compute_dot_products(
+    size_t width, size_t rows,
+    const float* A,
+    float const* const* T,
+    float* dots
+){
+    constexpr size_t ALIGNMENT = alignof(typename SumAT::vtype);
+    for (size_t r = 0; r < rows; r++){
+        const float* ptrT = T[r];
+        if ((size_t)A % ALIGNMENT != (size_t)ptrT % ALIGNMENT){
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "A and T must have the same alignment.");
+        }
+        SumAT sum;
+        sum.accumulate(width, A, ptrT);
+        dots[r] = sum.dot();
+    }
+}
+
+
 
 
 }
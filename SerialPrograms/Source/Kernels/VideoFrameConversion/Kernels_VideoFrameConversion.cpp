@@ -0,0 +1,110 @@
+/*  Video Frame Conversion
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "Common/Cpp/CpuId/CpuId.h"
+#include "Kernels_VideoFrameConversion.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+namespace{
+
+constexpr int32_t to_fixed(double x){
+    return (int32_t)(x * (1 << YUV_TO_RGB_SHIFT) + 0.5);
+}
+
+//  "kr" and "kb" are the luma weights of the color space.
+YUVToRGBCoefficients make_coefficients(double kr, double kb, bool full_range){
+    double kg = 1 - kr - kb;
+    double y_scale = full_range ? 1.0 : 255. / 219;
+    double c_scale = full_range ? 1.0 : 255. / 224;
+    YUVToRGBCoefficients ret;
+    ret.y_offset    = full_range ? 0 : 16;
+    ret.y_scale     = to_fixed(y_scale);
+    ret.v_to_r      = to_fixed(c_scale * 2 * (1 - kr));
+    ret.u_to_g      = to_fixed(c_scale * 2 * (1 - kb) * kb / kg);
+    ret.v_to_g      = to_fixed(c_scale * 2 * (1 - kr) * kr / kg);
+    ret.u_to_b      = to_fixed(c_scale * 2 * (1 - kb));
+    return ret;
+}
+
+}
+
+YUVToRGBCoefficients YUVToRGBCoefficients::BT601(bool full_range){
+    return make_coefficients(0.299, 0.114, full_range);
+}
+YUVToRGBCoefficients YUVToRGBCoefficients::BT709(bool full_range){
+    return make_coefficients(0.2126, 0.0722, full_range);
+}
+
+
+
+void convert_yuv_to_rgb32_Default(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+);
+void convert_yuv_to_rgb32_x64_SSE41(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+);
+void convert_yuv_to_rgb32_x64_AVX2(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+);
+void convert_yuv_to_rgb32_x64_AVX512(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+);
+void convert_yuv_to_rgb32_arm64_NEON(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+);
+
+
+
+void convert_yuv_to_rgb32(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+){
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        convert_yuv_to_rgb32_x64_AVX512(frame, image, bytes_per_row, coefficients);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        convert_yuv_to_rgb32_x64_AVX2(frame, image, bytes_per_row, coefficients);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        convert_yuv_to_rgb32_x64_SSE41(frame, image, bytes_per_row, coefficients);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_arm64_20_M1
+    if (CPU_CAPABILITY_CURRENT.OK_M1){
+        convert_yuv_to_rgb32_arm64_NEON(frame, image, bytes_per_row, coefficients);
+        return;
+    }
+#endif
+    convert_yuv_to_rgb32_Default(frame, image, bytes_per_row, coefficients);
+}
+
+
+
+
+}
+}
@@ -0,0 +1,69 @@
+/*  Video Frame Conversion
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ *      Convert raw YUV video frames (as delivered by capture cards) directly
+ *  into ARGB32 without going through QImage.
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_VideoFrameConversion_H
+#define PokemonAutomation_Kernels_VideoFrameConversion_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+enum class YUVFormat{
+    NV12,   //  Y plane + interleaved UV plane. 4:2:0
+    I420,   //  Y plane + U plane + V plane. 4:2:0
+    YUY2,   //  Packed Y0 U0 Y1 V0. 4:2:2
+    UYVY,   //  Packed U0 Y0 V0 Y1. 4:2:2
+};
+
+
+//  Fixed-point YUV -> RGB matrix. All the implementations do the exact same
+//  integer math so they are bit-identical with each other.
+constexpr int YUV_TO_RGB_SHIFT = 14;
+struct YUVToRGBCoefficients{
+    int32_t y_offset;
+    int32_t y_scale;
+    int32_t v_to_r;
+    int32_t u_to_g;
+    int32_t v_to_g;
+    int32_t u_to_b;
+
+    static YUVToRGBCoefficients BT601(bool full_range);
+    static YUVToRGBCoefficients BT709(bool full_range);
+};
+
+
+struct YUVFrameView{
+    YUVFormat format;
+    size_t width;
+    size_t height;
+
+    //  NV12:       planes[0] = Y, planes[1] = UV
+    //  I420:       planes[0] = Y, planes[1] = U, planes[2] = V
+    //  YUY2/UYVY:  planes[0] = packed pixels
+    const uint8_t* planes[3];
+    size_t bytes_per_row[3];
+};
+
+
+//  Convert "frame" into "image" which must be at least as large as the frame.
+//  The alpha channel is set to 255.
+void convert_yuv_to_rgb32(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+);
+
+
+
+}
+}
+#endif
@@ -0,0 +1,32 @@
+/*  Video Frame Conversion (Default)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#include "Kernels_VideoFrameConversion_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+struct YUVToRGB32_Default{
+    YUVToRGB32_Default(const YUVToRGBCoefficients&){}
+    size_t convert_row(YUVFormat, const YUVRow&, size_t, uint32_t*) const{
+        return 0;
+    }
+};
+
+
+void convert_yuv_to_rgb32_Default(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+){
+    yuv_to_rgb32_frame<YUVToRGB32_Default>(frame, image, bytes_per_row, coefficients);
+}
+
+
+
+}
+}
@@ -0,0 +1,119 @@
+/*  Video Frame Conversion Routines
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_VideoFrameConversion_Routines_H
+#define PokemonAutomation_Kernels_VideoFrameConversion_Routines_H
+
+#include <algorithm>
+#include "Common/Compiler.h"
+#include "Kernels_VideoFrameConversion.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+PA_FORCE_INLINE uint32_t yuv_to_rgb32_pixel(
+    int32_t Y, int32_t U, int32_t V,
+    const YUVToRGBCoefficients& coefficients
+){
+    int32_t y = (Y - coefficients.y_offset) * coefficients.y_scale + (1 << (YUV_TO_RGB_SHIFT - 1));
+    int32_t u = U - 128;
+    int32_t v = V - 128;
+    int32_t r = (y + v * coefficients.v_to_r) >> YUV_TO_RGB_SHIFT;
+    int32_t g = (y - u * coefficients.u_to_g - v * coefficients.v_to_g) >> YUV_TO_RGB_SHIFT;
+    int32_t b = (y + u * coefficients.u_to_b) >> YUV_TO_RGB_SHIFT;
+    r = std::min(std::max(r, 0), 255);
+    g = std::min(std::max(g, 0), 255);
+    b = std::min(std::max(b, 0), 255);
+    return 0xff000000 | ((uint32_t)r << 16) | ((uint32_t)g << 8) | (uint32_t)b;
+}
+
+
+//  Pointers to the start of row "r" of each plane.
+struct YUVRow{
+    const uint8_t* planes[3];
+
+    YUVRow(const YUVFrameView& frame, size_t r){
+        switch (frame.format){
+        case YUVFormat::NV12:
+            planes[0] = frame.planes[0] + r * frame.bytes_per_row[0];
+            planes[1] = frame.planes[1] + (r / 2) * frame.bytes_per_row[1];
+            planes[2] = nullptr;
+            return;
+        case YUVFormat::I420:
+            planes[0] = frame.planes[0] + r * frame.bytes_per_row[0];
+            planes[1] = frame.planes[1] + (r / 2) * frame.bytes_per_row[1];
+            planes[2] = frame.planes[2] + (r / 2) * frame.bytes_per_row[2];
+            return;
+        default:
+            planes[0] = frame.planes[0] + r * frame.bytes_per_row[0];
+            planes[1] = nullptr;
+            planes[2] = nullptr;
+            return;
+        }
+    }
+};
+
+
+//  Convert pixels [start, end) of a row.
+inline void yuv_to_rgb32_row_Default(
+    YUVFormat format, const YUVRow& row,
+    size_t start, size_t end, uint32_t* out,
+    const YUVToRGBCoefficients& coefficients
+){
+    switch (format){
+    case YUVFormat::NV12:
+        for (size_t x = start; x < end; x++){
+            const uint8_t* uv = row.planes[1] + (x & ~(size_t)1);
+            out[x] = yuv_to_rgb32_pixel(row.planes[0][x], uv[0], uv[1], coefficients);
+        }
+        return;
+    case YUVFormat::I420:
+        for (size_t x = start; x < end; x++){
+            out[x] = yuv_to_rgb32_pixel(row.planes[0][x], row.planes[1][x / 2], row.planes[2][x / 2], coefficients);
+        }
+        return;
+    case YUVFormat::YUY2:
+        for (size_t x = start; x < end; x++){
+            const uint8_t* pair = row.planes[0] + 2 * (x & ~(size_t)1);
+            out[x] = yuv_to_rgb32_pixel(pair[(x & 1) * 2], pair[1], pair[3], coefficients);
+        }
+        return;
+    case YUVFormat::UYVY:
+        for (size_t x = start; x < end; x++){
+            const uint8_t* pair = row.planes[0] + 2 * (x & ~(size_t)1);
+            out[x] = yuv_to_rgb32_pixel(pair[(x & 1) * 2 + 1], pair[0], pair[2], coefficients);
+        }
+        return;
+    }
+}
+
+
+//  "RowConverter" converts as many pixels of the row as it can with full
+//  vectors and returns how many it did. The rest are done here.
+template <typename RowConverter>
+void yuv_to_rgb32_frame(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+){
+    if (frame.width == 0 || frame.height == 0){
+        return;
+    }
+    RowConverter converter(coefficients);
+    for (size_t r = 0; r < frame.height; r++){
+        YUVRow row(frame, r);
+        size_t done = converter.convert_row(frame.format, row, frame.width, image);
+        yuv_to_rgb32_row_Default(frame.format, row, done, frame.width, image, coefficients);
+        image = (uint32_t*)((char*)image + bytes_per_row);
+    }
+}
+
+
+
+}
+}
+#endif
@@ -0,0 +1,143 @@
+/*  Video Frame Conversion (arm64 NEON)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_arm64_20_M1
+
+#include <string.h>
+#include <arm_neon.h>
+#include "Kernels_VideoFrameConversion_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+class YUVToRGB32_arm64_NEON{
+public:
+    YUVToRGB32_arm64_NEON(const YUVToRGBCoefficients& coefficients)
+        : m_y_offset(vmovq_n_s32(coefficients.y_offset))
+        , m_y_scale(vmovq_n_s32(coefficients.y_scale))
+        , m_v_to_r(vmovq_n_s32(coefficients.v_to_r))
+        , m_u_to_g(vmovq_n_s32(coefficients.u_to_g))
+        , m_v_to_g(vmovq_n_s32(coefficients.v_to_g))
+        , m_u_to_b(vmovq_n_s32(coefficients.u_to_b))
+    {}
+
+    //  8 pixels at a time.
+    size_t convert_row(YUVFormat format, const YUVRow& row, size_t width, uint32_t* out) const{
+        size_t lc = width / 8;
+        switch (format){
+        case YUVFormat::NV12:
+            for (size_t c = 0; c < lc; c++){
+                uint8x8_t y = vld1_u8(row.planes[0] + 8*c);
+                uint8x8_t uv = vld1_u8(row.planes[1] + 8*c);
+                store(out + 8*c, y, uv);
+            }
+            break;
+        case YUVFormat::I420:
+            for (size_t c = 0; c < lc; c++){
+                uint8x8_t y = vld1_u8(row.planes[0] + 8*c);
+                uint8x8_t u = load4(row.planes[1] + 4*c);
+                uint8x8_t v = load4(row.planes[2] + 4*c);
+                //  [U0, U0, U1, U1, U2, U2, U3, U3]
+                u = vzip_u8(u, u).val[0];
+                v = vzip_u8(v, v).val[0];
+                convert(out + 8*c, y, u, v);
+            }
+            break;
+        case YUVFormat::YUY2:
+            for (size_t c = 0; c < lc; c++){
+                uint8x8x2_t w = vld2_u8(row.planes[0] + 16*c);
+                store(out + 8*c, w.val[0], w.val[1]);
+            }
+            break;
+        case YUVFormat::UYVY:
+            for (size_t c = 0; c < lc; c++){
+                uint8x8x2_t w = vld2_u8(row.planes[0] + 16*c);
+                store(out + 8*c, w.val[1], w.val[0]);
+            }
+            break;
+        }
+        return lc * 8;
+    }
+
+private:
+    static PA_FORCE_INLINE uint8x8_t load4(const uint8_t* ptr){
+        uint32_t x;
+        memcpy(&x, ptr, sizeof(x));
+        return vreinterpret_u8_u32(vdup_n_u32(x));
+    }
+
+    //  "uv" is [U0, V0, U1, V1, U2, V2, U3, V3].
+    PA_FORCE_INLINE void store(uint32_t* out, uint8x8_t y, uint8x8_t uv) const{
+        uint8x8x2_t split = vuzp_u8(uv, uv);
+        uint8x8_t u = vzip_u8(split.val[0], split.val[0]).val[0];
+        uint8x8_t v = vzip_u8(split.val[1], split.val[1]).val[0];
+        convert(out, y, u, v);
+    }
+
+    PA_FORCE_INLINE void convert(uint32_t* out, uint8x8_t y, uint8x8_t u, uint8x8_t v) const{
+        uint16x8_t y16 = vmovl_u8(y);
+        uint16x8_t u16 = vmovl_u8(u);
+        uint16x8_t v16 = vmovl_u8(v);
+        vst1q_u32(out + 0, convert(
+            vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(y16))),
+            vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(u16))),
+            vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(v16)))
+        ));
+        vst1q_u32(out + 4, convert(
+            vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(y16))),
+            vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(u16))),
+            vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(v16)))
+        ));
+    }
+    PA_FORCE_INLINE uint32x4_t convert(int32x4_t y, int32x4_t u, int32x4_t v) const{
+        y = vmulq_s32(vsubq_s32(y, m_y_offset), m_y_scale);
+        y = vaddq_s32(y, vmovq_n_s32(1 << (YUV_TO_RGB_SHIFT - 1)));
+        u = vsubq_s32(u, vmovq_n_s32(128));
+        v = vsubq_s32(v, vmovq_n_s32(128));
+
+        int32x4_t r = vmlaq_s32(y, v, m_v_to_r);
+        int32x4_t g = vmlsq_s32(y, u, m_u_to_g);
+        g = vmlsq_s32(g, v, m_v_to_g);
+        int32x4_t b = vmlaq_s32(y, u, m_u_to_b);
+
+        uint32x4_t r_u32 = clamp(vshrq_n_s32(r, YUV_TO_RGB_SHIFT));
+        uint32x4_t g_u32 = clamp(vshrq_n_s32(g, YUV_TO_RGB_SHIFT));
+        uint32x4_t b_u32 = clamp(vshrq_n_s32(b, YUV_TO_RGB_SHIFT));
+
+        uint32x4_t pixel = vsliq_n_u32(b_u32, g_u32, 8);
+        pixel = vsliq_n_u32(pixel, r_u32, 16);
+        return vorrq_u32(pixel, vmovq_n_u32(0xff000000));
+    }
+    static PA_FORCE_INLINE uint32x4_t clamp(int32x4_t x){
+        x = vmaxq_s32(x, vmovq_n_s32(0));
+        x = vminq_s32(x, vmovq_n_s32(255));
+        return vreinterpretq_u32_s32(x);
+    }
+
+private:
+    int32x4_t m_y_offset;
+    int32x4_t m_y_scale;
+    int32x4_t m_v_to_r;
+    int32x4_t m_u_to_g;
+    int32x4_t m_v_to_g;
+    int32x4_t m_u_to_b;
+};
+
+
+void convert_yuv_to_rgb32_arm64_NEON(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+){
+    yuv_to_rgb32_frame<YUVToRGB32_arm64_NEON>(frame, image, bytes_per_row, coefficients);
+}
+
+
+
+}
+}
+#endif
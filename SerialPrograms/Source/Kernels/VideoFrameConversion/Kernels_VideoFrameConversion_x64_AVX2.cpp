@@ -0,0 +1,130 @@
+/*  Video Frame Conversion (x64 AVX2)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_13_Haswell
+
+#include <string.h>
+#include <immintrin.h>
+#include "Kernels_VideoFrameConversion_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+class YUVToRGB32_x64_AVX2{
+public:
+    YUVToRGB32_x64_AVX2(const YUVToRGBCoefficients& coefficients)
+        : m_y_offset(_mm256_set1_epi32(coefficients.y_offset))
+        , m_y_scale(_mm256_set1_epi32(coefficients.y_scale))
+        , m_v_to_r(_mm256_set1_epi32(coefficients.v_to_r))
+        , m_u_to_g(_mm256_set1_epi32(coefficients.u_to_g))
+        , m_v_to_g(_mm256_set1_epi32(coefficients.v_to_g))
+        , m_u_to_b(_mm256_set1_epi32(coefficients.u_to_b))
+    {}
+
+    //  8 pixels at a time.
+    size_t convert_row(YUVFormat format, const YUVRow& row, size_t width, uint32_t* out) const{
+        size_t lc = width / 8;
+        switch (format){
+        case YUVFormat::NV12:
+            for (size_t c = 0; c < lc; c++){
+                __m256i y = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(row.planes[0] + 8*c)));
+                __m256i uv = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(row.planes[1] + 8*c)));
+                store(out + 8*c, y, uv);
+            }
+            break;
+        case YUVFormat::I420:
+            for (size_t c = 0; c < lc; c++){
+                __m256i y = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(row.planes[0] + 8*c)));
+                __m256i u = _mm256_cvtepu8_epi32(load4(row.planes[1] + 4*c));
+                __m256i v = _mm256_cvtepu8_epi32(load4(row.planes[2] + 4*c));
+                const __m256i DUPLICATE = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+                u = _mm256_permutevar8x32_epi32(u, DUPLICATE);
+                v = _mm256_permutevar8x32_epi32(v, DUPLICATE);
+                _mm256_storeu_si256((__m256i*)(out + 8*c), convert(y, u, v));
+            }
+            break;
+        case YUVFormat::YUY2:
+            for (size_t c = 0; c < lc; c++){
+                __m256i w = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(row.planes[0] + 16*c)));
+                __m256i y = _mm256_and_si256(w, _mm256_set1_epi32(0x0000ffff));
+                __m256i uv = _mm256_srli_epi32(w, 16);
+                store(out + 8*c, y, uv);
+            }
+            break;
+        case YUVFormat::UYVY:
+            for (size_t c = 0; c < lc; c++){
+                __m256i w = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(row.planes[0] + 16*c)));
+                __m256i y = _mm256_srli_epi32(w, 16);
+                __m256i uv = _mm256_and_si256(w, _mm256_set1_epi32(0x0000ffff));
+                store(out + 8*c, y, uv);
+            }
+            break;
+        }
+        return lc * 8;
+    }
+
+private:
+    static PA_FORCE_INLINE __m128i load4(const uint8_t* ptr){
+        uint32_t x;
+        memcpy(&x, ptr, sizeof(x));
+        return _mm_cvtsi32_si128(x);
+    }
+
+    //  "uv" is [U0, V0, U1, V1, U2, V2, U3, V3].
+    PA_FORCE_INLINE void store(uint32_t* out, __m256i y, __m256i uv) const{
+        __m256i u = _mm256_permutevar8x32_epi32(uv, _mm256_setr_epi32(0, 0, 2, 2, 4, 4, 6, 6));
+        __m256i v = _mm256_permutevar8x32_epi32(uv, _mm256_setr_epi32(1, 1, 3, 3, 5, 5, 7, 7));
+        _mm256_storeu_si256((__m256i*)out, convert(y, u, v));
+    }
+
+    PA_FORCE_INLINE __m256i convert(__m256i y, __m256i u, __m256i v) const{
+        y = _mm256_mullo_epi32(_mm256_sub_epi32(y, m_y_offset), m_y_scale);
+        y = _mm256_add_epi32(y, _mm256_set1_epi32(1 << (YUV_TO_RGB_SHIFT - 1)));
+        u = _mm256_sub_epi32(u, _mm256_set1_epi32(128));
+        v = _mm256_sub_epi32(v, _mm256_set1_epi32(128));
+
+        __m256i r = _mm256_add_epi32(y, _mm256_mullo_epi32(v, m_v_to_r));
+        __m256i g = _mm256_sub_epi32(y, _mm256_mullo_epi32(u, m_u_to_g));
+        g = _mm256_sub_epi32(g, _mm256_mullo_epi32(v, m_v_to_g));
+        __m256i b = _mm256_add_epi32(y, _mm256_mullo_epi32(u, m_u_to_b));
+
+        r = clamp(_mm256_srai_epi32(r, YUV_TO_RGB_SHIFT));
+        g = clamp(_mm256_srai_epi32(g, YUV_TO_RGB_SHIFT));
+        b = clamp(_mm256_srai_epi32(b, YUV_TO_RGB_SHIFT));
+
+        __m256i pixel = _mm256_or_si256(_mm256_slli_epi32(r, 16), _mm256_slli_epi32(g, 8));
+        pixel = _mm256_or_si256(pixel, b);
+        return _mm256_or_si256(pixel, _mm256_set1_epi32(0xff000000));
+    }
+    static PA_FORCE_INLINE __m256i clamp(__m256i x){
+        x = _mm256_max_epi32(x, _mm256_setzero_si256());
+        return _mm256_min_epi32(x, _mm256_set1_epi32(255));
+    }
+
+private:
+    __m256i m_y_offset;
+    __m256i m_y_scale;
+    __m256i m_v_to_r;
+    __m256i m_u_to_g;
+    __m256i m_v_to_g;
+    __m256i m_u_to_b;
+};
+
+
+void convert_yuv_to_rgb32_x64_AVX2(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+){
+    yuv_to_rgb32_frame<YUVToRGB32_x64_AVX2>(frame, image, bytes_per_row, coefficients);
+}
+
+
+
+}
+}
+#endif
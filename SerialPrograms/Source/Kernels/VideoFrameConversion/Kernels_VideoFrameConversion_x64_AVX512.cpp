@@ -0,0 +1,127 @@
+/*  Video Frame Conversion (x64 AVX512)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_17_Skylake
+
+#include <immintrin.h>
+#include "Kernels_VideoFrameConversion_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+class YUVToRGB32_x64_AVX512{
+public:
+    YUVToRGB32_x64_AVX512(const YUVToRGBCoefficients& coefficients)
+        : m_y_offset(_mm512_set1_epi32(coefficients.y_offset))
+        , m_y_scale(_mm512_set1_epi32(coefficients.y_scale))
+        , m_v_to_r(_mm512_set1_epi32(coefficients.v_to_r))
+        , m_u_to_g(_mm512_set1_epi32(coefficients.u_to_g))
+        , m_v_to_g(_mm512_set1_epi32(coefficients.v_to_g))
+        , m_u_to_b(_mm512_set1_epi32(coefficients.u_to_b))
+    {}
+
+    //  16 pixels at a time.
+    size_t convert_row(YUVFormat format, const YUVRow& row, size_t width, uint32_t* out) const{
+        size_t lc = width / 16;
+        switch (format){
+        case YUVFormat::NV12:
+            for (size_t c = 0; c < lc; c++){
+                __m512i y = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)(row.planes[0] + 16*c)));
+                __m512i uv = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)(row.planes[1] + 16*c)));
+                store(out + 16*c, y, uv);
+            }
+            break;
+        case YUVFormat::I420:
+            for (size_t c = 0; c < lc; c++){
+                __m512i y = _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)(row.planes[0] + 16*c)));
+                __m512i u = _mm512_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(row.planes[1] + 8*c)));
+                __m512i v = _mm512_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(row.planes[2] + 8*c)));
+                const __m512i DUPLICATE = _mm512_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+                u = _mm512_permutexvar_epi32(DUPLICATE, u);
+                v = _mm512_permutexvar_epi32(DUPLICATE, v);
+                _mm512_storeu_si512(out + 16*c, convert(y, u, v));
+            }
+            break;
+        case YUVFormat::YUY2:
+            for (size_t c = 0; c < lc; c++){
+                __m512i w = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(row.planes[0] + 32*c)));
+                __m512i y = _mm512_and_si512(w, _mm512_set1_epi32(0x0000ffff));
+                __m512i uv = _mm512_srli_epi32(w, 16);
+                store(out + 16*c, y, uv);
+            }
+            break;
+        case YUVFormat::UYVY:
+            for (size_t c = 0; c < lc; c++){
+                __m512i w = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i*)(row.planes[0] + 32*c)));
+                __m512i y = _mm512_srli_epi32(w, 16);
+                __m512i uv = _mm512_and_si512(w, _mm512_set1_epi32(0x0000ffff));
+                store(out + 16*c, y, uv);
+            }
+            break;
+        }
+        return lc * 16;
+    }
+
+private:
+    //  "uv" is [U0, V0, U1, V1, ... U7, V7].
+    PA_FORCE_INLINE void store(uint32_t* out, __m512i y, __m512i uv) const{
+        __m512i u = _mm512_permutexvar_epi32(
+            _mm512_setr_epi32(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14), uv
+        );
+        __m512i v = _mm512_permutexvar_epi32(
+            _mm512_setr_epi32(1, 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15), uv
+        );
+        _mm512_storeu_si512(out, convert(y, u, v));
+    }
+
+    PA_FORCE_INLINE __m512i convert(__m512i y, __m512i u, __m512i v) const{
+        y = _mm512_mullo_epi32(_mm512_sub_epi32(y, m_y_offset), m_y_scale);
+        y = _mm512_add_epi32(y, _mm512_set1_epi32(1 << (YUV_TO_RGB_SHIFT - 1)));
+        u = _mm512_sub_epi32(u, _mm512_set1_epi32(128));
+        v = _mm512_sub_epi32(v, _mm512_set1_epi32(128));
+
+        __m512i r = _mm512_add_epi32(y, _mm512_mullo_epi32(v, m_v_to_r));
+        __m512i g = _mm512_sub_epi32(y, _mm512_mullo_epi32(u, m_u_to_g));
+        g = _mm512_sub_epi32(g, _mm512_mullo_epi32(v, m_v_to_g));
+        __m512i b = _mm512_add_epi32(y, _mm512_mullo_epi32(u, m_u_to_b));
+
+        r = clamp(_mm512_srai_epi32(r, YUV_TO_RGB_SHIFT));
+        g = clamp(_mm512_srai_epi32(g, YUV_TO_RGB_SHIFT));
+        b = clamp(_mm512_srai_epi32(b, YUV_TO_RGB_SHIFT));
+
+        __m512i pixel = _mm512_or_si512(_mm512_slli_epi32(r, 16), _mm512_slli_epi32(g, 8));
+        pixel = _mm512_or_si512(pixel, b);
+        return _mm512_or_si512(pixel, _mm512_set1_epi32(0xff000000));
+    }
+    static PA_FORCE_INLINE __m512i clamp(__m512i x){
+        x = _mm512_max_epi32(x, _mm512_setzero_si512());
+        return _mm512_min_epi32(x, _mm512_set1_epi32(255));
+    }
+
+private:
+    __m512i m_y_offset;
+    __m512i m_y_scale;
+    __m512i m_v_to_r;
+    __m512i m_u_to_g;
+    __m512i m_v_to_g;
+    __m512i m_u_to_b;
+};
+
+
+void convert_yuv_to_rgb32_x64_AVX512(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+){
+    yuv_to_rgb32_frame<YUVToRGB32_x64_AVX512>(frame, image, bytes_per_row, coefficients);
+}
+
+
+
+}
+}
+#endif
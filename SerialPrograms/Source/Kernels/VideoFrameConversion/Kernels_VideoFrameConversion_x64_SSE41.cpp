@@ -0,0 +1,134 @@
+/*  Video Frame Conversion (x64 SSE4.1)
+ *
+ *  From: https://github.com/PokemonAutomation/
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+
+#include <string.h>
+#include <smmintrin.h>
+#include "Kernels_VideoFrameConversion_Routines.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+class YUVToRGB32_x64_SSE41{
+public:
+    YUVToRGB32_x64_SSE41(const YUVToRGBCoefficients& coefficients)
+        : m_y_offset(_mm_set1_epi32(coefficients.y_offset))
+        , m_y_scale(_mm_set1_epi32(coefficients.y_scale))
+        , m_v_to_r(_mm_set1_epi32(coefficients.v_to_r))
+        , m_u_to_g(_mm_set1_epi32(coefficients.u_to_g))
+        , m_v_to_g(_mm_set1_epi32(coefficients.v_to_g))
+        , m_u_to_b(_mm_set1_epi32(coefficients.u_to_b))
+    {}
+
+    //  4 pixels at a time.
+    size_t convert_row(YUVFormat format, const YUVRow& row, size_t width, uint32_t* out) const{
+        size_t lc = width / 4;
+        switch (format){
+        case YUVFormat::NV12:
+            for (size_t c = 0; c < lc; c++){
+                __m128i y = _mm_cvtepu8_epi32(load4(row.planes[0] + 4*c));
+                __m128i uv = _mm_cvtepu8_epi32(load4(row.planes[1] + 4*c));
+                store(out + 4*c, y, uv);
+            }
+            break;
+        case YUVFormat::I420:
+            for (size_t c = 0; c < lc; c++){
+                __m128i y = _mm_cvtepu8_epi32(load4(row.planes[0] + 4*c));
+                __m128i u = _mm_cvtepu8_epi32(load2(row.planes[1] + 2*c));
+                __m128i v = _mm_cvtepu8_epi32(load2(row.planes[2] + 2*c));
+                u = _mm_shuffle_epi32(u, 0x50);
+                v = _mm_shuffle_epi32(v, 0x50);
+                _mm_storeu_si128((__m128i*)(out + 4*c), convert(y, u, v));
+            }
+            break;
+        case YUVFormat::YUY2:
+            for (size_t c = 0; c < lc; c++){
+                __m128i w = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)(row.planes[0] + 8*c)));
+                __m128i y = _mm_and_si128(w, _mm_set1_epi32(0x0000ffff));
+                __m128i uv = _mm_srli_epi32(w, 16);
+                store(out + 4*c, y, uv);
+            }
+            break;
+        case YUVFormat::UYVY:
+            for (size_t c = 0; c < lc; c++){
+                __m128i w = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)(row.planes[0] + 8*c)));
+                __m128i y = _mm_srli_epi32(w, 16);
+                __m128i uv = _mm_and_si128(w, _mm_set1_epi32(0x0000ffff));
+                store(out + 4*c, y, uv);
+            }
+            break;
+        }
+        return lc * 4;
+    }
+
+private:
+    static PA_FORCE_INLINE __m128i load4(const uint8_t* ptr){
+        uint32_t x;
+        memcpy(&x, ptr, sizeof(x));
+        return _mm_cvtsi32_si128(x);
+    }
+    static PA_FORCE_INLINE __m128i load2(const uint8_t* ptr){
+        uint16_t x;
+        memcpy(&x, ptr, sizeof(x));
+        return _mm_cvtsi32_si128(x);
+    }
+
+    //  "uv" is [U0, V0, U1, V1].
+    PA_FORCE_INLINE void store(uint32_t* out, __m128i y, __m128i uv) const{
+        __m128i u = _mm_shuffle_epi32(uv, 0xa0);
+        __m128i v = _mm_shuffle_epi32(uv, 0xf5);
+        _mm_storeu_si128((__m128i*)out, convert(y, u, v));
+    }
+
+    PA_FORCE_INLINE __m128i convert(__m128i y, __m128i u, __m128i v) const{
+        y = _mm_mullo_epi32(_mm_sub_epi32(y, m_y_offset), m_y_scale);
+        y = _mm_add_epi32(y, _mm_set1_epi32(1 << (YUV_TO_RGB_SHIFT - 1)));
+        u = _mm_sub_epi32(u, _mm_set1_epi32(128));
+        v = _mm_sub_epi32(v, _mm_set1_epi32(128));
+
+        __m128i r = _mm_add_epi32(y, _mm_mullo_epi32(v, m_v_to_r));
+        __m128i g = _mm_sub_epi32(y, _mm_mullo_epi32(u, m_u_to_g));
+        g = _mm_sub_epi32(g, _mm_mullo_epi32(v, m_v_to_g));
+        __m128i b = _mm_add_epi32(y, _mm_mullo_epi32(u, m_u_to_b));
+
+        r = clamp(_mm_srai_epi32(r, YUV_TO_RGB_SHIFT));
+        g = clamp(_mm_srai_epi32(g, YUV_TO_RGB_SHIFT));
+        b = clamp(_mm_srai_epi32(b, YUV_TO_RGB_SHIFT));
+
+        __m128i pixel = _mm_or_si128(_mm_slli_epi32(r, 16), _mm_slli_epi32(g, 8));
+        pixel = _mm_or_si128(pixel, b);
+        return _mm_or_si128(pixel, _mm_set1_epi32(0xff000000));
+    }
+    static PA_FORCE_INLINE __m128i clamp(__m128i x){
+        x = _mm_max_epi32(x, _mm_setzero_si128());
+        return _mm_min_epi32(x, _mm_set1_epi32(255));
+    }
+
+private:
+    __m128i m_y_offset;
+    __m128i m_y_scale;
+    __m128i m_v_to_r;
+    __m128i m_u_to_g;
+    __m128i m_v_to_g;
+    __m128i m_u_to_b;
+};
+
+
+void convert_yuv_to_rgb32_x64_SSE41(
+    const YUVFrameView& frame,
+    uint32_t* image, size_t bytes_per_row,
+    const YUVToRGBCoefficients& coefficients
+){
+    yuv_to_rgb32_frame<YUVToRGB32_x64_SSE41>(frame, image, bytes_per_row, coefficients);
+}
+
+
+
+}
+}
+#endif
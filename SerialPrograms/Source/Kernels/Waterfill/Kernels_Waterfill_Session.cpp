@@ -106,6 +106,21 @@ std::unique_ptr<WaterfillSession> make_WaterfillSession(PackedBinaryMatrix_IB& m
     }
 }
 
+WaterfillSession& thread_local_WaterfillSession(PackedBinaryMatrix_IB& matrix){
+    //  One session per matrix format. Almost everything uses the default
+    //  format so a thread normally ends up with just one.
+    constexpr size_t FORMATS = (size_t)BinaryMatrixType::arm64x8_x64_NEON + 1;
+    thread_local std::unique_ptr<WaterfillSession> sessions[FORMATS];
+
+    std::unique_ptr<WaterfillSession>& session = sessions[(size_t)matrix.type()];
+    if (session){
+        session->set_source(matrix);
+    }else{
+        session = make_WaterfillSession(matrix);
+    }
+    return *session;
+}
+
 
 
 }
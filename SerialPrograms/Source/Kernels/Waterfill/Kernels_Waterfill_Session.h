@@ -28,6 +28,11 @@ public:
 
     virtual std::unique_ptr<WaterfillIterator> make_iterator(size_t min_area) = 0;
 
+    //  Rewind and return the iterator owned by this session. Unlike
+    //  "make_iterator()" this does not allocate. The iterator is restarted by
+    //  the next call to "reset_iterator()".
+    virtual WaterfillIterator& reset_iterator(size_t min_area) = 0;
+
     //  Get the object at the specific bit position.
     //  The object will be removed from the input matrix.
     //  Return true if there is an object at the bit (x, y); false otherwise.
@@ -37,10 +42,25 @@ public:
         size_t x, size_t y
     ) = 0;
 
+    //  # of times this session has grown its own storage: its scratch
+    //  buffers, a new object matrix or an object's tile storage. Once warmed
+    //  up, this stays flat for frames that are no larger than any previous
+    //  one. This is not a count of heap allocations. Anything else the
+    //  caller or the iterator allocates is not included.
+    virtual size_t buffer_growths() const = 0;
+
 };
 std::unique_ptr<WaterfillSession> make_WaterfillSession();
 std::unique_ptr<WaterfillSession> make_WaterfillSession(PackedBinaryMatrix_IB& matrix);
 
+//  Return the calling thread's session for the format of "matrix", already
+//  pointed at "matrix". The session and its scratch buffers are kept for the
+//  life of the thread, so per-frame detectors stop re-creating them once
+//  warmed up.
+//  The next call on the same thread re-targets the session. So do not hold on
+//  to it across code that may also call this.
+WaterfillSession& thread_local_WaterfillSession(PackedBinaryMatrix_IB& matrix);
+
 
 
 class WaterfillIterator{
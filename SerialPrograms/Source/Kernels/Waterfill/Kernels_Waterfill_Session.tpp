@@ -7,8 +7,7 @@
 #ifndef PokemonAutomation_Kernels_Waterfill_Session_TPP
 #define PokemonAutomation_Kernels_Waterfill_Session_TPP
 
-#include <set>
-#include <map>
+#include <algorithm>
 #include "Common/Cpp/Exceptions.h"
 #include "Kernels/Kernels_BitSet.h"
 #include "Kernels/BinaryMatrix/Kernels_BinaryMatrix_t.h"
@@ -47,6 +46,32 @@ namespace Waterfill{
 // TileRoutines are defined as struct `Waterfill_<TILE_SHAPE>_<CPU_BRAND>_<CPU_ARCH>`, e.g. `Waterfill_64x8_x64_SSE42`.
 // For each SIMD implementation, there is this waterfill routine struct defined in header file
 // Waterfill/Kernels_Waterfill_Core_<TILE_SHAPE>_<CPU_BRAND>_<CPU_ARCH>.h
+template <typename Tile, typename TileRoutines>
+class WaterfillSession_t;
+
+
+template <typename Tile, typename TileRoutines>
+class WaterfillIterator_t final : public WaterfillIterator{
+public:
+    WaterfillIterator_t(WaterfillSession_t<Tile, TileRoutines>& session, size_t min_area)
+        : m_session(session)
+        , m_min_area(min_area)
+    {}
+    void reset(size_t min_area){
+        m_min_area = min_area;
+        m_tile_row = 0;
+        m_tile_col = 0;
+    }
+    virtual bool find_next(WaterfillObject& object, bool keep_object) override;
+
+private:
+    WaterfillSession_t<Tile, TileRoutines>& m_session;
+    size_t m_min_area;
+    size_t m_tile_row = 0;
+    size_t m_tile_col = 0;
+};
+
+
 template <typename Tile, typename TileRoutines>
 class WaterfillSession_t final : public WaterfillSession{
 public:
@@ -56,14 +81,22 @@ public:
         , m_object(source.width(), source.height())
         , m_busy_tiles(source.tile_width(), source.tile_height())
         , m_object_tiles(source.tile_width(), source.tile_height())
+        , m_buffer_growths(1)
     {}
 
     void set_source(PackedBinaryMatrixCore<Tile>& source){
         m_source = &source;
+
+        //  The scratch buffers only grow. So re-targeting the session at a
+        //  matrix that is no larger than any previous one does not allocate.
         if (m_object.width() < source.width() || m_object.height() < source.height()){
-            m_object = PackedBinaryMatrixCore<Tile>(source.width(), source.height());
-            m_busy_tiles = BitSet2D(source.width(), source.height());
-            m_object_tiles = BitSet2D(source.width(), source.height());
+            m_object = PackedBinaryMatrixCore<Tile>(
+                std::max(m_object.width(), source.width()),
+                std::max(m_object.height(), source.height())
+            );
+            m_busy_tiles = BitSet2D(m_object.tile_width(), m_object.tile_height());
+            m_object_tiles = BitSet2D(m_object.tile_width(), m_object.tile_height());
+            m_buffer_growths++;
         }
     }
     virtual void set_source(PackedBinaryMatrix_IB& source) override{
@@ -79,6 +112,11 @@ public:
     size_t tile_height() const{ return m_source->tile_height(); }
 
     virtual std::unique_ptr<WaterfillIterator> make_iterator(size_t min_area) override;
+    virtual WaterfillIterator& reset_iterator(size_t min_area) override;
+
+    virtual size_t buffer_growths() const override{
+        return m_buffer_growths;
+    }
 
     //  Get the object at the specific bit position.
     //  The object will be removed from the input matrix.
@@ -127,25 +165,11 @@ private:
     //  Reused scratch buffers. Only used inside "find_object()".
     BitSet2D m_busy_tiles;
     BitSet2D m_object_tiles;
-};
-
 
+    size_t m_buffer_growths = 0;
 
-
-template <typename Tile, typename TileRoutines>
-class WaterfillIterator_t final : public WaterfillIterator{
-public:
-    WaterfillIterator_t(WaterfillSession_t<Tile, TileRoutines>& session, size_t min_area)
-        : m_session(session)
-        , m_min_area(min_area)
-    {}
-    virtual bool find_next(WaterfillObject& object, bool keep_object) override;
-
-private:
-    WaterfillSession_t<Tile, TileRoutines>& m_session;
-    size_t m_min_area;
-    size_t m_tile_row = 0;
-    size_t m_tile_col = 0;
+    //  The iterator handed out by "reset_iterator()".
+    WaterfillIterator_t<Tile, TileRoutines> m_iterator{*this, 0};
 };
 
 
@@ -156,6 +180,11 @@ template <typename Tile, typename TileRoutines>
 std::unique_ptr<WaterfillIterator> WaterfillSession_t<Tile, TileRoutines>::make_iterator(size_t min_area){
     return std::make_unique<WaterfillIterator_t<Tile, TileRoutines>>(*this, min_area);
 }
+template <typename Tile, typename TileRoutines>
+WaterfillIterator& WaterfillSession_t<Tile, TileRoutines>::reset_iterator(size_t min_area){
+    m_iterator.reset(min_area);
+    return m_iterator;
+}
 
 
 template <typename Tile, typename TileRoutines>
@@ -168,9 +197,6 @@ bool WaterfillSession_t<Tile, TileRoutines>::find_object_on_bit(
         return false;
     }
 
-    std::set<TileIndex> busy;
-    std::map<TileIndex, Tile> obj;
-
     size_t tile_x = x / PackedBinaryMatrixCore<Tile>::Tile::WIDTH;
     size_t tile_y = y / PackedBinaryMatrixCore<Tile>::Tile::HEIGHT;
     size_t bit_x = x % PackedBinaryMatrixCore<Tile>::Tile::WIDTH;
@@ -313,9 +339,20 @@ bool WaterfillSession_t<Tile, TileRoutines>::find_object(
     stats.body_x = tile_x * Tile::WIDTH + bit_x;
     stats.body_y = tile_y * Tile::HEIGHT + bit_y;
 
-    std::unique_ptr<std::map<TileIndex, Tile>> sparse_set;
+    //  Write the object into the matrix left over from the caller's previous
+    //  object if there is one. This recycles its tile storage so a caller
+    //  that reuses one WaterfillObject across "find_next()" calls does not
+    //  allocate per object.
+    SparseBinaryMatrixCore<Tile>* sparse_set = nullptr;
+    size_t sparse_capacity = 0;
     if (keep_object){
-        sparse_set = std::make_unique<std::map<TileIndex, Tile>>();
+        if (!object.object || object.object->type() != Tile::TYPE){
+            object.object = std::make_unique<SparseBinaryMatrix_t<Tile>>();
+            m_buffer_growths++;
+        }
+        sparse_set = &static_cast<SparseBinaryMatrix_t<Tile>&>(*object.object).get();
+        sparse_set->reset(m_source->width(), m_source->height());
+        sparse_capacity = sparse_set->tile_capacity();
     }
 
     while (m_object_tiles.pop(x, y)){
@@ -323,7 +360,7 @@ bool WaterfillSession_t<Tile, TileRoutines>::find_object(
         Tile& recorded_tile = m_object.tile(x, y);
 
         if (sparse_set){
-            (*sparse_set)[TileIndex{x, y}] = recorded_tile;
+            sparse_set->append_tile(TileIndex{x, y}, recorded_tile);
         }
 
         // Get sum of (x,y) location of the 1-bits in the tile into (sum_x, sum_y)
@@ -363,14 +400,16 @@ bool WaterfillSession_t<Tile, TileRoutines>::find_object(
     cout << "sum y = " << stats.m_sum_y << endl;
 #endif
 
-    object = stats;
-
     if (sparse_set){
-        auto ptr = std::make_unique<SparseBinaryMatrix_t<Tile>>(m_source->width(), m_source->height());
-        ptr->get().set_data(std::move(*sparse_set));
-        object.object = std::move(ptr);
+        sparse_set->finish_append();
+        if (sparse_set->tile_capacity() != sparse_capacity){
+            m_buffer_growths++;
+        }
     }
 
+    //  This leaves "object.object" alone since "stats" has none.
+    object = stats;
+
     return true;
 }
 
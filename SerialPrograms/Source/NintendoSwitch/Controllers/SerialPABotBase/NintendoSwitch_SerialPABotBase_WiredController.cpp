@@ -8,7 +8,6 @@
 #include "CommonFramework/Options/Environment/ThemeSelectorOption.h"
 #include "Controllers/SerialPABotBase/SerialPABotBase.h"
 #include "Controllers/SerialPABotBase/SerialPABotBase_Routines_Protocol.h"
-#include "Controllers/SerialPABotBase/SerialPABotBase_Routines_NS2_WiredController.h"
 #include "NintendoSwitch_SerialPABotBase_WiredController.h"
 
 //#include <iostream>
@@ -36,6 +35,7 @@ SerialPABotBase_WiredController::SerialPABotBase_WiredController(
         connection
     )
     , m_controller_type(controller_type)
+    , m_batch(m_serial)
 {
     using namespace SerialPABotBase;
 
@@ -62,6 +62,12 @@ SerialPABotBase_WiredController::SerialPABotBase_WiredController(
         throw SerialProtocolException(logger, PA_CURRENT_FUNCTION, "Failed to set controller type.");
     }
 
+    m_batch.set_capacity(
+        connection.supports_command_batches()
+            ? PABB_NS2_WIRED_CONTROLLER_STATE_BATCH_SIZE
+            : 1
+    );
+
     m_status_thread.reset(new SerialPABotBase::ControllerStatusThread(
         connection, *this
     ));
@@ -165,24 +171,32 @@ void SerialPABotBase_WiredController::execute_state(
     }
     dpad_byte |= dpad;
 
-    //  Divide the controller state into smaller chunks that fit into the report
-    //  duration.
-    Milliseconds time_left = std::chrono::duration_cast<Milliseconds>(entry.duration);
-
-    while (time_left > Milliseconds::zero()){
-        Milliseconds current = std::min(time_left, 65535ms);
-        m_serial->issue_request(
-            SerialPABotBase::DeviceRequest_NS2_WiredController_ControllerStateMs(
-                (uint16_t)current.count(),
-                buttons,
-                dpad_byte,
-                controller_state.left_stick_x, controller_state.left_stick_y,
-                controller_state.right_stick_x, controller_state.right_stick_y
-            ),
-            cancellable
-        );
-        time_left -= current;
-    }
+    pabb_NintendoSwitch2_WiredController_State report;
+    report.buttons0 = (uint8_t)buttons;
+    report.buttons1 = (uint8_t)(buttons >> 8);
+    report.dpad_byte = dpad_byte;
+    report.left_joystick_x = controller_state.left_stick_x;
+    report.left_joystick_y = controller_state.left_stick_y;
+    report.right_joystick_x = controller_state.right_stick_x;
+    report.right_joystick_y = controller_state.right_stick_y;
+
+    //  The batch splits this into chunks that fit into the report duration.
+    m_batch.push(
+        cancellable,
+        std::chrono::duration_cast<Milliseconds>(entry.duration),
+        report
+    );
+}
+void SerialPABotBase_WiredController::execute_schedule(
+    const Cancellable* cancellable,
+    const SuperscalarScheduler::Schedule& schedule
+){
+    m_batch.execute_schedule(
+        cancellable, schedule,
+        [this](const Cancellable* cancellable, const SuperscalarScheduler::ScheduleEntry& entry){
+            execute_state(cancellable, entry);
+        }
+    );
 }
 
 
@@ -7,7 +7,10 @@
 #ifndef PokemonAutomation_NintendoSwitch_SerialPABotBase_WiredControllerNS1_H
 #define PokemonAutomation_NintendoSwitch_SerialPABotBase_WiredControllerNS1_H
 
+#include "Common/SerialPABotBase/SerialPABotBase_Messages_NS2_WiredController.h"
 #include "Controllers/SerialPABotBase/SerialPABotBase_StatusThread.h"
+#include "Controllers/SerialPABotBase/SerialPABotBase_StateBatch.h"
+#include "Controllers/SerialPABotBase/SerialPABotBase_Routines_NS2_WiredController.h"
 #include "NintendoSwitch/NintendoSwitch_Settings.h"
 #include "NintendoSwitch/Controllers/NintendoSwitch_ProController.h"
 #include "NintendoSwitch_SerialPABotBase_Controller.h"
@@ -233,11 +236,22 @@ private:
         const Cancellable* cancellable,
         const SuperscalarScheduler::ScheduleEntry& entry
     ) override;
+    virtual void execute_schedule(
+        const Cancellable* cancellable,
+        const SuperscalarScheduler::Schedule& schedule
+    ) override;
 
 
 private:
     const ControllerType m_controller_type;
     std::unique_ptr<SerialPABotBase::ControllerStatusThread> m_status_thread;
+
+    SerialPABotBase::ControllerStateSender<
+        SerialPABotBase::pabb_NS2_WiredController_TimedState,
+        PABB_NS2_WIRED_CONTROLLER_STATE_BATCH_SIZE,
+        SerialPABotBase::DeviceRequest_NS2_WiredController_ControllerStateMs,
+        SerialPABotBase::DeviceRequest_NS2_WiredController_ControllerStateBatch
+    > m_batch;
 };
 
 
@@ -7,7 +7,6 @@
 #include "CommonFramework/Options/Environment/ThemeSelectorOption.h"
 #include "Controllers/SerialPABotBase/SerialPABotBase.h"
 #include "Controllers/SerialPABotBase/SerialPABotBase_Routines_Protocol.h"
-#include "Controllers/SerialPABotBase/SerialPABotBase_Routines_NS1_WirelessControllers.h"
 #include "NintendoSwitch_SerialPABotBase_WirelessController.h"
 
 //#include <iostream>
@@ -37,6 +36,7 @@ SerialPABotBase_WirelessController::SerialPABotBase_WirelessController(
         connection
     )
     , m_controller_type(controller_type)
+    , m_batch(m_serial)
 {
     using namespace SerialPABotBase;
 
@@ -65,6 +65,12 @@ SerialPABotBase_WirelessController::SerialPABotBase_WirelessController(
         throw SerialProtocolException(logger, PA_CURRENT_FUNCTION, "Failed to set controller type.");
     }
 
+    m_batch.set_capacity(
+        connection.supports_command_batches()
+            ? PABB_NS1_WIRELESS_CONTROLLER_BUTTONS_BATCH_SIZE
+            : 1
+    );
+
     m_status_thread.reset(new SerialPABotBase::ControllerStatusThread(
         connection, *this
     ));
@@ -225,20 +231,12 @@ void SerialPABotBase_WirelessController::issue_report(
     //  We will not do any throttling or timing adjustments here. We'll defer
     //  to the microcontroller to do that for us.
 
-    //  Divide the controller state into smaller chunks of 65535 milliseconds.
-    Milliseconds time_left = std::chrono::duration_cast<Milliseconds>(duration);
-
-    while (time_left > Milliseconds::zero()){
-        Milliseconds current = std::min(time_left, 65535ms);
-        m_serial->issue_request(
-            SerialPABotBase::MessageControllerStateButtons(
-                (uint16_t)current.count(),
-                buttons
-            ),
-            cancellable
-        );
-        time_left -= current;
-    }
+    //  The batch splits this into chunks of 65535 milliseconds.
+    m_batch.push(
+        cancellable,
+        std::chrono::duration_cast<Milliseconds>(duration),
+        buttons
+    );
 }
 void SerialPABotBase_WirelessController::issue_report(
     const Cancellable* cancellable,
@@ -288,6 +286,9 @@ void SerialPABotBase_WirelessController::issue_report(
     //  We will not do any throttling or timing adjustments here. We'll defer
     //  to the microcontroller to do that for us.
 
+    //  Gyro states can't be batched. Send everything before it first.
+    m_batch.flush(cancellable);
+
     //  Divide the controller state into smaller chunks of 65535 milliseconds.
     Milliseconds time_left = std::chrono::duration_cast<Milliseconds>(duration);
 
@@ -307,6 +308,21 @@ void SerialPABotBase_WirelessController::issue_report(
 
 
 
+void SerialPABotBase_WirelessController::execute_schedule(
+    const Cancellable* cancellable,
+    const SuperscalarScheduler::Schedule& schedule
+){
+    m_batch.execute_schedule(
+        cancellable, schedule,
+        [this](const Cancellable* cancellable, const SuperscalarScheduler::ScheduleEntry& entry){
+            execute_state(cancellable, entry);
+        }
+    );
+}
+
+
+
+
 void SerialPABotBase_WirelessController::update_status(Cancellable& cancellable){
     if (m_color_html.empty()){
         try{
@@ -9,7 +9,10 @@
 
 #include <cmath>
 #include "Common/ControllerStates/NintendoSwitch_WirelessController_State.h"
+#include "Common/SerialPABotBase/SerialPABotBase_Messages_NS1_WirelessControllers.h"
 #include "Controllers/SerialPABotBase/SerialPABotBase_StatusThread.h"
+#include "Controllers/SerialPABotBase/SerialPABotBase_StateBatch.h"
+#include "Controllers/SerialPABotBase/SerialPABotBase_Routines_NS1_WirelessControllers.h"
 #include "Controllers/JoystickTools.h"
 #include "NintendoSwitch/NintendoSwitch_Settings.h"
 #include "NintendoSwitch_SerialPABotBase_Controller.h"
@@ -129,6 +132,11 @@ protected:
         const pabb_NintendoSwitch_WirelessController_State0x30_Gyro& gyro
     );
 
+    virtual void execute_schedule(
+        const Cancellable* cancellable,
+        const SuperscalarScheduler::Schedule& schedule
+    ) override;
+
 
 private:
     virtual void update_status(Cancellable& cancellable) override;
@@ -141,6 +149,13 @@ private:
     std::unique_ptr<SerialPABotBase::ControllerStatusThread> m_status_thread;
 
     std::string m_color_html;
+
+    SerialPABotBase::ControllerStateSender<
+        pabb_NS1_WirelessController_TimedButtons,
+        PABB_NS1_WIRELESS_CONTROLLER_BUTTONS_BATCH_SIZE,
+        SerialPABotBase::MessageControllerStateButtons,
+        SerialPABotBase::MessageControllerStateButtonsBatch
+    > m_batch;
 };
 
 
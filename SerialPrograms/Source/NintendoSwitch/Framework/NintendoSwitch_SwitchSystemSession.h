@@ -33,6 +33,8 @@ namespace PokemonAutomation{
     class MemoryUtilizationStats;
     class CpuUtilizationStat;
     class ThreadUtilizationStat;
+    class OcrPoolStat;
+    class SerialLinkStat;
 namespace NintendoSwitch{
 
 class SwitchSystemOption;
@@ -94,6 +96,8 @@ private:
     std::unique_ptr<MemoryUtilizationStats> m_memory_usage;
     std::unique_ptr<CpuUtilizationStat> m_cpu_utilization;
     std::unique_ptr<ThreadUtilizationStat> m_main_thread_utilization;
+    std::unique_ptr<OcrPoolStat> m_ocr_pool;
+    std::unique_ptr<SerialLinkStat> m_serial_link;
 };
 
 
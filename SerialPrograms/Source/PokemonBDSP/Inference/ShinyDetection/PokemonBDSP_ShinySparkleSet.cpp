@@ -88,9 +88,9 @@ void ShinySparkleSetBDSP::update_alphas(){
 
 ShinySparkleSetBDSP find_sparkles(size_t screen_area, WaterfillSession& session){
     ShinySparkleSetBDSP sparkles;
-    auto finder = session.make_iterator(20);
+    WaterfillIterator& finder = session.reset_iterator(20);
     WaterfillObject object;
-    while (finder->find_next(object, true)){
+    while (finder.find_next(object, true)){
         PokemonSwSh::RadialSparkleDetector radial_sparkle(screen_area, object);
         if (radial_sparkle.is_ball()){
             sparkles.balls.emplace_back(object.min_x, object.min_y, object.max_x, object.max_y);
@@ -123,9 +123,8 @@ void ShinySparkleSetBDSP::read_from_image(size_t screen_area, const ImageViewRGB
     double best_alpha = 0;
     GlobalThreadPools::realtime_inference().run_in_parallel(
         [&](size_t index){
-            auto session = make_WaterfillSession();
-            session->set_source(matrices[index]);
-            ShinySparkleSetBDSP sparkles = find_sparkles(screen_area, *session);
+            WaterfillSession& session = thread_local_WaterfillSession(matrices[index]);
+            ShinySparkleSetBDSP sparkles = find_sparkles(screen_area, session);
             sparkles.update_alphas();
             double alpha = sparkles.alpha_overall();
 
@@ -8,6 +8,7 @@
 #include "CommonFramework/Notifications/ProgramNotifications.h"
 #include "CommonFramework/ProgramStats/StatsTracking.h"
 #include "CommonTools/Async/InferenceRoutines.h"
+#include "CommonTools/Audio/AudioTemplateCache.h"
 #include "NintendoSwitch/Commands/NintendoSwitch_Commands_PushButtons.h"
 #include "Pokemon/Pokemon_Strings.h"
 #include "PokemonLA/PokemonLA_Settings.h"
@@ -274,6 +275,9 @@ void ShinyHuntCustomPath::run_path(SingleSwitchProgramEnvironment& env, ProContr
 void ShinyHuntCustomPath::program(SingleSwitchProgramEnvironment& env, ProControllerContext& context){
     ShinyHuntCustomPath_Descriptor::Stats& stats = env.current_stats<ShinyHuntCustomPath_Descriptor::Stats>();
 
+    //  Load the shiny sound template while we travel to the start of the path.
+    AudioTemplateCache::instance().preload({"PokemonLA/ShinySound"}, {44100, 48000});
+
     //  Connect the controller.
     pbf_press_button(context, BUTTON_LCLICK, 5, 5);
 
@@ -5,8 +5,48 @@
  */
 
 
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDirIterator>
+#include <QImage>
+#include <QVideoFrame>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Containers/AlignedVector.tpp"
+#include "Common/Cpp/Json/JsonTools.h"
+#include "Common/Cpp/Json/JsonParser.h"
+#include "Common/Cpp/Concurrency/ComputationThreadPoolCore.h"
+#include "Common/Cpp/Concurrency/ComputationThreadPoolCore_SingleQueue.h"
+#include "CommonFramework/Globals.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "CommonFramework/Logging/FileWindowLogger.h"
+#include "CommonFramework/Logging/BinaryEventLog.h"
+#include "CommonFramework/ImageTools/ImageStats.h"
+#include "CommonFramework/ImageTools/ImageDiff.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "CommonFramework/VideoPipeline/Backends/QVideoFrameConversion.h"
+#include "CommonFramework/VideoPipeline/VideoSources/VideoSource_FileReplay.h"
+#include "CommonTools/ImageMatch/ExactImageMatcher.h"
+#include "CommonTools/ImageMatch/CroppedImageDictionaryMatcher.h"
+#include "CommonTools/ImageMatch/SilhouetteDictionaryMatcher.h"
+#include "CommonTools/OCR/OCR_TextMatcher.h"
+#include "CommonFramework/AudioPipeline/AudioFeed.h"
+#include "CommonFramework/AudioPipeline/AudioTemplate.h"
+#include "CommonFramework/AudioPipeline/Spectrum/SpectrumPreprocessor.h"
+#include "CommonFramework/Recording/StreamHistoryFrameCodec.h"
 #include "CommonTools/VisualDetectors/BlackBorderDetector.h"
+#include "Controllers/SerialPABotBase/Connection/BotBaseMessage.h"
+#include "Controllers/SerialPABotBase/Connection/PABotBaseConnection.h"
 #include "CommonFramework_Tests.h"
 #include "TestUtils.h"
 
@@ -29,4 +69,1358 @@ int test_CommonFramework_BlackBorderDetector(const ImageViewRGB32& image, bool t
 }
 
 
+namespace{
+
+//  Build an NV12 frame from an image. The colors only need to be roughly
+//  right since the regions are compared against the full conversion.
+QVideoFrame make_NV12_frame(const ImageViewRGB32& image){
+    const int width = (int)image.width() & ~1;
+    const int height = (int)image.height() & ~1;
+    QVideoFrame frame(QVideoFrameFormat(QSize(width, height), QVideoFrameFormat::Format_NV12));
+#if (QT_VERSION_MAJOR == 6) && (QT_VERSION_MINOR >= 8)
+    if (!frame.map(QtVideo::MapMode::WriteOnly)){
+#else
+    if (!frame.map(QVideoFrame::WriteOnly)){
+#endif
+        return QVideoFrame();
+    }
+    for (int r = 0; r < height; r++){
+        uint8_t* luma = frame.bits(0) + r * frame.bytesPerLine(0);
+        uint8_t* chroma = frame.bits(1) + (r / 2) * frame.bytesPerLine(1);
+        for (int c = 0; c < width; c++){
+            uint32_t pixel = image.pixel(c, r);
+            int red = (pixel >> 16) & 0xff;
+            int green = (pixel >> 8) & 0xff;
+            int blue = pixel & 0xff;
+            luma[c] = (uint8_t)((66 * red + 129 * green + 25 * blue + 128) / 256 + 16);
+            if (r % 2 == 0 && c % 2 == 0){
+                chroma[c + 0] = (uint8_t)((-38 * red - 74 * green + 112 * blue + 128) / 256 + 128);
+                chroma[c + 1] = (uint8_t)((112 * red - 94 * green - 18 * blue + 128) / 256 + 128);
+            }
+        }
+    }
+    frame.unmap();
+    return frame;
+}
+
+bool region_matches(QVideoFrameRegions& regions, const ImageViewRGB32& full, const ImagePixelBox& box){
+    ImageViewRGB32 region = regions.region(box);
+    if (region.width() != box.width() || region.height() != box.height()){
+        std::cerr << "Error: region (" << box.min_x << ", " << box.min_y << ", " << box.max_x << ", " << box.max_y
+                  << ") is " << region.width() << " x " << region.height() << std::endl;
+        return false;
+    }
+    for (size_t r = 0; r < box.height(); r++){
+        for (size_t c = 0; c < box.width(); c++){
+            if (region.pixel(c, r) != full.pixel(box.min_x + c, box.min_y + r)){
+                std::cerr << "Error: region (" << box.min_x << ", " << box.min_y << ", " << box.max_x << ", " << box.max_y
+                          << ") differs from the full frame at (" << c << ", " << r << ")" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+int test_CommonFramework_QVideoFrameRegions(const ImageViewRGB32& image){
+    QVideoFrame frame = make_NV12_frame(image);
+    if (!frame.isValid()){
+        std::cerr << "Error: Unable to build an NV12 frame." << std::endl;
+        return 1;
+    }
+    std::shared_ptr<const ImageRGB32> full = QVideoFrameRegions(frame).full_frame();
+    if (!full){
+        std::cerr << "Error: NV12 frame was not converted natively." << std::endl;
+        return 1;
+    }
+    const size_t width = full->width();
+    const size_t height = full->height();
+    if (width < 64 || height < 64){
+        std::cerr << "Error: Image is too small for this test." << std::endl;
+        return 1;
+    }
+
+    //  Every combination of odd and even edges, plus the frame borders.
+    std::vector<ImagePixelBox> boxes;
+    for (size_t start = 10; start < 12; start++){
+        for (size_t end = 40; end < 42; end++){
+            boxes.emplace_back(start, start, end, end);
+            boxes.emplace_back(start, start + 1, end + 1, end);
+        }
+    }
+    boxes.emplace_back(1, 1, 2, 2);
+    boxes.emplace_back(0, 0, width, height);
+    boxes.emplace_back(width - 3, height - 3, width, height);
+
+    //  Each box on its own frame so it is converted, not served from the cache.
+    for (const ImagePixelBox& box : boxes){
+        QVideoFrameRegions regions(frame);
+        if (!region_matches(regions, *full, box)){
+            return 1;
+        }
+    }
+
+    //  All of them on one frame so the later ones are cache hits.
+    QVideoFrameRegions regions(frame);
+    for (size_t pass = 0; pass < 2; pass++){
+        for (const ImagePixelBox& box : boxes){
+            if (!region_matches(regions, *full, box)){
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "Checked " << boxes.size() << " regions against the full frame." << std::endl;
+    return 0;
+}
+
+
+namespace{
+
+uint64_t sum_row(const ImageViewRGB32& image, size_t row){
+    uint64_t sum = 0;
+    for (size_t c = 0; c < image.width(); c++){
+        sum += image.pixel(c, row) & 0x00ffffff;
+    }
+    return sum;
+}
+
+//  Simulate several consoles hammering the same pool. Each one runs small
+//  "run_in_parallel()" calls over the rows of the image and dispatches a few
+//  standalone tasks. Returns the time in milliseconds, or -1 on a wrong result.
+template <typename PoolCore>
+double benchmark_thread_pool(const ImageViewRGB32& image, size_t consoles, size_t iterations, bool nested){
+    const size_t height = image.height();
+    uint64_t expected = 0;
+    for (size_t r = 0; r < height; r++){
+        expected += sum_row(image, r);
+    }
+
+    PoolCore pool(nullptr, 0, std::thread::hardware_concurrency());
+    std::atomic<bool> ok(true);
+
+    WallClock time_start = current_time();
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < consoles; t++){
+        threads.emplace_back([&]{
+            std::vector<uint64_t> rows(height);
+            for (size_t iter = 0; iter < iterations; iter++){
+                if (nested){
+                    //  Split the image in half, then each half into rows.
+                    pool.run_in_parallel([&](size_t half){
+                        size_t start = half * height / 2;
+                        size_t end = (half + 1) * height / 2;
+                        pool.run_in_parallel([&](size_t r){
+                            rows[r] = sum_row(image, r);
+                        }, start, end, 1);
+                    }, 0, 2, 1);
+                }else{
+                    pool.run_in_parallel([&](size_t r){
+                        rows[r] = sum_row(image, r);
+                    }, 0, height, 1);
+                }
+                uint64_t total = 0;
+                for (uint64_t x : rows){
+                    total += x;
+                }
+                if (total != expected){
+                    ok.store(false);
+                }
+
+                std::atomic<uint64_t> task_sum(0);
+                std::function<void()> func = [&]{ task_sum += sum_row(image, 0); };
+                std::unique_ptr<AsyncTask> task = pool.try_dispatch(func);
+                if (task){
+                    task->wait_and_rethrow_exceptions();
+                }else{
+                    func();
+                }
+                if (task_sum.load() != sum_row(image, 0)){
+                    ok.store(false);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads){
+        thread.join();
+    }
+    WallClock time_end = current_time();
+
+    if (!ok.load()){
+        return -1;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count() / 1000.;
+}
+
+}
+
+int test_CommonFramework_ComputationThreadPool(const ImageViewRGB32& image){
+    if (image.height() < 2){
+        std::cerr << "Error: image is too small." << std::endl;
+        return 1;
+    }
+
+    const size_t consoles = 4;
+    const size_t iterations = 500;
+    std::cout << "Image: " << image.width() << " x " << image.height()
+              << ", " << consoles << " consoles, " << iterations << " iterations each" << std::endl;
+
+    double single_queue = benchmark_thread_pool<ComputationThreadPoolCore_SingleQueue>(image, consoles, iterations, false);
+    double work_stealing = benchmark_thread_pool<ComputationThreadPoolCore>(image, consoles, iterations, false);
+    double nested = benchmark_thread_pool<ComputationThreadPoolCore>(image, consoles, iterations, true);
+
+    if (single_queue < 0 || work_stealing < 0 || nested < 0){
+        std::cerr << "Error: thread pool returned the wrong result." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Single queue:  " << single_queue << " ms" << std::endl;
+    std::cout << "Work stealing: " << work_stealing << " ms" << std::endl;
+    std::cout << "Work stealing (nested): " << nested << " ms" << std::endl;
+
+    return 0;
+}
+
+
+
+namespace{
+
+class TestCroppedMatcher : public ImageMatch::CroppedImageDictionaryMatcher{
+protected:
+    virtual std::vector<ImageViewRGB32> get_crop_candidates(const ImageViewRGB32& image) const override{
+        std::vector<ImageViewRGB32> ret{image};
+        if (image.width() > 4 && image.height() > 4){
+            ret.emplace_back(image.sub_image(1, 1, image.width() - 2, image.height() - 2));
+        }
+        return ret;
+    }
+};
+
+bool same_results(const ImageMatch::ImageMatchResult& x, const ImageMatch::ImageMatchResult& y){
+    if (x.results == y.results){
+        return true;
+    }
+    std::cerr << "Error: pruned and exhaustive results differ." << std::endl;
+    for (const auto& item : x.results){
+        std::cerr << "    pruned:     " << item.first << " : " << item.second << std::endl;
+    }
+    for (const auto& item : y.results){
+        std::cerr << "    exhaustive: " << item.first << " : " << item.second << std::endl;
+    }
+    return false;
+}
+
+}
+
+int test_CommonFramework_ImageDictionaryMatcher(const ImageViewRGB32& image){
+    const size_t width = image.width();
+    const size_t height = image.height();
+    if (width < 32 || height < 32){
+        std::cerr << "Error: image is too small." << std::endl;
+        return 1;
+    }
+
+    //  Build the dictionaries out of pieces of the image. Some of them get a
+    //  transparent corner so the alpha handling is exercised.
+    const size_t templates = 200;
+    TestCroppedMatcher cropped;
+    ImageMatch::SilhouetteDictionaryMatcher silhouette;
+    std::vector<ImageViewRGB32> queries;
+    uint64_t seed = 1;
+    auto random = [&](size_t limit){
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        return (size_t)(seed >> 33) % limit;
+    };
+    for (size_t c = 0; c < templates; c++){
+        size_t w = 8 + random(width / 4);
+        size_t h = 8 + random(height / 4);
+        ImageViewRGB32 piece = image.sub_image(random(width - w), random(height - h), w, h);
+        ImageRGB32 sprite = piece.copy();
+        if (c % 3 == 0){
+            for (size_t r = 0; r < h / 3; r++){
+                for (size_t x = 0; x < w / 3; x++){
+                    sprite.pixel(x, r) &= 0x00ffffff;
+                }
+            }
+        }
+        std::string slug = "template-" + std::to_string(c);
+        cropped.add(slug, sprite);
+        silhouette.add(slug, sprite);
+        if (c % 20 == 0){
+            queries.emplace_back(piece);
+        }
+    }
+    queries.emplace_back(image);
+
+    double pruned_ms = 0;
+    double exhaustive_ms = 0;
+    for (const ImageViewRGB32& query : queries){
+        for (double alpha_spread : {0., 5., 50.}){
+            auto time0 = current_time();
+            ImageMatch::ImageMatchResult pruned = cropped.match(query, alpha_spread);
+            auto time1 = current_time();
+            ImageMatch::ImageMatchResult exhaustive = cropped.match_exhaustive(query, alpha_spread);
+            auto time2 = current_time();
+            if (!same_results(pruned, exhaustive)){
+                return 1;
+            }
+            pruned_ms += std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count() / 1000.;
+            exhaustive_ms += std::chrono::duration_cast<std::chrono::microseconds>(time2 - time1).count() / 1000.;
+
+            if (!same_results(silhouette.match(query, alpha_spread), silhouette.match_exhaustive(query, alpha_spread))){
+                return 1;
+            }
+        }
+    }
+
+    std::cout << templates << " templates, " << queries.size() << " queries" << std::endl;
+    std::cout << "CroppedImageDictionaryMatcher exhaustive: " << exhaustive_ms << " ms" << std::endl;
+    std::cout << "CroppedImageDictionaryMatcher pruned:     " << pruned_ms << " ms" << std::endl;
+
+    return 0;
+}
+
+
+
+namespace{
+
+//  What "ExactImageMatcher" used to do: resize the image, scale a copy of the
+//  template and compare them.
+double three_pass_rmsd(
+    const ImageRGB32& sprite, const ImageStats& stats, const ImageViewRGB32& image,
+    Kernels::SumSquareMode mode, Color background
+){
+    ImageRGB32 scaled = image.scale_to(sprite.width(), sprite.height());
+    FloatPixel scale = ImageMatch::pixel_average(scaled, sprite) / stats.average;
+    if (std::isnan(scale.r)) scale.r = 1.0;
+    if (std::isnan(scale.g)) scale.g = 1.0;
+    if (std::isnan(scale.b)) scale.b = 1.0;
+    scale.bound(0.85, 1.15);
+
+    ImageRGB32 reference = sprite.copy();
+    ImageMatch::scale_brightness(reference, scale);
+    switch (mode){
+    case Kernels::SumSquareMode::REFERENCE_ALPHA:
+        return ImageMatch::pixel_RMSD(reference, scaled);
+    case Kernels::SumSquareMode::USE_BACKGROUND:
+        return ImageMatch::pixel_RMSD(reference, scaled, background);
+    case Kernels::SumSquareMode::ARBITRATE_ALPHAS:
+        return ImageMatch::pixel_RMSD_masked(reference, scaled);
+    }
+    return 0;
+}
+
+}
+
+int test_CommonFramework_ExactImageMatcher(const ImageViewRGB32& image){
+    const size_t width = image.width();
+    const size_t height = image.height();
+    if (width < 32 || height < 32){
+        std::cerr << "Error: image is too small." << std::endl;
+        return 1;
+    }
+
+    //  Real templates from the resources. Spread the picks over all of them.
+    std::vector<std::string> files;
+    QDirIterator iter(QString::fromStdString(RESOURCE_PATH()), {"*.png"}, QDir::Files, QDirIterator::Subdirectories);
+    while (iter.hasNext()){
+        files.emplace_back(iter.next().toStdString());
+    }
+    std::sort(files.begin(), files.end());
+    if (files.empty()){
+        std::cerr << "Error: no PNG files found in " << RESOURCE_PATH() << std::endl;
+        return 1;
+    }
+    const size_t MAX_TEMPLATES = 300;
+    const size_t step = (files.size() + MAX_TEMPLATES - 1) / MAX_TEMPLATES;
+
+    const Color background(0xff204060);
+    uint64_t seed = 1;
+    auto random = [&](size_t limit){
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        return (size_t)(seed >> 33) % limit;
+    };
+
+    size_t templates = 0;
+    size_t comparisons = 0;
+    double fused_ms = 0;
+    double three_pass_ms = 0;
+    for (size_t f = 0; f < files.size(); f += step){
+        ImageRGB32 sprite(files[f]);
+        if (!sprite || sprite.width() > width || sprite.height() > height){
+            continue;
+        }
+        templates++;
+        ImageStats stats = image_stats(sprite);
+        ImageMatch::ExactImageMatcher matcher(sprite.copy());
+
+        //  Crops smaller than, the same size as and larger than the template.
+        const std::pair<size_t, size_t> SIZES[] = {
+            {sprite.width(), sprite.height()},
+            {std::max<size_t>(sprite.width() * 2 / 3, 1), std::max<size_t>(sprite.height() * 3 / 4, 1)},
+            {std::min(sprite.width() * 3 / 2 + 1, width), std::min(sprite.height() * 5 / 3 + 1, height)},
+            {1 + random(width / 2), 1 + random(height / 2)},
+        };
+        for (const auto& size : SIZES){
+            ImageViewRGB32 crop = image.sub_image(
+                random(width - size.first + 1), random(height - size.second + 1),
+                size.first, size.second
+            );
+
+            auto time0 = current_time();
+            double fused[3] = {
+                matcher.rmsd(crop),
+                matcher.rmsd(crop, background),
+                matcher.rmsd_masked(crop),
+            };
+            auto time1 = current_time();
+            double expected[3] = {
+                three_pass_rmsd(sprite, stats, crop, Kernels::SumSquareMode::REFERENCE_ALPHA, background),
+                three_pass_rmsd(sprite, stats, crop, Kernels::SumSquareMode::USE_BACKGROUND, background),
+                three_pass_rmsd(sprite, stats, crop, Kernels::SumSquareMode::ARBITRATE_ALPHAS, background),
+            };
+            auto time2 = current_time();
+            fused_ms += std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count() / 1000.;
+            three_pass_ms += std::chrono::duration_cast<std::chrono::microseconds>(time2 - time1).count() / 1000.;
+
+            //  Both add up the same integers. So they must be identical.
+            for (size_t m = 0; m < 3; m++){
+                if (!(fused[m] == expected[m]) && !(std::isnan(fused[m]) && std::isnan(expected[m]))){
+                    std::cerr << "Error: " << files[f] << ", crop " << size.first << " x " << size.second
+                              << ", mode " << m << ": three passes = " << expected[m] << ", fused = " << fused[m] << std::endl;
+                    return 1;
+                }
+            }
+
+            //  The bounded version either gives up or returns exactly the same.
+            //  It may only give up when the result is over the bound.
+            for (double max_rmsd : {expected[0] * 0.5, expected[0] * 1.5 + 1}){
+                if (std::isnan(max_rmsd)){
+                    break;
+                }
+                double rmsd;
+                if (matcher.rmsd_bounded(rmsd, crop, max_rmsd)){
+                    if (rmsd != expected[0]){
+                        std::cerr << "Error: " << files[f] << ", bounded RMSD = " << rmsd
+                                  << ", expected " << expected[0] << std::endl;
+                        return 1;
+                    }
+                }else if (max_rmsd > expected[0]){
+                    std::cerr << "Error: " << files[f] << ", gave up below the bound " << max_rmsd
+                              << ", RMSD = " << expected[0] << std::endl;
+                    return 1;
+                }
+            }
+            comparisons++;
+        }
+    }
+
+    std::cout << templates << " templates from " << files.size() << " files, " << comparisons << " crops" << std::endl;
+    std::cout << "ExactImageMatcher three passes: " << three_pass_ms << " ms" << std::endl;
+    std::cout << "ExactImageMatcher fused:        " << fused_ms << " ms" << std::endl;
+
+    return 0;
+}
+
+
+
+int test_CommonFramework_OCRTextMatcher(const ImageViewRGB32& image){
+    uint64_t seed = 1;
+    auto random = [&](size_t limit){
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        return (size_t)(seed >> 33) % limit;
+    };
+    auto random_string = [&](size_t length, size_t alphabet){
+        std::u32string str;
+        for (size_t c = 0; c < length; c++){
+            str += (char32_t)('a' + random(alphabet));
+        }
+        return str;
+    };
+
+    //  Bit-parallel distance against the plain DP. Long candidates exercise
+    //  the multi-word path.
+    for (size_t c = 0; c < 20000; c++){
+        size_t alphabet = 1 + random(6);
+        std::u32string candidate = random_string(random(150), alphabet);
+        std::u32string text = random_string(random(40), alphabet);
+        size_t expected = OCR::levenshtein_distance_substring(candidate, text);
+        size_t actual = OCR::levenshtein_distance_substring(OCR::CompiledCandidate(candidate), text);
+        if (expected != actual){
+            std::cerr << "Error: distance mismatch. Length = " << candidate.size() << ", "
+                      << text.size() << ", Expected = " << expected << ", Actual = " << actual << std::endl;
+            return 1;
+        }
+    }
+
+    //  Compiled dictionary against the reference matcher.
+    std::map<std::u32string, std::set<std::string>> database;
+    for (size_t c = 0; c < 5000; c++){
+        database[random_string(4 + random(14), 26)].insert("token-" + std::to_string(c));
+    }
+    OCR::CompiledTextDictionary compiled(database);
+
+    double reference_ms = 0;
+    double compiled_ms = 0;
+    for (size_t c = 0; c < 200; c++){
+        auto iter = database.begin();
+        std::advance(iter, random(database.size()));
+        std::string text(iter->first.begin(), iter->first.end());
+        if (c % 5 != 0){
+            for (size_t e = 0; e < 3; e++){
+                size_t pos = random(text.size());
+                text[pos] = (char)('a' + random(26));
+            }
+            text = "xy" + text + "z";
+        }
+
+        for (double spread : {0., 0.5, 3.}){
+            auto time0 = current_time();
+            OCR::StringMatchResult expected = OCR::match_substring(database, 0.2, text, spread);
+            auto time1 = current_time();
+            OCR::StringMatchResult actual = compiled.match_substring(0.2, text, spread);
+            auto time2 = current_time();
+            reference_ms += std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count() / 1000.;
+            compiled_ms += std::chrono::duration_cast<std::chrono::microseconds>(time2 - time1).count() / 1000.;
+
+            bool same = expected.exact_match == actual.exact_match && expected.results.size() == actual.results.size();
+            for (auto iter0 = expected.results.begin(), iter1 = actual.results.begin(); same && iter0 != expected.results.end(); ++iter0, ++iter1){
+                same = iter0->first == iter1->first && iter0->second.token == iter1->second.token;
+            }
+            if (!same){
+                std::cerr << "Error: match mismatch on \"" << text << "\", spread = " << spread << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "match_substring() reference: " << reference_ms << " ms" << std::endl;
+    std::cout << "match_substring() compiled:  " << compiled_ms << " ms" << std::endl;
+
+    return 0;
+}
+
+
+
+int test_CommonFramework_JsonParser(const ImageViewRGB32& image){
+    //  Every JSON file in the resources, as loaded at startup.
+    std::vector<std::string> files;
+    size_t total_bytes = 0;
+    QDirIterator iter(QString::fromStdString(RESOURCE_PATH()), {"*.json"}, QDir::Files, QDirIterator::Subdirectories);
+    while (iter.hasNext()){
+        files.emplace_back(file_to_string(iter.next().toStdString()));
+        total_bytes += files.back().size();
+    }
+    std::cout << "Loaded " << files.size() << " JSON files, " << total_bytes << " bytes, from " << RESOURCE_PATH() << std::endl;
+    if (files.empty()){
+        std::cerr << "Error: no JSON files found." << std::endl;
+        return 1;
+    }
+
+    double nlohmann_ms = 0;
+    double direct_ms = 0;
+    for (const std::string& str : files){
+        auto time0 = current_time();
+        JsonValue expected = from_nlohmann(nlohmann::json::parse(str, nullptr, false));
+        auto time1 = current_time();
+        JsonValue actual = parse_json(str.data(), str.size());
+        auto time2 = current_time();
+        nlohmann_ms += std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count() / 1000.;
+        direct_ms += std::chrono::duration_cast<std::chrono::microseconds>(time2 - time1).count() / 1000.;
+
+        if (expected.type() != actual.type() || expected.dump() != actual.dump()){
+            std::cerr << "Error: parsed JSON does not match nlohmann." << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "nlohmann + from_nlohmann(): " << nlohmann_ms << " ms" << std::endl;
+    std::cout << "parse_json():               " << direct_ms << " ms" << std::endl;
+
+    return 0;
+}
+
+
+
+namespace{
+
+//  What the codec is expected to give back: each channel cut down to RGB565
+//  and expanded again.
+uint32_t reduce_rgb565(uint32_t pixel){
+    uint32_t r = (pixel >> 19) & 0x1f;
+    uint32_t g = (pixel >> 10) & 0x3f;
+    uint32_t b = (pixel >>  3) & 0x1f;
+    r = (r << 3) | (r >> 2);
+    g = (g << 2) | (g >> 4);
+    b = (b << 3) | (b >> 2);
+    return 0xff000000 | (r << 16) | (g << 8) | b;
+}
+bool same_as_rgb565(const ImageViewRGB32& decoded, const ImageViewRGB32& original){
+    if (!decoded || decoded.width() != original.width() || decoded.height() != original.height()){
+        return false;
+    }
+    for (size_t r = 0; r < original.height(); r++){
+        for (size_t c = 0; c < original.width(); c++){
+            if (decoded.pixel(c, r) != reduce_rgb565(original.pixel(c, r))){
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+int test_CommonFramework_StreamHistoryFrameCodec(const ImageViewRGB32& image){
+    if (image.width() < 16 || image.height() < 16){
+        std::cerr << "Error: image is too small." << std::endl;
+        return 1;
+    }
+    const size_t width = std::min<size_t>(image.width(), 320);
+    const size_t height = std::min<size_t>(image.height(), 180);
+    const size_t frame_count = 30;
+    const size_t keyframe_interval = 8;
+
+    //  Each frame is the image with a block moving across it so that the
+    //  delta frames have both changed and unchanged areas.
+    std::vector<ImageRGB32> originals;
+    std::vector<CompressedFrame> frames;
+    StreamHistoryFrameEncoder encoder;
+    WallClock timestamp = current_time();
+    for (size_t f = 0; f < frame_count; f++){
+        ImageRGB32 frame = image.sub_image(0, 0, width, height).copy();
+        size_t x0 = f * 7 % (width - 8);
+        size_t y0 = f * 5 % (height - 8);
+        for (size_t r = y0; r < y0 + 8; r++){
+            for (size_t c = x0; c < x0 + 8; c++){
+                frame.pixel(c, r) ^= 0x00ffffff;
+            }
+        }
+        frames.emplace_back(encoder.encode(timestamp, frame, f % keyframe_interval == 0));
+        originals.emplace_back(std::move(frame));
+        timestamp += std::chrono::milliseconds(33);
+    }
+
+    //  The whole history decodes.
+    {
+        StreamHistoryFrameDecoder decoder;
+        for (size_t f = 0; f < frame_count; f++){
+            if (!same_as_rgb565(decoder.decode(frames[f]), originals[f])){
+                std::cerr << "Error: frame " << f << " does not decode to the original." << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    //  A delta frame cannot start the history.
+    CompressedFrameHistory history;
+    if (history.push_back(std::make_shared<CompressedFrame>(frames[1])) || !history.empty()){
+        std::cerr << "Error: history accepted a delta frame with no keyframe." << std::endl;
+        return 1;
+    }
+    size_t total_bytes = 0;
+    for (const CompressedFrame& frame : frames){
+        history.push_back(std::make_shared<CompressedFrame>(frame));
+        total_bytes += frame.bytes();
+    }
+    if (history.bytes() != total_bytes){
+        std::cerr << "Error: history bytes = " << history.bytes() << ", expected " << total_bytes << "." << std::endl;
+        return 1;
+    }
+
+    //  Whatever is left after an eviction must start on a keyframe, account
+    //  for its bytes and decode from scratch as it does in "save()".
+    auto check_history = [&](const char* when) -> bool{
+        const CompressedFrameHistory::FrameList& list = history.frames();
+        size_t start = frame_count - list.size();
+        size_t bytes = 0;
+        StreamHistoryFrameDecoder decoder;
+        for (size_t f = start; f < frame_count; f++){
+            bytes += list[f - start]->bytes();
+            if (!same_as_rgb565(decoder.decode(*list[f - start]), originals[f])){
+                std::cerr << "Error: frame " << f << " does not decode after " << when << "." << std::endl;
+                return false;
+            }
+        }
+        if (!list.empty() && !list.front()->keyframe){
+            std::cerr << "Error: history does not start on a keyframe after " << when << "." << std::endl;
+            return false;
+        }
+        if (bytes != history.bytes()){
+            std::cerr << "Error: history bytes are off after " << when << "." << std::endl;
+            return false;
+        }
+        return true;
+    };
+
+    //  Nothing is old or over the limit.
+    history.clear_old(frames[0].timestamp, total_bytes);
+    if (history.frames().size() != frame_count){
+        std::cerr << "Error: history evicted frames within the window and the limit." << std::endl;
+        return 1;
+    }
+
+    //  Age out: a keyframe interval goes as soon as its keyframe is older than
+    //  the threshold, together with its delta frames that are not.
+    history.clear_old(frames[keyframe_interval + 1].timestamp, total_bytes);
+    if (history.frames().size() != frame_count - 2 * keyframe_interval || !check_history("aging out")){
+        std::cerr << "Error: aging out kept " << history.frames().size() << " frames." << std::endl;
+        return 1;
+    }
+
+    //  Over the memory limit: evict whole keyframe intervals until it fits.
+    history.clear_old(frames[0].timestamp, history.bytes() - 1);
+    if (history.frames().size() != frame_count - 3 * keyframe_interval || !check_history("going over the memory limit")){
+        std::cerr << "Error: memory limit kept " << history.frames().size() << " frames." << std::endl;
+        return 1;
+    }
+    history.clear_old(frames[0].timestamp, 0);
+    if (!history.empty() || history.bytes() != 0){
+        std::cerr << "Error: a zero memory limit did not empty the history." << std::endl;
+        return 1;
+    }
+
+    //  Evicting only part of a keyframe interval leaves delta frames with no
+    //  keyframe. They must be rejected instead of decoding to garbage.
+    {
+        StreamHistoryFrameDecoder decoder;
+        for (size_t f = 1; f < keyframe_interval; f++){
+            if (decoder.decode(frames[f])){
+                std::cerr << "Error: delta frame " << f << " decoded without its keyframe." << std::endl;
+                return 1;
+            }
+        }
+        if (!same_as_rgb565(decoder.decode(frames[keyframe_interval]), originals[keyframe_interval])){
+            std::cerr << "Error: decoder did not recover on the next keyframe." << std::endl;
+            return 1;
+        }
+    }
+
+    //  After a reset, the encoder must start over with a keyframe.
+    encoder.reset();
+    CompressedFrame after_reset = encoder.encode(timestamp, originals.back(), false);
+    StreamHistoryFrameDecoder decoder;
+    if (!after_reset.keyframe || !same_as_rgb565(decoder.decode(after_reset), originals.back())){
+        std::cerr << "Error: encoder did not restart with a keyframe after reset." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+
+
+namespace{
+
+bool same_spectrum(
+    const ProcessedSpectrum& actual,
+    const AudioSpectrum& spectrum,
+    SpectrumProcessingMode mode,
+    size_t freq_start, size_t freq_end
+){
+    const AlignedVector<float>& source = *spectrum.magnitudes;
+    std::vector<float> kernel = build_spike_kernel(source.size(), spectrum.sample_rate / 2);
+    std::pair<size_t, size_t> range = processed_spectrum_range(mode, freq_start, freq_end, kernel.size());
+
+    const float* expected = source.data();
+    AlignedVector<float> processed(range.second + 64);
+    if (mode != SpectrumProcessingMode::RAW){
+        memset(processed.data(), 0, processed.size() * sizeof(float));
+        process_spectrum(mode, processed.data(), source.data(), freq_start, freq_end, kernel);
+        expected = processed.data();
+    }
+
+    float norm_sqr = 0;
+    for (size_t c = range.first; c < range.second; c++){
+        if (actual.magnitudes->data()[c] != expected[c]){
+            return false;
+        }
+        norm_sqr += expected[c] * expected[c];
+    }
+    return actual.norm_sqr == norm_sqr;
+}
+
+}
+
+int test_CommonFramework_SpectrumPreprocessor(const ImageViewRGB32& image){
+    const size_t frequencies = 2048;
+    const size_t sample_rate = 48000;
+    const uint64_t spectrums = 1000;
+
+    uint64_t seed = 1;
+    std::vector<AudioSpectrum> feed;
+    for (uint64_t stamp = 0; stamp < spectrums; stamp++){
+        std::shared_ptr<AlignedVector<float>> magnitudes = std::make_shared<AlignedVector<float>>(frequencies);
+        for (size_t c = 0; c < frequencies; c++){
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            magnitudes->data()[c] = (float)(seed >> 40) / (float)(1 << 24);
+        }
+        feed.emplace_back(stamp, sample_rate, std::move(magnitudes));
+    }
+
+    const SpectrumProcessingMode modes[] = {
+        SpectrumProcessingMode::RAW,
+        SpectrumProcessingMode::SPIKE_CONV,
+        SpectrumProcessingMode::AVERAGE_5,
+    };
+    const size_t freq_start = 20;
+    const size_t freq_end = 1200;
+
+    SpectrumPreprocessor preprocessor;
+    for (SpectrumProcessingMode mode : modes){
+        //  A matcher keeping up with the feed.
+        std::shared_ptr<const ProcessedSpectrum> newest;
+        for (const AudioSpectrum& spectrum : feed){
+            newest = preprocessor.process(spectrum, mode, freq_start, freq_end);
+            if (!same_spectrum(*newest, spectrum, mode, freq_start, freq_end)){
+                std::cerr << "Error: spectrum " << spectrum.stamp << " was filtered incorrectly." << std::endl;
+                return 1;
+            }
+        }
+        if (preprocessor.process(feed.back(), mode, freq_start, freq_end) != newest){
+            std::cerr << "Error: the newest spectrum was not cached." << std::endl;
+            return 1;
+        }
+
+        //  A matcher that has fallen far behind gets the right result without
+        //  throwing out what the others are using.
+        const AudioSpectrum& stale = feed[100];
+        if (!same_spectrum(*preprocessor.process(stale, mode, freq_start, freq_end), stale, mode, freq_start, freq_end)){
+            std::cerr << "Error: stale spectrum was filtered incorrectly." << std::endl;
+            return 1;
+        }
+        if (preprocessor.process(feed.back(), mode, freq_start, freq_end) != newest){
+            std::cerr << "Error: a stale spectrum evicted the cache." << std::endl;
+            return 1;
+        }
+    }
+
+    //  After a reset, the stamps start over and must be cached again.
+    preprocessor.clear();
+    std::shared_ptr<const ProcessedSpectrum> first = preprocessor.process(feed[0], SpectrumProcessingMode::SPIKE_CONV, freq_start, freq_end);
+    if (preprocessor.process(feed[0], SpectrumProcessingMode::SPIKE_CONV, freq_start, freq_end) != first){
+        std::cerr << "Error: spectrums are not cached after clear()." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+
+
+int test_CommonFramework_FileWindowLogger(const ImageViewRGB32& image){
+    const size_t PRODUCERS = 8;
+    const size_t LINES_PER_PRODUCER = 20000;
+    const QString path = QDir::temp().filePath("PA-FileWindowLogger-Test.log");
+
+    for (LogOverflowPolicy policy : {LogOverflowPolicy::BLOCK, LogOverflowPolicy::DROP}){
+        const char* name = policy == LogOverflowPolicy::BLOCK ? "BLOCK" : "DROP";
+        QFile::remove(path);
+
+        //  A tiny ring so that the producers run into a full ring all the time.
+        uint64_t dropped;
+        uint64_t blocked;
+        {
+            FileWindowLogger logger(path.toStdString(), 16);
+            logger.set_overflow_policy(policy);
+
+            std::atomic<bool> go(false);
+            std::vector<std::thread> threads;
+            for (size_t p = 0; p < PRODUCERS; p++){
+                threads.emplace_back([&, p]{
+                    while (!go.load(std::memory_order_acquire));
+                    for (size_t c = 0; c < LINES_PER_PRODUCER; c++){
+                        logger.log("P" + std::to_string(p) + " " + std::to_string(c));
+                    }
+                });
+            }
+            go.store(true, std::memory_order_release);
+            for (std::thread& thread : threads){
+                thread.join();
+            }
+            dropped = logger.dropped_messages();
+            blocked = logger.blocked_messages();
+        }
+
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)){
+            std::cerr << "Error: " << name << ": unable to read the log file." << std::endl;
+            return 1;
+        }
+        std::string text = file.readAll().toStdString();
+        file.close();
+        QFile::remove(path);
+        if (text.compare(0, 3, "\xef\xbb\xbf") == 0){
+            text.erase(0, 3);
+        }
+
+        //  Each producer's lines must come out in order. Every line must be
+        //  either in the file or counted as dropped. The writer reports every
+        //  drop in the file.
+        std::vector<size_t> next(PRODUCERS, 0);
+        size_t written = 0;
+        uint64_t reported = 0;
+        std::istringstream stream(text);
+        std::string line;
+        while (std::getline(stream, line)){
+            if (!line.empty() && line.back() == '\r'){
+                line.pop_back();
+            }
+            size_t p, c;
+            char ch;
+            if (sscanf(line.c_str(), "P%zu %zu%c", &p, &c, &ch) == 2 && p < PRODUCERS){
+                if (c < next[p] || c >= LINES_PER_PRODUCER){
+                    std::cerr << "Error: " << name << ": \"" << line << "\" is out of order." << std::endl;
+                    return 1;
+                }
+                next[p] = c + 1;
+                written++;
+                continue;
+            }
+            unsigned long long count;
+            if (sscanf(line.c_str(), "Logger: %llu line(s) dropped.", &count) == 1){
+                reported += count;
+            }
+        }
+
+        std::cout << name << ": written = " << written << ", dropped = " << dropped
+             << ", reported dropped = " << reported << ", blocked = " << blocked << std::endl;
+        if (written + dropped != PRODUCERS * LINES_PER_PRODUCER || reported != dropped){
+            std::cerr << "Error: " << name << ": lines were lost or miscounted." << std::endl;
+            return 1;
+        }
+        if (policy == LogOverflowPolicy::BLOCK && dropped != 0){
+            std::cerr << "Error: BLOCK dropped lines." << std::endl;
+            return 1;
+        }
+        if (policy == LogOverflowPolicy::DROP && blocked != 0){
+            std::cerr << "Error: DROP blocked on a full ring." << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+
+int test_CommonFramework_AudioTemplateCache(const ImageViewRGB32& image){
+    const std::string path = QDir::temp().filePath("PA-AudioTemplateCache-Test.bin").toStdString();
+    const std::string source_hash = "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
+    const size_t sample_rate = 48000;
+
+    //  An odd # of frequencies so that every spectrum is padded.
+    AudioTemplate original(1001, 37);
+    for (size_t w = 0; w < original.numWindows(); w++){
+        float* window = original.getWindow(w);
+        for (size_t f = 0; f < original.numFrequencies(); f++){
+            window[f] = (float)(w * 1000 + f) / 7.f;
+        }
+    }
+
+    if (!saveAudioTemplateBinary(path, original, source_hash, sample_rate)){
+        std::cerr << "Error: unable to write " << path << std::endl;
+        return 1;
+    }
+
+    {
+        AudioTemplate loaded = loadAudioTemplateBinary(path, source_hash, sample_rate);
+        if (loaded.numFrequencies() != original.numFrequencies() || loaded.numWindows() != original.numWindows()){
+            std::cerr << "Error: loaded template is " << loaded.numFrequencies() << " x " << loaded.numWindows()
+                 << ", expected " << original.numFrequencies() << " x " << original.numWindows() << std::endl;
+            QFile::remove(QString::fromStdString(path));
+            return 1;
+        }
+        for (size_t w = 0; w < original.numWindows(); w++){
+            if (memcmp(loaded.getWindow(w), original.getWindow(w), original.numFrequencies() * sizeof(float)) != 0){
+                std::cerr << "Error: window " << w << " does not match after loading." << std::endl;
+                QFile::remove(QString::fromStdString(path));
+                return 1;
+            }
+        }
+    }
+
+    //  A cache file from a different source or sample rate must not be used.
+    if (loadAudioTemplateBinary(path, std::string(64, '0'), sample_rate).numFrequencies() != 0 ||
+        loadAudioTemplateBinary(path, source_hash, 44100).numFrequencies() != 0
+    ){
+        std::cerr << "Error: loaded a template for a different source or sample rate." << std::endl;
+        QFile::remove(QString::fromStdString(path));
+        return 1;
+    }
+
+    QByteArray file_data;
+    {
+        QFile file(QString::fromStdString(path));
+        if (!file.open(QIODevice::ReadOnly)){
+            std::cerr << "Error: unable to read " << path << std::endl;
+            return 1;
+        }
+        file_data = file.readAll();
+    }
+
+    //  Corrupt each field of the header in turn. Then truncate the file.
+    //  The second byte is flipped since a change to the low bits of the # of
+    //  frequencies can be lost in the padding.
+    const std::pair<size_t, const char*> FIELDS[] = {
+        {0, "magic"},
+        {8, "version"},
+        {12, "header size"},
+        {16, "sample rate"},
+        {24, "FFT length"},
+        {32, "FFT step"},
+        {40, "# of frequencies"},
+        {48, "# of windows"},
+        {56, "bytes per spectrum"},
+        {64, "source hash"},
+    };
+    auto rejects = [&](const QByteArray& data, const char* what){
+        {
+            QFile file(QString::fromStdString(path));
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(data) != data.size()){
+                std::cerr << "Error: unable to write " << path << std::endl;
+                return false;
+            }
+        }
+        if (loadAudioTemplateBinary(path, source_hash, sample_rate).numFrequencies() != 0){
+            std::cerr << "Error: loaded a template with a bad " << what << "." << std::endl;
+            return false;
+        }
+        return true;
+    };
+    bool ok = true;
+    for (const auto& field : FIELDS){
+        QByteArray data = file_data;
+        data[(qsizetype)field.first + 1] = (char)(data[(qsizetype)field.first + 1] ^ 1);
+        ok &= rejects(data, field.second);
+    }
+    ok &= rejects(file_data.left(file_data.size() - 4), "file size");
+    ok &= rejects(file_data.left(64), "header");
+
+    QFile::remove(QString::fromStdString(path));
+    return ok ? 0 : 1;
+}
+
+
+
+int test_CommonFramework_BinaryEventLog(const ImageViewRGB32& image){
+    //  Numbers are pulled out of the message, so the interesting cases are
+    //  the ones at the edges of what fits in an argument.
+    const std::vector<std::string> messages{
+        "",
+        "0",
+        "00",
+        "007",
+        "0000000000000000000000",
+        "Frame 123 of 456",
+        "Frame 123 of 456",
+        "Frame 124 of 456",
+        "x = -5, y = -0, z = -0012",
+        "999999999999999999",
+        "0999999999999999999",
+        "9223372036854775807",
+        "9223372036854775808",
+        "18446744073709551615",
+        "18446744073709551616",
+        "9999999999999999999",
+        "99999999999999999999999999999",
+        "000000000000000001",
+        "0000000000000000001",
+        "1.5e-10, 0x7f",
+        "Control \x01 and \x02 characters: \x01\x02 1\x01" "2",
+    };
+
+    std::vector<BinaryLogEvent> events;
+    WallClock time = current_time();
+    for (size_t c = 0; c < messages.size(); c++){
+        //  Timestamps may go backwards.
+        time += std::chrono::microseconds(c % 3 == 2 ? -1000 : 12345);
+        events.emplace_back(BinaryLogEvent{time, c % 2 ? "Tag A" : "Tag B", Color((uint32_t)(0xff000000 + c)), messages[c]});
+
+        //  Mostly the local time zone. A few in the middle are somewhere else
+        //  as if the clocks changed.
+        events.back().utc_offset = c >= 8 && c < 11
+            ? (int32_t)(c % 2 ? -9 * 3600 - 30 * 60 : 14 * 3600)
+            : local_utc_offset(time);
+    }
+
+    std::string encoded;
+    BinaryEventLogEncoder encoder;
+    encoder.start_session(encoded);
+    for (const BinaryLogEvent& event : events){
+        encoder.encode(encoded, event);
+    }
+
+    std::istringstream stream(encoded);
+    BinaryEventLogDecoder decoder(stream);
+    BinaryLogEvent decoded;
+    for (const BinaryLogEvent& event : events){
+        if (!decoder.next(decoded)){
+            std::cerr << "Error: stream ended early." << std::endl;
+            return 1;
+        }
+        if (decoded.message != event.message){
+            std::cerr << "Error: \"" << event.message << "\" decoded as \"" << decoded.message << "\"" << std::endl;
+            return 1;
+        }
+        if (decoded.tag != event.tag || decoded.color != event.color || decoded.utc_offset != event.utc_offset ||
+            std::chrono::duration_cast<std::chrono::microseconds>(decoded.timestamp - event.timestamp).count() != 0
+        ){
+            std::cerr << "Error: \"" << event.message << "\" decoded with the wrong tag, color, time or UTC offset." << std::endl;
+            return 1;
+        }
+
+        //  Must match the text log line no matter where it is decoded.
+        std::string expected = time_to_str_utc(event.timestamp + std::chrono::seconds(event.utc_offset))
+            + " - [" + event.tag + "]: " + event.message;
+        if (event.utc_offset == local_utc_offset(event.timestamp)){
+            std::string text_log = time_to_str(event.timestamp) + " - [" + event.tag + "]: " + event.message;
+            if (text_log != expected){
+                std::cerr << "Error: local time \"" << text_log << "\" does not match the UTC offset." << std::endl;
+                return 1;
+            }
+        }
+        if (decoded.to_log_line() != expected){
+            std::cerr << "Error: \"" << decoded.to_log_line() << "\", expected \"" << expected << "\"" << std::endl;
+            return 1;
+        }
+    }
+    if (decoder.next(decoded)){
+        std::cerr << "Error: extra event at end of stream." << std::endl;
+        return 1;
+    }
+
+    std::cout << events.size() << " events in " << encoded.size() << " bytes." << std::endl;
+    return 0;
+}
+
+
+
+namespace{
+
+//  Feeds everything that is sent straight back into the listeners, cut into
+//  uneven chunks so that messages straddle the reads.
+class LoopbackStream : public StreamConnection{
+public:
+    virtual void stop() override{}
+    virtual void send(const void* data, size_t bytes) override{
+        m_sends++;
+        const char* ptr = (const char*)data;
+        while (bytes > 0){
+            size_t chunk = std::min<size_t>(bytes, 1 + m_chunks++ % 37);
+            on_recv(ptr, chunk);
+            ptr += chunk;
+            bytes -= chunk;
+        }
+    }
+
+    size_t m_sends = 0;
+
+private:
+    size_t m_chunks = 0;
+};
+
+class LoopbackConnection : public PABotBaseConnection{
+public:
+    LoopbackConnection(Logger& logger, LoopbackStream* stream, size_t messages)
+        : PABotBaseConnection(logger, std::unique_ptr<StreamConnection>(stream))
+        , m_stream(*stream)
+        , m_sent_time(messages)
+    {}
+
+    void send(uint32_t id){
+        m_sent_time[id] = current_time();
+        send_message(make_message(id), false);
+    }
+    void send(SendBatch& batch, uint32_t id){
+        m_sent_time[id] = current_time();
+        batch.send_message(make_message(id), false);
+    }
+
+    static BotBaseMessage make_message(uint32_t id){
+        //  Vary the length to cover every body size.
+        std::string body(sizeof(uint32_t) + id % (PABB_PROTOCOL_MAX_PACKET_SIZE - PABB_PROTOCOL_OVERHEAD - sizeof(uint32_t) + 1), (char)id);
+        memcpy(&body[0], &id, sizeof(uint32_t));
+        return BotBaseMessage((uint8_t)(id % 128 + 1), std::move(body));
+    }
+
+    virtual void on_recv_message(BotBaseMessage message) override{
+        WallClock now = current_time();
+        uint32_t id;
+        memcpy(&id, message.body.data(), sizeof(uint32_t));
+        BotBaseMessage expected = make_message(id);
+        if (id != m_received || message.type != expected.type || message.body != expected.body){
+            m_ok = false;
+        }
+        m_received++;
+        m_total_latency += now - m_sent_time[id];
+    }
+
+    LoopbackStream& m_stream;
+    std::vector<WallClock> m_sent_time;
+    uint32_t m_received = 0;
+    WallDuration m_total_latency = WallDuration::zero();
+    bool m_ok = true;
+};
+
+}
+
+int test_CommonFramework_SerialLoopback(const ImageViewRGB32& image){
+    const uint32_t messages = 200000;
+    const uint32_t batch_size = 8;
+
+    auto run = [&](bool batched) -> bool{
+        LoopbackConnection connection(global_logger_command_line(), new LoopbackStream(), messages);
+
+        //  Line noise in front of the first message.
+        connection.send_zeros(3);
+
+        WallClock time_start = current_time();
+        if (batched){
+            for (uint32_t id = 0; id < messages; id += batch_size){
+                PABotBaseConnection::SendBatch batch(connection);
+                for (uint32_t c = id; c < std::min(id + batch_size, messages); c++){
+                    connection.send(batch, c);
+                }
+            }
+        }else{
+            for (uint32_t id = 0; id < messages; id++){
+                connection.send(id);
+            }
+        }
+        WallClock time_end = current_time();
+
+        if (!connection.m_ok || connection.m_received != messages){
+            std::cerr << "Error: received " << connection.m_received << " / " << messages << " messages correctly." << std::endl;
+            return false;
+        }
+
+        double seconds = std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count() / 1000000.;
+        double latency_us = std::chrono::duration_cast<std::chrono::nanoseconds>(connection.m_total_latency).count() / 1000. / messages;
+        std::cout << (batched ? "Batched:   " : "Unbatched: ")
+                  << messages / seconds << " messages/s, "
+                  << latency_us << " us/message latency, "
+                  << connection.m_stream.m_sends << " sends" << std::endl;
+        return true;
+    };
+
+    if (!run(false) || !run(true)){
+        return 1;
+    }
+
+    return 0;
+}
+
+
+
+int test_CommonFramework_VideoFileReplay(const ImageViewRGB32& image){
+    Logger& logger = global_logger_command_line();
+    QDir dir(QDir::temp().filePath("PA-VideoFileReplay-Test"));
+
+    //  Replace the contents of the directory with solid frames of these colors.
+    using FrameList = std::vector<std::pair<const char*, uint32_t>>;
+    auto write_frames = [&](const FrameList& frames){
+        dir.removeRecursively();
+        QDir().mkpath(dir.path());
+        for (const auto& frame : frames){
+            QImage qimage(16, 16, QImage::Format_ARGB32);
+            qimage.fill(frame.second);
+            if (!qimage.save(dir.filePath(frame.first))){
+                std::cerr << "Error: unable to write " << frame.first << std::endl;
+                return false;
+            }
+        }
+        return true;
+    };
+    auto check_frames = [&](const char* label, const std::vector<std::pair<const char*, int64_t>>& expected){
+        std::vector<FileReplayFrame> frames = list_replay_frames(logger, dir.path().toStdString());
+        bool ok = frames.size() == expected.size();
+        for (size_t c = 0; ok && c < frames.size(); c++){
+            ok &= QFileInfo(QString::fromStdString(frames[c].path)).fileName() == expected[c].first;
+            ok &= frames[c].offset == Milliseconds(expected[c].second);
+        }
+        if (!ok){
+            std::cerr << "Error: " << label << " frames are:" << std::endl;
+            for (const FileReplayFrame& frame : frames){
+                std::cerr << "    " << frame.path << " @ " << frame.offset.count() << " ms" << std::endl;
+            }
+        }
+        return ok;
+    };
+
+    //  Numbered names play in numeric order, starting at zero. Frames with
+    //  the same number keep their name order.
+    const FrameList numbered{
+        {"1000.png",        0xffff0000},
+        {"200.png",         0xff00ff00},
+        {"0050-start.png",  0xff0000ff},
+        {"200b.png",        0xffffffff},
+    };
+    if (!write_frames(numbered) || !check_frames("numbered", {
+        {"0050-start.png", 0},
+        {"200.png", 150},
+        {"200b.png", 150},
+        {"1000.png", 950},
+    })){
+        dir.removeRecursively();
+        return 1;
+    }
+
+    //  Otherwise they play in name order at 30 FPS. One name without a
+    //  number is enough.
+    if (!write_frames({{"b.png", 0xff000000}, {"a.png", 0xff000000}, {"c.png", 0xff000000}}) ||
+        !check_frames("unnumbered", {{"a.png", 0}, {"b.png", 33}, {"c.png", 66}}) ||
+        !write_frames({{"10.png", 0xff000000}, {"cover.png", 0xff000000}}) ||
+        !check_frames("partly numbered", {{"10.png", 0}, {"cover.png", 33}})
+    ){
+        dir.removeRecursively();
+        return 1;
+    }
+
+    //  As fast as possible: The next frame is shown only once the current
+    //  one has been read. So however slowly it is read, no frame is skipped.
+    if (!write_frames(numbered)){
+        dir.removeRecursively();
+        return 1;
+    }
+    bool ok = true;
+    {
+        VideoSource_FileReplay source(logger, dir.path().toStdString(), Resolution(16, 16), false, true);
+        const uint32_t expected[] = {0xff0000ff, 0xff00ff00, 0xffffffff, 0xffff0000};
+        WallClock last_timestamp = WallClock::min();
+        WallClock deadline = current_time() + std::chrono::seconds(10);
+        for (uint32_t color : expected){
+            //  Leave time for the replay to run ahead if it were going to.
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+            VideoSnapshot snapshot;
+            while (current_time() < deadline){
+                snapshot = source.snapshot_latest_blocking();
+                if (snapshot && snapshot.timestamp != last_timestamp){
+                    break;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (!snapshot || snapshot.timestamp == last_timestamp){
+                std::cerr << "Error: replay stopped before frame 0x" << std::hex << color << std::dec << std::endl;
+                ok = false;
+                break;
+            }
+            last_timestamp = snapshot.timestamp;
+            uint32_t pixel = snapshot->pixel(0, 0);
+            if (pixel != color){
+                std::cerr << "Error: expected frame 0x" << std::hex << color << ", got 0x" << pixel << std::dec << std::endl;
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    dir.removeRecursively();
+    return ok ? 0 : 1;
+}
+
+
 }
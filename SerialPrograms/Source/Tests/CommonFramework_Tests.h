@@ -15,6 +15,45 @@ class ImageViewRGB32;
 
 int test_CommonFramework_BlackBorderDetector(const ImageViewRGB32& image, bool target);
 
+//  Check that converted regions of a frame match the same area of the full conversion.
+int test_CommonFramework_QVideoFrameRegions(const ImageViewRGB32& image);
+
+//  Benchmark the work-stealing thread pool against the single-queue one.
+int test_CommonFramework_ComputationThreadPool(const ImageViewRGB32& image);
+
+//  Check that pruned dictionary matching gives the same results as exhaustive matching.
+int test_CommonFramework_ImageDictionaryMatcher(const ImageViewRGB32& image);
+
+//  Check "ExactImageMatcher" against resizing and brightness scaling in separate passes on the resource templates.
+int test_CommonFramework_ExactImageMatcher(const ImageViewRGB32& image);
+
+//  Check the bit-parallel OCR text matcher against the dynamic programming one.
+int test_CommonFramework_OCRTextMatcher(const ImageViewRGB32& image);
+
+//  Parse all the resource JSON files and compare against nlohmann.
+int test_CommonFramework_JsonParser(const ImageViewRGB32& image);
+
+//  Check that stream history frames still decode after the oldest ones are evicted.
+int test_CommonFramework_StreamHistoryFrameCodec(const ImageViewRGB32& image);
+
+//  Check the shared spectrum filtering against filtering each spectrum directly.
+int test_CommonFramework_SpectrumPreprocessor(const ImageViewRGB32& image);
+
+//  Log from several threads at once under both overflow policies.
+int test_CommonFramework_FileWindowLogger(const ImageViewRGB32& image);
+
+//  Round-trip an audio template through its binary cache file and reject bad headers.
+int test_CommonFramework_AudioTemplateCache(const ImageViewRGB32& image);
+
+//  Round-trip log lines through the binary event log, including numbers too big for an argument.
+int test_CommonFramework_BinaryEventLog(const ImageViewRGB32& image);
+
+//  Round-trip PABotBase messages through a loopback stream and time them.
+int test_CommonFramework_SerialLoopback(const ImageViewRGB32& image);
+
+//  Check the frame order and timing of a replayed frame directory, and that fast replay waits for each frame to be read.
+int test_CommonFramework_VideoFileReplay(const ImageViewRGB32& image);
+
 }
 
 #endif
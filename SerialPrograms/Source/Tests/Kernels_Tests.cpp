@@ -9,10 +9,12 @@
 #include "Common/Cpp/Color.h"
 #include "Common/Cpp/CpuId/CpuId.h"
 #include "Common/Cpp/Time.h"
+#include "Common/Cpp/Containers/AlignedVector.tpp"
 #include "CommonFramework/ImageTypes/BinaryImage.h"
 #include "CommonFramework/ImageTools/ImageBoxes.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "Kernels/AbsFFT/Kernels_AbsFFT.h"
 #include "Kernels/BinaryMatrix/Kernels_BinaryMatrix.h"
 #ifdef PA_AutoDispatch_arm64_20_M1
     #include "Kernels/BinaryMatrix/Kernels_BinaryMatrixTile_64x8_arm64_NEON.h"
@@ -26,7 +28,14 @@
 #include "Kernels/ImageFilters/Kernels_ImageFilter_Basic.h"
 #include "Kernels/ImageFilters/RGB32_Range/Kernels_ImageFilter_RGB32_Range.h"
 #include "Kernels/ImageFilters/RGB32_EuclideanDistance/Kernels_ImageFilter_RGB32_Euclidean.h"
+#include "Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV.h"
+#include "Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_Routines_Default.h"
 #include "Kernels/ImageScaleBrightness/Kernels_ImageScaleBrightness.h"
+#include "Kernels/ImageStats/Kernels_ImagePixelSumSqrDev.h"
+#include "Kernels/ImageStats/Kernels_ImageScaledSumSqrDev.h"
+#include "Kernels/ScaleInvariantMatrixMatch/Kernels_ScaleInvariantMatrixMatch.h"
+#include "Kernels/VideoFrameConversion/Kernels_VideoFrameConversion.h"
+#include "Kernels/VideoFrameConversion/Kernels_VideoFrameConversion_Routines.h"
 #include "Kernels/Waterfill/Kernels_Waterfill.h"
 #include "Kernels/Waterfill/Kernels_Waterfill_Session.h"
 #include "Kernels/Waterfill/Kernels_Waterfill_Core_64xH_Default.h"
@@ -34,22 +43,226 @@
 #include "Kernels_Tests.h"
 #include "TestUtils.h"
 
+#include <cmath>
+#include <cstring>
+#include <algorithm>
 #include <functional>
+#include <vector>
 #include <iostream>
 using std::cout;
 using std::cerr;
 using std::endl;
 using std::flush;
 
+
 namespace PokemonAutomation{
 
 using namespace Kernels;
 
-namespace Kernels{}
+namespace Kernels{
+void scale_brightness_Default(
+    size_t width, size_t height,
+    uint32_t* image, size_t bytes_per_row,
+    float scaleR, float scaleG, float scaleB
+);
+void scaled_pixel_sum_Default(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation_Default(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+void scale_brightness_x64_SSE41(
+    size_t width, size_t height,
+    uint32_t* image, size_t bytes_per_row,
+    float scaleR, float scaleG, float scaleB
+);
+void scaled_pixel_sum_x64_SSE41(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation_x64_SSE41(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+void scale_brightness_x64_AVX2(
+    size_t width, size_t height,
+    uint32_t* image, size_t bytes_per_row,
+    float scaleR, float scaleG, float scaleB
+);
+void scaled_pixel_sum_x64_AVX2(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation_x64_AVX2(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+void scale_brightness_x64_AVX512(
+    size_t width, size_t height,
+    uint32_t* image, size_t bytes_per_row,
+    float scaleR, float scaleG, float scaleB
+);
+void scaled_pixel_sum_x64_AVX512(
+    ScaledPixelSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template <SumSquareMode mode>
+void scaled_sum_sqr_deviation_x64_AVX512(
+    uint64_t& sumsqrs,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    size_t img_width, size_t img_height,
+    const uint32_t* img, size_t img_bytes_per_line,
+    float scaleR, float scaleG, float scaleB,
+    uint32_t background,
+    size_t row_start, size_t row_step
+);
+namespace ScaleInvariantMatrixMatch{
+void compute_dot_products_Default         (size_t width, size_t rows, const float* A, float const* const* T, float* dots);
+void compute_dot_products_min4_x86_SSE    (size_t width, size_t rows, const float* A, float const* const* T, float* dots);
+void compute_dot_products_min8_x86_AVX2   (size_t width, size_t rows, const float* A, float const* const* T, float* dots);
+void compute_dot_products_min16_x86_AVX512(size_t width, size_t rows, const float* A, float const* const* T, float* dots);
+}
+namespace AbsFFT{
+void fft_abs_Default(int k, float* abs, float* real);
+void fft_abs_x86_SSE41(int k, float* abs, float* real);
+void fft_abs_x86_AVX2(int k, float* abs, float* real);
+void fft_abs_x86_AVX512(int k, float* abs, float* real);
+void fft_abs_Default(int k, float* abs, const float* const input[4], float* work);
+void fft_abs_x86_SSE41(int k, float* abs, const float* const input[4], float* work);
+void fft_abs_x86_AVX2(int k, float* abs, const float* const input[4], float* work);
+void fft_abs_x86_AVX512(int k, float* abs, const float* const input[4], float* work);
+}
+}
 
 namespace{
 
 
+//  Reference RGB -> YUV (BT.709, limited range) for building test frames.
+void rgb_to_yuv_BT709(uint32_t pixel, uint8_t& y, uint8_t& u, uint8_t& v){
+    double r = (pixel >> 16) & 0xff;
+    double g = (pixel >> 8) & 0xff;
+    double b = pixel & 0xff;
+    double luma = 0.2126 * r + 0.7152 * g + 0.0722 * b;
+    double cb = (b - luma) / 1.8556;
+    double cr = (r - luma) / 1.5748;
+    y = (uint8_t)std::min(std::max(16 + luma * 219 / 255 + 0.5, 0.), 255.);
+    u = (uint8_t)std::min(std::max(128 + cb * 224 / 255 + 0.5, 0.), 255.);
+    v = (uint8_t)std::min(std::max(128 + cr * 224 / 255 + 0.5, 0.), 255.);
+}
+
+struct YUVTestFrame{
+    std::vector<uint8_t> planes[3];
+    YUVFrameView view;
+
+    YUVTestFrame(const ImageViewRGB32& image, YUVFormat format){
+        const size_t width = image.width() & ~(size_t)1;
+        const size_t height = image.height() & ~(size_t)1;
+        const size_t chroma_width = width / 2;
+        view.format = format;
+        view.width = width;
+        view.height = height;
+        switch (format){
+        case YUVFormat::NV12:
+            planes[0].resize(width * height);
+            planes[1].resize(width * height / 2);
+            view.bytes_per_row[0] = width;
+            view.bytes_per_row[1] = width;
+            break;
+        case YUVFormat::I420:
+            planes[0].resize(width * height);
+            planes[1].resize(chroma_width * height / 2);
+            planes[2].resize(chroma_width * height / 2);
+            view.bytes_per_row[0] = width;
+            view.bytes_per_row[1] = chroma_width;
+            view.bytes_per_row[2] = chroma_width;
+            break;
+        case YUVFormat::YUY2:
+        case YUVFormat::UYVY:
+            planes[0].resize(width * height * 2);
+            view.bytes_per_row[0] = width * 2;
+            break;
+        }
+        for (size_t c = 0; c < 3; c++){
+            view.planes[c] = planes[c].data();
+        }
+
+        //  Chroma is taken from the top-left pixel of each block.
+        for (size_t r = 0; r < height; r++){
+            for (size_t x = 0; x < width; x++){
+                uint8_t y, u, v;
+                rgb_to_yuv_BT709(image.pixel(x, r), y, u, v);
+                bool chroma = x % 2 == 0 && (r % 2 == 0 || format == YUVFormat::YUY2 || format == YUVFormat::UYVY);
+                switch (format){
+                case YUVFormat::NV12:
+                    planes[0][r * width + x] = y;
+                    if (chroma){
+                        planes[1][(r / 2) * width + x + 0] = u;
+                        planes[1][(r / 2) * width + x + 1] = v;
+                    }
+                    break;
+                case YUVFormat::I420:
+                    planes[0][r * width + x] = y;
+                    if (chroma){
+                        planes[1][(r / 2) * chroma_width + x / 2] = u;
+                        planes[2][(r / 2) * chroma_width + x / 2] = v;
+                    }
+                    break;
+                case YUVFormat::YUY2:
+                    planes[0][r * width * 2 + x * 2] = y;
+                    if (chroma){
+                        planes[0][r * width * 2 + x * 2 + 1] = u;
+                        planes[0][r * width * 2 + x * 2 + 3] = v;
+                    }
+                    break;
+                case YUVFormat::UYVY:
+                    planes[0][r * width * 2 + x * 2 + 1] = y;
+                    if (chroma){
+                        planes[0][r * width * 2 + x * 2 + 0] = u;
+                        planes[0][r * width * 2 + x * 2 + 2] = v;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+};
+
 
 }
 
@@ -75,6 +288,591 @@ int test_kernels_ImageScaleBrightness(const ImageViewRGB32& image){
 }
 
 
+int test_kernels_ImageScaledSumSqrDev(const ImageViewRGB32& image){
+    using ScaleBrightness = void (*)(
+        size_t width, size_t height,
+        uint32_t* image, size_t bytes_per_row,
+        float scaleR, float scaleG, float scaleB
+    );
+    using PixelSum = void (*)(
+        ScaledPixelSums& sums,
+        size_t width, size_t height,
+        const uint32_t* ref, size_t ref_bytes_per_line,
+        size_t img_width, size_t img_height,
+        const uint32_t* img, size_t img_bytes_per_line
+    );
+    using SumSqrDev = void (*)(
+        uint64_t& sumsqrs,
+        size_t width, size_t height,
+        const uint32_t* ref, size_t ref_bytes_per_line,
+        size_t img_width, size_t img_height,
+        const uint32_t* img, size_t img_bytes_per_line,
+        float scaleR, float scaleG, float scaleB,
+        uint32_t background,
+        size_t row_start, size_t row_step
+    );
+
+    const size_t width = image.width();
+    const size_t height = image.height();
+    if (width < 16 || height < 16){
+        cout << "Error: image is too small." << endl;
+        return 1;
+    }
+    const uint32_t background = 0xff204060;
+    const float scaleR = 1.13f, scaleG = 0.9f, scaleB = 1.0f;   //  Red saturates and rounds differently per instruction set.
+
+    //  Templates smaller than, the same size as and larger than the image.
+    //  Each is a resized copy of the image with a transparent band. The image
+    //  they are compared against is shifted so that the pixels differ.
+    ImageViewRGB32 shifted = image.sub_image(width / 10, height / 10, width * 8 / 10, height * 8 / 10);
+    const std::pair<size_t, size_t> SIZES[] = {
+        {width / 3, height / 3},
+        {width / 7 + 1, height / 5 + 3},
+        {shifted.width(), shifted.height()},
+        {width * 3 / 2 + 1, height * 5 / 4},
+        {3, 2},
+    };
+    std::vector<ImageRGB32> templates;
+    for (const auto& size : SIZES){
+        templates.emplace_back(image.scale_to(size.first, size.second));
+        ImageRGB32& ref = templates.back();
+        for (size_t r = 0; r < ref.height(); r++){
+            for (size_t c = 0; c < ref.width() / 4; c++){
+                ref.pixel(c, r) &= 0x00ffffff;
+            }
+        }
+    }
+
+    const SumSquareMode MODES[] = {
+        SumSquareMode::REFERENCE_ALPHA,
+        SumSquareMode::USE_BACKGROUND,
+        SumSquareMode::ARBITRATE_ALPHAS,
+    };
+
+    //  Must be exactly the same as resizing the image with Qt, scaling the
+    //  template with "scale_brightness()" on the same instruction set and then
+    //  "sum_sqr_deviation()". Also split into interleaved row passes.
+    auto check = [&](const char* name, ScaleBrightness scale_fn, PixelSum sum_fn, const SumSqrDev dev_fn[3]) -> bool{
+        cout << "Testing scaled_sum_sqr_deviation(): " << name << endl;
+        for (const ImageRGB32& ref : templates){
+            ImageRGB32 scaled = shifted.scale_to(ref.width(), ref.height());
+
+            ScaledPixelSums expected_sums;
+            for (size_t r = 0; r < ref.height(); r++){
+                for (size_t c = 0; c < ref.width(); c++){
+                    if ((int32_t)ref.pixel(c, r) >= 0){
+                        continue;
+                    }
+                    uint32_t pixel = scaled.pixel(c, r);
+                    expected_sums.count++;
+                    expected_sums.sum[0] += pixel & 0xff;
+                    expected_sums.sum[1] += (pixel >> 8) & 0xff;
+                    expected_sums.sum[2] += (pixel >> 16) & 0xff;
+                }
+            }
+            ScaledPixelSums sums;
+            sum_fn(
+                sums,
+                ref.width(), ref.height(), ref.data(), ref.bytes_per_row(),
+                shifted.width(), shifted.height(), shifted.data(), shifted.bytes_per_row()
+            );
+            if (memcmp(&sums, &expected_sums, sizeof(sums)) != 0){
+                cout << "Error: " << name << ", template " << ref.width() << " x " << ref.height()
+                     << ", resized pixel sums do not match." << endl;
+                return false;
+            }
+
+            ImageRGB32 scaled_ref = ref.copy();
+            scale_fn(
+                scaled_ref.width(), scaled_ref.height(),
+                scaled_ref.data(), scaled_ref.bytes_per_row(),
+                scaleR, scaleG, scaleB
+            );
+            for (size_t m = 0; m < 3; m++){
+                uint64_t count = 0;
+                uint64_t expected = 0;
+                switch (MODES[m]){
+                case SumSquareMode::REFERENCE_ALPHA:
+                    sum_sqr_deviation(
+                        count, expected, ref.width(), ref.height(),
+                        scaled_ref.data(), scaled_ref.bytes_per_row(),
+                        scaled.data(), scaled.bytes_per_row()
+                    );
+                    break;
+                case SumSquareMode::USE_BACKGROUND:
+                    sum_sqr_deviation(
+                        count, expected, ref.width(), ref.height(),
+                        scaled_ref.data(), scaled_ref.bytes_per_row(),
+                        scaled.data(), scaled.bytes_per_row(),
+                        background
+                    );
+                    break;
+                case SumSquareMode::ARBITRATE_ALPHAS:
+                    sum_sqr_deviation_masked(
+                        count, expected, ref.width(), ref.height(),
+                        scaled_ref.data(), scaled_ref.bytes_per_row(),
+                        scaled.data(), scaled.bytes_per_row()
+                    );
+                    break;
+                }
+                for (size_t passes : {1, 3}){
+                    uint64_t actual = 0;
+                    for (size_t pass = 0; pass < passes; pass++){
+                        dev_fn[m](
+                            actual,
+                            ref.width(), ref.height(), ref.data(), ref.bytes_per_row(),
+                            shifted.width(), shifted.height(), shifted.data(), shifted.bytes_per_row(),
+                            scaleR, scaleG, scaleB,
+                            background,
+                            pass, passes
+                        );
+                    }
+                    if (actual != expected){
+                        cout << "Error: " << name << ", template " << ref.width() << " x " << ref.height()
+                             << ", mode " << m << ", passes " << passes
+                             << ": expected = " << expected << ", actual = " << actual << endl;
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    };
+
+    {
+        const SumSqrDev dev[3] = {
+            scaled_sum_sqr_deviation_Default<SumSquareMode::REFERENCE_ALPHA>,
+            scaled_sum_sqr_deviation_Default<SumSquareMode::USE_BACKGROUND>,
+            scaled_sum_sqr_deviation_Default<SumSquareMode::ARBITRATE_ALPHAS>,
+        };
+        if (!check("Default", scale_brightness_Default, scaled_pixel_sum_Default, dev)){
+            return 1;
+        }
+    }
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        const SumSqrDev dev[3] = {
+            scaled_sum_sqr_deviation_x64_SSE41<SumSquareMode::REFERENCE_ALPHA>,
+            scaled_sum_sqr_deviation_x64_SSE41<SumSquareMode::USE_BACKGROUND>,
+            scaled_sum_sqr_deviation_x64_SSE41<SumSquareMode::ARBITRATE_ALPHAS>,
+        };
+        if (!check("x64 SSE4.1", scale_brightness_x64_SSE41, scaled_pixel_sum_x64_SSE41, dev)){
+            return 1;
+        }
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        const SumSqrDev dev[3] = {
+            scaled_sum_sqr_deviation_x64_AVX2<SumSquareMode::REFERENCE_ALPHA>,
+            scaled_sum_sqr_deviation_x64_AVX2<SumSquareMode::USE_BACKGROUND>,
+            scaled_sum_sqr_deviation_x64_AVX2<SumSquareMode::ARBITRATE_ALPHAS>,
+        };
+        if (!check("x64 AVX2", scale_brightness_x64_AVX2, scaled_pixel_sum_x64_AVX2, dev)){
+            return 1;
+        }
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake){
+        const SumSqrDev dev[3] = {
+            scaled_sum_sqr_deviation_x64_AVX512<SumSquareMode::REFERENCE_ALPHA>,
+            scaled_sum_sqr_deviation_x64_AVX512<SumSquareMode::USE_BACKGROUND>,
+            scaled_sum_sqr_deviation_x64_AVX512<SumSquareMode::ARBITRATE_ALPHAS>,
+        };
+        if (!check("x64 AVX512", scale_brightness_x64_AVX512, scaled_pixel_sum_x64_AVX512, dev)){
+            return 1;
+        }
+    }
+#endif
+
+    const ImageRGB32& ref = templates[0];
+    const size_t num_iters = 1000;
+    auto time_start = current_time();
+    for (size_t i = 0; i < num_iters; i++){
+        ScaledPixelSums sums;
+        scaled_pixel_sum(
+            sums,
+            ref.width(), ref.height(), ref.data(), ref.bytes_per_row(),
+            width, height, image.data(), image.bytes_per_row()
+        );
+        uint64_t sumsqrs = 0;
+        scaled_sum_sqr_deviation(
+            sumsqrs, SumSquareMode::REFERENCE_ALPHA,
+            ref.width(), ref.height(), ref.data(), ref.bytes_per_row(),
+            width, height, image.data(), image.bytes_per_row(),
+            scaleR, scaleG, scaleB
+        );
+    }
+    auto time_end = current_time();
+    double ms = std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count() / 1000.;
+    cout << "Running " << num_iters << " iters, avg time: " << ms / num_iters << " ms" << endl;
+
+    return 0;
+}
+
+
+int test_kernels_ScaleInvariantMatrixMatch(const ImageViewRGB32& image){
+    using namespace Kernels::ScaleInvariantMatrixMatch;
+    using DotProducts = void (*)(size_t width, size_t rows, const float* A, float const* const* T, float* dots);
+
+    const size_t MAX_WIDTH = 200;
+    const size_t ROWS = 8;
+    const size_t PADDING = 16;  //  Enough to shift the start through every lane of a 512-bit vector.
+
+    uint64_t seed = 1;
+    auto random = [&]{
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        return (float)(seed >> 40) / (float)(1 << 24);
+    };
+    AlignedVector<float> A(MAX_WIDTH + PADDING);
+    std::vector<AlignedVector<float>> T;
+    for (size_t c = 0; c < MAX_WIDTH + PADDING; c++){
+        A[c] = random();
+    }
+    for (size_t r = 0; r < ROWS; r++){
+        T.emplace_back(MAX_WIDTH + PADDING);
+        for (size_t c = 0; c < MAX_WIDTH + PADDING; c++){
+            T[r][c] = random();
+        }
+    }
+
+    //  Every width and every alignment against a double-precision reference.
+    //  Each kernel only runs on widths of at least its vector length.
+    auto check = [&](const char* name, DotProducts kernel, size_t min_width) -> bool{
+        cout << "Testing compute_dot_products(): " << name << endl;
+        const float* rows[ROWS];
+        float dots[ROWS];
+        for (size_t offset = 0; offset < PADDING; offset++){
+            for (size_t r = 0; r < ROWS; r++){
+                rows[r] = T[r].data() + offset;
+            }
+            for (size_t width = min_width; width <= MAX_WIDTH; width++){
+                kernel(width, ROWS, A.data() + offset, rows, dots);
+                for (size_t r = 0; r < ROWS; r++){
+                    double expected = 0;
+                    for (size_t c = 0; c < width; c++){
+                        expected += (double)A[offset + c] * rows[r][c];
+                    }
+                    if (std::abs(dots[r] - expected) > 1e-5 * expected + 1e-6){
+                        cout << "Error: " << name << ", width = " << width << ", offset = " << offset
+                             << ", row = " << r << ", expected = " << expected << ", actual = " << dots[r] << endl;
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    };
+
+    if (!check("Default", compute_dot_products_Default, 1)){
+        return 1;
+    }
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem && !check("x86 SSE", compute_dot_products_min4_x86_SSE, 4)){
+        return 1;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell && !check("x86 AVX2", compute_dot_products_min8_x86_AVX2, 8)){
+        return 1;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake && !check("x86 AVX512", compute_dot_products_min16_x86_AVX512, 16)){
+        return 1;
+    }
+#endif
+    if (!check("Dispatched", compute_dot_products, 1)){
+        return 1;
+    }
+
+    return 0;
+}
+
+
+int test_kernels_AbsFFT(const ImageViewRGB32& image){
+    using namespace Kernels::AbsFFT;
+    using FFTAbs = void (*)(int k, float* abs, float* real);
+    using FFTAbsQuarters = void (*)(int k, float* abs, const float* const input[4], float* work);
+
+    const int MAX_K = 13;
+    const size_t MAX_LENGTH = (size_t)1 << MAX_K;
+    const double PI = 3.14159265358979323846;
+
+    uint64_t seed = 1;
+    AlignedVector<float> circular(MAX_LENGTH);
+    AlignedVector<float> real(MAX_LENGTH);
+    AlignedVector<float> work(MAX_LENGTH);
+    AlignedVector<float> abs(MAX_LENGTH / 2);
+    std::vector<double> expected(MAX_LENGTH / 2);
+    std::vector<double> cos_table(MAX_LENGTH);
+    std::vector<double> sin_table(MAX_LENGTH);
+
+    //  A window of "circular" starting at "start" is compared against a
+    //  plain DFT of the same samples.
+    size_t length = 0;
+    size_t start = 0;
+    double tolerance = 0;
+    auto compute_expected = [&]{
+        for (size_t c = 0; c < length; c++){
+            cos_table[c] = std::cos(2 * PI * (double)c / (double)length);
+            sin_table[c] = std::sin(2 * PI * (double)c / (double)length);
+        }
+        double sum_abs = 0;
+        for (size_t f = 0; f < length / 2; f++){
+            double re = 0;
+            double im = 0;
+            for (size_t t = 0; t < length; t++){
+                double x = circular[(start + t) & (length - 1)];
+                size_t index = (f * t) & (length - 1);
+                re += x * cos_table[index];
+                im -= x * sin_table[index];
+            }
+            expected[f] = std::sqrt(re*re + im*im);
+        }
+        for (size_t t = 0; t < length; t++){
+            sum_abs += std::abs(circular[t]);
+        }
+        //  Every output is bounded by the sum of the inputs. The error of a
+        //  float FFT grows with log(length).
+        tolerance = 1e-6 * sum_abs * std::log2((double)length);
+    };
+    auto compare = [&](const std::string& name) -> bool{
+        for (size_t f = 0; f < length / 2; f++){
+            if (std::abs(abs[f] - expected[f]) > tolerance){
+                cout << "Error: " << name << ", length = " << length << ", start = " << start
+                     << ", frequency = " << f << ", expected = " << expected[f] << ", actual = " << abs[f] << endl;
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto check = [&](const std::string& name, FFTAbs linear, FFTAbsQuarters quarters) -> bool{
+        cout << "Testing fft_abs(): " << name << endl;
+        for (int k = 1; k <= MAX_K; k++){
+            length = (size_t)1 << k;
+            for (size_t c = 0; c < length; c++){
+                seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+                circular[c] = (float)(seed >> 40) / (float)(1 << 23) - 1;
+            }
+
+            start = 0;
+            compute_expected();
+            memcpy(real.data(), circular.data(), length * sizeof(float));
+            linear(k, abs.data(), real.data());
+            if (!compare(name)){
+                return false;
+            }
+
+            //  Read the window in place from each quarter of the circular buffer.
+            for (size_t quarter = 1; k >= 2 && quarter < 4; quarter++){
+                start = quarter * length / 4;
+                compute_expected();
+                const float* input[4];
+                for (size_t c = 0; c < 4; c++){
+                    input[c] = circular.data() + ((start + c * length / 4) & (length - 1));
+                }
+                quarters(k, abs.data(), input, work.data());
+                if (!compare(name + " (circular)")){
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    if (!check("Default", fft_abs_Default, fft_abs_Default)){
+        return 1;
+    }
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem && !check("x86 SSE4.1", fft_abs_x86_SSE41, fft_abs_x86_SSE41)){
+        return 1;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell && !check("x86 AVX2", fft_abs_x86_AVX2, fft_abs_x86_AVX2)){
+        return 1;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    if (CPU_CAPABILITY_CURRENT.OK_17_Skylake && !check("x86 AVX512", fft_abs_x86_AVX512, fft_abs_x86_AVX512)){
+        return 1;
+    }
+#endif
+
+    //  The dispatched circular FFT, including starts that are not on a
+    //  quarter and have to be unwrapped first.
+    cout << "Testing fft_abs_circular()" << endl;
+    for (int k = 2; k <= MAX_K; k++){
+        length = (size_t)1 << k;
+        for (size_t s : {(size_t)0, (size_t)1, length / 4, length / 3, length - 1}){
+            start = s;
+            compute_expected();
+            fft_abs_circular(k, abs.data(), circular.data(), start, work.data());
+            if (!compare("fft_abs_circular()")){
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+int test_kernels_VideoFrameConversion(const ImageViewRGB32& image){
+    const YUVToRGBCoefficients coefficients = YUVToRGBCoefficients::BT709(false);
+    const std::pair<YUVFormat, const char*> FORMATS[] = {
+        {YUVFormat::NV12, "NV12"},
+        {YUVFormat::I420, "I420"},
+        {YUVFormat::YUY2, "YUY2"},
+        {YUVFormat::UYVY, "UYVY"},
+    };
+
+    for (const auto& format : FORMATS){
+        YUVTestFrame frame(image, format.first);
+        const size_t width = frame.view.width, height = frame.view.height;
+        cout << "Testing convert_yuv_to_rgb32(): " << format.second << ", frame size " << width << " x " << height << endl;
+
+        ImageRGB32 image_out(width, height);
+        convert_yuv_to_rgb32(frame.view, image_out.data(), image_out.bytes_per_row(), coefficients);
+
+        //  Must be bit-identical to the scalar code.
+        ImageRGB32 image_ref(width, height);
+        for (size_t r = 0; r < height; r++){
+            yuv_to_rgb32_row_Default(
+                format.first, YUVRow(frame.view, r), 0, width,
+                &image_ref.pixel(0, r), coefficients
+            );
+        }
+
+        size_t error_count = 0;
+        uint64_t total_diff = 0;
+        for (size_t y = 0; y < height; y++){
+            for (size_t x = 0; x < width; x++){
+                uint32_t pixel = image_out.pixel(x, y);
+                if (pixel != image_ref.pixel(x, y) && error_count < 10){
+                    cout << "Error: pixel (" << x << ", " << y << ") got " << Color(pixel).to_string()
+                         << " but scalar is " << Color(image_ref.pixel(x, y)).to_string() << endl;
+                    error_count++;
+                }
+                uint32_t original = image.pixel(x, y);
+                for (int shift = 0; shift < 24; shift += 8){
+                    total_diff += std::abs((int)((pixel >> shift) & 0xff) - (int)((original >> shift) & 0xff));
+                }
+            }
+        }
+        if (error_count){
+            return 1;
+        }
+        cout << "Mean channel error vs. original: " << (double)total_diff / (3. * width * height) << endl;
+
+        const size_t num_iters = 200;
+        auto time_start = current_time();
+        for (size_t i = 0; i < num_iters; i++){
+            convert_yuv_to_rgb32(frame.view, image_out.data(), image_out.bytes_per_row(), coefficients);
+        }
+        auto time_end = current_time();
+        double ms = std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count() / 1000.;
+        cout << "Running " << num_iters << " iters, avg conversion time: " << ms / num_iters << " ms" << endl;
+    }
+
+    return 0;
+}
+
+
+int test_kernels_RGB32ToHSV32(const ImageViewRGB32& image){
+    const size_t width = image.width(), height = image.height();
+    cout << "Testing convert_rgb32_to_hsv32(), image size " << width << " x " << height << endl;
+
+    ImageRGB32 image_out(width, height);
+    convert_rgb32_to_hsv32(
+        image.data(), image.bytes_per_row(), width, height,
+        image_out.data(), image_out.bytes_per_row()
+    );
+
+    //  Must be bit-identical to the scalar code.
+    size_t error_count = 0;
+    for (size_t y = 0; y < height; y++){
+        for (size_t x = 0; x < width; x++){
+            uint32_t expected = rgb32_to_hsv32_Default(image.pixel(x, y));
+            if (image_out.pixel(x, y) != expected && error_count < 10){
+                cout << "Error: pixel (" << x << ", " << y << ") got " << Color(image_out.pixel(x, y)).to_string()
+                     << " but scalar is " << Color(expected).to_string() << endl;
+                error_count++;
+            }
+        }
+    }
+    if (error_count){
+        return 1;
+    }
+
+    //  Every RGB value once, with the alpha channel varying too.
+    {
+        const size_t side = 4096;
+        ImageRGB32 all_colors(side, side);
+        for (size_t y = 0; y < side; y++){
+            for (size_t x = 0; x < side; x++){
+                uint32_t rgb = (uint32_t)(y * side + x);
+                all_colors.pixel(x, y) = rgb | (uint32_t)(rgb * 2654435761u) << 24;
+            }
+        }
+        ImageRGB32 all_out(side, side);
+        convert_rgb32_to_hsv32(
+            all_colors.data(), all_colors.bytes_per_row(), side, side,
+            all_out.data(), all_out.bytes_per_row()
+        );
+        for (size_t y = 0; y < side; y++){
+            for (size_t x = 0; x < side; x++){
+                uint32_t expected = rgb32_to_hsv32_Default(all_colors.pixel(x, y));
+                if (all_out.pixel(x, y) != expected){
+                    cout << "Error: color " << Color(all_colors.pixel(x, y)).to_string() << " got "
+                         << Color(all_out.pixel(x, y)).to_string() << " but scalar is " << Color(expected).to_string() << endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    //  HSV range into a binary matrix.
+    const uint32_t mins = 0xff202040, maxs = 0xff60ffff;
+    auto binary_matrix = make_PackedBinaryMatrix(get_BinaryMatrixType(), width, height);
+    compress_rgb32_to_binary_hsv_range(
+        image.data(), image.bytes_per_row(), *binary_matrix, mins, maxs
+    );
+    for (size_t y = 0; y < height; y++){
+        for (size_t x = 0; x < width; x++){
+            uint32_t hsv = image_out.pixel(x, y);
+            bool in_range = true;
+            for (int shift = 0; shift < 32; shift += 8){
+                uint32_t c = (hsv >> shift) & 0xff;
+                in_range = in_range && ((mins >> shift) & 0xff) <= c && c <= ((maxs >> shift) & 0xff);
+            }
+            if (binary_matrix->get(x, y) != in_range){
+                cout << "Error: HSV range matrix (" << x << ", " << y << ") is " << binary_matrix->get(x, y)
+                     << " but HSV " << Color(hsv).to_string() << " is " << (in_range ? "in" : "out of") << " range" << endl;
+                return 1;
+            }
+        }
+    }
+
+    const size_t num_iters = 200;
+    auto time_start = current_time();
+    for (size_t i = 0; i < num_iters; i++){
+        convert_rgb32_to_hsv32(
+            image.data(), image.bytes_per_row(), width, height,
+            image_out.data(), image_out.bytes_per_row()
+        );
+    }
+    auto time_end = current_time();
+    double ms = std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count() / 1000.;
+    cout << "Running " << num_iters << " iters, avg conversion time: " << ms / num_iters << " ms" << endl;
+
+    return 0;
+}
+
+
 int test_kernels_BinaryMatrix(const ImageViewRGB32& image){
 
     if (test_binary_matrix_tile() != 0){
@@ -459,6 +1257,72 @@ int test_kernels_ToBlackWhiteRGB32Range(const ImageViewRGB32& image){
     return 0;
 }
 
+
+int test_kernels_ToBlackWhiteGray8RGB32Range(const ImageViewRGB32& image){
+    const size_t width = image.width();
+    const size_t height = image.height();
+    cout << "Testing to_blackwhite_gray8_rgb32_range(), image size " << width << " x " << height << endl;
+
+    const std::vector<std::pair<uint32_t, uint32_t>> ranges{
+        {0xff000000, 0xff404040},
+        {0xff000000, 0xff606060},
+        {0xff000000, 0xff808080},
+        {0xff808080, 0xffffffff},
+        {0xffa0a0a0, 0xffffffff},
+    };
+
+    //  Reference: one RGB32 image per filter.
+    std::vector<ImageRGB32> expected;
+    std::vector<size_t> expected_counts;
+    auto time_start = current_time();
+    for (const auto& range : ranges){
+        expected.emplace_back(width, height);
+        expected_counts.emplace_back(Kernels::to_blackwhite_rgb32_range(
+            image.data(), image.bytes_per_row(), width, height,
+            expected.back().data(), expected.back().bytes_per_row(),
+            true, range.first, range.second
+        ));
+    }
+    auto time_end = current_time();
+    cout << "RGB32, one pass per filter: " << std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count() / 1000. << " ms" << endl;
+
+    //  Every other filter only counts.
+    std::vector<uint8_t> planes(ranges.size() * width * height);
+    std::vector<Kernels::ToBlackWhiteGray8RangeFilter> filters;
+    for (size_t c = 0; c < ranges.size(); c++){
+        uint8_t* data = c % 2 == 0 ? planes.data() + c * width * height : nullptr;
+        filters.emplace_back(Kernels::ToBlackWhiteGray8RangeFilter{
+            data, width, ranges[c].first, ranges[c].second, true, 0
+        });
+    }
+    time_start = current_time();
+    Kernels::to_blackwhite_gray8_rgb32_range(
+        image.data(), image.bytes_per_row(), width, height,
+        filters.data(), filters.size()
+    );
+    time_end = current_time();
+    cout << "Gray8, single pass:         " << std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count() / 1000. << " ms" << endl;
+
+    for (size_t c = 0; c < ranges.size(); c++){
+        TEST_RESULT_EQUAL(filters[c].pixels_in_range, expected_counts[c]);
+        if (filters[c].data == nullptr){
+            continue;
+        }
+        for (size_t y = 0; y < height; y++){
+            for (size_t x = 0; x < width; x++){
+                uint8_t expected_pixel = expected[c].pixel(x, y) == 0xffffffff ? 0xff : 0x00;
+                uint8_t actual = filters[c].data[y * width + x];
+                if (actual != expected_pixel){
+                    cout << "Error: filter " << c << " mismatch at (x,y) = " << x << ", " << y << endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
 int test_kernels_FilterByMask(const ImageViewRGB32& image){
     const size_t width = image.width(), height = image.height();
     cout << "Image width " << width << " height " << height << endl;
@@ -684,6 +1548,117 @@ int test_kernels_Waterfill(const ImageViewRGB32& image){
     return 0;
 }
 
+int test_kernels_WaterfillBufferGrowth(const ImageViewRGB32& image){
+    using namespace Kernels::Waterfill;
+
+    const size_t width = image.width();
+    const size_t height = image.height();
+    cout << "Testing test_kernels_WaterfillBufferGrowth(), image size " << width << " x " << height << endl;
+
+    //  Same filters as the SwSh shiny sparkle detector.
+    std::vector<PackedBinaryMatrix> sources;
+    for (uint32_t mins : {0xffa0a000, 0xffb0b000, 0xffc0c000, 0xffd0d000}){
+        PackedBinaryMatrix matrix(width, height);
+        Kernels::compress_rgb32_to_binary_range(
+            image.data(), image.bytes_per_row(),
+            matrix, mins, 0xffffffff
+        );
+        sources.emplace_back(std::move(matrix));
+    }
+    const size_t min_area = 20;
+
+    //  Run one frame through a path and add up the objects it found and how
+    //  many times the sessions grew their scratch buffers or object storage,
+    //  as reported by "buffer_growths()". This is not a heap allocation
+    //  count. The session and iterator objects are not included.
+    struct FrameStats{
+        size_t buffer_growths = 0;
+        size_t objects = 0;
+        uint64_t checksum = 0;
+        void add(const WaterfillObject& object){
+            objects++;
+            checksum += object.area + object.min_x * 3 + object.min_y * 5 + object.max_x * 7 + object.max_y * 11;
+            if (object.object){
+                checksum += object.object->get(object.body_x, object.body_y);
+            }
+        }
+    };
+    std::vector<PackedBinaryMatrix> matrices;
+    auto reload = [&]{
+        matrices.clear();
+        for (const PackedBinaryMatrix& matrix : sources){
+            matrices.emplace_back(matrix.copy());
+        }
+    };
+
+    //  The old way: a new session, iterator and object matrix every time.
+    auto run_fresh = [&]{
+        reload();
+        FrameStats stats;
+        for (PackedBinaryMatrix& matrix : matrices){
+            std::unique_ptr<WaterfillSession> session = make_WaterfillSession();
+            session->set_source(matrix);
+            std::unique_ptr<WaterfillIterator> finder = session->make_iterator(min_area);
+            WaterfillObject object;
+            while (finder->find_next(object, true)){
+                stats.add(object);
+            }
+            stats.buffer_growths += session->buffer_growths();
+        }
+        return stats;
+    };
+
+    //  The pooled way: this thread's session, its own iterator and one
+    //  object whose matrix gets recycled.
+    WaterfillObject pooled_object;
+    auto run_pooled = [&]{
+        reload();
+        FrameStats stats;
+        for (PackedBinaryMatrix& matrix : matrices){
+            WaterfillSession& session = thread_local_WaterfillSession(matrix);
+            size_t start = session.buffer_growths();
+            WaterfillIterator& finder = session.reset_iterator(min_area);
+            while (finder.find_next(pooled_object, true)){
+                stats.add(pooled_object);
+            }
+            stats.buffer_growths += session.buffer_growths() - start;
+        }
+        return stats;
+    };
+
+    //  The first pooled frame warms up the session and the object.
+    FrameStats fresh = run_fresh();
+    FrameStats warmup = run_pooled();
+    FrameStats pooled = run_pooled();
+    cout << "Objects found: " << fresh.objects << endl;
+    cout << "Buffer growths per frame, fresh session: " << fresh.buffer_growths << endl;
+    cout << "Buffer growths per frame, pooled session (first frame): " << warmup.buffer_growths << endl;
+    cout << "Buffer growths per frame, pooled session (steady state): " << pooled.buffer_growths << endl;
+
+    TEST_RESULT_COMPONENT_EQUAL(pooled.objects, fresh.objects, "object count");
+    TEST_RESULT_COMPONENT_EQUAL(pooled.checksum, fresh.checksum, "object checksum");
+    TEST_RESULT_COMPONENT_EQUAL(pooled.buffer_growths, (size_t)0, "steady state buffer growths");
+
+    //  Timings. Both include the same cost of restoring the matrices.
+    const size_t num_iters = 200;
+    auto time_start = current_time();
+    for (size_t i = 0; i < num_iters; i++){
+        run_fresh();
+    }
+    auto time_end = current_time();
+    double fresh_ms = (double)std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count() / 1000.;
+    time_start = current_time();
+    for (size_t i = 0; i < num_iters; i++){
+        run_pooled();
+    }
+    time_end = current_time();
+    double pooled_ms = (double)std::chrono::duration_cast<std::chrono::microseconds>(time_end - time_start).count() / 1000.;
+    cout << "Running " << num_iters << " frames, avg time: fresh session " << fresh_ms / num_iters
+         << " ms, pooled session " << pooled_ms / num_iters << " ms" << endl;
+
+    return 0;
+}
+
 // Additional tests on binary matrix tile implementation
 template<class Tile> int test_binary_matrix_tile_t(){
     size_t num_iters = 100000;
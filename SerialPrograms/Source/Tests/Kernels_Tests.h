@@ -15,6 +15,16 @@ class ImageViewRGB32;
 
 int test_kernels_ImageScaleBrightness(const ImageViewRGB32& image);
 
+int test_kernels_ImageScaledSumSqrDev(const ImageViewRGB32& image);
+
+int test_kernels_ScaleInvariantMatrixMatch(const ImageViewRGB32& image);
+
+int test_kernels_AbsFFT(const ImageViewRGB32& image);
+
+int test_kernels_VideoFrameConversion(const ImageViewRGB32& image);
+
+int test_kernels_RGB32ToHSV32(const ImageViewRGB32& image);
+
 int test_kernels_BinaryMatrix(const ImageViewRGB32& image);
 
 int test_kernels_FilterRGB32Range(const ImageViewRGB32& image);
@@ -25,12 +35,16 @@ int test_kernels_FilterRGB32Euclidean(const ImageViewRGB32& image);
 
 int test_kernels_ToBlackWhiteRGB32Range(const ImageViewRGB32& image);
 
+int test_kernels_ToBlackWhiteGray8RGB32Range(const ImageViewRGB32& image);
+
 int test_kernels_FilterByMask(const ImageViewRGB32& image);
 
 int test_kernels_CompressRGB32ToBinaryEuclidean(const ImageViewRGB32& image);
 
 int test_kernels_Waterfill(const ImageViewRGB32& image);
 
+int test_kernels_WaterfillBufferGrowth(const ImageViewRGB32& image);
+
 
 }
 
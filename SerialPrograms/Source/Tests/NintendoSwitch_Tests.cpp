@@ -11,11 +11,13 @@
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
 #include "CommonFramework/Recording/StreamHistorySession.h"
+#include "Controllers/SerialPABotBase/Connection/PABotBaseEmulator.h"
 #include "NintendoSwitch/Controllers/SerialPABotBase/NintendoSwitch_SerialPABotBase_WiredController.h"
 #include "NintendoSwitch/Inference/NintendoSwitch_UpdatePopupDetector.h"
 #include "NintendoSwitch_Tests.h"
 #include "TestUtils.h"
 
+#include <thread>
 #include <iostream>
 using std::cout;
 using std::cerr;
@@ -48,5 +50,150 @@ int test_NintendoSwitch_UpdatePopupDetector(const ImageViewRGB32& image, bool ta
 }
 
 
+int test_NintendoSwitch_EmulatedController(const ImageViewRGB32& image){
+    using namespace std::chrono_literals;
+    auto& logger = global_logger_command_line();
+
+    const size_t presses = 200;
+    const Milliseconds hold = 40ms;
+    const Milliseconds cooldown = 10ms;
+
+    auto run = [&](const char* label, PABotBaseEmulatorConfig config, bool expect_batches) -> bool{
+        PABotBaseEmulator* emulator = new PABotBaseEmulator(config);
+        SerialPABotBase::SerialPABotBase_Connection connection(
+            logger, "emulator", std::unique_ptr<StreamConnection>(emulator), false,
+            PABOTBASE_EMULATOR_DEVICES()
+        );
+
+        WallClock deadline = current_time() + 10s;
+        while (!connection.is_ready()){
+            if (current_time() > deadline){
+                cerr << "Error: " << label << " emulator never became ready." << endl;
+                return false;
+            }
+            std::this_thread::sleep_for(10ms);
+        }
+
+        SerialPABotBase_WiredController controller(
+            logger, connection,
+            ControllerType::NintendoSwitch_WiredController,
+            ControllerResetMode::SIMPLE_RESET
+        );
+        while (!controller.is_ready()){
+            if (current_time() > deadline){
+                cerr << "Error: " << label << " controller never became ready." << endl;
+                return false;
+            }
+            std::this_thread::sleep_for(10ms);
+        }
+
+        if (connection.supports_command_batches() != expect_batches){
+            cerr << "Error: " << label << " negotiated the wrong command batching." << endl;
+            return false;
+        }
+
+        emulator->clear_timeline();
+        uint64_t commands_before = emulator->stats().commands_executed;
+        WallClock time_start = current_time();
+        for (size_t c = 0; c < presses; c++){
+            controller.issue_buttons(nullptr, hold + cooldown, hold, cooldown, BUTTON_A);
+        }
+        controller.wait_for_all(nullptr);
+        WallClock time_end = current_time();
+
+        //  Every press must be held for exactly its duration on the device.
+        size_t pressed_runs = 0;
+        size_t gaps = 0;
+        WallDuration pressed = WallDuration::zero();
+        bool last_pressed = false;
+        std::vector<PABotBaseEmulatorReport> timeline = emulator->timeline();
+        for (size_t c = 0; c < timeline.size(); c++){
+            const PABotBaseEmulatorReport& entry = timeline[c];
+            bool current = (uint8_t)entry.report[0] != 0 || (uint8_t)entry.report[1] != 0;
+            if (current){
+                pressed += entry.duration;
+                pressed_runs += !last_pressed;
+            }
+            if (c != 0 && entry.start != timeline[c - 1].start + timeline[c - 1].duration){
+                gaps++;
+            }
+            last_pressed = current;
+        }
+
+        PABotBaseEmulatorStats stats = emulator->stats();
+        PABotBaseLinkStats link = connection.link_stats();
+        uint64_t commands = stats.commands_executed - commands_before;
+        double seconds = std::chrono::duration_cast<std::chrono::milliseconds>(time_end - time_start).count() / 1000.;
+        cout << label << ": "
+             << timeline.size() / seconds << " states/s, "
+             << commands << " commands for " << timeline.size() << " states, "
+             << gaps << " gaps, "
+             << stats.writes_dropped << " writes dropped, "
+             << stats.writes_corrupted << " writes corrupted, "
+             << stats.commands_dropped << " commands dropped, "
+             << link.retransmits << " retransmits" << endl;
+
+        if (pressed_runs != presses || pressed != presses * hold){
+            cerr << "Error: " << label << " expected " << presses << " presses of " << hold.count()
+                 << " ms. Got " << pressed_runs << " presses totaling "
+                 << std::chrono::duration_cast<Milliseconds>(pressed).count() << " ms." << endl;
+            return false;
+        }
+
+        //  Nothing is lost on a clean link so nothing should be resent, no
+        //  matter how long the messages wait behind each other on the wire.
+        if (config.loss_rate == 0 && config.corruption_rate == 0 &&
+            (link.retransmits != 0 || stats.duplicate_messages != 0)
+        ){
+            cerr << "Error: " << label << " resent " << link.retransmits << " messages on a clean link." << endl;
+            return false;
+        }
+
+        //  Without batches every state is its own command.
+        if ((commands < timeline.size()) != expect_batches){
+            cerr << "Error: " << label << " sent " << commands << " commands for " << timeline.size() << " states." << endl;
+            return false;
+        }
+        return true;
+    };
+
+    PABotBaseEmulatorConfig clean;
+    clean.controller = PABB_CID_NintendoSwitch_WiredController;
+    if (!run("Clean Link", clean, true)){
+        return 1;
+    }
+
+    PABotBaseEmulatorConfig slow = clean;
+    slow.latency = 5ms;
+    slow.jitter = 3ms;
+    slow.seed = 1;
+    if (!run("Clean Link with Latency", slow, true)){
+        return 1;
+    }
+
+    PABotBaseEmulatorConfig lossy = clean;
+    lossy.latency = 5ms;
+    lossy.jitter = 3ms;
+    lossy.loss_rate = 0.05;
+    lossy.corruption_rate = 0.02;
+    lossy.seed = 1;
+    if (!run("Lossy Link", lossy, true)){
+        return 1;
+    }
+
+    //  Firmware that predates batching. The host must fall back to one state
+    //  per command.
+    PABotBaseEmulatorConfig old_firmware = clean;
+    old_firmware.protocol_version = 2025090400;
+    old_firmware.program_id = PABB_PID_UNSPECIFIED;
+    old_firmware.command_batches = false;
+    if (!run("Old Firmware", old_firmware, false)){
+        return 1;
+    }
+
+    return 0;
+}
+
+
 
 }
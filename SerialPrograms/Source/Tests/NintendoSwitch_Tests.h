@@ -15,6 +15,8 @@ class ImageViewRGB32;
 
 int test_NintendoSwitch_UpdatePopupDetector(const ImageViewRGB32& image, bool target);
 
+int test_NintendoSwitch_EmulatedController(const ImageViewRGB32& image);
+
 }
 
 #endif
@@ -221,15 +221,36 @@ int sound_bool_detector_helper(SoundBoolDetectorFunction test_func, const std::s
 
 const std::map<std::string, TestFunction> TEST_MAP = {
     {"Kernels_ImageScaleBrightness", std::bind(image_void_detector_helper, test_kernels_ImageScaleBrightness, _1)},
+    {"Kernels_ImageScaledSumSqrDev", std::bind(image_void_detector_helper, test_kernels_ImageScaledSumSqrDev, _1)},
+    {"Kernels_ScaleInvariantMatrixMatch", std::bind(image_void_detector_helper, test_kernels_ScaleInvariantMatrixMatch, _1)},
+    {"Kernels_AbsFFT", std::bind(image_void_detector_helper, test_kernels_AbsFFT, _1)},
+    {"Kernels_VideoFrameConversion", std::bind(image_void_detector_helper, test_kernels_VideoFrameConversion, _1)},
+    {"Kernels_RGB32ToHSV32", std::bind(image_void_detector_helper, test_kernels_RGB32ToHSV32, _1)},
     {"Kernels_BinaryMatrix", std::bind(image_void_detector_helper, test_kernels_BinaryMatrix, _1)},
     {"Kernels_FilterRGB32Range", std::bind(image_void_detector_helper, test_kernels_FilterRGB32Range, _1)},
     {"Kernels_FilterRGB32Euclidean", std::bind(image_void_detector_helper, test_kernels_FilterRGB32Euclidean, _1)},
     {"Kernels_ToBlackWhiteRGB32Range", std::bind(image_void_detector_helper, test_kernels_ToBlackWhiteRGB32Range, _1)},
+    {"Kernels_ToBlackWhiteGray8RGB32Range", std::bind(image_void_detector_helper, test_kernels_ToBlackWhiteGray8RGB32Range, _1)},
     {"Kernels_FilterByMask", std::bind(image_void_detector_helper, test_kernels_FilterByMask, _1)},
     {"Kernels_CompressRGB32ToBinaryEuclidean", std::bind(image_void_detector_helper, test_kernels_CompressRGB32ToBinaryEuclidean, _1)},
     {"Kernels_Waterfill", std::bind(image_void_detector_helper, test_kernels_Waterfill, _1)},
+    {"Kernels_WaterfillBufferGrowth", std::bind(image_void_detector_helper, test_kernels_WaterfillBufferGrowth, _1)},
     {"CommonFramework_BlackBorderDetector", std::bind(image_bool_detector_helper, test_CommonFramework_BlackBorderDetector, _1)},
+    {"CommonFramework_QVideoFrameRegions", std::bind(image_void_detector_helper, test_CommonFramework_QVideoFrameRegions, _1)},
+    {"CommonFramework_ComputationThreadPool", std::bind(image_void_detector_helper, test_CommonFramework_ComputationThreadPool, _1)},
+    {"CommonFramework_ImageDictionaryMatcher", std::bind(image_void_detector_helper, test_CommonFramework_ImageDictionaryMatcher, _1)},
+    {"CommonFramework_ExactImageMatcher", std::bind(image_void_detector_helper, test_CommonFramework_ExactImageMatcher, _1)},
+    {"CommonFramework_OCRTextMatcher", std::bind(image_void_detector_helper, test_CommonFramework_OCRTextMatcher, _1)},
+    {"CommonFramework_JsonParser", std::bind(image_void_detector_helper, test_CommonFramework_JsonParser, _1)},
+    {"CommonFramework_StreamHistoryFrameCodec", std::bind(image_void_detector_helper, test_CommonFramework_StreamHistoryFrameCodec, _1)},
+    {"CommonFramework_SpectrumPreprocessor", std::bind(image_void_detector_helper, test_CommonFramework_SpectrumPreprocessor, _1)},
+    {"CommonFramework_FileWindowLogger", std::bind(image_void_detector_helper, test_CommonFramework_FileWindowLogger, _1)},
+    {"CommonFramework_AudioTemplateCache", std::bind(image_void_detector_helper, test_CommonFramework_AudioTemplateCache, _1)},
+    {"CommonFramework_BinaryEventLog", std::bind(image_void_detector_helper, test_CommonFramework_BinaryEventLog, _1)},
+    {"CommonFramework_SerialLoopback", std::bind(image_void_detector_helper, test_CommonFramework_SerialLoopback, _1)},
+    {"CommonFramework_VideoFileReplay", std::bind(image_void_detector_helper, test_CommonFramework_VideoFileReplay, _1)},
     {"NintendoSwitch_UpdatePopupDetector", std::bind(image_bool_detector_helper, test_NintendoSwitch_UpdatePopupDetector, _1)},
+    {"NintendoSwitch_EmulatedController", std::bind(image_void_detector_helper, test_NintendoSwitch_EmulatedController, _1)},
     {"PokemonSwSh_YCommMenuDetector", std::bind(image_bool_detector_helper, test_pokemonSwSh_YCommMenuDetector, _1)},
     {"PokemonSwSh_MaxLair_BattleMenuDetector", std::bind(image_bool_detector_helper, test_pokemonSwSh_MaxLair_BattleMenuDetector, _1)},
     {"PokemonSwSh_DialogTriangleDetector", std::bind(image_bool_detector_helper, test_pokemonSwSh_DialogTriangleDetector, _1)},
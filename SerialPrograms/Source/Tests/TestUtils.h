@@ -17,6 +17,7 @@
 #include "Controllers/SerialPABotBase/Connection/BotBase.h"
 #include "Controllers/SerialPABotBase/Connection/BotBaseMessage.h"
 #include "CommonFramework/AudioPipeline/AudioFeed.h"
+#include "CommonFramework/AudioPipeline/Spectrum/SpectrumPreprocessor.h"
 //#include "CommonFramework/Logging/Logger.h"
 #include "CommonFramework/VideoPipeline/VideoFeed.h"
 #include "CommonFramework/VideoPipeline/VideoOverlay.h"
@@ -139,6 +140,11 @@ public:
     virtual std::vector<AudioSpectrum> spectrums_latest(size_t num_last_spectrums) override { return std::vector<AudioSpectrum>(); }
 
     void add_overlay(uint64_t starting_seqnum, size_t end_seqnum, Color color) override {}
+
+    virtual SpectrumPreprocessor& spectrum_preprocessor() override { return m_spectrum_preprocessor; }
+
+private:
+    SpectrumPreprocessor m_spectrum_preprocessor;
 };
 
 
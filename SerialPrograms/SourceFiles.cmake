@@ -33,8 +33,11 @@ file(GLOB LIBRARY_SOURCES
     ../Common/Cpp/Concurrency/ComputationThreadPool.h
     ../Common/Cpp/Concurrency/ComputationThreadPoolCore.cpp
     ../Common/Cpp/Concurrency/ComputationThreadPoolCore.h
+    ../Common/Cpp/Concurrency/ComputationThreadPoolCore_SingleQueue.cpp
+    ../Common/Cpp/Concurrency/ComputationThreadPoolCore_SingleQueue.h
     ../Common/Cpp/Concurrency/FireForgetDispatcher.cpp
     ../Common/Cpp/Concurrency/FireForgetDispatcher.h
+    ../Common/Cpp/Concurrency/LockFreeQueues.h
     ../Common/Cpp/Concurrency/PeriodicScheduler.cpp
     ../Common/Cpp/Concurrency/PeriodicScheduler.h
     ../Common/Cpp/Concurrency/ReverseLockGuard.h
@@ -85,6 +88,8 @@ file(GLOB LIBRARY_SOURCES
     ../Common/Cpp/Json/JsonArray.h
     ../Common/Cpp/Json/JsonObject.cpp
     ../Common/Cpp/Json/JsonObject.h
+    ../Common/Cpp/Json/JsonParser.cpp
+    ../Common/Cpp/Json/JsonParser.h
     ../Common/Cpp/Json/JsonTools.cpp
     ../Common/Cpp/Json/JsonTools.h
     ../Common/Cpp/Json/JsonValue.cpp
@@ -281,6 +286,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/AudioPipeline/Spectrum/FFTStreamer.h
     Source/CommonFramework/AudioPipeline/Spectrum/Spectrograph.cpp
     Source/CommonFramework/AudioPipeline/Spectrum/Spectrograph.h
+    Source/CommonFramework/AudioPipeline/Spectrum/SpectrumPreprocessor.cpp
+    Source/CommonFramework/AudioPipeline/Spectrum/SpectrumPreprocessor.h
     Source/CommonFramework/AudioPipeline/Tools/AudioFormatUtils.cpp
     Source/CommonFramework/AudioPipeline/Tools/AudioFormatUtils.h
     Source/CommonFramework/AudioPipeline/Tools/AudioNormalization.h
@@ -351,6 +358,10 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/ImageTypes/ImageViewRGB32.h
     Source/CommonFramework/Language.cpp
     Source/CommonFramework/Language.h
+    Source/CommonFramework/Logging/BinaryEventLog.cpp
+    Source/CommonFramework/Logging/BinaryEventLog.h
+    Source/CommonFramework/Logging/BinaryEventLogFile.cpp
+    Source/CommonFramework/Logging/BinaryEventLogFile.h
     Source/CommonFramework/Logging/FileWindowLogger.cpp
     Source/CommonFramework/Logging/FileWindowLogger.h
     Source/CommonFramework/Logging/Logger.cpp
@@ -416,10 +427,13 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/ProgramStats/StatsDatabase.h
     Source/CommonFramework/ProgramStats/StatsTracking.cpp
     Source/CommonFramework/ProgramStats/StatsTracking.h
+    Source/CommonFramework/Recording/StreamHistoryFrameCodec.cpp
+    Source/CommonFramework/Recording/StreamHistoryFrameCodec.h
     Source/CommonFramework/Recording/StreamHistoryOption.cpp
     Source/CommonFramework/Recording/StreamHistoryOption.h
     Source/CommonFramework/Recording/StreamHistorySession.cpp
     Source/CommonFramework/Recording/StreamHistorySession.h
+    Source/CommonFramework/Recording/StreamHistoryTracker_CompressedFrames.h
     Source/CommonFramework/Recording/StreamHistoryTracker_Null.h
     Source/CommonFramework/Recording/StreamHistoryTracker_ParallelStreams.h
     Source/CommonFramework/Recording/StreamHistoryTracker_RecordOnTheFly.h
@@ -454,6 +468,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/VideoPipeline/Backends/MediaServicesQt6.h
     Source/CommonFramework/VideoPipeline/Backends/QCameraThread.h
     Source/CommonFramework/VideoPipeline/Backends/QVideoFrameCache.h
+    Source/CommonFramework/VideoPipeline/Backends/QVideoFrameConversion.cpp
+    Source/CommonFramework/VideoPipeline/Backends/QVideoFrameConversion.h
     Source/CommonFramework/VideoPipeline/Backends/SnapshotManager.cpp
     Source/CommonFramework/VideoPipeline/Backends/SnapshotManager.h
     Source/CommonFramework/VideoPipeline/Backends/VideoFrameQt.h
@@ -462,6 +478,10 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/VideoPipeline/Stats/CpuUtilizationStats.h
     Source/CommonFramework/VideoPipeline/Stats/MemoryUtilizationStats.cpp
     Source/CommonFramework/VideoPipeline/Stats/MemoryUtilizationStats.h
+    Source/CommonFramework/VideoPipeline/Stats/OcrPoolStats.cpp
+    Source/CommonFramework/VideoPipeline/Stats/OcrPoolStats.h
+    Source/CommonFramework/VideoPipeline/Stats/SerialLinkStats.cpp
+    Source/CommonFramework/VideoPipeline/Stats/SerialLinkStats.h
     Source/CommonFramework/VideoPipeline/Stats/ThreadUtilizationStats.cpp
     Source/CommonFramework/VideoPipeline/Stats/ThreadUtilizationStats.h
     Source/CommonFramework/VideoPipeline/UI/VideoDisplayWidget.cpp
@@ -483,6 +503,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/VideoPipeline/VideoOverlayTypes.cpp
     Source/CommonFramework/VideoPipeline/VideoOverlayTypes.h
     Source/CommonFramework/VideoPipeline/VideoPipelineOptions.h
+    Source/CommonFramework/VideoPipeline/VideoRegionSnapshot.cpp
+    Source/CommonFramework/VideoPipeline/VideoRegionSnapshot.h
     Source/CommonFramework/VideoPipeline/VideoSession.cpp
     Source/CommonFramework/VideoPipeline/VideoSession.h
     Source/CommonFramework/VideoPipeline/VideoSource.cpp
@@ -491,6 +513,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonFramework/VideoPipeline/VideoSourceDescriptor.h
     Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_Camera.cpp
     Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_Camera.h
+    Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_FileReplay.cpp
+    Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_FileReplay.h
     Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_Null.cpp
     Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_Null.h
     Source/CommonFramework/VideoPipeline/VideoSources/VideoSource_StillImage.cpp
@@ -521,6 +545,8 @@ file(GLOB LIBRARY_SOURCES
     Source/CommonTools/FailureWatchdog.h
     Source/CommonTools/ImageMatch/CroppedImageDictionaryMatcher.cpp
     Source/CommonTools/ImageMatch/CroppedImageDictionaryMatcher.h
+    Source/CommonTools/ImageMatch/DictionaryMatchPruning.cpp
+    Source/CommonTools/ImageMatch/DictionaryMatchPruning.h
     Source/CommonTools/ImageMatch/ExactImageDictionaryMatcher.cpp
     Source/CommonTools/ImageMatch/ExactImageDictionaryMatcher.h
     Source/CommonTools/ImageMatch/ExactImageMatcher.cpp
@@ -666,8 +692,12 @@ file(GLOB LIBRARY_SOURCES
     Source/Controllers/SerialPABotBase/Connection/MessageSniffer.h
     Source/Controllers/SerialPABotBase/Connection/PABotBase.cpp
     Source/Controllers/SerialPABotBase/Connection/PABotBase.h
+    Source/Controllers/SerialPABotBase/Connection/PABotBaseLinkStats.cpp
+    Source/Controllers/SerialPABotBase/Connection/PABotBaseLinkStats.h
     Source/Controllers/SerialPABotBase/Connection/PABotBaseConnection.cpp
     Source/Controllers/SerialPABotBase/Connection/PABotBaseConnection.h
+    Source/Controllers/SerialPABotBase/Connection/PABotBaseEmulator.cpp
+    Source/Controllers/SerialPABotBase/Connection/PABotBaseEmulator.h
     Source/Controllers/SerialPABotBase/SerialPABotBase.cpp
     Source/Controllers/SerialPABotBase/SerialPABotBase.h
     Source/Controllers/SerialPABotBase/SerialPABotBase_Connection.cpp
@@ -683,6 +713,7 @@ file(GLOB LIBRARY_SOURCES
     Source/Controllers/SerialPABotBase/SerialPABotBase_Routines_Protocol.cpp
     Source/Controllers/SerialPABotBase/SerialPABotBase_Routines_Protocol.h
     Source/Controllers/SerialPABotBase/SerialPABotBase_SelectorWidget.h
+    Source/Controllers/SerialPABotBase/SerialPABotBase_StateBatch.h
     Source/Controllers/SerialPABotBase/SerialPABotBase_StatusThread.h
     Source/Controllers/StandardHid/StandardHid_Keyboard.cpp
     Source/Controllers/StandardHid/StandardHid_Keyboard.h
@@ -720,8 +751,10 @@ file(GLOB LIBRARY_SOURCES
     Source/Kernels/AbsFFT/Kernels_AbsFFT_Arch.h
     Source/Kernels/AbsFFT/Kernels_AbsFFT_Arch_Default.h
     Source/Kernels/AbsFFT/Kernels_AbsFFT_Arch_x86_AVX2.h
+    Source/Kernels/AbsFFT/Kernels_AbsFFT_Arch_x86_AVX512.h
     Source/Kernels/AbsFFT/Kernels_AbsFFT_Arch_x86_SSE41.h
     Source/Kernels/AbsFFT/Kernels_AbsFFT_BaseTransform_x86_AVX2.h
+    Source/Kernels/AbsFFT/Kernels_AbsFFT_BaseTransform_x86_AVX512.h
     Source/Kernels/AbsFFT/Kernels_AbsFFT_BaseTransform_x86_SSE41.h
     Source/Kernels/AbsFFT/Kernels_AbsFFT_BitReverse.h
     Source/Kernels/AbsFFT/Kernels_AbsFFT_Butterflies.h
@@ -730,6 +763,7 @@ file(GLOB LIBRARY_SOURCES
     Source/Kernels/AbsFFT/Kernels_AbsFFT_ComplexVector.h
     Source/Kernels/AbsFFT/Kernels_AbsFFT_Core_Default.cpp
     Source/Kernels/AbsFFT/Kernels_AbsFFT_Core_x86_AVX2.cpp
+    Source/Kernels/AbsFFT/Kernels_AbsFFT_Core_x86_AVX512.cpp
     Source/Kernels/AbsFFT/Kernels_AbsFFT_Core_x86_SSE41.cpp
     Source/Kernels/AbsFFT/Kernels_AbsFFT_FullTransform.h
     Source/Kernels/AbsFFT/Kernels_AbsFFT_FullTransform.tpp
@@ -813,6 +847,19 @@ file(GLOB LIBRARY_SOURCES
     Source/Kernels/ImageFilters/RGB32_EuclideanDistance/Kernels_ImageFilter_RGB32_Euclidean_x64_AVX2.cpp
     Source/Kernels/ImageFilters/RGB32_EuclideanDistance/Kernels_ImageFilter_RGB32_Euclidean_x64_AVX512.cpp
     Source/Kernels/ImageFilters/RGB32_EuclideanDistance/Kernels_ImageFilter_RGB32_Euclidean_x64_SSE42.cpp
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV.cpp
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV.h
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_ARM64_NEON.cpp
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_Default.cpp
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_Routines.h
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_Routines_ARM64_NEON.h
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_Routines_Default.h
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_Routines_x64_AVX2.h
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_Routines_x64_AVX512.h
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_Routines_x64_SSE42.h
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_x64_AVX2.cpp
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_x64_AVX512.cpp
+    Source/Kernels/ImageFilters/RGB32_HSV/Kernels_ImageFilter_RGB32_HSV_x64_SSE42.cpp
     Source/Kernels/ImageFilters/RGB32_Range/Kernels_ImageFilter_RGB32_Range.cpp
     Source/Kernels/ImageFilters/RGB32_Range/Kernels_ImageFilter_RGB32_Range.h
     Source/Kernels/ImageFilters/RGB32_Range/Kernels_ImageFilter_RGB32_Range_ARM64_NEON.cpp
@@ -839,6 +886,13 @@ file(GLOB LIBRARY_SOURCES
     Source/Kernels/ImageStats/Kernels_ImagePixelSumSqr_x64_AVX2.cpp
     Source/Kernels/ImageStats/Kernels_ImagePixelSumSqr_x64_AVX512.cpp
     Source/Kernels/ImageStats/Kernels_ImagePixelSumSqr_x64_SSE41.cpp
+    Source/Kernels/ImageStats/Kernels_ImageScaledSumSqrDev.cpp
+    Source/Kernels/ImageStats/Kernels_ImageScaledSumSqrDev.h
+    Source/Kernels/ImageStats/Kernels_ImageScaledSumSqrDev_Default.cpp
+    Source/Kernels/ImageStats/Kernels_ImageScaledSumSqrDev_Routines.h
+    Source/Kernels/ImageStats/Kernels_ImageScaledSumSqrDev_x64_AVX2.cpp
+    Source/Kernels/ImageStats/Kernels_ImageScaledSumSqrDev_x64_AVX512.cpp
+    Source/Kernels/ImageStats/Kernels_ImageScaledSumSqrDev_x64_SSE41.cpp
     Source/Kernels/Kernels_Alignment.h
     Source/Kernels/Kernels_BitScan.h
     Source/Kernels/Kernels_BitSet.h
@@ -863,6 +917,14 @@ file(GLOB LIBRARY_SOURCES
     Source/Kernels/SpikeConvolution/Kernels_SpikeConvolution_Core_x86_AVX512.cpp
     Source/Kernels/SpikeConvolution/Kernels_SpikeConvolution_Core_x86_SSE41.cpp
     Source/Kernels/SpikeConvolution/Kernels_SpikeConvolution_Routines.h
+    Source/Kernels/VideoFrameConversion/Kernels_VideoFrameConversion.cpp
+    Source/Kernels/VideoFrameConversion/Kernels_VideoFrameConversion.h
+    Source/Kernels/VideoFrameConversion/Kernels_VideoFrameConversion_Default.cpp
+    Source/Kernels/VideoFrameConversion/Kernels_VideoFrameConversion_Routines.h
+    Source/Kernels/VideoFrameConversion/Kernels_VideoFrameConversion_arm64_NEON.cpp
+    Source/Kernels/VideoFrameConversion/Kernels_VideoFrameConversion_x64_AVX2.cpp
+    Source/Kernels/VideoFrameConversion/Kernels_VideoFrameConversion_x64_AVX512.cpp
+    Source/Kernels/VideoFrameConversion/Kernels_VideoFrameConversion_x64_SSE41.cpp
     Source/Kernels/Waterfill/Kernels_Waterfill.cpp
     Source/Kernels/Waterfill/Kernels_Waterfill.h
     Source/Kernels/Waterfill/Kernels_Waterfill_Core_64x16_x64_AVX2.cpp